@@ -0,0 +1,24 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+/**
+ * \brief Copy a library to a backup file while it stays available to other processes.
+ * \param library Path to library file.
+ * \param output Path to backup file.
+ * \param pagesPerStep Number of pages copied per step.
+ * \param throttle Time to sleep after each step.
+ * \param out Ostream to write the progress to.
+ */
+void backupLibrary(const std::filesystem::path& library,
+                   const std::filesystem::path& output,
+                   int32_t                      pagesPerStep,
+                   std::chrono::milliseconds    throttle,
+                   std::ostream&                out);
@@ -0,0 +1,10 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <ostream>
+
+void writeStorageStats(const std::filesystem::path& library, std::ostream& out);
@@ -0,0 +1,29 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
+
+/**
+ * \brief Write the schema and all instances of a library to a dump file. See alex::LibraryDump::write.
+ * \param library Path to library file.
+ * \param output Path to dump file.
+ * \param out Ostream to write the throughput or error to.
+ */
+void exportLibrary(const std::filesystem::path& library, const std::filesystem::path& output, std::ostream& out);
+
+/**
+ * \brief Read a dump file into a library, creating the library if it does not exist. See alex::LibraryDump::read.
+ * \param library Path to library file.
+ * \param input Path to dump file.
+ * \param batchSize Number of rows per transaction.
+ * \param out Ostream to write the throughput or error to.
+ */
+void importLibrary(const std::filesystem::path& library,
+                   const std::filesystem::path& input,
+                   size_t                       batchSize,
+                   std::ostream&                out);
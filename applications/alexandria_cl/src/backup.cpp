@@ -0,0 +1,50 @@
+#include "alexandria_cl/backup.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <iostream>
+#include <thread>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+
+void backupLibrary(const std::filesystem::path&    library,
+                   const std::filesystem::path&    output,
+                   const int32_t                   pagesPerStep,
+                   const std::chrono::milliseconds throttle,
+                   std::ostream&                   out)
+{
+    try
+    {
+        const auto start   = std::chrono::steady_clock::now();
+        const auto lib     = alex::Library::open(library);
+        int32_t    percent = -1;
+        int64_t    pages   = 0;
+        lib->backupTo(output, pagesPerStep, [&](const alex::BackupProgress& progress) {
+            // Only write a line when the percentage changes.
+            if (const auto current = static_cast<int32_t>(progress.getFraction() * 100.0); current != percent)
+            {
+                percent = current;
+                out << std::format(
+                  "{:>3}% ({} of {} pages)\n", percent, progress.total - progress.remaining, progress.total);
+            }
+            pages = progress.total;
+
+            if (progress.remaining > 0 && throttle.count() > 0) std::this_thread::sleep_for(throttle);
+            return true;
+        });
+
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        out << std::format("Copied {} pages to {} in {:.3f}s\n", pages, output.string(), seconds);
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+}
@@ -2,6 +2,8 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 
@@ -15,7 +17,10 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria_cl/backup.h"
 #include "alexandria_cl/specification.h"
+#include "alexandria_cl/stats.h"
+#include "alexandria_cl/transfer.h"
 
 int main(int argc, char** argv)
 {
@@ -28,6 +33,20 @@ int main(int argc, char** argv)
     output->set_help("Path to output file");
     auto spec = parser.add_flag('\0', "specification");
     spec->set_help("Write specification graph to output file");
+    auto stats = parser.add_flag('\0', "stats");
+    stats->set_help("Print the storage used by each type, table, index and column");
+    auto exportFlag = parser.add_flag('\0', "export");
+    exportFlag->set_help("Write all instances to a dump file at the output path");
+    auto importFile = parser.add_value<std::filesystem::path>('\0', "import");
+    importFile->set_help("Read a dump file into the library. The library is created if it does not exist");
+    auto batch = parser.add_value<int32_t>('\0', "batch");
+    batch->set_help("Number of rows per transaction when importing (default 10000)");
+    auto backup = parser.add_flag('\0', "backup");
+    backup->set_help("Copy the library to the output path while it stays in use");
+    auto pages = parser.add_value<int32_t>('\0', "pages");
+    pages->set_help("Number of pages copied per backup step (default 128)");
+    auto throttle = parser.add_value<int32_t>('\0', "throttle");
+    throttle->set_help("Milliseconds to sleep after each backup step (default 0)");
 
     // Run the parser.
     std::string e;
@@ -57,4 +76,67 @@ int main(int argc, char** argv)
         writeSpecification(library->get_value(), output->get_value());
         return 0;
     }
+
+    if (stats->is_set())
+    {
+        if (!library->is_set())
+        {
+            std::cout << "Missing library argument" << std::endl;
+            return 0;
+        }
+
+        writeStorageStats(library->get_value(), std::cout);
+        return 0;
+    }
+
+    if (exportFlag->is_set())
+    {
+        if (!library->is_set())
+        {
+            std::cout << "Missing library argument" << std::endl;
+            return 0;
+        }
+
+        if (!output->is_set())
+        {
+            std::cout << "Missing output argument" << std::endl;
+            return 0;
+        }
+
+        exportLibrary(library->get_value(), output->get_value(), std::cout);
+        return 0;
+    }
+
+    if (importFile->is_set())
+    {
+        if (!library->is_set())
+        {
+            std::cout << "Missing library argument" << std::endl;
+            return 0;
+        }
+
+        const auto batchSize = batch->is_set() ? static_cast<size_t>(std::max(batch->get_value(), 1)) : 10000;
+        importLibrary(library->get_value(), importFile->get_value(), batchSize, std::cout);
+        return 0;
+    }
+
+    if (backup->is_set())
+    {
+        if (!library->is_set())
+        {
+            std::cout << "Missing library argument" << std::endl;
+            return 0;
+        }
+
+        if (!output->is_set())
+        {
+            std::cout << "Missing output argument" << std::endl;
+            return 0;
+        }
+
+        const auto pagesPerStep = pages->is_set() ? std::max(pages->get_value(), 1) : 128;
+        const auto sleep = std::chrono::milliseconds(throttle->is_set() ? std::max(throttle->get_value(), 0) : 0);
+        backupLibrary(library->get_value(), output->get_value(), pagesPerStep, sleep, std::cout);
+        return 0;
+    }
 }
@@ -11,7 +11,7 @@
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
-#include "alexandria/library.h"
+#include "alexandria-core/library.h"
 
 void writeSpecification(const std::filesystem::path& library, const std::filesystem::path& output)
 {
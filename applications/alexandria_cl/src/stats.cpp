@@ -0,0 +1,110 @@
+#include "alexandria_cl/stats.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+
+namespace
+{
+    void writeHeader(std::ostream& out)
+    {
+        out << std::format("{:<40} {:<16} {:>10} {:>8} {:>8} {:>12} {:>12} {:>12} {:>12} {:>6}\n",
+                           "type / table / column",
+                           "kind",
+                           "rows",
+                           "pages",
+                           "overflow",
+                           "payload",
+                           "unused",
+                           "table size",
+                           "index size",
+                           "frag%");
+    }
+
+    void writeRow(std::ostream&           out,
+                  const std::string_view  name,
+                  const std::string_view  kind,
+                  const alex::BtreeStats& table,
+                  const alex::BtreeStats& indices)
+    {
+        out << std::format("{:<40} {:<16} {:>10} {:>8} {:>8} {:>12} {:>12} {:>12} {:>12} {:>6.1f}\n",
+                           name,
+                           kind,
+                           table.rows,
+                           table.pages,
+                           table.overflowPages,
+                           table.payload,
+                           table.unused,
+                           table.size,
+                           indices.size,
+                           table.getFragmentation() * 100.0);
+    }
+
+    void writeTable(std::ostream& out, const alex::TableStats& table)
+    {
+        writeRow(out, "  " + table.name, table.kind, table.table, table.indices);
+        for (const auto& column : table.columns)
+            out << std::format(
+              "{:<40} {:<16} {:>10} {:>8} {:>8} {:>12}\n", "    " + column.name, "", "", "", "", column.bytes);
+    }
+}  // namespace
+
+void writeStorageStats(const std::filesystem::path& library, std::ostream& out)
+{
+    alex::StorageStats stats;
+    try
+    {
+        const auto lib = alex::Library::open(library);
+        stats          = lib->storageStats();
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return;
+    }
+
+    out << std::format("{} pages of {} bytes ({} bytes), {} free pages\n\n",
+                       stats.pageCount,
+                       stats.pageSize,
+                       stats.pageCount * stats.pageSize,
+                       stats.freePages);
+
+    // Largest types first.
+    auto types = stats.types;
+    std::ranges::sort(
+      types, std::greater{}, [](const alex::TypeStats& type) { return type.table.size + type.indices.size; });
+
+    writeHeader(out);
+    for (const auto& type : types)
+    {
+        writeRow(out, type.nameSpace + "." + type.name, "", type.table, type.indices);
+        for (const auto& table : type.tables) writeTable(out, table);
+    }
+
+    out << "other\n";
+    for (const auto& table : stats.other) writeTable(out, table);
+
+    out << std::format("\nshared blobs: {} blobs, {} references, {} bytes stored, {} bytes referenced ({:.2f}x)\n",
+                       stats.shared.blobs,
+                       stats.shared.references,
+                       stats.shared.storedBytes,
+                       stats.shared.referencedBytes,
+                       stats.shared.getRatio());
+    out << std::format("external blobs: {} blobs, {} live bytes, {} bytes in pack file\n",
+                       stats.external.blobs,
+                       stats.external.liveBytes,
+                       stats.external.fileBytes);
+}
@@ -0,0 +1,67 @@
+#include "alexandria_cl/transfer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/library_dump.h"
+
+namespace
+{
+    void writeThroughput(std::ostream&                               out,
+                         const std::string_view                      action,
+                         const alex::LibraryDump::Stats&             stats,
+                         const std::chrono::steady_clock::time_point start)
+    {
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        out << std::format("{} {} rows of {} tables, {} bytes in {:.3f}s ({:.1f} MB/s)\n",
+                           action,
+                           stats.rows,
+                           stats.tables,
+                           stats.bytes,
+                           seconds,
+                           seconds > 0.0 ? static_cast<double>(stats.bytes) / 1e6 / seconds : 0.0);
+    }
+}  // namespace
+
+void exportLibrary(const std::filesystem::path& library, const std::filesystem::path& output, std::ostream& out)
+{
+    try
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto lib   = alex::Library::open(library);
+        const auto stats = alex::LibraryDump::write(*lib, output);
+        writeThroughput(out, "Exported", stats, start);
+    }
+    catch (const std::runtime_error& e)
+    {
+        out << e.what() << std::endl;
+    }
+}
+
+void importLibrary(const std::filesystem::path& library,
+                   const std::filesystem::path& input,
+                   const size_t                 batchSize,
+                   std::ostream&                out)
+{
+    try
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto stats = alex::LibraryDump::read(library, input, batchSize);
+        writeThroughput(out, "Imported", stats, start);
+    }
+    catch (const std::runtime_error& e)
+    {
+        out << e.what() << std::endl;
+    }
+}
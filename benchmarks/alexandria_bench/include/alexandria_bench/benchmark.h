@@ -0,0 +1,158 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    /**
+     * \brief Timings of a single benchmark.
+     */
+    struct Result
+    {
+        std::string              name;
+        size_t                   iterations = 0;
+        size_t                   items      = 0;
+        std::chrono::nanoseconds min{};
+        std::chrono::nanoseconds median{};
+        std::chrono::nanoseconds mean{};
+    };
+
+    /**
+     * \brief Runs benchmark functions a fixed number of times and collects their timings.
+     */
+    class Runner
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        Runner() = delete;
+
+        /**
+         * \brief Construct a runner.
+         * \param iterationCount Number of timed iterations per benchmark. One untimed warm-up run precedes them.
+         * \param nameFilter Only benchmarks whose name contains this string are run. Empty to run all.
+         */
+        Runner(size_t iterationCount, std::string nameFilter);
+
+        Runner(const Runner&) = delete;
+
+        Runner(Runner&&) noexcept = delete;
+
+        ~Runner() noexcept = default;
+
+        Runner& operator=(const Runner&) = delete;
+
+        Runner& operator=(Runner&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Running.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Returns whether a benchmark is selected by the name filter.
+         * \param name Benchmark name.
+         * \return True if selected.
+         */
+        [[nodiscard]] bool selected(const std::string& name) const;
+
+        /**
+         * \brief Run a benchmark.
+         * \tparam F Callable returning the number of processed items (e.g. returned search results), which is
+         * reported and prevents the work from being optimized away.
+         * \param name Benchmark name.
+         * \param f Benchmark function.
+         */
+        template<typename F>
+        void run(const std::string& name, F&& f)
+        {
+            run(name, [] {}, std::forward<F>(f));
+        }
+
+        /**
+         * \brief Run a benchmark that needs to restore some state before each iteration, e.g. reinsert the instances
+         * that were deleted by the previous iteration. The setup is not timed.
+         * \tparam S Setup callable.
+         * \tparam F Callable returning the number of processed items.
+         * \param name Benchmark name.
+         * \param setup Setup function, called before each run of f.
+         * \param f Benchmark function.
+         */
+        template<typename S, typename F>
+        void run(const std::string& name, S&& setup, F&& f)
+        {
+            if (!selected(name)) return;
+
+            // Warm-up run to populate caches and prepared statements.
+            setup();
+            size_t items = f();
+
+            std::vector<std::chrono::nanoseconds> times;
+            times.reserve(iterations);
+            for (size_t i = 0; i < iterations; i++)
+            {
+                setup();
+                const auto start = std::chrono::steady_clock::now();
+                items            = f();
+                times.emplace_back(std::chrono::steady_clock::now() - start);
+            }
+
+            add(name, items, std::move(times));
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Results.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] const std::vector<Result>& getResults() const noexcept;
+
+        void print(std::ostream& out) const;
+
+        /**
+         * \brief Write all results as a JSON document, with one object per benchmark in the "results" array.
+         * \param out Stream.
+         */
+        void writeJson(std::ostream& out) const;
+
+        /**
+         * \brief Read the results from a JSON document written by writeJson.
+         * \param in Stream.
+         * \return Results.
+         */
+        [[nodiscard]] static std::vector<Result> readJson(std::istream& in);
+
+        /**
+         * \brief Print the change of the median of each benchmark relative to a baseline run.
+         * \param baseline Results of the baseline run.
+         * \param threshold Relative increase of the median above which a benchmark is reported as a regression, e.g.
+         * 0.1 for 10%.
+         * \param out Stream.
+         * \return Number of regressions.
+         */
+        size_t compare(const std::vector<Result>& baseline, double threshold, std::ostream& out) const;
+
+    private:
+        void add(std::string name, size_t items, std::vector<std::chrono::nanoseconds> times);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        size_t iterations = 0;
+
+        std::string filter;
+
+        std::vector<Result> results;
+    };
+}  // namespace bench
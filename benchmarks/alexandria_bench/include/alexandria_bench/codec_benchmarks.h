@@ -0,0 +1,26 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Measure the compression ratio and throughput of the blob codecs on mesh data, both directly and through
+     * insert and get queries. Meshes are read from the OBJ models in a directory (e.g. examples/geometry/models), plus
+     * a large generated sphere. The compression ratio is part of the benchmark name, the number of items is the
+     * encoded size in bytes.
+     * \param runner Runner.
+     * \param modelDir Directory with OBJ models. If it does not exist, only the generated mesh is used.
+     */
+    void runCodecBenchmarks(Runner& runner, const std::string& modelDir);
+}  // namespace bench
@@ -0,0 +1,26 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Measure the cost and benefit of blob deduplication on a scene in which every mesh is placed several
+     * times, as happens when assets are instanced. Meshes are read from the OBJ models in a directory, plus a large
+     * generated sphere. Inserting and retrieving the scene is compared with and without deduplication. The
+     * deduplication ratio of the scene is part of the benchmark name. Also measures the throughput of the content hash.
+     * \param runner Runner.
+     * \param modelDir Directory with OBJ models. If it does not exist, only the generated mesh is used.
+     */
+    void runDedupBenchmarks(Runner& runner, const std::string& modelDir);
+}  // namespace bench
@@ -0,0 +1,25 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Compare storing large meshes in the database with storing them in the external pack file. Inserting,
+     * retrieving and viewing the vertices without copying are measured for both. Libraries are created as files in the
+     * temporary directory, so that both include the cost of writing to disk.
+     * \param runner Runner.
+     * \param modelDir Directory with OBJ models. If it does not exist, only the generated mesh is used.
+     */
+    void runExternalBenchmarks(Runner& runner, const std::string& modelDir);
+}  // namespace bench
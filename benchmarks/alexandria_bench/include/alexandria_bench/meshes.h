@@ -0,0 +1,61 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+
+namespace bench
+{
+    struct Float3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    struct Mesh
+    {
+        alex::InstanceId                id;
+        std::string                     name;
+        alex::Blob<std::vector<Float3>> vertices;
+        alex::PrimitiveBlob<uint32_t>   indices;
+    };
+
+    using MeshDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Mesh::id>,
+                                                        alex::Member<"name", &Mesh::name>,
+                                                        alex::Member<"vertices", &Mesh::vertices>,
+                                                        alex::Member<"indices", &Mesh::indices>>;
+
+    /**
+     * \brief Read the vertices and faces of an OBJ file. Polygons are triangulated as fans.
+     * \param path Path to OBJ file.
+     * \return Mesh.
+     */
+    [[nodiscard]] Mesh readObj(const std::filesystem::path& path);
+
+    /**
+     * \brief Generate a UV sphere.
+     * \param rings Number of rings.
+     * \param segments Number of segments per ring.
+     * \return Mesh.
+     */
+    [[nodiscard]] Mesh generateSphere(uint32_t rings, uint32_t segments);
+
+    /**
+     * \brief Read all OBJ models in a directory (e.g. examples/geometry/models), plus a large generated sphere.
+     * \param modelDir Directory with OBJ models. If it does not exist, only the generated mesh is returned.
+     * \return Meshes.
+     */
+    [[nodiscard]] std::vector<Mesh> loadMeshes(const std::string& modelDir);
+}  // namespace bench
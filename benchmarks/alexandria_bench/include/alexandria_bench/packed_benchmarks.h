@@ -0,0 +1,18 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Compare packed primitive and string arrays with arrays stored as one row per element. Objects hold an
+     * array of floats and an array of strings. Inserting and retrieving them is measured for several array sizes, with
+     * the same total number of elements for each size.
+     * \param runner Runner.
+     */
+    void runPackedBenchmarks(Runner& runner);
+}  // namespace bench
@@ -0,0 +1,26 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Measure the basic queries (insert, get, update and delete) and, where the member supports them, primitive
+     * and reference searches for each kind of member: primitive, string, blob, primitive blob, primitive array, string
+     * array, blob array, reference and reference array. Members with a variable size are measured for several sizes.
+     * Benchmarks are named "query <kind> <instances>x<size> <query>", so that they can be selected with the filter.
+     * \param runner Runner.
+     * \param instances Number of instances for the smallest size. Fewer instances are used for larger sizes.
+     */
+    void runQueryBenchmarks(Runner& runner, size_t instances);
+}  // namespace bench
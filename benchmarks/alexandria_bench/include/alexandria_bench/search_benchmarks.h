@@ -0,0 +1,24 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Compare searches compiled from search expressions (EXISTS subqueries in a single statement) with the
+     * UNION/INTERSECT based reference searches and client-side combination of separate searches.
+     * \param runner Runner.
+     * \param instances Number of instances to search over.
+     */
+    void runSearchBenchmarks(Runner& runner, size_t instances);
+}  // namespace bench
@@ -0,0 +1,25 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+
+namespace bench
+{
+    /**
+     * \brief Compare box and radius searches through the R*Tree index with the equivalent conjunction of primitive
+     * comparisons, which scans the instance table. Runs on its own number of instances (--spatial-instances, default
+     * 1000000), since the difference only shows on large tables.
+     * \param runner Runner.
+     * \param instances Number of instances to search over.
+     */
+    void runSpatialBenchmarks(Runner& runner, size_t instances);
+}  // namespace bench
@@ -0,0 +1,193 @@
+#include "alexandria_bench/benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <numeric>
+#include <regex>
+#include <unordered_map>
+
+namespace
+{
+    [[nodiscard]] std::string escape(const std::string& str)
+    {
+        std::string escaped;
+        for (const auto c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+                escaped += std::format("\\u{:04x}", static_cast<int32_t>(c));
+            else
+                escaped += c;
+        }
+        return escaped;
+    }
+
+    [[nodiscard]] std::string unescape(const std::string& str)
+    {
+        std::string unescaped;
+        for (size_t i = 0; i < str.size(); i++)
+        {
+            if (str[i] != '\\' || i + 1 == str.size())
+                unescaped += str[i];
+            else if (str[i + 1] == 'u' && i + 5 < str.size())
+            {
+                unescaped += static_cast<char>(std::stoi(str.substr(i + 2, 4), nullptr, 16));
+                i += 5;
+            }
+            else
+                unescaped += str[++i];
+        }
+        return unescaped;
+    }
+
+    [[nodiscard]] double toMicroseconds(const std::chrono::nanoseconds ns)
+    {
+        return static_cast<double>(ns.count()) / 1000.0;
+    }
+}  // namespace
+
+namespace bench
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    Runner::Runner(const size_t iterationCount, std::string nameFilter) :
+        iterations(std::max<size_t>(iterationCount, 1)), filter(std::move(nameFilter))
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Running.
+    ////////////////////////////////////////////////////////////////
+
+    bool Runner::selected(const std::string& name) const
+    {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Results.
+    ////////////////////////////////////////////////////////////////
+
+    const std::vector<Result>& Runner::getResults() const noexcept { return results; }
+
+    void Runner::print(std::ostream& out) const
+    {
+        out << std::format("{:<56} {:>8} {:>10} {:>14} {:>14} {:>14}\n",
+                           "benchmark",
+                           "iters",
+                           "items",
+                           "min (us)",
+                           "median (us)",
+                           "mean (us)");
+        for (const auto& res : results)
+        {
+            out << std::format("{:<56} {:>8} {:>10} {:>14.1f} {:>14.1f} {:>14.1f}\n",
+                               res.name,
+                               res.iterations,
+                               res.items,
+                               toMicroseconds(res.min),
+                               toMicroseconds(res.median),
+                               toMicroseconds(res.mean));
+        }
+    }
+
+    void Runner::writeJson(std::ostream& out) const
+    {
+        out << "{\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const auto& res = results[i];
+            out << std::format("{}\n    {{\"name\": \"{}\", \"iterations\": {}, \"items\": {}, \"min_ns\": {}, "
+                               "\"median_ns\": {}, \"mean_ns\": {}}}",
+                               i == 0 ? "" : ",",
+                               escape(res.name),
+                               res.iterations,
+                               res.items,
+                               res.min.count(),
+                               res.median.count(),
+                               res.mean.count());
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    std::vector<Result> Runner::readJson(std::istream& in)
+    {
+        // Only the fixed layout written by writeJson is supported, which is enough for comparing with a baseline.
+        static const std::regex pattern(
+          R"re(\{"name":\s*"((?:[^"\\]|\\.)*)",\s*"iterations":\s*(\d+),\s*"items":\s*(\d+),\s*)re"
+          R"re("min_ns":\s*(\d+),\s*"median_ns":\s*(\d+),\s*"mean_ns":\s*(\d+)\})re");
+
+        const std::string   json{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        std::vector<Result> res;
+        for (auto it = std::sregex_iterator(json.begin(), json.end(), pattern); it != std::sregex_iterator(); ++it)
+        {
+            const auto& match = *it;
+            res.emplace_back(Result{.name       = unescape(match[1].str()),
+                                    .iterations = std::stoull(match[2].str()),
+                                    .items      = std::stoull(match[3].str()),
+                                    .min        = std::chrono::nanoseconds(std::stoll(match[4].str())),
+                                    .median     = std::chrono::nanoseconds(std::stoll(match[5].str())),
+                                    .mean       = std::chrono::nanoseconds(std::stoll(match[6].str()))});
+        }
+        return res;
+    }
+
+    size_t Runner::compare(const std::vector<Result>& baseline, const double threshold, std::ostream& out) const
+    {
+        std::unordered_map<std::string, const Result*> baselineByName;
+        for (const auto& res : baseline) baselineByName.try_emplace(res.name, &res);
+
+        size_t regressions = 0;
+        out << std::format("{:<56} {:>14} {:>14} {:>10}\n", "benchmark", "base (us)", "median (us)", "change");
+        for (const auto& res : results)
+        {
+            const auto it = baselineByName.find(res.name);
+            if (it == baselineByName.end())
+            {
+                out << std::format(
+                  "{:<56} {:>14} {:>14.1f} {:>10}\n", res.name, "-", toMicroseconds(res.median), "new");
+                continue;
+            }
+
+            const auto base      = toMicroseconds(it->second->median);
+            const auto median    = toMicroseconds(res.median);
+            const auto change    = base > 0 ? median / base - 1.0 : 0.0;
+            const bool regressed = change > threshold;
+            if (regressed) regressions++;
+            out << std::format("{:<56} {:>14.1f} {:>14.1f} {:>+9.1f}%{}\n",
+                               res.name,
+                               base,
+                               median,
+                               change * 100.0,
+                               regressed ? " REGRESSION" : "");
+        }
+
+        out << std::format("{} regression(s) above {:.1f}%\n", regressions, threshold * 100.0);
+        return regressions;
+    }
+
+    void Runner::add(std::string name, const size_t items, std::vector<std::chrono::nanoseconds> times)
+    {
+        std::ranges::sort(times);
+        const auto total = std::accumulate(times.begin(), times.end(), std::chrono::nanoseconds{0});
+
+        results.emplace_back(Result{.name       = std::move(name),
+                                    .iterations = times.size(),
+                                    .items      = items,
+                                    .min        = times.front(),
+                                    .median     = times[times.size() / 2],
+                                    .mean       = total / static_cast<int64_t>(times.size())});
+    }
+}  // namespace bench
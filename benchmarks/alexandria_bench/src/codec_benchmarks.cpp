@@ -0,0 +1,115 @@
+#include "alexandria_bench/codec_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/meshes.h"
+
+namespace
+{
+    template<typename T>
+    void runCodec(bench::Runner&        runner,
+                  const std::string&    name,
+                  const alex::Codec     codec,
+                  const std::vector<T>& values,
+                  const size_t          elementSize)
+    {
+        const auto             raw = std::as_bytes(std::span(values));
+        std::vector<std::byte> encoded, decoded;
+        alex::encode(codec, elementSize, raw, encoded);
+        const auto ratio = static_cast<double>(raw.size()) / static_cast<double>(std::max<size_t>(encoded.size(), 1));
+        const auto label = std::format("codec {} {} {:.2f}x", alex::toString(codec), name, ratio);
+
+        runner.run(label + " enc", [&] {
+            alex::encode(codec, elementSize, raw, encoded);
+            return encoded.size();
+        });
+        runner.run(label + " dec", [&] {
+            alex::decode(encoded, decoded);
+            return encoded.size();
+        });
+    }
+}  // namespace
+
+namespace bench
+{
+    void runCodecBenchmarks(Runner& runner, const std::string& modelDir)
+    {
+        const auto meshes = loadMeshes(modelDir);
+
+        /*
+         * Codecs on their own.
+         */
+
+        for (const auto& mesh : meshes)
+        {
+            runCodec(runner, mesh.name + ".vertices", alex::Codec::ShuffleLz, mesh.vertices.get(), sizeof(Float3));
+            runCodec(runner, mesh.name + ".indices", alex::Codec::ShuffleLz, mesh.indices.get(), sizeof(uint32_t));
+            runCodec(runner, mesh.name + ".indices", alex::Codec::DeltaVarint, mesh.indices.get(), sizeof(uint32_t));
+        }
+
+        /*
+         * Insert and retrieve all meshes with and without codecs.
+         */
+
+        for (const auto codec : {alex::Codec::None, alex::Codec::ShuffleLz})
+        {
+            auto  library   = alex::Library::create("");
+            auto& nameSpace = library->createNamespace("bench");
+
+            alex::TypeLayout meshLayout;
+            meshLayout.createStringProperty("name");
+            meshLayout.createBlobProperty("vertices").setCodec(codec);
+            meshLayout.createPrimitiveBlobProperty("indices", alex::DataType::Uint32)
+              .setCodec(codec == alex::Codec::None ? alex::Codec::None : alex::Codec::DeltaVarint);
+            meshLayout.commit(nameSpace, "mesh");
+
+            auto meshDescriptor = MeshDescriptor(nameSpace.getType("mesh"));
+            auto inserter       = alex::InsertQuery(meshDescriptor);
+            auto getter         = alex::GetQuery(meshDescriptor);
+
+            std::vector<Mesh> inserted = meshes;
+            runner.run(std::format("codec {} insert meshes", alex::toString(codec)), [&] {
+                for (auto& mesh : inserted)
+                {
+                    mesh.id.reset();
+                    inserter(mesh);
+                }
+                return inserted.size();
+            });
+            runner.run(std::format("codec {} get meshes", alex::toString(codec)), [&] {
+                size_t vertices = 0;
+                for (const auto& mesh : inserted)
+                {
+                    Mesh m{.id = mesh.id};
+                    getter(m);
+                    vertices += m.vertices.get().size();
+                }
+                return vertices;
+            });
+        }
+    }
+}  // namespace bench
@@ -0,0 +1,102 @@
+#include "alexandria_bench/dedup_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <format>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/meshes.h"
+
+namespace bench
+{
+    void runDedupBenchmarks(Runner& runner, const std::string& modelDir)
+    {
+        // Number of times each mesh is placed in the scene.
+        constexpr size_t copies = 8;
+
+        const auto        meshes = loadMeshes(modelDir);
+        std::vector<Mesh> scene;
+        for (size_t i = 0; i < copies; i++) scene.insert(scene.end(), meshes.begin(), meshes.end());
+
+        /*
+         * Content hash on its own.
+         */
+
+        for (const auto& mesh : meshes)
+        {
+            const auto bytes = std::as_bytes(std::span(mesh.vertices.get()));
+            runner.run(std::format("dedup hash {}.vertices", mesh.name), [&] {
+                const auto key = alex::hashBlob(bytes);
+                return bytes.size() + static_cast<size_t>(key[0]);
+            });
+        }
+
+        /*
+         * Insert and retrieve the scene with and without deduplication.
+         */
+
+        for (const auto deduplicated : {false, true})
+        {
+            auto  library   = alex::Library::create("");
+            auto& nameSpace = library->createNamespace("bench");
+
+            alex::TypeLayout meshLayout;
+            meshLayout.createStringProperty("name");
+            meshLayout.createBlobProperty("vertices").setDeduplicated(deduplicated);
+            meshLayout.createPrimitiveBlobProperty("indices", alex::DataType::Uint32).setDeduplicated(deduplicated);
+            meshLayout.commit(nameSpace, "mesh");
+
+            auto meshDescriptor = MeshDescriptor(nameSpace.getType("mesh"));
+            auto inserter       = alex::InsertQuery(meshDescriptor);
+            auto getter         = alex::GetQuery(meshDescriptor);
+
+            // Insert the scene once up front to determine the deduplication ratio.
+            std::vector<Mesh> inserted = scene;
+            for (auto& mesh : inserted) inserter(mesh);
+            const auto stats = alex::BlobStore::getStats(library->getDatabase());
+            const auto label = std::format("dedup {} {}x{} meshes {:.2f}x",
+                                           deduplicated ? "on" : "off",
+                                           copies,
+                                           meshes.size(),
+                                           stats.getRatio());
+
+            runner.run(label + " insert", [&] {
+                for (auto& mesh : inserted)
+                {
+                    mesh.id.reset();
+                    inserter(mesh);
+                }
+                return inserted.size();
+            });
+            runner.run(label + " get", [&] {
+                size_t vertices = 0;
+                for (const auto& mesh : inserted)
+                {
+                    Mesh m{.id = mesh.id};
+                    getter(m);
+                    vertices += m.vertices.get().size();
+                }
+                return vertices;
+            });
+        }
+    }
+}  // namespace bench
@@ -0,0 +1,102 @@
+#include "alexandria_bench/external_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/blob_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/meshes.h"
+
+namespace bench
+{
+    void runExternalBenchmarks(Runner& runner, const std::string& modelDir)
+    {
+        // Values of at least 64 KiB are stored externally.
+        constexpr int64_t threshold = 64 * 1024;
+
+        const auto meshes = loadMeshes(modelDir);
+        const auto file   = std::filesystem::temp_directory_path() / "alexandria_bench_external.db";
+
+        for (const auto external : {false, true})
+        {
+            std::filesystem::remove(file);
+
+            {
+                auto  library   = alex::Library::create(file);
+                auto& nameSpace = library->createNamespace("bench");
+
+                alex::TypeLayout meshLayout;
+                meshLayout.createStringProperty("name");
+                meshLayout.createBlobProperty("vertices").setExternal(external ? threshold : 0);
+                meshLayout.createPrimitiveBlobProperty("indices", alex::DataType::Uint32)
+                  .setExternal(external ? threshold : 0);
+                meshLayout.commit(nameSpace, "mesh");
+
+                auto meshDescriptor = MeshDescriptor(nameSpace.getType("mesh"));
+                auto inserter       = alex::InsertQuery(meshDescriptor);
+                auto getter         = alex::GetQuery(meshDescriptor);
+
+                std::vector<Mesh> inserted = meshes;
+                for (auto& mesh : inserted) inserter(mesh);
+                const auto label = std::format("external {} {} meshes", external ? "on" : "off", meshes.size());
+
+                runner.run(label + " insert", [&] {
+                    for (auto& mesh : inserted)
+                    {
+                        mesh.id.reset();
+                        inserter(mesh);
+                    }
+                    return inserted.size();
+                });
+                runner.run(label + " get", [&] {
+                    size_t vertices = 0;
+                    for (const auto& mesh : inserted)
+                    {
+                        Mesh m{.id = mesh.id};
+                        getter(m);
+                        vertices += m.vertices.get().size();
+                    }
+                    return vertices;
+                });
+                runner.run(label + " view", [&] {
+                    size_t vertices = 0;
+                    for (const auto& mesh : inserted)
+                        vertices += alex::viewBlob<"vertices">(meshDescriptor, mesh.id).as<Float3>().size();
+                    return vertices;
+                });
+
+                // Copy all live values to a new pack file.
+                if (external)
+                    runner.run(label + " compact", [&] {
+                        return static_cast<size_t>(library->getExternalStore().compact());
+                    });
+            }
+
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+            for (const auto& entry : std::filesystem::directory_iterator(file.parent_path(), ec))
+                if (entry.path().filename().string().starts_with(file.filename().string()))
+                    std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}  // namespace bench
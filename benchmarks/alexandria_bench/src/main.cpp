@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "parsertongue/parser.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_bench/benchmark.h"
+#include "alexandria_bench/codec_benchmarks.h"
+#include "alexandria_bench/dedup_benchmarks.h"
+#include "alexandria_bench/external_benchmarks.h"
+#include "alexandria_bench/packed_benchmarks.h"
+#include "alexandria_bench/query_benchmarks.h"
+#include "alexandria_bench/search_benchmarks.h"
+#include "alexandria_bench/spatial_benchmarks.h"
+
+int main(int argc, char** argv)
+{
+    pt::parser parser(argc, argv);
+
+    // Add arguments.
+    auto instances = parser.add_value<int32_t>('n', "instances");
+    instances->set_help("Number of instances to generate (default 10000)");
+    auto spatialInstances = parser.add_value<int32_t>('s', "spatial-instances");
+    spatialInstances->set_help("Number of instances to generate for the spatial benchmarks (default 1000000)");
+    auto iterations = parser.add_value<int32_t>('i', "iterations");
+    iterations->set_help("Number of timed iterations per benchmark (default 20)");
+    auto filter = parser.add_value<std::string>('f', "filter");
+    filter->set_help("Only run benchmarks whose name contains this string");
+    auto models = parser.add_value<std::string>('m', "models");
+    models->set_help(
+      "Directory with OBJ models for the codec, dedup and external benchmarks (default examples/geometry/models)");
+    auto json = parser.add_value<std::string>('j', "json");
+    json->set_help("Write results as JSON to this file");
+    auto baseline = parser.add_value<std::string>('b', "baseline");
+    baseline->set_help("Compare results with a JSON file written by a previous run");
+    auto threshold = parser.add_value<int32_t>('t', "threshold");
+    threshold->set_help(
+      "Increase of the median in percent above which a benchmark counts as a regression when comparing (default 10)");
+
+    // Run the parser.
+    std::string e;
+    if (!parser(e))
+    {
+        std::cout << "Internal parsing error: " << e << std::endl;
+        return 0;
+    }
+
+    // User requested help or version, don't run.
+    if (parser.display_help(std::cout)) return 0;
+
+    const auto instanceCount        = instances->is_set() ? instances->get_value() : 10000;
+    const auto spatialInstanceCount = spatialInstances->is_set() ? spatialInstances->get_value() : 1000000;
+    const auto iterationCount       = iterations->is_set() ? iterations->get_value() : 20;
+    if (instanceCount <= 0 || spatialInstanceCount <= 0 || iterationCount <= 0)
+    {
+        std::cout << "Number of instances and iterations must be positive" << std::endl;
+        return 0;
+    }
+
+    // Read the baseline before running, so that a missing file does not waste a run.
+    std::vector<bench::Result> baselineResults;
+    if (baseline->is_set())
+    {
+        std::ifstream file(baseline->get_value());
+        if (!file)
+        {
+            std::cout << "Could not open baseline file " << baseline->get_value() << std::endl;
+            return 1;
+        }
+        baselineResults = bench::Runner::readJson(file);
+    }
+
+    bench::Runner runner(static_cast<size_t>(iterationCount), filter->is_set() ? filter->get_value() : "");
+    bench::runQueryBenchmarks(runner, static_cast<size_t>(instanceCount));
+    bench::runSearchBenchmarks(runner, static_cast<size_t>(instanceCount));
+    bench::runSpatialBenchmarks(runner, static_cast<size_t>(spatialInstanceCount));
+    const auto modelDir = models->is_set() ? models->get_value() : "examples/geometry/models";
+    bench::runCodecBenchmarks(runner, modelDir);
+    bench::runDedupBenchmarks(runner, modelDir);
+    bench::runExternalBenchmarks(runner, modelDir);
+    bench::runPackedBenchmarks(runner);
+    runner.print(std::cout);
+
+    if (json->is_set())
+    {
+        std::ofstream file(json->get_value());
+        if (!file)
+        {
+            std::cout << "Could not open output file " << json->get_value() << std::endl;
+            return 1;
+        }
+        runner.writeJson(file);
+    }
+
+    // Exit with an error if any benchmark regressed, so that the comparison can be used in scripts.
+    if (baseline->is_set())
+    {
+        std::cout << std::endl;
+        const auto percent = threshold->is_set() ? threshold->get_value() : 10;
+        if (runner.compare(baselineResults, static_cast<double>(percent) / 100.0, std::cout) > 0) return 1;
+    }
+
+    return 0;
+}
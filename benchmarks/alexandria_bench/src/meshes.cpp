@@ -0,0 +1,77 @@
+#include "alexandria_bench/meshes.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <fstream>
+#include <numbers>
+#include <sstream>
+
+namespace bench
+{
+    Mesh readObj(const std::filesystem::path& path)
+    {
+        Mesh          mesh{.name = path.stem().string()};
+        std::ifstream file(path);
+        std::string   line;
+        while (std::getline(file, line))
+        {
+            std::istringstream stream(line);
+            std::string        tag;
+            stream >> tag;
+            if (tag == "v")
+            {
+                Float3 v;
+                stream >> v.x >> v.y >> v.z;
+                mesh.vertices.get().push_back(v);
+            }
+            else if (tag == "f")
+            {
+                // Only the vertex index of each "v/vt/vn" triplet is used. OBJ indices are 1-based.
+                std::vector<uint32_t> face;
+                for (std::string vertex; stream >> vertex;)
+                    face.push_back(static_cast<uint32_t>(std::stoul(vertex.substr(0, vertex.find('/')))) - 1);
+                for (size_t i = 2; i < face.size(); i++)
+                    mesh.indices.get().insert(mesh.indices.get().end(), {face[0], face[i - 1], face[i]});
+            }
+        }
+        return mesh;
+    }
+
+    Mesh generateSphere(const uint32_t rings, const uint32_t segments)
+    {
+        Mesh mesh{.name = "sphere_gen"};
+        for (uint32_t r = 0; r <= rings; r++)
+        {
+            const auto theta = std::numbers::pi_v<float> * static_cast<float>(r) / static_cast<float>(rings);
+            for (uint32_t s = 0; s < segments; s++)
+            {
+                const auto phi = 2 * std::numbers::pi_v<float> * static_cast<float>(s) / static_cast<float>(segments);
+                mesh.vertices.get().push_back(
+                  {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+        for (uint32_t r = 0; r < rings; r++)
+        {
+            for (uint32_t s = 0; s < segments; s++)
+            {
+                const auto a = r * segments + s, b = r * segments + (s + 1) % segments;
+                const auto c = a + segments, d = b + segments;
+                mesh.indices.get().insert(mesh.indices.get().end(), {a, c, b, b, c, d});
+            }
+        }
+        return mesh;
+    }
+
+    std::vector<Mesh> loadMeshes(const std::string& modelDir)
+    {
+        std::vector<Mesh> meshes;
+        if (std::filesystem::is_directory(modelDir))
+            for (const auto& entry : std::filesystem::directory_iterator(modelDir))
+                if (entry.path().extension() == ".obj") meshes.emplace_back(readObj(entry.path()));
+        meshes.emplace_back(generateSphere(500, 500));
+        return meshes;
+    }
+}  // namespace bench
@@ -0,0 +1,93 @@
+#include "alexandria_bench/packed_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Sample
+    {
+        alex::InstanceId            id;
+        alex::PrimitiveArray<float> values;
+        alex::StringArray           tags;
+    };
+
+    using SampleDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Sample::id>,
+                                                          alex::Member<"values", &Sample::values>,
+                                                          alex::Member<"tags", &Sample::tags>>;
+}  // namespace
+
+namespace bench
+{
+    void runPackedBenchmarks(Runner& runner)
+    {
+        // Total number of floats per run. There is one string per 16 floats.
+        constexpr size_t elements = 1 << 18;
+
+        for (const size_t size : {16, 1024, 65536})
+        {
+            std::vector<Sample> samples(elements / size);
+            for (size_t i = 0; i < samples.size(); i++)
+            {
+                auto& values = samples[i].values.get();
+                values.resize(size);
+                for (size_t j = 0; j < size; j++) values[j] = static_cast<float>(i * size + j);
+                for (size_t j = 0; j < size / 16; j++) samples[i].tags.add(std::format("tag{}", i + j));
+            }
+
+            for (const auto packed : {false, true})
+            {
+                auto  library   = alex::Library::create("");
+                auto& nameSpace = library->createNamespace("bench");
+
+                alex::TypeLayout sampleLayout;
+                sampleLayout.createPrimitiveArrayProperty("values", alex::DataType::Float).setPacked(packed);
+                sampleLayout.createStringArrayProperty("tags").setPacked(packed);
+                sampleLayout.commit(nameSpace, "sample");
+
+                auto sampleDescriptor = SampleDescriptor(nameSpace.getType("sample"));
+                auto inserter         = alex::InsertQuery(sampleDescriptor);
+                auto getter           = alex::GetQuery(sampleDescriptor);
+
+                std::vector<Sample> inserted = samples;
+                for (auto& sample : inserted) inserter(sample);
+                const auto label = std::format("packed {} {}x{} floats", packed ? "on" : "off", inserted.size(), size);
+
+                runner.run(label + " insert", [&] {
+                    for (auto& sample : inserted)
+                    {
+                        sample.id.reset();
+                        inserter(sample);
+                    }
+                    return elements;
+                });
+                runner.run(label + " get", [&] {
+                    size_t values = 0;
+                    for (const auto& sample : inserted)
+                    {
+                        Sample s{.id = sample.id};
+                        getter(s);
+                        values += s.values.get().size();
+                    }
+                    return values;
+                });
+            }
+        }
+    }
+}  // namespace bench
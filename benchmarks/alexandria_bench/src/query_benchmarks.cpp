@@ -0,0 +1,367 @@
+#include "alexandria_bench/query_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <numeric>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+#include "alexandria-extended-query/search_queries/reference_search.h"
+
+namespace
+{
+    struct Target
+    {
+        alex::InstanceId id;
+        int32_t          value = 0;
+    };
+
+    using TargetDescriptor =
+      alex::GenerateTypeDescriptor<alex::Member<"id", &Target::id>, alex::Member<"value", &Target::value>>;
+
+    /*
+     * One type per member kind, each with a single member.
+     */
+
+    struct PrimitiveItem
+    {
+        alex::InstanceId id;
+        int64_t          value = 0;
+    };
+
+    struct StringItem
+    {
+        alex::InstanceId id;
+        std::string      value;
+    };
+
+    struct BlobItem
+    {
+        alex::InstanceId               id;
+        alex::Blob<std::vector<float>> value;
+    };
+
+    struct PrimitiveBlobItem
+    {
+        alex::InstanceId           id;
+        alex::PrimitiveBlob<float> value;
+    };
+
+    struct PrimitiveArrayItem
+    {
+        alex::InstanceId            id;
+        alex::PrimitiveArray<float> value;
+    };
+
+    struct StringArrayItem
+    {
+        alex::InstanceId  id;
+        alex::StringArray value;
+    };
+
+    struct BlobArrayItem
+    {
+        alex::InstanceId                    id;
+        alex::BlobArray<std::vector<float>> value;
+    };
+
+    struct ReferenceItem
+    {
+        alex::InstanceId        id;
+        alex::Reference<Target> value;
+    };
+
+    struct ReferenceArrayItem
+    {
+        alex::InstanceId             id;
+        alex::ReferenceArray<Target> value;
+    };
+
+    template<typename O>
+    using ItemDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &O::id>, alex::Member<"value", &O::value>>;
+
+    /**
+     * \brief Number of referenced instances.
+     */
+    constexpr size_t targetCount = 256;
+
+    /**
+     * \brief Number of floats per blob array element and characters per string array element.
+     */
+    constexpr size_t elementSize = 16;
+
+    template<typename Q>
+    size_t count(Q& query)
+    {
+        size_t n = 0;
+        for (auto it = query.begin(); it != query.end(); ++it) n++;
+        return n;
+    }
+
+    void fill(std::vector<float>& values, const size_t size, const size_t seed)
+    {
+        values.resize(size);
+        std::iota(values.begin(), values.end(), static_cast<float>(seed));
+    }
+
+    [[nodiscard]] std::string makeString(const size_t size, const size_t seed)
+    {
+        auto str = std::to_string(seed % 100);
+        str.resize(std::max(size, str.size()), 'x');
+        return str;
+    }
+
+    /**
+     * \brief Run the query benchmarks of a single member kind and size in a new in-memory library.
+     * \tparam O Object type.
+     * \tparam L Callable adding the "value" property to a TypeLayout, given the referenced type.
+     * \tparam G Callable (re)generating the value of an object, given its index, the update round and the targets.
+     * \tparam S Callable running the search benchmarks, given the descriptor, the targets and a function to time a
+     * named search.
+     * \param runner Runner.
+     * \param kind Member kind.
+     * \param size Size of a single value, e.g. number of array elements.
+     * \param instances Number of instances.
+     * \param layout Layout function.
+     * \param generate Generate function.
+     * \param search Search function.
+     */
+    template<typename O, typename L, typename G, typename S>
+    void runKind(bench::Runner&     runner,
+                 const std::string& kind,
+                 const size_t       size,
+                 const size_t       instances,
+                 L&&                layout,
+                 G&&                generate,
+                 S&&                search)
+    {
+        // Skip generating data if the filter excludes all benchmarks of this kind and size.
+        const auto label = std::format("query {} {}x{}", kind, instances, size);
+        if (std::ranges::none_of(std::array{"insert", "get", "update", "primitiveSearch", "referenceSearch", "delete"},
+                                 [&](const std::string& op) { return runner.selected(label + " " + op); }))
+            return;
+
+        auto  library   = alex::Library::create("");
+        auto& nameSpace = library->createNamespace("bench");
+
+        alex::TypeLayout targetLayout;
+        targetLayout.createPrimitiveProperty("value", alex::DataType::Int32);
+        targetLayout.commit(nameSpace, "target");
+        auto& targetType = nameSpace.getType("target");
+
+        alex::TypeLayout itemLayout;
+        layout(itemLayout, targetType);
+        itemLayout.commit(nameSpace, "item");
+
+        std::vector<Target> targets(targetCount);
+        {
+            auto inserter = alex::InsertQuery(TargetDescriptor(targetType));
+            for (auto& t : targets) inserter(t);
+        }
+
+        std::vector<O> objects(instances);
+        for (size_t i = 0; i < objects.size(); i++) generate(objects[i], i, 0, targets);
+
+        auto descriptor = ItemDescriptor<O>(nameSpace.getType("item"));
+        auto inserter   = alex::InsertQuery(descriptor);
+        auto getter     = alex::GetQuery(descriptor);
+        auto updater    = alex::UpdateQuery(descriptor);
+        auto deleter    = alex::DeleteQuery(descriptor);
+
+        const auto insertAll = [&] {
+            for (auto& o : objects)
+                if (!o.id.valid()) inserter(o);
+        };
+        const auto deleteAll = [&] {
+            for (auto& o : objects)
+                if (o.id.valid()) deleter(o);
+        };
+
+        runner.run(label + " insert", deleteAll, [&] {
+            for (auto& o : objects) inserter(o);
+            return objects.size();
+        });
+        insertAll();
+
+        runner.run(label + " get", [&] {
+            size_t n = 0;
+            for (const auto& o : objects) n += static_cast<size_t>(getter(o.id).id == o.id);
+            return n;
+        });
+
+        size_t round = 0;
+        runner.run(
+          label + " update",
+          [&] {
+              round++;
+              for (size_t i = 0; i < objects.size(); i++) generate(objects[i], i, round, targets);
+          },
+          [&] {
+              for (auto& o : objects) updater(o);
+              return objects.size();
+          });
+
+        search(descriptor, targets, [&](const std::string& op, auto&& f) { runner.run(label + " " + op, f); });
+
+        runner.run(label + " delete", insertAll, [&] {
+            for (auto& o : objects) deleter(o);
+            return objects.size();
+        });
+    }
+}  // namespace
+
+namespace bench
+{
+    void runQueryBenchmarks(Runner& runner, const size_t instances)
+    {
+        // Larger values are measured with fewer instances, so that each run processes a similar amount of data.
+        constexpr std::array<size_t, 3> sizes = {4, 64, 1024};
+        const auto countFor = [&](const size_t size) {
+            return std::clamp<size_t>(instances * 16 / size, 1, instances);
+        };
+        const auto noSearch = [](auto&, const auto&, auto&&) {};
+
+        runKind<PrimitiveItem>(
+          runner,
+          "primitive",
+          1,
+          instances,
+          [](alex::TypeLayout& l, alex::Type&) { l.createPrimitiveProperty("value", alex::DataType::Int64); },
+          [](PrimitiveItem& o, const size_t i, const size_t round, const auto&) {
+              o.value = static_cast<int64_t>((i + round) % 100);
+          },
+          [](auto& desc, const auto&, auto&& time) {
+              auto query = alex::primitiveSearch(desc, alex::equal<ItemDescriptor<PrimitiveItem>, "value">());
+              query(int64_t{7});
+              time("primitiveSearch", [&] { return count(query); });
+          });
+
+        runKind<ReferenceItem>(
+          runner,
+          "reference",
+          1,
+          instances,
+          [](alex::TypeLayout& l, alex::Type& target) { l.createReferenceProperty("value", target); },
+          [](ReferenceItem& o, const size_t i, const size_t round, const std::vector<Target>& targets) {
+              o.value = targets[(i + round) % targets.size()];
+          },
+          [](auto& desc, const std::vector<Target>& targets, auto&& time) {
+              auto query = alex::primitiveSearch(desc, alex::equal<ItemDescriptor<ReferenceItem>, "value">());
+              query(targets[0].id);
+              time("primitiveSearch", [&] { return count(query); });
+          });
+
+        for (const auto size : sizes)
+        {
+            runKind<StringItem>(
+              runner,
+              "string",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type&) { l.createStringProperty("value"); },
+              [size](StringItem& o, const size_t i, const size_t round, const auto&) {
+                  o.value = makeString(size, i + round);
+              },
+              [size](auto& desc, const auto&, auto&& time) {
+                  auto query = alex::primitiveSearch(desc, alex::equal<ItemDescriptor<StringItem>, "value">());
+                  query(makeString(size, 7));
+                  time("primitiveSearch", [&] { return count(query); });
+              });
+
+            runKind<BlobItem>(
+              runner,
+              "blob",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type&) { l.createBlobProperty("value"); },
+              [size](BlobItem& o, const size_t i, const size_t round, const auto&) {
+                  fill(o.value.get(), size, i + round);
+              },
+              noSearch);
+
+            runKind<PrimitiveBlobItem>(
+              runner,
+              "primitive blob",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type&) { l.createPrimitiveBlobProperty("value", alex::DataType::Float); },
+              [size](PrimitiveBlobItem& o, const size_t i, const size_t round, const auto&) {
+                  fill(o.value.get(), size, i + round);
+              },
+              noSearch);
+
+            runKind<PrimitiveArrayItem>(
+              runner,
+              "primitive array",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type&) { l.createPrimitiveArrayProperty("value", alex::DataType::Float); },
+              [size](PrimitiveArrayItem& o, const size_t i, const size_t round, const auto&) {
+                  fill(o.value.get(), size, i + round);
+              },
+              noSearch);
+
+            runKind<StringArrayItem>(
+              runner,
+              "string array",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type&) { l.createStringArrayProperty("value"); },
+              [size](StringArrayItem& o, const size_t i, const size_t round, const auto&) {
+                  auto& values = o.value.get();
+                  values.resize(size);
+                  for (size_t j = 0; j < size; j++) values[j] = makeString(elementSize, i + j + round);
+              },
+              noSearch);
+
+            runKind<BlobArrayItem>(
+              runner,
+              "blob array",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type&) { l.createBlobArrayProperty("value"); },
+              [size](BlobArrayItem& o, const size_t i, const size_t round, const auto&) {
+                  auto& values = o.value.get();
+                  values.resize(size);
+                  for (size_t j = 0; j < size; j++) fill(values[j], elementSize, i + j + round);
+              },
+              noSearch);
+
+            runKind<ReferenceArrayItem>(
+              runner,
+              "reference array",
+              size,
+              countFor(size),
+              [](alex::TypeLayout& l, alex::Type& target) { l.createReferenceArrayProperty("value", target); },
+              [size](ReferenceArrayItem& o, const size_t i, const size_t round, const std::vector<Target>& targets) {
+                  auto& ids = o.value.get();
+                  ids.resize(size);
+                  for (size_t j = 0; j < size; j++) ids[j] = targets[(i + j * 7 + round) % targets.size()].id;
+              },
+              [](auto& desc, const std::vector<Target>& targets, auto&& time) {
+                  auto query =
+                    alex::referenceSearch(desc, alex::references<ItemDescriptor<ReferenceArrayItem>, "value">());
+                  query(targets[0].id);
+                  time("referenceSearch", [&] { return count(query); });
+              });
+        }
+    }
+}  // namespace bench
@@ -0,0 +1,163 @@
+#include "alexandria_bench/search_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+
+namespace
+{
+    struct Target
+    {
+        alex::InstanceId id;
+        int32_t          value = 0;
+    };
+
+    struct Item
+    {
+        alex::InstanceId             id;
+        float                        radius = 0;
+        std::string                  name;
+        alex::ReferenceArray<Target> refs;
+    };
+
+    using TargetDescriptor =
+      alex::GenerateTypeDescriptor<alex::Member<"id", &Target::id>, alex::Member<"value", &Target::value>>;
+    using ItemDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Item::id>,
+                                                        alex::Member<"radius", &Item::radius>,
+                                                        alex::Member<"name", &Item::name>,
+                                                        alex::Member<"refs", &Item::refs>>;
+
+    template<typename Q>
+    size_t count(Q& query)
+    {
+        size_t n = 0;
+        for (auto it = query.begin(); it != query.end(); ++it) n++;
+        return n;
+    }
+}  // namespace
+
+namespace bench
+{
+    void runSearchBenchmarks(Runner& runner, const size_t instances)
+    {
+        auto  library   = alex::Library::create("");
+        auto& nameSpace = library->createNamespace("bench");
+
+        alex::TypeLayout targetLayout;
+        targetLayout.createPrimitiveProperty("value", alex::DataType::Int32);
+        targetLayout.commit(nameSpace, "target");
+
+        alex::TypeLayout itemLayout;
+        itemLayout.createPrimitiveProperty("radius", alex::DataType::Float);
+        itemLayout.createStringProperty("name");
+        itemLayout.createReferenceArrayProperty("refs", nameSpace.getType("target"));
+        itemLayout.commit(nameSpace, "item");
+
+        auto targetDescriptor = TargetDescriptor(nameSpace.getType("target"));
+        auto itemDescriptor   = ItemDescriptor(nameSpace.getType("item"));
+
+        // Generate targets and items with a few random references each.
+        std::mt19937                          rng(42);
+        std::uniform_real_distribution<float> radiusDist(0.0f, 100.0f);
+        std::vector<Target>                   targets(std::max<size_t>(instances / 10, 2));
+        std::uniform_int_distribution<size_t> targetDist(0, targets.size() - 1);
+        {
+            auto inserter = alex::InsertQuery(targetDescriptor);
+            for (auto& t : targets) inserter(t);
+
+            auto itemInserter = alex::InsertQuery(itemDescriptor);
+            for (size_t i = 0; i < instances; i++)
+            {
+                Item item{.radius = radiusDist(rng), .name = std::to_string(i % 100)};
+                for (size_t j = 0; j < 4; j++) item.refs.add(targets[targetDist(rng)]);
+                itemInserter(item);
+            }
+        }
+
+        const auto& t0 = targets[0].id;
+        const auto& t1 = targets[1].id;
+
+        /*
+         * Conjunction and disjunction of reference operators.
+         */
+
+        {
+            auto query = alex::referenceSearchAnd(itemDescriptor,
+                                                  alex::references<ItemDescriptor, "refs">(),
+                                                  alex::references<ItemDescriptor, "refs">());
+            query(t0, t1);
+            runner.run("references && references (INTERSECT)", [&] { return count(query); });
+        }
+
+        {
+            auto query = alex::search(itemDescriptor,
+                                      alex::references<ItemDescriptor, "refs">() &&
+                                        alex::references<ItemDescriptor, "refs">());
+            query(t0, t1);
+            runner.run("references && references (expression)", [&] { return count(query); });
+        }
+
+        {
+            auto query = alex::referenceSearchOr(itemDescriptor,
+                                                 alex::references<ItemDescriptor, "refs">(),
+                                                 alex::references<ItemDescriptor, "refs">());
+            query(t0, t1);
+            runner.run("references || references (UNION)", [&] { return count(query); });
+        }
+
+        {
+            auto query = alex::search(itemDescriptor,
+                                      alex::references<ItemDescriptor, "refs">() ||
+                                        alex::references<ItemDescriptor, "refs">());
+            query(t0, t1);
+            runner.run("references || references (expression)", [&] { return count(query); });
+        }
+
+        /*
+         * Mixed primitive and reference operators. Without expressions, this requires two separate searches that are
+         * intersected on the client.
+         */
+
+        {
+            auto primQuery = alex::primitiveSearchOr(
+              itemDescriptor, alex::less<ItemDescriptor, "radius">(), alex::equal<ItemDescriptor, "name">());
+            auto refQuery = alex::referenceSearch(itemDescriptor, alex::references<ItemDescriptor, "refs">());
+            primQuery(10.0f, "7");
+            refQuery(t0);
+            runner.run("(radius < x || name == y) && references (client)", [&] {
+                std::unordered_set<alex::InstanceId> ids;
+                for (auto it = primQuery.begin(); it != primQuery.end(); ++it) ids.emplace(*it);
+                size_t n = 0;
+                for (auto it = refQuery.begin(); it != refQuery.end(); ++it)
+                    if (ids.contains(*it)) n++;
+                return n;
+            });
+        }
+
+        {
+            auto query = alex::search(itemDescriptor,
+                                      (alex::less<ItemDescriptor, "radius">() ||
+                                       alex::equal<ItemDescriptor, "name">()) &&
+                                        alex::references<ItemDescriptor, "refs">());
+            query(10.0f, "7", t0);
+            runner.run("(radius < x || name == y) && references (expression)", [&] { return count(query); });
+        }
+    }
+}  // namespace bench
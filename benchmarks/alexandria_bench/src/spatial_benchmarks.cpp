@@ -0,0 +1,131 @@
+#include "alexandria_bench/spatial_benchmarks.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+
+namespace
+{
+    struct Float3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    struct Node
+    {
+        alex::InstanceId id;
+        Float3           position;
+    };
+
+    using Float3MemberList =
+      alex::MemberList<alex::Member<"x", &Float3::x>, alex::Member<"y", &Float3::y>, alex::Member<"z", &Float3::z>>;
+    using NodeDescriptor =
+      alex::GenerateTypeDescriptor<alex::Member<"id", &Node::id>,
+                                   alex::NestedMember<"position", Float3MemberList, &Node::position>>;
+
+    template<typename Q>
+    size_t count(Q& query)
+    {
+        size_t n = 0;
+        for (auto it = query.begin(); it != query.end(); ++it) n++;
+        return n;
+    }
+}  // namespace
+
+namespace bench
+{
+    void runSpatialBenchmarks(Runner& runner, const size_t instances)
+    {
+        // Skip generating the nodes if the filter excludes all spatial benchmarks.
+        if (std::ranges::none_of(std::array{"spatial box (primitive comparisons)",
+                                            "spatial box (rtree)",
+                                            "spatial radius (rtree)",
+                                            "spatial nearest 10 (rtree)"},
+                                 [&](const std::string& name) { return runner.selected(name); }))
+            return;
+
+        auto  library   = alex::Library::create("");
+        auto& nameSpace = library->createNamespace("bench");
+
+        alex::TypeLayout float3Layout;
+        float3Layout.createPrimitiveProperty("x", alex::DataType::Float);
+        float3Layout.createPrimitiveProperty("y", alex::DataType::Float);
+        float3Layout.createPrimitiveProperty("z", alex::DataType::Float);
+        float3Layout.commit(nameSpace, "float3", alex::TypeLayout::Instantiable::False);
+
+        alex::TypeLayout nodeLayout;
+        nodeLayout.createNestedTypeProperty("position", nameSpace.getType("float3")).setSpatial();
+        nodeLayout.commit(nameSpace, "node");
+
+        auto nodeDescriptor = NodeDescriptor(nameSpace.getType("node"));
+
+        // Scatter nodes uniformly over a cube.
+        std::mt19937                          rng(42);
+        std::uniform_real_distribution<float> dist(0.0f, 1000.0f);
+        {
+            auto inserter = alex::InsertQuery(nodeDescriptor);
+            for (size_t i = 0; i < instances; i++)
+            {
+                Node node{.position = {dist(rng), dist(rng), dist(rng)}};
+                inserter(node);
+            }
+        }
+
+        /*
+         * Box containing roughly 0.1% of all nodes.
+         */
+
+        {
+            auto query = alex::primitiveSearchAnd(nodeDescriptor,
+                                                  alex::greaterEqual<NodeDescriptor, "position.x">(),
+                                                  alex::lessEqual<NodeDescriptor, "position.x">(),
+                                                  alex::greaterEqual<NodeDescriptor, "position.y">(),
+                                                  alex::lessEqual<NodeDescriptor, "position.y">(),
+                                                  alex::greaterEqual<NodeDescriptor, "position.z">(),
+                                                  alex::lessEqual<NodeDescriptor, "position.z">());
+            query(450.0f, 550.0f, 450.0f, 550.0f, 450.0f, 550.0f);
+            runner.run("spatial box (primitive comparisons)", [&] { return count(query); });
+        }
+
+        {
+            auto query = alex::spatialSearch(nodeDescriptor, alex::withinBox<NodeDescriptor, "position">());
+            query(alex::SpatialBox<3>{.min = {450, 450, 450}, .max = {550, 550, 550}});
+            runner.run("spatial box (rtree)", [&] { return count(query); });
+        }
+
+        /*
+         * Radius and nearest neighbour searches.
+         */
+
+        {
+            auto query = alex::spatialSearch(nodeDescriptor, alex::withinRadius<NodeDescriptor, "position">());
+            query(alex::SpatialSphere<3>{.center = {500, 500, 500}, .radius = 60});
+            runner.run("spatial radius (rtree)", [&] { return count(query); });
+        }
+
+        {
+            auto query = alex::nearestSearch(nodeDescriptor, alex::withinRadius<NodeDescriptor, "position">());
+            query.limit(10);
+            query(alex::SpatialSphere<3>{.center = {500, 500, 500}, .radius = 60});
+            runner.run("spatial nearest 10 (rtree)", [&] { return count(query); });
+        }
+    }
+}  // namespace bench
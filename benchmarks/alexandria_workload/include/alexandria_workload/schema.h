@@ -0,0 +1,135 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/member.h"
+#include "alexandria-core/type_descriptor.h"
+
+/*
+ * Types of the geometry example (examples/geometry), without the insert validation of the example.
+ */
+
+namespace workload
+{
+    struct Float3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    using float3_t =
+      alex::MemberList<alex::Member<"x", &Float3::x>, alex::Member<"y", &Float3::y>, alex::Member<"z", &Float3::z>>;
+
+    struct Int3
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+    };
+
+    struct Cube
+    {
+        alex::InstanceId id;
+        std::string      name;
+        Float3           size;
+    };
+
+    struct Material
+    {
+        alex::InstanceId id;
+        std::string      name;
+        Float3           color;
+        float            specular = 0;
+    };
+
+    struct Mesh
+    {
+        alex::InstanceId                id;
+        std::string                     name;
+        alex::Blob<std::vector<Float3>> vertices;
+        alex::Blob<std::vector<Int3>>   indices;
+    };
+
+    struct Sphere
+    {
+        alex::InstanceId id;
+        std::string      name;
+        float            radius = 0;
+    };
+
+    struct Node
+    {
+        alex::InstanceId          id;
+        std::string               name;
+        Float3                    translation;
+        alex::Reference<Material> material;
+        alex::Reference<Cube>     cube;
+        alex::Reference<Mesh>     mesh;
+        alex::Reference<Sphere>   sphere;
+    };
+
+    struct Scene
+    {
+        alex::InstanceId           id;
+        std::string                name;
+        alex::ReferenceArray<Node> nodes;
+    };
+
+    using CubeDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Cube::id>,
+                                                        alex::Member<"name", &Cube::name>,
+                                                        alex::NestedMember<"size", float3_t, &Cube::size>>;
+
+    using MaterialDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Material::id>,
+                                                            alex::Member<"name", &Material::name>,
+                                                            alex::NestedMember<"color", float3_t, &Material::color>,
+                                                            alex::Member<"specular", &Material::specular>>;
+
+    using MeshDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Mesh::id>,
+                                                        alex::Member<"name", &Mesh::name>,
+                                                        alex::Member<"vertices", &Mesh::vertices>,
+                                                        alex::Member<"indices", &Mesh::indices>>;
+
+    using SphereDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Sphere::id>,
+                                                          alex::Member<"name", &Sphere::name>,
+                                                          alex::Member<"radius", &Sphere::radius>>;
+
+    using NodeDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Node::id>,
+                                                        alex::Member<"name", &Node::name>,
+                                                        alex::NestedMember<"translation", float3_t, &Node::translation>,
+                                                        alex::Member<"material", &Node::material>,
+                                                        alex::Member<"cube", &Node::cube>,
+                                                        alex::Member<"mesh", &Node::mesh>,
+                                                        alex::Member<"sphere", &Node::sphere>>;
+
+    using SceneDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Scene::id>,
+                                                         alex::Member<"name", &Scene::name>,
+                                                         alex::Member<"nodes", &Scene::nodes>>;
+
+    /**
+     * \brief Create a library with the cube/material/mesh/node/scene schema of the geometry example in the "main"
+     * namespace.
+     * \param file Library file. Must not exist yet.
+     * \return Library.
+     */
+    [[nodiscard]] alex::LibraryPtr createLibrary(const std::filesystem::path& file);
+
+    /**
+     * \brief Configure a connection for concurrent clients: write-ahead logging, so that readers do not block the
+     * writer, and a busy timeout, so that writers wait for each other instead of failing immediately.
+     * \param library Library.
+     */
+    void configureConnection(alex::Library& library);
+}  // namespace workload
@@ -0,0 +1,239 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/latency_histogram.h"
+#include "alexandria-core/properties/instance_id.h"
+
+
+namespace workload
+{
+    /**
+     * \brief Operations of a workload.
+     *  - Read: get a node.
+     *  - Update: get a node, modify its translation, and update it.
+     *  - Insert: insert a new node that references an existing material and geometry.
+     *  - Scan: get a slice of the nodes array of the scene that holds a node, and get each node in the slice.
+     *  - Search: search all nodes that reference a random material.
+     */
+    enum class Operation : size_t
+    {
+        Read   = 0,
+        Update = 1,
+        Insert = 2,
+        Scan   = 3,
+        Search = 4
+    };
+
+    inline constexpr size_t operationCount = 5;
+
+    inline constexpr std::array<const char*, operationCount> operationNames = {
+      "read", "update", "insert", "scan", "search"};
+
+    /**
+     * \brief Distribution of the keys of the nodes that are read, updated and scanned.
+     *  - Uniform: all nodes are equally likely.
+     *  - Zipfian: a few nodes, spread over the key space, are very popular.
+     *  - Latest: the most recently inserted nodes are the most popular.
+     */
+    enum class Distribution
+    {
+        Uniform,
+        Zipfian,
+        Latest
+    };
+
+    struct Config
+    {
+        /**
+         * \brief Library file.
+         */
+        std::filesystem::path file;
+
+        /**
+         * \brief Number of nodes inserted during the load phase.
+         */
+        size_t records = 10000;
+
+        /**
+         * \brief Total number of operations of the run phase, divided over the threads.
+         */
+        size_t operations = 100000;
+
+        size_t threads = 1;
+
+        /**
+         * \brief Number of nodes per scene.
+         */
+        size_t nodesPerScene = 100;
+
+        /**
+         * \brief Maximum number of nodes per scan. The length of each scan is uniformly distributed in
+         * [1, scanLength].
+         */
+        size_t scanLength = 20;
+
+        Distribution distribution = Distribution::Zipfian;
+
+        /**
+         * \brief Relative weight of each operation.
+         */
+        std::array<uint32_t, operationCount> proportions{};
+
+        uint64_t seed = 42;
+    };
+
+    /**
+     * \brief Get the configuration of a YCSB core workload:
+     *  - a: 50% read, 50% update, zipfian.
+     *  - b: 95% read, 5% update, zipfian.
+     *  - c: 100% read, zipfian.
+     *  - d: 95% read, 5% insert, latest.
+     *  - e: 95% scan, 5% insert, zipfian.
+     * \param name Workload name.
+     * \return Configuration, or nullopt if the name is unknown.
+     */
+    [[nodiscard]] std::optional<Config> getCoreWorkload(const std::string& name);
+
+    /**
+     * \brief Identifiers of all instances of the workload. Node slots past the loaded records are claimed by inserts
+     * during the run phase, and become visible to other threads once the insert is done.
+     */
+    class KeySpace
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        KeySpace() = delete;
+
+        /**
+         * \brief Construct a key space.
+         * \param capacity Maximum number of nodes, i.e. records plus the maximum number of inserts.
+         */
+        explicit KeySpace(size_t capacity);
+
+        KeySpace(const KeySpace&) = delete;
+
+        KeySpace(KeySpace&&) noexcept = delete;
+
+        ~KeySpace() noexcept = default;
+
+        KeySpace& operator=(const KeySpace&) = delete;
+
+        KeySpace& operator=(KeySpace&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Nodes.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Claim the slot of a new node.
+         * \return Slot.
+         */
+        [[nodiscard]] size_t claim();
+
+        /**
+         * \brief Make a node visible to other threads.
+         * \param slot Slot returned by claim.
+         * \param id Node ID.
+         */
+        void publish(size_t slot, const alex::InstanceId& id);
+
+        /**
+         * \brief Get the ID of a node.
+         * \param slot Slot.
+         * \return Node ID, or nullopt if the slot was not published (yet).
+         */
+        [[nodiscard]] std::optional<alex::InstanceId> get(size_t slot) const;
+
+        /**
+         * \brief Get the number of claimed slots.
+         * \return Number of slots.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::vector<alex::InstanceId> materials;
+
+        std::vector<alex::InstanceId> cubes;
+
+        std::vector<alex::InstanceId> meshes;
+
+        std::vector<alex::InstanceId> spheres;
+
+        /**
+         * \brief Scene i holds the nodes [i * nodesPerScene, (i + 1) * nodesPerScene).
+         */
+        std::vector<alex::InstanceId> scenes;
+
+    private:
+        std::vector<alex::InstanceId> nodes;
+
+        std::unique_ptr<std::atomic<bool>[]> published;
+
+        std::atomic<size_t> next = 0;
+    };
+
+    /**
+     * \brief Latencies of a single operation. All threads record into the same statistics without locking.
+     */
+    struct OperationStats
+    {
+        alex::LatencyHistogram latency;
+
+        /**
+         * \brief Number of operations that threw, e.g. because the database stayed locked for too long. Failed
+         * operations are not included in the latencies.
+         */
+        std::atomic<size_t> failed = 0;
+    };
+
+    struct Report
+    {
+        std::array<OperationStats, operationCount> operations;
+
+        std::chrono::nanoseconds elapsed{};
+
+        size_t threads = 0;
+
+        void print(std::ostream& out) const;
+    };
+
+    /**
+     * \brief Create the library and insert the materials, geometry, nodes and scenes.
+     * \param config Configuration.
+     * \param keys Key space to store the identifiers of the inserted instances in.
+     */
+    void load(const Config& config, KeySpace& keys);
+
+    /**
+     * \brief Run the operations on several threads, each with its own connection to the library.
+     * \param config Configuration.
+     * \param keys Key space filled by load.
+     * \param report Report to record the latencies into.
+     */
+    void run(const Config& config, KeySpace& keys, Report& report);
+}  // namespace workload
@@ -0,0 +1,75 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+
+namespace workload
+{
+    /**
+     * \brief Generates integers in [0, items) with a zipfian distribution, using the algorithm from "Quickly
+     * Generating Billion-Record Synthetic Databases" (Gray et al.) that YCSB uses as well. Item 0 is the most popular.
+     */
+    class ZipfianGenerator
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ZipfianGenerator() = delete;
+
+        /**
+         * \brief Construct a generator. Takes time linear in the number of items to compute the zeta constant.
+         * \param itemCount Number of items. Must be at least 1.
+         * \param zipfianConstant Skew of the distribution. YCSB uses 0.99.
+         */
+        explicit ZipfianGenerator(uint64_t itemCount, double zipfianConstant = 0.99);
+
+        ZipfianGenerator(const ZipfianGenerator&) = default;
+
+        ZipfianGenerator(ZipfianGenerator&&) noexcept = default;
+
+        ~ZipfianGenerator() noexcept = default;
+
+        ZipfianGenerator& operator=(const ZipfianGenerator&) = default;
+
+        ZipfianGenerator& operator=(ZipfianGenerator&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Map a uniformly distributed value to an item.
+         * \param u Value in [0, 1).
+         * \return Item in [0, items).
+         */
+        [[nodiscard]] uint64_t operator()(double u) const noexcept;
+
+        /**
+         * \brief Map a uniformly distributed value to an item, spreading the popular items over the whole range
+         * instead of clustering them at the start.
+         * \param u Value in [0, 1).
+         * \return Item in [0, items).
+         */
+        [[nodiscard]] uint64_t scrambled(double u) const noexcept;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        uint64_t items = 0;
+
+        double theta = 0;
+
+        double alpha = 0;
+
+        double zetan = 0;
+
+        double eta = 0;
+    };
+}  // namespace workload
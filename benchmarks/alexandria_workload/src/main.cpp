@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "parsertongue/parser.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_workload/workload.h"
+
+int main(int argc, char** argv)
+{
+    pt::parser parser(argc, argv);
+
+    // Add arguments.
+    auto file = parser.add_value<std::filesystem::path>('\0', "library");
+    file->set_help("Path to the library file that is created (default workload.db)");
+    auto overwrite = parser.add_flag('\0', "overwrite");
+    overwrite->set_help("Delete the library file if it already exists");
+    auto workloadName = parser.add_value<std::string>('w', "workload");
+    workloadName->set_help("YCSB core workload a, b, c, d or e (default a)");
+    auto records = parser.add_value<int32_t>('r', "records");
+    records->set_help("Number of nodes to load (default 10000)");
+    auto operations = parser.add_value<int32_t>('o', "operations");
+    operations->set_help("Number of operations to run (default 100000)");
+    auto threads = parser.add_value<int32_t>('t', "threads");
+    threads->set_help("Number of client threads (default 1)");
+    auto distribution = parser.add_value<std::string>('d', "distribution");
+    distribution->set_help("Key distribution: uniform, zipfian or latest (default depends on the workload)");
+    auto scanLength = parser.add_value<int32_t>('\0', "scan-length");
+    scanLength->set_help("Maximum number of nodes per scan (default 20)");
+    auto read = parser.add_value<int32_t>('\0', "read");
+    read->set_help("Weight of read operations. Setting any weight replaces the mix of the workload");
+    auto update = parser.add_value<int32_t>('\0', "update");
+    update->set_help("Weight of update operations");
+    auto insert = parser.add_value<int32_t>('\0', "insert");
+    insert->set_help("Weight of insert operations");
+    auto scan = parser.add_value<int32_t>('\0', "scan");
+    scan->set_help("Weight of scan operations");
+    auto search = parser.add_value<int32_t>('\0', "search");
+    search->set_help("Weight of search operations");
+
+    // Run the parser.
+    std::string e;
+    if (!parser(e))
+    {
+        std::cout << "Internal parsing error: " << e << std::endl;
+        return 0;
+    }
+
+    // User requested help or version, don't run.
+    if (parser.display_help(std::cout)) return 0;
+
+    auto config = workload::getCoreWorkload(workloadName->is_set() ? workloadName->get_value() : "a");
+    if (!config)
+    {
+        std::cout << "Unknown workload " << workloadName->get_value() << std::endl;
+        return 1;
+    }
+
+    // Override the mix of the workload.
+    if (read->is_set() || update->is_set() || insert->is_set() || scan->is_set() || search->is_set())
+    {
+        size_t i = 0;
+        for (const auto& weight : {read, update, insert, scan, search})
+            config->proportions[i++] = weight->is_set() ? static_cast<uint32_t>(std::max(weight->get_value(), 0)) : 0;
+    }
+
+    if (distribution->is_set())
+    {
+        if (distribution->get_value() == "uniform")
+            config->distribution = workload::Distribution::Uniform;
+        else if (distribution->get_value() == "zipfian")
+            config->distribution = workload::Distribution::Zipfian;
+        else if (distribution->get_value() == "latest")
+            config->distribution = workload::Distribution::Latest;
+        else
+        {
+            std::cout << "Unknown distribution " << distribution->get_value() << std::endl;
+            return 1;
+        }
+    }
+
+    config->file = file->is_set() ? file->get_value() : "workload.db";
+    if (records->is_set()) config->records = static_cast<size_t>(std::max(records->get_value(), 0));
+    if (operations->is_set()) config->operations = static_cast<size_t>(std::max(operations->get_value(), 0));
+    if (threads->is_set()) config->threads = static_cast<size_t>(std::max(threads->get_value(), 0));
+    if (scanLength->is_set()) config->scanLength = static_cast<size_t>(std::max(scanLength->get_value(), 0));
+
+    if (config->records == 0 || config->threads == 0 || config->scanLength == 0)
+    {
+        std::cout << "Number of records, threads and scan length must be positive" << std::endl;
+        return 1;
+    }
+    if (std::accumulate(config->proportions.begin(), config->proportions.end(), uint32_t{0}) == 0)
+    {
+        std::cout << "At least one operation must have a positive weight" << std::endl;
+        return 1;
+    }
+
+    if (exists(config->file))
+    {
+        if (!overwrite->is_set())
+        {
+            std::cout << "Library file " << config->file << " already exists, pass --overwrite to replace it"
+                      << std::endl;
+            return 1;
+        }
+        for (const auto* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(config->file.string() + suffix);
+    }
+
+    try
+    {
+        workload::KeySpace keys(config->records + config->operations);
+        std::cout << "Loading " << config->records << " nodes" << std::endl;
+        workload::load(*config, keys);
+        workload::Report report;
+        workload::run(*config, keys, report);
+        report.print(std::cout);
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
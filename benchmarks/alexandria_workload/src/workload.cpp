@@ -0,0 +1,432 @@
+#include "alexandria_workload/workload.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <latch>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/namespace.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_workload/schema.h"
+#include "alexandria_workload/zipfian.h"
+
+namespace
+{
+    /**
+     * \brief Number of materials, cubes, meshes and spheres.
+     */
+    constexpr size_t assetCount = 16;
+
+    [[nodiscard]] workload::Float3 randomFloat3(std::mt19937_64& rng, const float lo, const float hi)
+    {
+        std::uniform_real_distribution<float> dist(lo, hi);
+        return {dist(rng), dist(rng), dist(rng)};
+    }
+
+    [[nodiscard]] workload::Mesh generateGrid(const size_t index)
+    {
+        // Grid of (n + 1) x (n + 1) vertices, two triangles per cell.
+        const auto     n = static_cast<int32_t>(4 + index);
+        workload::Mesh mesh{.name = std::format("grid{}", index)};
+        for (int32_t y = 0; y <= n; y++)
+            for (int32_t x = 0; x <= n; x++)
+                mesh.vertices.get().push_back({static_cast<float>(x), static_cast<float>(y), 0.0f});
+        for (int32_t y = 0; y < n; y++)
+        {
+            for (int32_t x = 0; x < n; x++)
+            {
+                const auto i = y * (n + 1) + x;
+                mesh.indices.get().push_back({i, i + 1, i + n + 1});
+                mesh.indices.get().push_back({i + 1, i + n + 2, i + n + 1});
+            }
+        }
+        return mesh;
+    }
+
+    /**
+     * \brief Create a node that references a random material and, depending on the index, a cube, mesh or sphere.
+     */
+    [[nodiscard]] workload::Node makeNode(const workload::KeySpace& keys, const size_t index, std::mt19937_64& rng)
+    {
+        std::uniform_int_distribution<size_t> assetDist(0, assetCount - 1);
+        workload::Node                        node{.name        = std::format("node{}", index),
+                                                   .translation = randomFloat3(rng, -100.0f, 100.0f)};
+        node.material = keys.materials[assetDist(rng)];
+        switch (index % 3)
+        {
+        case 0: node.cube = keys.cubes[assetDist(rng)]; break;
+        case 1: node.mesh = keys.meshes[assetDist(rng)]; break;
+        default: node.sphere = keys.spheres[assetDist(rng)]; break;
+        }
+        return node;
+    }
+
+    /**
+     * \brief Runs the operations of a single thread on its own connection.
+     */
+    class Client
+    {
+    public:
+        Client(const workload::Config& cfg, workload::KeySpace& keySpace, const uint64_t seed) :
+            config(cfg),
+            keys(keySpace),
+            library(alex::Library::open(cfg.file)),
+            nodeDescriptor(library->getNamespace("main").getType("node")),
+            sceneDescriptor(library->getNamespace("main").getType("scene")),
+            getNode(nodeDescriptor),
+            updateNode(nodeDescriptor),
+            insertNode(nodeDescriptor),
+            getScene(sceneDescriptor),
+            rng(seed),
+            operationDist(cfg.proportions.begin(), cfg.proportions.end()),
+            zipfian(cfg.records)
+        {
+            workload::configureConnection(*library);
+        }
+
+        void run(const size_t operations, workload::Report& report)
+        {
+            auto search = alex::primitiveSearch(nodeDescriptor, alex::equal<workload::NodeDescriptor, "material">());
+
+            for (size_t i = 0; i < operations; i++)
+            {
+                const auto index = operationDist(rng);
+                auto&      stats = report.operations[index];
+                const auto start = std::chrono::steady_clock::now();
+                try
+                {
+                    switch (static_cast<workload::Operation>(index))
+                    {
+                    case workload::Operation::Read: read(); break;
+                    case workload::Operation::Update: update(); break;
+                    case workload::Operation::Insert: insert(); break;
+                    case workload::Operation::Scan: scan(); break;
+                    case workload::Operation::Search: find(search); break;
+                    }
+                }
+                catch (const std::exception&)
+                {
+                    stats.failed.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                stats.latency.record(std::chrono::steady_clock::now() - start);
+            }
+        }
+
+    private:
+        /**
+         * \brief Choose the slot of a node according to the configured distribution.
+         */
+        [[nodiscard]] size_t nextSlot()
+        {
+            const auto size = keys.size();
+            switch (config.distribution)
+            {
+            case workload::Distribution::Uniform: return std::uniform_int_distribution<size_t>(0, size - 1)(rng);
+            case workload::Distribution::Zipfian: return static_cast<size_t>(zipfian.scrambled(unit(rng)));
+            case workload::Distribution::Latest:
+                return size - 1 - std::min(static_cast<size_t>(zipfian(unit(rng))), size - 1);
+            }
+            return 0;
+        }
+
+        /**
+         * \brief Get the ID of a node. Falls back to a loaded node if the chosen one is still being inserted.
+         */
+        [[nodiscard]] alex::InstanceId nextNode()
+        {
+            const auto slot = nextSlot();
+            if (auto id = keys.get(slot)) return *id;
+            return *keys.get(slot % config.records);
+        }
+
+        void read() { static_cast<void>(getNode(nextNode())); }
+
+        void update()
+        {
+            auto node        = getNode(nextNode());
+            node.translation = randomFloat3(rng, -100.0f, 100.0f);
+            updateNode(node);
+        }
+
+        void insert()
+        {
+            const auto slot = keys.claim();
+            auto       node = makeNode(keys, slot, rng);
+            insertNode(node);
+            keys.publish(slot, node.id);
+        }
+
+        void scan()
+        {
+            // Inserted nodes are not in a scene, so use the scene of a loaded node instead.
+            const auto slot   = nextSlot() % config.records;
+            const auto scene  = keys.scenes[slot / config.nodesPerScene];
+            const auto length = std::uniform_int_distribution<size_t>(1, config.scanLength)(rng);
+            for (const auto& id : getScene.getSlice<"nodes">(scene, slot % config.nodesPerScene, length))
+                static_cast<void>(getNode(id));
+        }
+
+        template<typename Q>
+        void find(Q& search)
+        {
+            const auto material = keys.materials[std::uniform_int_distribution<size_t>(0, assetCount - 1)(rng)];
+            search(material);
+            size_t count = 0;
+            for (auto it = search.begin(); it != search.end(); ++it) count++;
+            static_cast<void>(count);
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        const workload::Config& config;
+
+        workload::KeySpace& keys;
+
+        alex::LibraryPtr library;
+
+        workload::NodeDescriptor nodeDescriptor;
+
+        workload::SceneDescriptor sceneDescriptor;
+
+        alex::GetQuery<workload::NodeDescriptor> getNode;
+
+        alex::UpdateQuery<workload::NodeDescriptor> updateNode;
+
+        alex::InsertQuery<workload::NodeDescriptor> insertNode;
+
+        alex::GetQuery<workload::SceneDescriptor> getScene;
+
+        std::mt19937_64 rng;
+
+        std::uniform_real_distribution<double> unit{0.0, 1.0};
+
+        std::discrete_distribution<size_t> operationDist;
+
+        workload::ZipfianGenerator zipfian;
+    };
+}  // namespace
+
+namespace workload
+{
+    std::optional<Config> getCoreWorkload(const std::string& name)
+    {
+        Config config;
+        if (name == "a")
+            config.proportions = {50, 50, 0, 0, 0};
+        else if (name == "b")
+            config.proportions = {95, 5, 0, 0, 0};
+        else if (name == "c")
+            config.proportions = {100, 0, 0, 0, 0};
+        else if (name == "d")
+        {
+            config.proportions  = {95, 0, 5, 0, 0};
+            config.distribution = Distribution::Latest;
+        }
+        else if (name == "e")
+            config.proportions = {0, 0, 5, 95, 0};
+        else
+            return std::nullopt;
+        return config;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // KeySpace.
+    ////////////////////////////////////////////////////////////////
+
+    KeySpace::KeySpace(const size_t capacity) :
+        nodes(capacity), published(std::make_unique<std::atomic<bool>[]>(capacity))
+    {
+    }
+
+    size_t KeySpace::claim()
+    {
+        const auto slot = next.fetch_add(1);
+        if (slot >= nodes.size()) throw std::runtime_error("Key space is full.");
+        return slot;
+    }
+
+    void KeySpace::publish(const size_t slot, const alex::InstanceId& id)
+    {
+        nodes[slot] = id;
+        published[slot].store(true, std::memory_order_release);
+    }
+
+    std::optional<alex::InstanceId> KeySpace::get(const size_t slot) const
+    {
+        if (slot >= nodes.size() || !published[slot].load(std::memory_order_acquire)) return std::nullopt;
+        return nodes[slot];
+    }
+
+    size_t KeySpace::size() const noexcept { return std::min(next.load(), nodes.size()); }
+
+    ////////////////////////////////////////////////////////////////
+    // Report.
+    ////////////////////////////////////////////////////////////////
+
+    void Report::print(std::ostream& out) const
+    {
+        size_t total = 0;
+        for (const auto& op : operations) total += op.latency.count() + op.failed.load();
+        const auto seconds = std::chrono::duration<double>(elapsed).count();
+        out << std::format("{} operations on {} thread(s) in {:.2f} s ({:.0f} ops/s)\n",
+                           total,
+                           threads,
+                           seconds,
+                           seconds > 0 ? static_cast<double>(total) / seconds : 0.0);
+
+        const auto us = [](const std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1000.0; };
+        out << std::format("{:<8} {:>10} {:>8} {:>12} {:>12} {:>12} {:>12} {:>12}\n",
+                           "op",
+                           "count",
+                           "failed",
+                           "mean (us)",
+                           "p50 (us)",
+                           "p99 (us)",
+                           "p999 (us)",
+                           "max (us)");
+        for (size_t i = 0; i < operationCount; i++)
+        {
+            const auto& op     = operations[i];
+            const auto  failed = op.failed.load();
+            if (op.latency.count() == 0 && failed == 0) continue;
+            out << std::format("{:<8} {:>10} {:>8} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}\n",
+                               operationNames[i],
+                               op.latency.count(),
+                               failed,
+                               us(op.latency.mean()),
+                               us(op.latency.percentile(50)),
+                               us(op.latency.percentile(99)),
+                               us(op.latency.percentile(99.9)),
+                               us(op.latency.max()));
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Phases.
+    ////////////////////////////////////////////////////////////////
+
+    void load(const Config& config, KeySpace& keys)
+    {
+        auto library = createLibrary(config.file);
+        configureConnection(*library);
+        auto& mainSpace = library->getNamespace("main");
+
+        std::mt19937_64 rng(config.seed);
+
+        {
+            auto inserter = alex::InsertQuery(MaterialDescriptor(mainSpace.getType("material")));
+            for (size_t i = 0; i < assetCount; i++)
+            {
+                Material material{.name     = std::format("material{}", i),
+                                  .color    = randomFloat3(rng, 0.0f, 1.0f),
+                                  .specular = std::uniform_real_distribution<float>(0.0f, 1.0f)(rng)};
+                inserter(material);
+                keys.materials.emplace_back(material.id);
+            }
+        }
+
+        {
+            auto inserter = alex::InsertQuery(CubeDescriptor(mainSpace.getType("cube")));
+            for (size_t i = 0; i < assetCount; i++)
+            {
+                Cube cube{.name = std::format("cube{}", i), .size = randomFloat3(rng, 0.5f, 10.0f)};
+                inserter(cube);
+                keys.cubes.emplace_back(cube.id);
+            }
+        }
+
+        {
+            auto inserter = alex::InsertQuery(MeshDescriptor(mainSpace.getType("mesh")));
+            for (size_t i = 0; i < assetCount; i++)
+            {
+                auto mesh = generateGrid(i);
+                inserter(mesh);
+                keys.meshes.emplace_back(mesh.id);
+            }
+        }
+
+        {
+            auto inserter = alex::InsertQuery(SphereDescriptor(mainSpace.getType("sphere")));
+            for (size_t i = 0; i < assetCount; i++)
+            {
+                Sphere sphere{.name   = std::format("sphere{}", i),
+                              .radius = std::uniform_real_distribution<float>(0.5f, 10.0f)(rng)};
+                inserter(sphere);
+                keys.spheres.emplace_back(sphere.id);
+            }
+        }
+
+        {
+            auto nodeInserter  = alex::InsertQuery(NodeDescriptor(mainSpace.getType("node")));
+            auto sceneInserter = alex::InsertQuery(SceneDescriptor(mainSpace.getType("scene")));
+            Scene scene;
+            for (size_t i = 0; i < config.records; i++)
+            {
+                const auto slot = keys.claim();
+                auto       node = makeNode(keys, slot, rng);
+                nodeInserter(node);
+                keys.publish(slot, node.id);
+
+                scene.nodes.get().emplace_back(node.id);
+                if (scene.nodes.get().size() == config.nodesPerScene || i + 1 == config.records)
+                {
+                    scene.name = std::format("scene{}", keys.scenes.size());
+                    sceneInserter(scene);
+                    keys.scenes.emplace_back(scene.id);
+                    scene = Scene{};
+                }
+            }
+        }
+    }
+
+    void run(const Config& config, KeySpace& keys, Report& report)
+    {
+        // Open all connections before starting the clock.
+        std::vector<std::unique_ptr<Client>> clients;
+        for (size_t i = 0; i < config.threads; i++)
+            clients.emplace_back(std::make_unique<Client>(config, keys, config.seed + i + 1));
+
+        std::latch                            start(static_cast<std::ptrdiff_t>(config.threads + 1));
+        std::chrono::steady_clock::time_point begin;
+        {
+            std::vector<std::jthread> threads;
+            for (size_t i = 0; i < config.threads; i++)
+            {
+                // Spread the remainder over the first threads.
+                const auto operations =
+                  config.operations / config.threads + static_cast<size_t>(i < config.operations % config.threads);
+                threads.emplace_back([&, i, operations] {
+                    start.arrive_and_wait();
+                    clients[i]->run(operations, report);
+                });
+            }
+            start.arrive_and_wait();
+            begin = std::chrono::steady_clock::now();
+        }
+
+        report.elapsed = std::chrono::steady_clock::now() - begin;
+        report.threads = config.threads;
+    }
+}  // namespace workload
@@ -0,0 +1,64 @@
+#include "alexandria_workload/zipfian.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    [[nodiscard]] double zeta(const uint64_t n, const double theta)
+    {
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; i++) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    /**
+     * \brief 64-bit FNV-1a hash of the bytes of a value.
+     */
+    [[nodiscard]] uint64_t fnv1a(uint64_t value) noexcept
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (int32_t i = 0; i < 8; i++)
+        {
+            hash ^= value & 0xff;
+            hash *= 0x100000001b3ull;
+            value >>= 8;
+        }
+        return hash;
+    }
+}  // namespace
+
+namespace workload
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    ZipfianGenerator::ZipfianGenerator(const uint64_t itemCount, const double zipfianConstant) :
+        items(std::max<uint64_t>(itemCount, 1)), theta(zipfianConstant)
+    {
+        alpha            = 1.0 / (1.0 - theta);
+        zetan            = zeta(items, theta);
+        const auto zeta2 = zeta(2, theta);
+        eta              = (1.0 - std::pow(2.0 / static_cast<double>(items), 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t ZipfianGenerator::operator()(const double u) const noexcept
+    {
+        const auto uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta)) return std::min<uint64_t>(1, items - 1);
+        const auto item = static_cast<uint64_t>(static_cast<double>(items) * std::pow(eta * u - eta + 1.0, alpha));
+        return std::min(item, items - 1);
+    }
+
+    uint64_t ZipfianGenerator::scrambled(const double u) const noexcept { return fnv1a((*this)(u)) % items; }
+}  // namespace workload
@@ -37,9 +37,14 @@ class AlexandriaConan(ConanFile):
     python_requires_extend = "pyreq.BaseConan"
 
     options = {
+        "build_benchmarks": [True, False]
     }
     
     default_options = {
+        "build_benchmarks": False,
+        "sqlite3/*:enable_dbstat_vtab": True,
+        "sqlite3/*:enable_fts5": True,
+        "sqlite3/*:enable_rtree": True
     }
     
     ############################################################################
@@ -65,6 +70,7 @@ class AlexandriaConan(ConanFile):
         copy(self, "license", self.recipe_folder, self.export_sources_folder)
         copy(self, "readme.md", self.recipe_folder, self.export_sources_folder)
         copy(self, "applications/*", self.recipe_folder, self.export_sources_folder)
+        copy(self, "benchmarks/*", self.recipe_folder, self.export_sources_folder)
         copy(self, "buildtools/*", self.recipe_folder, self.export_sources_folder)
         copy(self, "modules/*", self.recipe_folder, self.export_sources_folder)
     
@@ -90,7 +96,7 @@ class AlexandriaConan(ConanFile):
         if self.options.build_tests:
             self.requires("bettertest/1.0.1@timzoet/v1.0.1")
         
-        if self.options.build_tests or self.options.build_examples:
+        if self.options.build_tests or self.options.build_examples or self.options.build_benchmarks:
             self.requires("parsertongue/1.3.1@timzoet/v1.3.1")
 
     def package_info(self):
@@ -105,6 +111,7 @@ class AlexandriaConan(ConanFile):
         base = self.python_requires["pyreq"].module.BaseConan
         
         tc = base.generate_toolchain(self)
+        tc.variables["BUILD_BENCHMARKS"] = bool(self.options.build_benchmarks)
         tc.generate()
         
         deps = base.generate_deps(self)
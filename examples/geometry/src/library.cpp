@@ -38,8 +38,8 @@ alex::LibraryPtr createLibrary()
 
         alex::TypeLayout layoutMesh;
         layoutMesh.createStringProperty("name");
-        layoutMesh.createBlobProperty("vertices");
-        layoutMesh.createBlobProperty("indices");
+        layoutMesh.createBlobProperty("vertices").setDeduplicated();
+        layoutMesh.createBlobProperty("indices").setDeduplicated();
         layoutMesh.commit(mainSpace, "mesh");
         alex::Type& typeMesh = mainSpace.getType("mesh");
 
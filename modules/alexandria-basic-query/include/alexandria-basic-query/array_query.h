@@ -0,0 +1,683 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/change_log.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/properties/instance_id.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/packed_array.h"
+#include "alexandria-basic-query/utils.h"
+#include "alexandria-basic-query/types/member_extractor.h"
+
+namespace alex
+{
+    namespace detail
+    {
+        /**
+         * \brief Modifies the rows of the array table of a single array member, without touching the rest of the
+         * instance. Statements are prepared on first use. Each modification runs in a savepoint, so that it is atomic
+         * on its own and can also be batched inside a transaction started by the caller.
+         *
+         * Modifications are recorded as updates of the instance in the change log of the library, if it is enabled.
+         *
+         * Positions of primitive, string and blob arrays are kept contiguous, i.e. erasing elements shifts the
+         * positions of all following elements. Positions of reference arrays can have gaps, because deleting a
+         * referenced instance removes its rows. Their elements are addressed by their rank instead.
+         *
+         * \tparam T TypeDescriptor.
+         * \tparam M Member name.
+         */
+        template<typename T, MemberName M>
+        class ArrayModifier
+        {
+        public:
+            ////////////////////////////////////////////////////////////////
+            // Types.
+            ////////////////////////////////////////////////////////////////
+
+            using type_descriptor_t = T;
+            using members_t         = typename type_descriptor_t::members_t;
+            using member_t          = member_by_name_t<M, type_descriptor_t>;
+            using element_t         = array_element_t<member_t>;
+
+            ////////////////////////////////////////////////////////////////
+            // Constructors.
+            ////////////////////////////////////////////////////////////////
+
+            ArrayModifier() = delete;
+
+            explicit ArrayModifier(const type_descriptor_t& desc) :
+                db(&desc.getType().getInstanceTable().getDatabase()),
+                library(&desc.getType().getNamespace().getLibrary()),
+                typeId(desc.getType().getId())
+            {
+                const Type& type = desc.getType();
+                if constexpr (member_t::is_blob_array)
+                {
+                    constexpr auto index = getColumnIndex<M, extract_blob_array_members_t<members_t>>();
+                    table                = quoteIdentifier(type.getBlobArrayTables()[index]->getName());
+                    format               = getBlobArrayFormat(type, index);
+                    stores               = makeBlobStores(type, std::array{format});
+                }
+                else if constexpr (member_t::is_reference_array)
+                {
+                    constexpr auto index = getColumnIndex<M, extract_reference_array_members_t<members_t>>();
+                    table                = quoteIdentifier(type.getReferenceArrayTables()[index]->getName());
+                }
+                else
+                {
+                    constexpr auto index = getColumnIndex<M, extract_primitive_array_members_t<members_t>>();
+                    table                = quoteIdentifier(type.getPrimitiveArrayTables()[index]->getName());
+                    packed               = isPackedArray(type, index);
+                }
+            }
+
+            ArrayModifier(const ArrayModifier&) = delete;
+
+            ArrayModifier(ArrayModifier&&) = default;
+
+            ~ArrayModifier() noexcept = default;
+
+            ArrayModifier& operator=(const ArrayModifier&) = delete;
+
+            ArrayModifier& operator=(ArrayModifier&&) = default;
+
+            ////////////////////////////////////////////////////////////////
+            // Modify.
+            ////////////////////////////////////////////////////////////////
+
+            /**
+             * \brief Append elements to the end of the array.
+             * \tparam R Range type.
+             * \param uuid Instance ID.
+             * \param values Elements.
+             */
+            template<typename R>
+            void append(const std::string& uuid, const R& values)
+            {
+                Savepoint savepoint(*this);
+
+                if (packed)
+                {
+                    auto array = readPacked(uuid);
+                    array.insert(array.end(), std::ranges::begin(values), std::ranges::end(values));
+                    writePacked(uuid, array);
+                }
+                else
+                {
+                    auto& stmt     = prepare(insertStatement,
+                                         "INSERT INTO {} (instance, value, position) VALUES (?1, ?2, ?3);");
+                    auto  position = nextPosition(uuid);
+                    for (const auto& v : values)
+                    {
+                        ScopedReset reset{stmt};
+                        stmt.bind(1, uuid);
+                        bindValue(stmt, 2, v);
+                        stmt.bind(3, position++);
+                        stmt.step();
+                    }
+                }
+
+                recordChange(uuid);
+                savepoint.release();
+            }
+
+            /**
+             * \brief Erase a range of elements.
+             * \param uuid Instance ID.
+             * \param begin Index of first element.
+             * \param count Number of elements.
+             * \return Number of erased elements.
+             */
+            size_t erase(const std::string& uuid, const size_t begin, const size_t count)
+            {
+                Savepoint savepoint(*this);
+                size_t    erased = 0;
+
+                if (packed)
+                {
+                    auto       array = readPacked(uuid);
+                    const auto first = std::min(begin, array.size());
+                    erased           = std::min(count, array.size() - first);
+                    if (erased > 0)
+                    {
+                        const auto it = array.begin() + static_cast<ptrdiff_t>(first);
+                        array.erase(it, it + static_cast<ptrdiff_t>(erased));
+                        writePacked(uuid, array);
+                    }
+                }
+                else if constexpr (member_t::is_reference_array)
+                {
+                    auto& stmt = prepare(eraseStatement,
+                                         "DELETE FROM {0} WHERE id IN (SELECT id FROM {0} WHERE instance = ?1 ORDER BY "
+                                         "position LIMIT ?3 OFFSET ?2);");
+                    run(stmt, uuid, begin, count);
+                    erased = changes();
+                }
+                else
+                {
+                    auto& stmt = prepare(
+                      eraseStatement, "DELETE FROM {} WHERE instance = ?1 AND position >= ?2 AND position < ?2 + ?3;");
+                    run(stmt, uuid, begin, count);
+                    erased = changes();
+
+                    // Close the gap.
+                    if (erased > 0)
+                        run(prepare(shiftStatement,
+                                    "UPDATE {} SET position = position - ?3 WHERE instance = ?1 AND position >= ?2 + "
+                                    "?3;"),
+                            uuid,
+                            begin,
+                            erased);
+                }
+
+                if (erased > 0) recordChange(uuid);
+                savepoint.release();
+                return erased;
+            }
+
+            /**
+             * \brief Replace an element.
+             * \param uuid Instance ID.
+             * \param index Index of the element.
+             * \param value New value.
+             */
+            void set(const std::string& uuid, const size_t index, const element_t& value)
+            {
+                Savepoint savepoint(*this);
+
+                bool found = false;
+                if (packed)
+                {
+                    auto array = readPacked(uuid);
+                    if (index < array.size())
+                    {
+                        array[index] = value;
+                        writePacked(uuid, array);
+                        found = true;
+                    }
+                }
+                else
+                {
+                    auto& stmt = prepare(setStatement,
+                                         member_t::is_reference_array ?
+                                           "UPDATE {0} SET value = ?3 WHERE id = (SELECT id FROM {0} WHERE instance = "
+                                           "?1 ORDER BY position LIMIT 1 OFFSET ?2);" :
+                                           "UPDATE {} SET value = ?3 WHERE instance = ?1 AND position = ?2;");
+                    ScopedReset reset{stmt};
+                    stmt.bind(1, uuid);
+                    stmt.bind(2, static_cast<int64_t>(index));
+                    bindValue(stmt, 3, value);
+                    stmt.step();
+                    found = changes() > 0;
+                }
+
+                if (!found)
+                    throw std::runtime_error(std::format(R"(Cannot set element {} of array "{}". Index out of range.)",
+                                                         index,
+                                                         std::string_view(member_t::name_v.name)));
+
+                recordChange(uuid);
+                savepoint.release();
+            }
+
+        private:
+            /**
+             * \brief Savepoint that is rolled back unless it is released.
+             */
+            class Savepoint
+            {
+            public:
+                explicit Savepoint(ArrayModifier& m) : modifier(&m)
+                {
+                    run(modifier->prepare(modifier->savepointStatement, "SAVEPOINT alexandria_array;"));
+                }
+
+                Savepoint(const Savepoint&) = delete;
+
+                Savepoint& operator=(const Savepoint&) = delete;
+
+                ~Savepoint() noexcept
+                {
+                    if (!modifier) return;
+                    try
+                    {
+                        run(modifier->prepare(modifier->rollbackStatement, "ROLLBACK TO alexandria_array;"));
+                        run(modifier->prepare(modifier->releaseStatement, "RELEASE alexandria_array;"));
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+
+                void release()
+                {
+                    run(modifier->prepare(modifier->releaseStatement, "RELEASE alexandria_array;"));
+                    modifier = nullptr;
+                }
+
+            private:
+                static void run(RawStatement& stmt)
+                {
+                    ScopedReset reset{stmt};
+                    stmt.step();
+                }
+
+                ArrayModifier* modifier = nullptr;
+            };
+
+            /**
+             * \brief Prepare a statement on first use.
+             * \param stmt Statement.
+             * \param sql SQL string. Arguments are replaced with the quoted name of the array table.
+             * \return Statement.
+             */
+            RawStatement& prepare(RawStatement& stmt, const std::string_view sql)
+            {
+                if (!stmt.get()) stmt = RawStatement(*db, std::vformat(sql, std::make_format_args(table)));
+                return stmt;
+            }
+
+            /**
+             * \brief Run a statement that takes the instance as ?1 and a range as ?2 and ?3.
+             */
+            static void run(RawStatement& stmt, const std::string& uuid, const size_t begin, const size_t count)
+            {
+                constexpr auto max = static_cast<size_t>(std::numeric_limits<int64_t>::max());
+                ScopedReset    reset{stmt};
+                stmt.bind(1, uuid);
+                stmt.bind(2, static_cast<int64_t>(std::min(begin, max)));
+                stmt.bind(3, static_cast<int64_t>(std::min(count, max)));
+                stmt.step();
+            }
+
+            /**
+             * \brief Get the number of rows changed by the last statement.
+             * \return Number of rows.
+             */
+            [[nodiscard]] size_t changes()
+            {
+                auto& stmt = prepare(changesStatement, "SELECT changes();");
+                ScopedReset reset{stmt};
+                stmt.step();
+                return static_cast<size_t>(stmt.getInt64(0));
+            }
+
+            /**
+             * \brief Record an update of the instance in the change log, if the library has one.
+             * \param uuid Instance ID.
+             */
+            void recordChange(const std::string& uuid)
+            {
+                if (!library->isChangeLogEnabled()) return;
+                if (!changeLogStatement.get()) changeLogStatement = RawStatement(*db, ChangeLog::getUpdateSql(typeId));
+                ScopedReset reset{changeLogStatement};
+                changeLogStatement.bind(1, uuid);
+                changeLogStatement.step();
+            }
+
+            /**
+             * \brief Get the position after the last element of an array.
+             * \param uuid Instance ID.
+             * \return Position.
+             */
+            [[nodiscard]] int64_t nextPosition(const std::string& uuid)
+            {
+                auto& stmt =
+                  prepare(positionStatement, "SELECT coalesce(max(position) + 1, 0) FROM {} WHERE instance = ?1;");
+                ScopedReset reset{stmt};
+                stmt.bind(1, uuid);
+                stmt.step();
+                return stmt.getInt64(0);
+            }
+
+            template<typename V>
+            void bindValue(RawStatement& stmt, const int32_t index, const V& value)
+            {
+                if constexpr (member_t::is_blob_array)
+                    bindBlobValue(stmt, index, format, value, buffer, stores);
+                else if constexpr (member_t::is_reference_array)
+                {
+                    text = value.getAsString();
+                    stmt.bind(index, text);
+                }
+                else
+                    stmt.bind(index, value);
+            }
+
+            /**
+             * \brief Read all elements of a packed array.
+             * \param uuid Instance ID.
+             * \return Elements.
+             */
+            [[nodiscard]] std::vector<element_t> readPacked(const std::string& uuid)
+            {
+                std::vector<element_t> array;
+                if constexpr (!member_t::is_blob_array && !member_t::is_reference_array)
+                {
+                    auto& stmt = prepare(readStatement, "SELECT value FROM {} WHERE instance = ?1;");
+                    ScopedReset reset{stmt};
+                    stmt.bind(1, uuid);
+                    if (stmt.step()) unpackArray(stmt.getBlob(0), array);
+                }
+                return array;
+            }
+
+            /**
+             * \brief Replace all elements of a packed array. Empty arrays have no row.
+             * \param uuid Instance ID.
+             * \param array Elements.
+             */
+            void writePacked(const std::string& uuid, const std::vector<element_t>& array)
+            {
+                if constexpr (!member_t::is_blob_array && !member_t::is_reference_array)
+                {
+                    {
+                        auto& stmt = prepare(clearStatement, "DELETE FROM {} WHERE instance = ?1;");
+                        ScopedReset reset{stmt};
+                        stmt.bind(1, uuid);
+                        stmt.step();
+                    }
+
+                    if (array.empty()) return;
+                    packArray(array, buffer);
+                    auto& stmt =
+                      prepare(writeStatement, "INSERT INTO {} (instance, value, position) VALUES (?1, ?2, 0);");
+                    ScopedReset reset{stmt};
+                    stmt.bind(1, uuid);
+                    stmt.bindBlob(2, buffer);
+                    stmt.step();
+                }
+            }
+
+            ////////////////////////////////////////////////////////////////
+            // Member variables.
+            ////////////////////////////////////////////////////////////////
+
+            sql::Database* db = nullptr;
+
+            const Library* library = nullptr;
+
+            sql::row_id typeId = 0;
+
+            /**
+             * \brief Quoted name of the array table.
+             */
+            std::string table;
+
+            bool packed = false;
+
+            BlobFormat format;
+
+            BlobStores stores;
+
+            RawStatement insertStatement;
+
+            RawStatement eraseStatement;
+
+            RawStatement shiftStatement;
+
+            RawStatement setStatement;
+
+            RawStatement readStatement;
+
+            RawStatement clearStatement;
+
+            RawStatement writeStatement;
+
+            RawStatement positionStatement;
+
+            RawStatement changesStatement;
+
+            RawStatement savepointStatement;
+
+            RawStatement rollbackStatement;
+
+            RawStatement releaseStatement;
+
+            RawStatement changeLogStatement;
+
+            std::vector<std::byte> buffer;
+
+            std::string text;
+        };
+
+        [[nodiscard]] inline std::string checkId(const InstanceId& id, const std::string_view action)
+        {
+            if (!id.valid())
+                throw std::runtime_error(std::format("Cannot {} array. Instance does not have a valid UUID.", action));
+            return id.getAsString();
+        }
+    }  // namespace detail
+
+    /**
+     * \brief Appends elements to a single array member of an instance, without rewriting the other elements or the
+     * other members. All elements passed in one call are appended in a single transaction. To batch calls, for example
+     * to append to the arrays of many instances, run them inside a transaction:
+     *
+     * \code
+     * alex::ArrayAppendQuery<SceneDescriptor, "nodes"> append(sceneDescriptor);
+     * auto transaction = library.getDatabase().beginTransaction(sql::Transaction::Type::Deferred);
+     * for (const auto& node : nodes) append(sceneId, node.id);
+     * transaction.commit();
+     * \endcode
+     *
+     * \tparam T TypeDescriptor.
+     * \tparam M Member name of a primitive, string, blob or reference array.
+     */
+    template<typename T, detail::MemberName M>
+        requires(detail::is_array_member_name<M, T>)
+    class ArrayAppendQuery
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using type_descriptor_t = T;
+        using modifier_t        = detail::ArrayModifier<type_descriptor_t, M>;
+        using element_t         = typename modifier_t::element_t;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ArrayAppendQuery() = delete;
+
+        explicit ArrayAppendQuery(type_descriptor_t desc) : modifier(desc) {}
+
+        ArrayAppendQuery(const ArrayAppendQuery&) = delete;
+
+        ArrayAppendQuery(ArrayAppendQuery&&) = default;
+
+        ~ArrayAppendQuery() noexcept = default;
+
+        ArrayAppendQuery& operator=(const ArrayAppendQuery&) = delete;
+
+        ArrayAppendQuery& operator=(ArrayAppendQuery&&) = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Invoke.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Append an element.
+         * \param id Instance ID.
+         * \param value Element.
+         */
+        void operator()(const InstanceId& id, const element_t& value)
+        {
+            modifier.append(detail::checkId(id, "append to"), std::span(&value, 1));
+        }
+
+        /**
+         * \brief Append a range of elements.
+         * \tparam R Range type.
+         * \param id Instance ID.
+         * \param values Elements.
+         */
+        template<std::ranges::input_range R>
+            requires(std::convertible_to<std::ranges::range_reference_t<R>, const element_t&>)
+        void operator()(const InstanceId& id, R&& values)
+        {
+            modifier.append(detail::checkId(id, "append to"), values);
+        }
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        modifier_t modifier;
+    };
+
+    /**
+     * \brief Erases elements from a single array member of an instance, without rewriting the other members. Elements
+     * after the erased range move up.
+     * \tparam T TypeDescriptor.
+     * \tparam M Member name of a primitive, string, blob or reference array.
+     */
+    template<typename T, detail::MemberName M>
+        requires(detail::is_array_member_name<M, T>)
+    class ArrayEraseQuery
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using type_descriptor_t = T;
+        using modifier_t        = detail::ArrayModifier<type_descriptor_t, M>;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ArrayEraseQuery() = delete;
+
+        explicit ArrayEraseQuery(type_descriptor_t desc) : modifier(desc) {}
+
+        ArrayEraseQuery(const ArrayEraseQuery&) = delete;
+
+        ArrayEraseQuery(ArrayEraseQuery&&) = default;
+
+        ~ArrayEraseQuery() noexcept = default;
+
+        ArrayEraseQuery& operator=(const ArrayEraseQuery&) = delete;
+
+        ArrayEraseQuery& operator=(ArrayEraseQuery&&) = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Invoke.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Erase elements [begin, begin + count). Elements past the end of the array are ignored.
+         * \param id Instance ID.
+         * \param begin Index of first element.
+         * \param count Number of elements.
+         * \return Number of erased elements.
+         */
+        size_t operator()(const InstanceId& id, const size_t begin, const size_t count = 1)
+        {
+            return modifier.erase(detail::checkId(id, "erase from"), begin, count);
+        }
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        modifier_t modifier;
+    };
+
+    /**
+     * \brief Replaces an element of a single array member of an instance, without rewriting the other elements or the
+     * other members.
+     * \tparam T TypeDescriptor.
+     * \tparam M Member name of a primitive, string, blob or reference array.
+     */
+    template<typename T, detail::MemberName M>
+        requires(detail::is_array_member_name<M, T>)
+    class ArraySetQuery
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using type_descriptor_t = T;
+        using modifier_t        = detail::ArrayModifier<type_descriptor_t, M>;
+        using element_t         = typename modifier_t::element_t;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ArraySetQuery() = delete;
+
+        explicit ArraySetQuery(type_descriptor_t desc) : modifier(desc) {}
+
+        ArraySetQuery(const ArraySetQuery&) = delete;
+
+        ArraySetQuery(ArraySetQuery&&) = default;
+
+        ~ArraySetQuery() noexcept = default;
+
+        ArraySetQuery& operator=(const ArraySetQuery&) = delete;
+
+        ArraySetQuery& operator=(ArraySetQuery&&) = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Invoke.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Replace an element. Throws if the index is out of range.
+         * \param id Instance ID.
+         * \param index Index of the element.
+         * \param value New value.
+         */
+        void operator()(const InstanceId& id, const size_t index, const element_t& value)
+        {
+            modifier.set(detail::checkId(id, "set element of"), index, value);
+        }
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        modifier_t modifier;
+    };
+}  // namespace alex
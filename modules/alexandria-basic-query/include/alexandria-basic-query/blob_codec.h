@@ -0,0 +1,568 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "common/type_traits.h"
+
+namespace alex::detail
+{
+    template<typename T>
+    struct IsVector : std::false_type
+    {
+    };
+
+    template<typename T>
+    struct IsVector<std::vector<T>> : std::true_type
+    {
+    };
+
+    /**
+     * \brief Get the names of all columns of the instance table of a type, in order.
+     * \param type Type.
+     * \return Column names.
+     */
+    [[nodiscard]] inline std::vector<std::string> getInstanceColumnNames(const Type& type)
+    {
+        auto&                    db = type.getInstanceTable().getDatabase();
+        std::vector<std::string> names;
+        RawStatement             stmt(db, "SELECT name FROM pragma_table_info(?1) ORDER BY cid;", false);
+        stmt.bind(1, type.getInstanceTable().getName());
+        while (stmt.step()) names.emplace_back(stmt.getText(0));
+        return names;
+    }
+
+    /**
+     * \brief How the values of a blob, primitive blob or blob array property are stored.
+     */
+    struct BlobFormat
+    {
+        Codec   codec             = Codec::None;
+        bool    deduplicated      = false;
+        int64_t externalThreshold = 0;
+
+        /**
+         * \brief Returns whether values are stored as is, i.e. are not encoded, not deduplicated and never external.
+         * \return True if plain.
+         */
+        [[nodiscard]] bool isPlain() const noexcept
+        {
+            return codec == Codec::None && !deduplicated && externalThreshold == 0;
+        }
+
+        /**
+         * \brief Returns whether a value is stored in the external store.
+         * \param size Size of the (encoded) value in bytes.
+         * \return True if external.
+         */
+        [[nodiscard]] bool isExternal(const size_t size) const noexcept
+        {
+            return externalThreshold > 0 && static_cast<int64_t>(size) >= externalThreshold;
+        }
+    };
+
+    /**
+     * \brief Destinations of blobs that are not stored in the instance or array table itself.
+     */
+    struct BlobStores
+    {
+        /**
+         * \brief Store for deduplicated blobs. Only prepared if any format is deduplicated.
+         */
+        BlobStore shared;
+
+        /**
+         * \brief Store for external blobs. Only set if any format has an external threshold.
+         */
+        ExternalStore* external = nullptr;
+    };
+
+    /**
+     * \brief Get the format of a column of the instance table or, for blob arrays, of an array table.
+     * \param type Type.
+     * \param column Column name, see Type::getCodec.
+     * \return BlobFormat.
+     */
+    [[nodiscard]] inline BlobFormat getBlobFormat(const Type& type, const std::string& column)
+    {
+        return {.codec             = type.getCodec(column),
+                .deduplicated      = type.isDeduplicated(column),
+                .externalThreshold = type.getExternalThreshold(column)};
+    }
+
+    /**
+     * \brief Get the format of each member of a list of instance table members. Members that are not blobs or
+     * primitive blobs are always plain.
+     * \tparam M Tuple of members, starting with the UUID member.
+     * \param type Type.
+     * \return BlobFormat per member.
+     */
+    template<typename M>
+    [[nodiscard]] std::array<BlobFormat, std::tuple_size_v<M>> getBlobFormats(const Type& type)
+    {
+        std::array<BlobFormat, std::tuple_size_v<M>> formats{};
+        std::vector<std::string>                     names;
+
+        const auto f = [&]<size_t... Is>(std::index_sequence<Is...>)
+        {
+            (
+              [&] {
+                  using member_t = std::tuple_element_t<Is, M>;
+                  if constexpr (member_t::is_blob || member_t::is_primitive_blob)
+                  {
+                      // Add 1 to account for integer primary key column.
+                      if (names.empty()) names = getInstanceColumnNames(type);
+                      formats[Is] = getBlobFormat(type, names.at(Is + 1));
+                  }
+              }(),
+              ...);
+        };
+        f(std::make_index_sequence<std::tuple_size_v<M>>{});
+
+        return formats;
+    }
+
+    /**
+     * \brief Get the format of a blob array table of a type.
+     * \param type Type.
+     * \param index Index into Type::getBlobArrayTables.
+     * \return BlobFormat.
+     */
+    [[nodiscard]] inline BlobFormat getBlobArrayFormat(const Type& type, const size_t index)
+    {
+        // Array tables are named after the instance table, followed by the (prefixed) property name.
+        const auto& name = type.getBlobArrayTables()[index]->getName();
+        return getBlobFormat(type, name.substr(type.getInstanceTable().getName().size() + 1));
+    }
+
+    template<size_t N>
+    [[nodiscard]] bool hasEncoding(const std::array<BlobFormat, N>& formats) noexcept
+    {
+        return std::ranges::any_of(formats, [](const BlobFormat& f) { return !f.isPlain(); });
+    }
+
+    template<size_t N>
+    [[nodiscard]] bool hasDeduplication(const std::array<BlobFormat, N>& formats) noexcept
+    {
+        return std::ranges::any_of(formats, [](const BlobFormat& f) { return f.deduplicated; });
+    }
+
+    template<size_t N>
+    [[nodiscard]] bool hasExternal(const std::array<BlobFormat, N>& formats) noexcept
+    {
+        return std::ranges::any_of(formats, [](const BlobFormat& f) { return f.externalThreshold > 0; });
+    }
+
+    /**
+     * \brief Get the external store of the library of a type.
+     * \param type Type.
+     * \return ExternalStore.
+     */
+    [[nodiscard]] inline ExternalStore& getExternalStore(const Type& type)
+    {
+        return type.getNamespace().getLibrary().getExternalStore();
+    }
+
+    /**
+     * \brief Create the stores that deduplicated and external values are written to.
+     * \tparam N Number of formats.
+     * \param type Type.
+     * \param formats Formats.
+     * \return BlobStores.
+     */
+    template<size_t N>
+    [[nodiscard]] BlobStores makeBlobStores(const Type& type, const std::array<BlobFormat, N>& formats)
+    {
+        BlobStores stores;
+        if (hasDeduplication(formats)) stores.shared = BlobStore(type.getInstanceTable().getDatabase());
+        if (hasExternal(formats)) stores.external = &getExternalStore(type);
+        return stores;
+    }
+
+    /**
+     * \brief Statements that write the ids of external values to a table. Rows are first written with null in place of
+     * external values, after which the ids are filled in.
+     * \tparam N Number of columns.
+     */
+    template<size_t N>
+    class ExternalIdWriter
+    {
+    public:
+        ExternalIdWriter() = default;
+
+        /**
+         * \brief Prepare a statement for each column with an external threshold.
+         * \param db Database.
+         * \param table Table name.
+         * \param columns Name of each column. Only used for columns with an external threshold.
+         * \param formats Format of each column.
+         * \param where Condition selecting the row. Can use parameter ?2.
+         */
+        ExternalIdWriter(sql::Database&                    db,
+                         const std::string&                table,
+                         const std::array<std::string, N>& columns,
+                         const std::array<BlobFormat, N>&  formats,
+                         const std::string&                where)
+        {
+            for (size_t i = 0; i < N; i++)
+                if (formats[i].externalThreshold > 0)
+                    statements[i] = RawStatement(db,
+                                                 std::format("UPDATE {} SET {} = ?1 WHERE {};",
+                                                             quoteIdentifier(table),
+                                                             quoteIdentifier(columns[i]),
+                                                             where));
+        }
+
+        /**
+         * \brief Prepare a statement for each member of the instance table with an external threshold.
+         * \param type Type.
+         * \param formats Format of each member, starting with the UUID member.
+         * \param where Condition selecting the row. Can use parameter ?2.
+         */
+        ExternalIdWriter(const Type& type, const std::array<BlobFormat, N>& formats, const std::string& where)
+        {
+            if (!hasExternal(formats)) return;
+
+            const auto                 names = getInstanceColumnNames(type);
+            std::array<std::string, N> columns;
+            // Add 1 to account for integer primary key column.
+            for (size_t i = 0; i < N; i++) columns[i] = names.at(i + 1);
+            *this = ExternalIdWriter(
+              type.getInstanceTable().getDatabase(), type.getInstanceTable().getName(), columns, formats, where);
+        }
+
+        /**
+         * \brief Get the id of the external value of a column, set by writeBlob.
+         * \param index Column index.
+         * \return Id. 0 if the value is not external.
+         */
+        [[nodiscard]] int64_t& operator[](const size_t index) noexcept { return ids[index]; }
+
+        /**
+         * \brief Write all ids that were set and clear them.
+         * \tparam F Callable binding parameter ?2, if any.
+         * \param bind Callable.
+         */
+        template<typename F>
+        void write(F&& bind)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                if (ids[i] == 0) continue;
+
+                ScopedReset reset{statements[i]};
+
+                statements[i].bind(1, std::exchange(ids[i], 0));
+                bind(statements[i]);
+                statements[i].step();
+            }
+        }
+
+        /**
+         * \brief Clear all ids without writing them.
+         */
+        void clear() noexcept { ids.fill(0); }
+
+    private:
+        std::array<RawStatement, N> statements;
+
+        std::array<int64_t, N> ids{};
+    };
+
+    /**
+     * \brief Get an expression that resolves a column holding content keys to the shared blob.
+     * \param column Qualified and quoted column.
+     * \return SQL expression.
+     */
+    [[nodiscard]] inline std::string getSharedBlobExpression(const std::string& column)
+    {
+        return std::format("(SELECT value FROM {} WHERE key = {})", quoteIdentifier(BlobStore::getTableName()), column);
+    }
+
+    /**
+     * \brief Build a list of all columns of the instance table of a type, in order. Deduplicated columns are resolved
+     * to the shared blob.
+     * \tparam N Number of members.
+     * \param type Type.
+     * \param formats Format of each member, starting with the UUID member.
+     * \param prefix Prefix of each column, e.g. a table alias followed by a dot.
+     * \return SQL string.
+     */
+    template<size_t N>
+    [[nodiscard]] std::string
+      selectInstanceColumns(const Type& type, const std::array<BlobFormat, N>& formats, const std::string& prefix = "")
+    {
+        const auto  names = getInstanceColumnNames(type);
+        std::string columns;
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            const auto column = prefix + quoteIdentifier(names[i]);
+            if (i > 0) columns += ", ";
+            // Add 1 to account for integer primary key column.
+            if (i > 0 && i <= N && formats[i - 1].deduplicated)
+                columns += getSharedBlobExpression(column);
+            else
+                columns += column;
+        }
+        return columns;
+    }
+
+    /**
+     * \brief Build a statement selecting all columns of the instance table of a type by UUID, in order. Deduplicated
+     * columns are resolved to the shared blob.
+     * \tparam N Number of members.
+     * \param type Type.
+     * \param formats Format of each member, starting with the UUID member.
+     * \return SQL string.
+     */
+    template<size_t N>
+    [[nodiscard]] std::string selectInstanceSql(const Type& type, const std::array<BlobFormat, N>& formats)
+    {
+        return std::format("SELECT {} FROM {} WHERE uuid = ?1;",
+                           selectInstanceColumns(type, formats),
+                           quoteIdentifier(type.getInstanceTable().getName()));
+    }
+
+    /**
+     * \brief Size of the elements of a blob value, i.e. of the vector elements or of the value itself.
+     */
+    template<typename V>
+    [[nodiscard]] constexpr size_t getElementSize() noexcept
+    {
+        if constexpr (IsVector<V>::value)
+            return sizeof(typename V::value_type);
+        else
+            return sizeof(V);
+    }
+
+    /**
+     * \brief Get the bytes of a blob value.
+     * \tparam V Value type, either a trivially copyable type or a std::vector thereof.
+     * \param value Value.
+     * \return Bytes.
+     */
+    template<typename V>
+    [[nodiscard]] std::span<const std::byte> getValueBytes(const V& value) noexcept
+    {
+        if constexpr (IsVector<V>::value)
+            return std::as_bytes(std::span(value));
+        else
+            return std::as_bytes(std::span(&value, 1));
+    }
+
+    /**
+     * \brief Prepare a blob value for writing: encode it and, if it is deduplicated, put it in the shared blob table
+     * or, if it is large enough, in the external store.
+     * \tparam V Value type, either a trivially copyable type or a std::vector thereof.
+     * \param format Format. Must not be plain.
+     * \param value Value.
+     * \param buffer Buffer the encoded value or content key is written to.
+     * \param stores Stores. Only used if the format is deduplicated or has an external threshold.
+     * \param externalId Set to the id of the external value, or to 0 if the value is not external. In the former case,
+     * null is returned and the id must be written to the column afterwards (see ExternalIdWriter).
+     * \return Blob pointing to the value or buffer.
+     */
+    template<typename V>
+    [[nodiscard]] sql::StaticBlob writeBlob(const BlobFormat&       format,
+                                            const V&                value,
+                                            std::vector<std::byte>& buffer,
+                                            BlobStores&             stores,
+                                            int64_t&                externalId)
+    {
+        externalId = 0;
+
+        auto bytes = getValueBytes(value);
+
+        if (format.codec != Codec::None)
+        {
+            encode(format.codec, getElementSize<V>(), bytes, buffer);
+            bytes = buffer;
+        }
+
+        if (format.isExternal(bytes.size()))
+        {
+            externalId = stores.external->put(bytes);
+            buffer.clear();
+        }
+        else if (format.deduplicated)
+        {
+            const auto key = stores.shared.put(bytes);
+            buffer.assign(key.begin(), key.end());
+        }
+        else if (format.codec == Codec::None)
+            return sql::toStaticBlob(value);
+
+        return sql::toStaticBlob(buffer);
+    }
+
+    /**
+     * \brief Prepare a blob value for writing (see writeBlob) and bind it to a parameter of a statement. External
+     * values are bound as their id, so no separate ExternalIdWriter is needed.
+     * \tparam V Value type, either a trivially copyable type or a std::vector thereof.
+     * \param stmt Statement.
+     * \param index Parameter index.
+     * \param format Format.
+     * \param value Value.
+     * \param buffer Buffer the encoded value or content key is written to. Must outlive the execution of the statement.
+     * \param stores Stores. Only used if the format is deduplicated or has an external threshold.
+     */
+    template<typename V>
+    void bindBlobValue(RawStatement&           stmt,
+                       const int32_t           index,
+                       const BlobFormat&       format,
+                       const V&                value,
+                       std::vector<std::byte>& buffer,
+                       BlobStores&             stores)
+    {
+        if (format.isPlain())
+        {
+            stmt.bindBlob(index, getValueBytes(value));
+            return;
+        }
+
+        int64_t externalId = 0;
+        static_cast<void>(writeBlob(format, value, buffer, stores, externalId));
+        if (externalId != 0)
+            stmt.bind(index, externalId);
+        else if (format.deduplicated || format.codec != Codec::None)
+            stmt.bindBlob(index, buffer);
+        else
+            stmt.bindBlob(index, getValueBytes(value));
+    }
+
+    /**
+     * \brief Get the stored bytes of a blob column, resolving external values through the memory mapped pack file.
+     * \param stmt Statement positioned on a row.
+     * \param column Column index.
+     * \param external External store. May be null if the column has no external threshold.
+     * \param view View that keeps an external value mapped while the returned bytes are in use.
+     * \return Stored bytes.
+     */
+    [[nodiscard]] inline std::span<const std::byte>
+      getStoredBlob(const RawStatement& stmt, const int32_t column, const ExternalStore* external, BlobView& view)
+    {
+        // External values are stored as the integer id of the value, inline values as blobs.
+        if (external && stmt.isInteger(column))
+        {
+            view = external->get(stmt.getInt64(column));
+            return view.get();
+        }
+        return stmt.getBlob(column);
+    }
+
+    /**
+     * \brief Decode a blob value, or copy it if there is no codec.
+     * \tparam V Value type, either a trivially copyable type or a std::vector thereof.
+     * \param codec Codec.
+     * \param bytes Stored value.
+     * \param buffer Scratch buffer.
+     * \return Value.
+     */
+    template<typename V>
+    [[nodiscard]] V decodeBlob(const Codec codec, std::span<const std::byte> bytes, std::vector<std::byte>& buffer)
+    {
+        if (codec != Codec::None)
+        {
+            decode(bytes, buffer);
+            bytes = buffer;
+        }
+
+        V value{};
+        if constexpr (IsVector<V>::value)
+        {
+            constexpr auto size = getElementSize<V>();
+            if (bytes.size() % size != 0)
+                throw std::runtime_error(std::format("Size of blob is not a multiple of {} bytes.", size));
+            value.resize(bytes.size() / size);
+            if (!value.empty()) std::memcpy(value.data(), bytes.data(), bytes.size());
+        }
+        else if (!bytes.empty())
+        {
+            if (bytes.size() != sizeof(V)) throw std::runtime_error("Size of blob does not match size of value.");
+            std::memcpy(&value, bytes.data(), sizeof(V));
+        }
+        return value;
+    }
+
+    /**
+     * \brief Read a column of the current row of a statement as an element of a primitive or string array.
+     * \tparam V Element type.
+     * \param stmt Statement positioned on a row.
+     * \param column Column index.
+     * \return Element.
+     */
+    template<typename V>
+    [[nodiscard]] V readElement(const RawStatement& stmt, const int32_t column)
+    {
+        if constexpr (std::same_as<V, std::string>)
+            return std::string(stmt.getText(column));
+        else if constexpr (std::floating_point<V>)
+            return static_cast<V>(stmt.getDouble(column));
+        else
+            return static_cast<V>(stmt.getInt64(column));
+    }
+
+    /**
+     * \brief Read a column of the current row of a statement into a member of an instance.
+     * \tparam M Member.
+     * \tparam O Object type.
+     * \param stmt Statement positioned on a row.
+     * \param column Column index.
+     * \param format Format of the column.
+     * \param buffer Scratch buffer for decoding.
+     * \param external External store. May be null if the column has no external threshold.
+     * \param instance Instance.
+     */
+    template<typename M, typename O>
+    void readColumn(const RawStatement&     stmt,
+                    const int32_t           column,
+                    const BlobFormat&       format,
+                    std::vector<std::byte>& buffer,
+                    const ExternalStore*    external,
+                    O&                      instance)
+    {
+        BlobView   view;
+        const auto codec = stmt.isNull(column) ? Codec::None : format.codec;
+        if constexpr (M::is_primitive_blob)
+            M::template get(instance).set(decodeBlob<std::vector<typename M::value_t::value_t>>(
+              codec, getStoredBlob(stmt, column, external, view), buffer));
+        else if constexpr (M::is_blob)
+            M::template get(instance).set(decodeBlob<typename M::value_t::value_t>(
+              codec, getStoredBlob(stmt, column, external, view), buffer));
+        else if constexpr (M::is_instance_id || M::is_string || M::is_reference)
+            M::template get(instance) = std::string(stmt.getText(column));
+        else if constexpr (M::is_primitive && std::floating_point<typename M::value_t>)
+            M::template get(instance) = static_cast<typename M::value_t>(stmt.getDouble(column));
+        else if constexpr (M::is_primitive)
+            M::template get(instance) = static_cast<typename M::value_t>(stmt.getInt64(column));
+        else
+            constexpr_static_assert();
+    }
+}  // namespace alex::detail
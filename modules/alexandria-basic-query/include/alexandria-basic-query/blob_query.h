@@ -0,0 +1,338 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_stream.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/pack_file.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/properties/instance_id.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/utils.h"
+
+namespace alex
+{
+    namespace detail
+    {
+        template<MemberName Name, typename T>
+        using primitive_member_t =
+          std::tuple_element_t<getColumnIndex<Name, extract_primitive_members_t<typename T::members_t>>(),
+                               extract_primitive_members_t<typename T::members_t>>;
+
+        template<MemberName Name, typename T>
+        concept is_blob_member_name = is_primitive_member_name<Name, T> &&
+                                      (primitive_member_t<Name, T>::is_blob ||
+                                       primitive_member_t<Name, T>::is_primitive_blob);
+
+        /**
+         * \brief Location of a blob value in the instance table or, if it is deduplicated, in the shared blob table. If
+         * it is external, the id of the value in the external store.
+         */
+        struct BlobLocation
+        {
+            std::string table;
+            std::string column;
+            int64_t     rowid = 0;
+            bool        null  = false;
+
+            /**
+             * \brief Name of the instance table column of the member.
+             */
+            std::string name;
+
+            BlobFormat format;
+
+            /**
+             * \brief Id of the value in the external store. 0 if the value is stored in the database.
+             */
+            int64_t external = 0;
+        };
+
+        /**
+         * \brief Look up the table, column and row that hold a blob member of an instance.
+         * \tparam M MemberName.
+         * \tparam T TypeDescriptor.
+         * \param desc TypeDescriptor instance.
+         * \param id Instance ID.
+         * \return BlobLocation.
+         */
+        template<MemberName M, typename T>
+        [[nodiscard]] BlobLocation locateBlob(const T& desc, const InstanceId& id)
+        {
+            auto&        type = desc.getType();
+            auto&        db   = type.getInstanceTable().getDatabase();
+            const auto&  instanceTable = type.getInstanceTable().getName();
+            BlobLocation location{.table = instanceTable};
+
+            // Add 1 to account for integer primary key column.
+            constexpr auto index = getColumnIndex<M, extract_primitive_members_t<typename T::members_t>>() + 1;
+            {
+                RawStatement stmt(db, "SELECT name FROM pragma_table_info(?1) WHERE cid = ?2;", false);
+                stmt.bind(1, instanceTable);
+                stmt.bind(2, index);
+                if (!stmt.step())
+                    throw std::runtime_error(
+                      std::format(R"(Instance table "{}" has no column {}.)", instanceTable, index));
+                location.column = stmt.getText(0);
+            }
+            location.name   = location.column;
+            location.format = getBlobFormat(type, location.column);
+
+            // Deduplicated values live in the shared blob table, the instance table only holds their key. External
+            // values live in the pack file, the instance table only holds their id.
+            const auto sql = location.format.deduplicated ?
+                               std::format("SELECT b.id, b.id IS NULL, 0 FROM {0} AS i LEFT JOIN {1} AS b ON b.key = "
+                                           "i.{2} WHERE i.uuid = ?1;",
+                                           quoteIdentifier(instanceTable),
+                                           quoteIdentifier(BlobStore::getTableName()),
+                                           quoteIdentifier(location.column)) :
+                               std::format("SELECT rowid, {0} IS NULL, CASE WHEN typeof({0}) = 'integer' THEN {0} "
+                                           "ELSE 0 END FROM {1} WHERE uuid = ?1;",
+                                           quoteIdentifier(location.column),
+                                           quoteIdentifier(instanceTable));
+            if (location.format.deduplicated)
+            {
+                location.table  = BlobStore::getTableName();
+                location.column = "value";
+            }
+
+            RawStatement stmt(db, sql, false);
+            stmt.bind(1, id.getAsString());
+            if (!stmt.step())
+                throw std::runtime_error(
+                  std::format("Cannot open blob of instance {}. It does not exist.", id.getAsString()));
+            location.rowid = stmt.getInt64(0);
+            location.null     = stmt.getInt64(1) != 0;
+            location.external = location.format.externalThreshold > 0 ? stmt.getInt64(2) : 0;
+            return location;
+        }
+
+        /**
+         * \brief Throw if a blob is stored encoded or externally, in which case its bytes cannot be accessed
+         * incrementally.
+         * \param location BlobLocation.
+         */
+        inline void checkIncremental(const BlobLocation& location)
+        {
+            if (location.external != 0)
+                throw std::runtime_error(std::format(
+                  R"(Cannot open blob "{}" for incremental access. It is stored externally, use alex::viewBlob.)",
+                  location.name));
+            if (location.format.codec != Codec::None)
+                throw std::runtime_error(std::format(R"(Cannot open blob "{}" for incremental access. It is encoded )"
+                                                     R"(with codec "{}".)",
+                                                     location.name,
+                                                     toString(location.format.codec)));
+        }
+
+        /**
+         * \brief Throw if a blob is deduplicated, in which case its bytes are shared with other instances and cannot be
+         * written in place.
+         * \param location BlobLocation.
+         */
+        inline void checkWritable(const BlobLocation& location)
+        {
+            if (location.format.deduplicated)
+                throw std::runtime_error(std::format(
+                  R"(Cannot open blob "{}" for incremental writing. It is deduplicated.)", location.name));
+        }
+    }  // namespace detail
+
+    /**
+     * \brief Open a blob or primitive blob member of an instance for incremental reading, without loading it in full.
+     * Not supported for members with a codec or for external values. Deduplicated members are read from the shared blob
+     * table.
+     *
+     * \code
+     * auto reader = alex::openBlobReader<"vertices">(desc, mesh.id);
+     * std::vector<float3> chunk(1024);
+     * reader.read(std::span(chunk), 0);
+     * \endcode
+     *
+     * \tparam M MemberName.
+     * \tparam T TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \param id Instance ID.
+     * \return BlobReader.
+     */
+    template<detail::MemberName M, is_type_descriptor T>
+        requires(detail::is_blob_member_name<M, T>)
+    [[nodiscard]] BlobReader openBlobReader(const T& desc, const InstanceId& id)
+    {
+        const auto location = detail::locateBlob<M>(desc, id);
+        detail::checkIncremental(location);
+        return BlobReader(
+          desc.getType().getInstanceTable().getDatabase(), location.table, location.column, location.rowid);
+    }
+
+    /**
+     * \brief Open a blob or primitive blob member of an instance for incremental reading and writing. The size of the
+     * blob is not changed. Not supported for members with a codec, that are deduplicated, or for external values.
+     * \tparam M MemberName.
+     * \tparam T TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \param id Instance ID.
+     * \return BlobWriter.
+     */
+    template<detail::MemberName M, is_type_descriptor T>
+        requires(detail::is_blob_member_name<M, T>)
+    [[nodiscard]] BlobWriter openBlobWriter(const T& desc, const InstanceId& id)
+    {
+        const auto location = detail::locateBlob<M>(desc, id);
+        detail::checkIncremental(location);
+        detail::checkWritable(location);
+        return BlobWriter(
+          desc.getType().getInstanceTable().getDatabase(), location.table, location.column, location.rowid);
+    }
+
+    /**
+     * \brief Replace a blob or primitive blob member of an instance with a zero-filled blob of the given size and open
+     * it for writing. This allows streaming a large buffer into the database in chunks, without ever holding it in
+     * memory in full. Not supported for members with a codec, that are deduplicated, or for external values.
+     *
+     * \code
+     * auto writer = alex::openBlobWriter<"vertices">(desc, mesh.id, count * sizeof(float3));
+     * for (int64_t offset = 0; offset < writer.size(); offset += chunk.size() * sizeof(float3))
+     *     writer.write(std::span(generateChunk(chunk)), offset);
+     * \endcode
+     *
+     * \tparam M MemberName.
+     * \tparam T TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \param id Instance ID.
+     * \param size Size in bytes.
+     * \return BlobWriter.
+     */
+    template<detail::MemberName M, is_type_descriptor T>
+        requires(detail::is_blob_member_name<M, T>)
+    [[nodiscard]] BlobWriter openBlobWriter(const T& desc, const InstanceId& id, const int64_t size)
+    {
+        auto&      db       = desc.getType().getInstanceTable().getDatabase();
+        const auto location = detail::locateBlob<M>(desc, id);
+        detail::checkIncremental(location);
+        detail::checkWritable(location);
+        allocateBlob(db, location.table, location.column, location.rowid, size);
+        return BlobWriter(db, location.table, location.column, location.rowid);
+    }
+
+    /**
+     * \brief Load a blob or primitive blob member of an instance that was skipped by a GetQuery with
+     * BlobLoading::Lazy. Reads the value directly into the member, unless it is encoded and needs to be decoded first.
+     * External values are copied from the memory mapped pack file.
+     * \tparam M MemberName.
+     * \tparam T TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \param instance Instance with a valid ID.
+     */
+    template<detail::MemberName M, is_type_descriptor T>
+        requires(detail::is_blob_member_name<M, T>)
+    void loadBlob(const T& desc, typename T::object_t& instance)
+    {
+        using member_t = detail::primitive_member_t<M, T>;
+
+        const auto& id       = T::uuid_member_t::template get(instance);
+        const auto  location = detail::locateBlob<M>(desc, id);
+        auto&       member   = member_t::template get(instance);
+
+        const auto read = [&]<typename E>(std::vector<E> values) {
+            if (location.external != 0)
+            {
+                const auto             view = detail::getExternalStore(desc.getType()).get(location.external);
+                std::vector<std::byte> buffer;
+                return detail::decodeBlob<std::vector<E>>(location.format.codec, view.get(), buffer);
+            }
+            if (!location.null)
+            {
+                const BlobReader reader(desc.getType().getInstanceTable().getDatabase(),
+                                        location.table,
+                                        location.column,
+                                        location.rowid);
+                if (location.format.codec != Codec::None)
+                {
+                    std::vector<std::byte> encoded(static_cast<size_t>(reader.size())), buffer;
+                    reader.read(std::span(encoded), 0);
+                    return detail::decodeBlob<std::vector<E>>(location.format.codec, encoded, buffer);
+                }
+                if (reader.size() % static_cast<int64_t>(sizeof(E)) != 0)
+                    throw std::runtime_error(std::format(R"(Size of blob "{}" is not a multiple of {} bytes.)",
+                                                         location.name,
+                                                         sizeof(E)));
+                values.resize(static_cast<size_t>(reader.size()) / sizeof(E));
+                reader.read(std::span(values), 0);
+            }
+            return values;
+        };
+
+        using value_t = typename member_t::value_t::value_t;
+        if constexpr (member_t::is_primitive_blob)
+            member.set(read(std::vector<value_t>{}));
+        else if constexpr (detail::IsVector<value_t>::value)
+            member.set(read(value_t{}));
+        else
+        {
+            auto values = read(std::vector<value_t>{});
+            if (values.size() != 1)
+                throw std::runtime_error(
+                  std::format(R"(Size of blob "{}" does not match size of value.)", location.name));
+            member.set(std::move(values.front()));
+        }
+    }
+
+    /**
+     * \brief Get a read only view of the stored bytes of a blob or primitive blob member of an instance. External
+     * values are viewed in the memory mapped pack file without copying, and can be reinterpreted with BlobView::as.
+     * Other values are copied out of the database. Values of members with a codec are returned encoded, use
+     * alex::decode to decode them.
+     *
+     * \code
+     * const auto view     = alex::viewBlob<"vertices">(desc, mesh.id);
+     * const auto vertices = view.as<float3>();
+     * \endcode
+     *
+     * \tparam M MemberName.
+     * \tparam T TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \param id Instance ID.
+     * \return BlobView. Empty if the value is null.
+     */
+    template<detail::MemberName M, is_type_descriptor T>
+        requires(detail::is_blob_member_name<M, T>)
+    [[nodiscard]] BlobView viewBlob(const T& desc, const InstanceId& id)
+    {
+        const auto location = detail::locateBlob<M>(desc, id);
+        if (location.external != 0) return detail::getExternalStore(desc.getType()).get(location.external);
+        if (location.null) return {};
+
+        const BlobReader reader(
+          desc.getType().getInstanceTable().getDatabase(), location.table, location.column, location.rowid);
+        auto bytes = std::make_shared<std::vector<std::byte>>(static_cast<size_t>(reader.size()));
+        reader.read(std::span(*bytes), 0);
+        return {bytes, *bytes};
+    }
+}  // namespace alex
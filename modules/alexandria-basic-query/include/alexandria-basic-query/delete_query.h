@@ -12,6 +12,7 @@
 
 #include "alexandria-core/library.h"
 #include "alexandria-core/namespace.h"
+#include "alexandria-core/query_observer.h"
 #include "alexandria-core/type.h"
 
 ////////////////////////////////////////////////////////////////
@@ -84,18 +85,24 @@ namespace alex
 
         virtual bool operator()(const InstanceId& id)
         {
+            Type&        type    = descriptor.getType();
+            auto&        library = type.getNamespace().getLibrary();
+            QueryProfile profile(library, type, QueryClass::Delete);
             try
             {
                 // Update parameter.
+                profile.stage(QueryStage::Uuid);
                 *uuidParam = id.getAsString();
 
                 // Start transaction.
-                Type&            type = descriptor.getType();
-                auto&            db   = type.getNamespace().getLibrary().getDatabase();
+                profile.stage(QueryStage::Begin);
+                auto&            db = library.getDatabase();
                 sql::Transaction transaction(db, sql::Transaction::Type::Deferred);
 
+                profile.stage(QueryStage::Primitive);
                 primitiveDeleter();
 
+                profile.stage(QueryStage::Commit);
                 transaction.commit();
 
                 return db.getChanges() > 0;
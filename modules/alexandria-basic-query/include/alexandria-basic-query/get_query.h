@@ -4,14 +4,21 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <concepts>
+#include <format>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/external_store.h"
 #include "alexandria-core/library.h"
 #include "alexandria-core/namespace.h"
+#include "alexandria-core/query_observer.h"
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 #include "cppql/core/transaction.h"
 
@@ -19,19 +26,40 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/row_view.h"
 #include "alexandria-basic-query/utils.h"
+#include "alexandria-basic-query/getters/array_slice_getter.h"
 #include "alexandria-basic-query/getters/blob_array_getter.h"
+#include "alexandria-basic-query/getters/non_blob_primitive_getter.h"
 #include "alexandria-basic-query/getters/primitive_array_getter.h"
 #include "alexandria-basic-query/getters/primitive_getter.h"
 #include "alexandria-basic-query/getters/reference_array_getter.h"
 
 namespace alex
 {
+    /**
+     * \brief Controls how a GetQuery retrieves single blob and primitive blob members.
+     */
+    enum class BlobLoading
+    {
+        /**
+         * \brief Retrieve blobs together with all other members.
+         */
+        Eager = 0,
+
+        /**
+         * \brief Skip blobs. They can be retrieved afterwards with loadBlob or openBlobReader.
+         */
+        Lazy = 1
+    };
+
     /**
      * \brief
      * \tparam T TypeDescriptor.
+     * \tparam B Whether to skip blob members.
      */
-    template<typename T>
+    template<typename T, BlobLoading B = BlobLoading::Eager>
     class GetQuery
     {
     public:
@@ -41,10 +69,14 @@ namespace alex
 
         using type_descriptor_t        = T;
         using object_t                 = typename type_descriptor_t::object_t;
-        using primitive_getter_t       = PrimitiveGetter<type_descriptor_t>;
+        using primitive_getter_t       = std::conditional_t<B == BlobLoading::Eager,
+                                                      PrimitiveGetter<type_descriptor_t>,
+                                                      NonBlobPrimitiveGetter<type_descriptor_t>>;
         using primitive_array_getter_t = PrimitiveArrayGetter<type_descriptor_t>;
         using blob_array_getter_t      = BlobArrayGetter<type_descriptor_t>;
         using reference_array_getter_t = ReferenceArrayGetter<type_descriptor_t>;
+        using slice_getter_t           = detail::ArraySliceGetter<type_descriptor_t>;
+        using row_view_t               = RowView<type_descriptor_t>;
 
         ////////////////////////////////////////////////////////////////
         // Constructors.
@@ -62,7 +94,8 @@ namespace alex
             primitiveGetter(desc, *uuidParam),
             primitiveArrayGetter(desc, *uuidParam),
             blobArrayGetter(desc, *uuidParam),
-            referenceArrayGetter(desc, *uuidParam)
+            referenceArrayGetter(desc, *uuidParam),
+            sliceGetter(desc)
         {
         }
 
@@ -106,22 +139,31 @@ namespace alex
             if (!type_descriptor_t::uuid_member_t::template get(instance).valid())
                 throw std::runtime_error("Cannot retrieve instance. It does not have a valid UUID.");
 
-            Type& type = descriptor.getType();
-            auto& db   = type.getNamespace().getLibrary().getDatabase();
+            Type&        type    = descriptor.getType();
+            auto&        library = type.getNamespace().getLibrary();
+            auto&        db      = library.getDatabase();
+            QueryProfile profile(library, type, QueryClass::Get);
             try
             {
                 // Update parameter.
+                profile.stage(QueryStage::Uuid);
                 *uuidParam = type_descriptor_t::uuid_member_t::template get(instance).getAsString();
 
                 // Start transaction.
+                profile.stage(QueryStage::Begin);
                 sql::Transaction transaction(db, sql::Transaction::Type::Deferred);
 
                 // Run all statements.
+                profile.stage(QueryStage::Primitive);
                 primitiveGetter(instance);
+                profile.stage(QueryStage::PrimitiveArray);
                 primitiveArrayGetter(instance);
+                profile.stage(QueryStage::BlobArray);
                 blobArrayGetter(instance);
+                profile.stage(QueryStage::ReferenceArray);
                 referenceArrayGetter(instance);
 
+                profile.stage(QueryStage::Commit);
                 transaction.commit();
             }
             catch (...)
@@ -131,16 +173,94 @@ namespace alex
             }
         }
 
+        ////////////////////////////////////////////////////////////////
+        // Visit.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Read an instance without materializing it. The callback receives a RowView of the instance table row,
+         * which exposes strings and blobs as views directly into the statement buffers, the shared blobs of
+         * deduplicated members and the pack file of external members. These are only valid for the duration of the
+         * callback. Array members are not visited, and members with a codec cannot be viewed.
+         *
+         * \code
+         * getter.visit(id, [&](const alex::RowView<MeshDescriptor>& row) {
+         *     const auto vertices = row.get<"vertices">();
+         *     upload(vertices.data(), vertices.size());
+         * });
+         * \endcode
+         *
+         * \tparam F Callback type.
+         * \param id Instance ID.
+         * \param f Callback.
+         */
+        template<typename F>
+            requires(std::invocable<F&, RowView<type_descriptor_t>>)
+        void visit(const InstanceId& id, F&& f)
+        {
+            if (!id.valid()) throw std::runtime_error("Cannot visit instance. It does not have a valid UUID.");
+
+            // Prepare statement on first use.
+            if (!visitStatement.get())
+            {
+                auto& type     = descriptor.getType();
+                visitFormats   = detail::getBlobFormats<typename row_view_t::members_t>(type);
+                visitStatement = RawStatement(type.getNamespace().getLibrary().getDatabase(),
+                                              detail::selectInstanceSql(type, visitFormats));
+                if (detail::hasExternal(visitFormats)) visitExternal = &detail::getExternalStore(type);
+            }
+
+            // Always reset the statement, so that the database is not kept locked by a pending read.
+            ScopedReset reset{visitStatement};
+
+            visitStatement.bind(1, id.getAsString());
+            if (!visitStatement.step())
+                throw std::runtime_error(std::format("Cannot visit instance {}. It does not exist.", id.getAsString()));
+            detail::visitRow<type_descriptor_t>(f, visitStatement, visitFormats, visitExternal);
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Slice.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Retrieve a range of elements of an array member, without retrieving the rest of the array or the
+         * instance. Elements are read in order through the (instance, position) index of the array table. Elements
+         * past the end of the array are ignored, so the result can be shorter than count.
+         *
+         * \code
+         * const auto nodes = getter.getSlice<"nodes">(sceneId, 1000000, 100);
+         * \endcode
+         *
+         * \tparam M Member name of a primitive, string, blob or reference array.
+         * \param id Instance ID.
+         * \param begin Index of first element.
+         * \param count Number of elements.
+         * \return Vector of elements. References are returned as InstanceIds.
+         */
+        template<detail::MemberName M>
+            requires(detail::is_array_member_name<M, type_descriptor_t>)
+        [[nodiscard]] auto getSlice(const InstanceId& id, const size_t begin, const size_t count)
+        {
+            if (!id.valid())
+                throw std::runtime_error("Cannot retrieve array slice. Instance does not have a valid UUID.");
+            return sliceGetter.template get<M>(id.getAsString(), begin, count);
+        }
+
     private:
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
-        type_descriptor_t            descriptor;
-        std::unique_ptr<std::string> uuidParam;
-        primitive_getter_t           primitiveGetter;
-        primitive_array_getter_t     primitiveArrayGetter;
-        blob_array_getter_t          blobArrayGetter;
-        reference_array_getter_t     referenceArrayGetter;
+        type_descriptor_t              descriptor;
+        std::unique_ptr<std::string>   uuidParam;
+        primitive_getter_t             primitiveGetter;
+        primitive_array_getter_t       primitiveArrayGetter;
+        blob_array_getter_t            blobArrayGetter;
+        reference_array_getter_t       referenceArrayGetter;
+        RawStatement                   visitStatement;
+        typename row_view_t::formats_t visitFormats{};
+        const ExternalStore*           visitExternal = nullptr;
+        slice_getter_t                 sliceGetter;
     };
 }  // namespace alex
@@ -0,0 +1,233 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/pack_file.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/properties/instance_id.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/packed_array.h"
+#include "alexandria-basic-query/utils.h"
+#include "alexandria-basic-query/types/member_extractor.h"
+
+namespace alex::detail
+{
+    /**
+     * \brief The ArraySliceGetter retrieves a range of elements of a single array member, using the (instance,
+     * position) index of its array table. Statements are prepared on first use of each member.
+     * \tparam T TypeDescriptor.
+     */
+    template<typename T>
+    class ArraySliceGetter
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using type_descriptor_t         = T;
+        using primitive_array_members_t = extract_primitive_array_members_t<typename type_descriptor_t::members_t>;
+        using blob_array_members_t      = extract_blob_array_members_t<typename type_descriptor_t::members_t>;
+        using reference_array_members_t = extract_reference_array_members_t<typename type_descriptor_t::members_t>;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ArraySliceGetter() = delete;
+
+        explicit ArraySliceGetter(const type_descriptor_t& desc) : type(&desc.getType()) {}
+
+        ArraySliceGetter(const ArraySliceGetter&) = delete;
+
+        ArraySliceGetter(ArraySliceGetter&&) = default;
+
+        ~ArraySliceGetter() noexcept = default;
+
+        ArraySliceGetter& operator=(const ArraySliceGetter&) = delete;
+
+        ArraySliceGetter& operator=(ArraySliceGetter&&) = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Invoke.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Retrieve elements [begin, begin + count) of an array member. Elements past the end of the array are
+         * ignored.
+         * \tparam M Member name.
+         * \param uuid Instance ID.
+         * \param begin Index of first element.
+         * \param count Number of elements.
+         * \return Elements.
+         */
+        template<MemberName M>
+        [[nodiscard]] auto get(const std::string& uuid, const size_t begin, const size_t count)
+        {
+            constexpr auto npos = static_cast<size_t>(-1);
+            if constexpr (constexpr auto i = findColumnIndex<M, primitive_array_members_t>(); i != npos)
+                return getPrimitiveArray<i>(uuid, begin, count);
+            else if constexpr (constexpr auto j = findColumnIndex<M, blob_array_members_t>(); j != npos)
+                return getBlobArray<j>(uuid, begin, count);
+            else
+                return getReferenceArray<findColumnIndex<M, reference_array_members_t>()>(uuid, begin, count);
+        }
+
+    private:
+        template<size_t I>
+        [[nodiscard]] auto getPrimitiveArray(const std::string& uuid, const size_t begin, const size_t count)
+        {
+            using value_t = array_element_t<std::tuple_element_t<I, primitive_array_members_t>>;
+
+            std::vector<value_t> values;
+            auto&                stmt   = primitiveArrayStatements[I];
+            const auto           packed = isPackedArray(*type, I);
+            if (!stmt.get())
+            {
+                // Packed primitive arrays are sliced in the database. Packed strings have variable length and are
+                // unpacked as a whole.
+                const auto& table = *type->getPrimitiveArrayTables()[I];
+                const auto  name  = quoteIdentifier(table.getName());
+                std::string sql;
+                if (packed && std::same_as<value_t, std::string>)
+                    sql = std::format("SELECT value FROM {} WHERE instance = ?1;", name);
+                else if (packed)
+                    sql = std::format("SELECT substr(value, ?2, ?3) FROM {} WHERE instance = ?1;", name);
+                else
+                    sql = std::format("SELECT value FROM {} WHERE instance = ?1 AND position >= ?2 AND position < ?2 + "
+                                      "?3 ORDER BY position;",
+                                      name);
+                stmt = RawStatement(table.getDatabase(), sql);
+            }
+
+            ScopedReset reset{stmt};
+            stmt.bind(1, uuid);
+            if constexpr (std::same_as<value_t, std::string>)
+            {
+                if (packed)
+                {
+                    if (stmt.step()) unpackArray(stmt.getBlob(0), values);
+                    const auto first = std::min(begin, values.size());
+                    const auto last  = first + std::min(count, values.size() - first);
+                    return std::vector<value_t>(std::make_move_iterator(values.begin() + first),
+                                                std::make_move_iterator(values.begin() + last));
+                }
+            }
+            else if (packed)
+            {
+                // substr on blobs counts bytes, starting at 1.
+                stmt.bind(2, static_cast<int64_t>(begin * sizeof(value_t) + 1));
+                stmt.bind(3, static_cast<int64_t>(count * sizeof(value_t)));
+                if (stmt.step()) unpackArray(stmt.getBlob(0), values);
+                return values;
+            }
+
+            bindRange(stmt, begin, count);
+            while (stmt.step()) values.emplace_back(readElement<value_t>(stmt, 0));
+            return values;
+        }
+
+        template<size_t I>
+        [[nodiscard]] auto getBlobArray(const std::string& uuid, const size_t begin, const size_t count)
+        {
+            using value_t = array_element_t<std::tuple_element_t<I, blob_array_members_t>>;
+
+            auto& stmt = blobArrayStatements[I];
+            if (!stmt.get())
+            {
+                blobArrayFormats[I] = getBlobArrayFormat(*type, I);
+                const auto& format  = blobArrayFormats[I];
+                const auto& table   = *type->getBlobArrayTables()[I];
+                if (format.externalThreshold > 0) external = &getExternalStore(*type);
+                stmt = RawStatement(table.getDatabase(),
+                                    std::format("SELECT {} FROM {} AS a WHERE a.instance = ?1 AND a.position >= ?2 AND "
+                                                "a.position < ?2 + ?3 ORDER BY a.position;",
+                                                format.deduplicated ? getSharedBlobExpression("a.value") : "a.value",
+                                                quoteIdentifier(table.getName())));
+            }
+
+            std::vector<value_t> values;
+            ScopedReset          reset{stmt};
+            stmt.bind(1, uuid);
+            bindRange(stmt, begin, count);
+            BlobView view;
+            while (stmt.step())
+                values.emplace_back(decodeBlob<value_t>(stmt.isNull(0) ? Codec::None : blobArrayFormats[I].codec,
+                                                        getStoredBlob(stmt, 0, external, view),
+                                                        buffer));
+            return values;
+        }
+
+        template<size_t I>
+        [[nodiscard]] auto getReferenceArray(const std::string& uuid, const size_t begin, const size_t count)
+        {
+            // Positions of reference arrays are not contiguous after referenced instances were deleted, so skip rows
+            // instead of comparing positions. This still walks the index instead of the table.
+            auto& stmt = referenceArrayStatements[I];
+            if (!stmt.get())
+            {
+                const auto& table = *type->getReferenceArrayTables()[I];
+                stmt              = RawStatement(
+                  table.getDatabase(),
+                  std::format("SELECT value FROM {} WHERE instance = ?1 ORDER BY position LIMIT ?3 OFFSET ?2;",
+                              quoteIdentifier(table.getName())));
+            }
+
+            std::vector<InstanceId> values;
+            ScopedReset             reset{stmt};
+            stmt.bind(1, uuid);
+            bindRange(stmt, begin, count);
+            while (stmt.step()) values.emplace_back(std::string(stmt.getText(0)));
+            return values;
+        }
+
+        static void bindRange(RawStatement& stmt, const size_t begin, const size_t count)
+        {
+            stmt.bind(2, static_cast<int64_t>(begin));
+            stmt.bind(3, static_cast<int64_t>(count));
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        const Type* type = nullptr;
+
+        std::array<RawStatement, std::tuple_size_v<primitive_array_members_t>> primitiveArrayStatements;
+
+        std::array<RawStatement, std::tuple_size_v<blob_array_members_t>> blobArrayStatements;
+
+        std::array<BlobFormat, std::tuple_size_v<blob_array_members_t>> blobArrayFormats{};
+
+        std::array<RawStatement, std::tuple_size_v<reference_array_members_t>> referenceArrayStatements;
+
+        const ExternalStore* external = nullptr;
+
+        std::vector<std::byte> buffer;
+    };
+}  // namespace alex::detail
@@ -4,18 +4,27 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <cstddef>
+#include <format>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/pack_file.h"
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -155,8 +164,19 @@ namespace alex
             ////////////////////////////////////////////////////////////////
 
             BlobArrayGetterImpl(const type_descriptor_t& desc, std::string& uuidParam) :
-                statement(compile(desc, uuidParam))
+                uuid(&uuidParam), statement(compile(desc, uuidParam)), format(getBlobArrayFormat(desc.getType(), I))
             {
+                // Encoded, deduplicated and external values cannot be read by the typed statement, so select them raw.
+                if (!format.isPlain())
+                {
+                    if (format.externalThreshold > 0) external = &getExternalStore(desc.getType());
+                    auto& table = *desc.getType().getBlobArrayTables()[I];
+                    rawStatement =
+                      RawStatement(table.getDatabase(),
+                                   std::format("SELECT {} FROM {} AS a WHERE a.instance = ?1 ORDER BY a.position;",
+                                               format.deduplicated ? getSharedBlobExpression("a.value") : "a.value",
+                                               quoteIdentifier(table.getName())));
+                }
             }
 
             ////////////////////////////////////////////////////////////////
@@ -167,6 +187,22 @@ namespace alex
             {
                 auto& blobArray = member_t::template get(instance);
                 blobArray.clear();
+
+                if (rawStatement.get())
+                {
+                    // Always reset the statement, also when decoding fails.
+                    ScopedReset reset{rawStatement};
+
+                    rawStatement.bind(1, *uuid);
+                    BlobView view;
+                    while (rawStatement.step())
+                        blobArray.add(decodeBlob<typename member_t::value_t::value_t>(
+                          rawStatement.isNull(0) ? Codec::None : format.codec,
+                          getStoredBlob(rawStatement, 0, external, view),
+                          buffer));
+                    return;
+                }
+
                 for (auto v : statement.bind(sql::BindParameters::Dynamic)) { blobArray.add(std::move(v)); }
                 statement.clearBindings();
             }
@@ -179,6 +215,7 @@ namespace alex
                 const auto  table  = table_t(*tables[I]);
                 return table.template selectAs<sql::col_t<2, table_t>, 2>()
                   .where(sql::like(table.template col<1>(), &uuidParam))
+                  .orderBy(sql::ascending(table.template col<3>()))
                   .compile();
             }
 
@@ -186,7 +223,17 @@ namespace alex
             // Member variables.
             ////////////////////////////////////////////////////////////////
 
+            std::string* uuid = nullptr;
+
             statement_t statement;
+
+            BlobFormat format;
+
+            RawStatement rawStatement;
+
+            const ExternalStore* external = nullptr;
+
+            std::vector<std::byte> buffer;
         };
     }  // namespace detail
 
@@ -0,0 +1,161 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-basic-query/utils.h"
+#include "alexandria-basic-query/types/member_extractor.h"
+
+namespace alex
+{
+    /**
+     * \brief The NonBlobPrimitiveGetter handles the retrieval of all columns of the instance table, except for single
+     * blob and primitive blob columns. Those are left untouched, to be read lazily through a BlobReader.
+     * \tparam T TypeDescriptor.
+     */
+    template<typename T>
+    class NonBlobPrimitiveGetter
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief TypeDescriptor.
+         */
+        using type_descriptor_t = T;
+
+        /**
+         * \brief Object type.
+         */
+        using object_t = typename type_descriptor_t::object_t;
+
+        /**
+         * \brief Concatenation of the UUID member and all primitive members.
+         */
+        using members_t = detail::extract_primitive_members_t<typename type_descriptor_t::members_t>;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        NonBlobPrimitiveGetter() = delete;
+
+        NonBlobPrimitiveGetter(const type_descriptor_t& desc, std::string& uuidParam) :
+            uuid(&uuidParam), statement(compile(desc))
+        {
+        }
+
+        NonBlobPrimitiveGetter(const NonBlobPrimitiveGetter&) = delete;
+
+        NonBlobPrimitiveGetter(NonBlobPrimitiveGetter&&) = default;
+
+        ~NonBlobPrimitiveGetter() noexcept = default;
+
+        NonBlobPrimitiveGetter& operator=(const NonBlobPrimitiveGetter&) = delete;
+
+        NonBlobPrimitiveGetter& operator=(NonBlobPrimitiveGetter&&) = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Invoke.
+        ////////////////////////////////////////////////////////////////
+
+        void operator()(object_t& instance)
+        {
+            statement.bind(1, *uuid);
+            if (!statement.step())
+            {
+                statement.reset();
+                statement.clearBindings();
+                throw std::runtime_error(std::format("Cannot retrieve instance {}. It does not exist.", *uuid));
+            }
+
+            int32_t    column = 0;
+            const auto setter = [&]<typename M>(M) {
+                if constexpr (M::is_blob || M::is_primitive_blob)
+                    return;
+                else if constexpr (M::is_instance_id || M::is_string || M::is_reference)
+                    M::template get(instance) = std::string(statement.getText(column++));
+                else if constexpr (M::is_primitive && std::floating_point<typename M::value_t>)
+                    M::template get(instance) = static_cast<typename M::value_t>(statement.getDouble(column++));
+                else if constexpr (M::is_primitive)
+                    M::template get(instance) = static_cast<typename M::value_t>(statement.getInt64(column++));
+                else
+                    constexpr_static_assert();
+            };
+
+            const auto f = [&]<typename... Ms>(std::tuple<Ms...>) { (setter(Ms{}), ...); };
+
+            f(members_t{});
+
+            statement.reset();
+            statement.clearBindings();
+        }
+
+    private:
+        [[nodiscard]] static RawStatement compile(const type_descriptor_t& desc)
+        {
+            auto&       type = desc.getType();
+            auto&       db   = type.getInstanceTable().getDatabase();
+            const auto& name = type.getInstanceTable().getName();
+
+            // Look up the names of all columns of the instance table, in order.
+            std::vector<std::string> names;
+            {
+                RawStatement stmt(db, "SELECT name FROM pragma_table_info(?1) ORDER BY cid;", false);
+                stmt.bind(1, name);
+                while (stmt.step()) names.emplace_back(stmt.getText(0));
+            }
+
+            // Select all non-blob columns. Add 1 to account for integer primary key column.
+            std::string columns;
+            const auto  f = [&]<size_t... Is>(std::index_sequence<Is...>)
+            {
+                (
+                  [&] {
+                      using M = std::tuple_element_t<Is, members_t>;
+                      if constexpr (!M::is_blob && !M::is_primitive_blob)
+                          columns += (columns.empty() ? "" : ", ") + quoteIdentifier(names.at(Is + 1));
+                  }(),
+                  ...);
+            };
+            f(std::make_index_sequence<std::tuple_size_v<members_t>>{});
+
+            return RawStatement(
+              db, std::format("SELECT {} FROM {} WHERE uuid = ?1;", columns, quoteIdentifier(name)));
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::string* uuid = nullptr;
+
+        RawStatement statement;
+    };
+}  // namespace alex
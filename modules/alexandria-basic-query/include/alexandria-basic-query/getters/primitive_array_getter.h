@@ -4,18 +4,23 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <format>
+#include <string>
 #include <type_traits>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/packed_array.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -134,29 +139,20 @@ namespace alex
              */
             using member_t = M;
 
-            /**
-             * \brief TypedTable for the primitive array table.
-             */
-            using table_t = primitive_array_table_t<member_t>;
-
-            /**
-             * \brief Select query type.
-             */
-            using query_t =
-              std::remove_cvref_t<decltype(std::declval<table_t>().template selectAs<sql::col_t<2, table_t>, 2>())>;
-
-            /**
-             * \brief Select statement type.
-             */
-            using statement_t = std::remove_cvref_t<decltype(std::declval<query_t>().compile())>;
-
             ////////////////////////////////////////////////////////////////
             // Constructors.
             ////////////////////////////////////////////////////////////////
 
             PrimitiveArrayGetterImpl(const type_descriptor_t& desc, std::string& uuidParam) :
-                statement(compile(desc, uuidParam))
+                uuid(&uuidParam), packed(isPackedArray(desc.getType(), I))
             {
+                // Compare instance with = instead of LIKE, so that the position index is used. It also returns the
+                // elements in order without a separate sort.
+                const auto& table = *desc.getType().getPrimitiveArrayTables()[I];
+                const auto  sql   = std::format("SELECT value FROM {} WHERE instance = ?1{};",
+                                                quoteIdentifier(table.getName()),
+                                                packed ? "" : " ORDER BY position");
+                statement         = RawStatement(table.getDatabase(), sql);
             }
 
             ////////////////////////////////////////////////////////////////
@@ -167,28 +163,31 @@ namespace alex
             {
                 auto& array = member_t::template get(instance);
                 array.clear();
-                for (auto v : statement.bind(sql::BindParameters::Dynamic)) { array.add(std::move(v)); }
 
-                statement.clearBindings();
-            }
+                ScopedReset reset{statement};
 
-        private:
-            [[nodiscard]] static statement_t compile(const type_descriptor_t& desc, std::string& uuidParam)
-            {
-                const Type& type   = desc.getType();
-                const auto& tables = type.getPrimitiveArrayTables();
-                const auto  table  = table_t(*tables[I]);
-                // TODO: Should this not be ordered by rowid? Same for other array getters.
-                return table.template selectAs<sql::col_t<2, table_t>, 2>()
-                  .where(sql::like(table.template col<1>(), &uuidParam))
-                  .compile();
+                statement.bind(1, *uuid);
+
+                // The whole array is stored as a single blob. There is no row for empty arrays.
+                if (packed)
+                {
+                    if (statement.step()) unpackArray(statement.getBlob(0), array.get());
+                    return;
+                }
+
+                while (statement.step()) array.add(readElement<typename member_t::value_t::value_t>(statement, 0));
             }
 
+        private:
             ////////////////////////////////////////////////////////////////
             // Member variables.
             ////////////////////////////////////////////////////////////////
 
-            statement_t statement;
+            std::string* uuid = nullptr;
+
+            bool packed = false;
+
+            RawStatement statement;
         };
     }  // namespace detail
 
@@ -4,12 +4,30 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/raw_statement.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -17,7 +35,9 @@ namespace alex
 {
     /**
      * \brief The PrimitiveGetter handles the retrieval of all columns of the instance table. This includes not
-     * just integers and floats, but also the UUID and single string, blob and reference columns.
+     * just integers and floats, but also the UUID and single string, blob and reference columns. If any of the blobs
+     * has a codec, is deduplicated or can be external, the row is read through a raw statement that resolves the shared
+     * blobs, so that the blobs can be decoded and external values can be read from the pack file.
      * \tparam T TypeDescriptor.
      */
     template<typename T>
@@ -64,7 +84,16 @@ namespace alex
 
         PrimitiveGetter() = delete;
 
-        PrimitiveGetter(const type_descriptor_t& desc, std::string& uuidParam) : statement(compile(desc, uuidParam)) {}
+        PrimitiveGetter(const type_descriptor_t& desc, std::string& uuidParam) :
+            uuid(&uuidParam),
+            statement(compile(desc, uuidParam)),
+            formats(detail::getBlobFormats<members_t>(desc.getType()))
+        {
+            if (detail::hasEncoding(formats))
+                rawStatement = RawStatement(desc.getType().getInstanceTable().getDatabase(),
+                                            detail::selectInstanceSql(desc.getType(), formats));
+            if (detail::hasExternal(formats)) external = &detail::getExternalStore(desc.getType());
+        }
 
         PrimitiveGetter(const PrimitiveGetter&) = delete;
 
@@ -82,6 +111,12 @@ namespace alex
 
         void operator()(object_t& instance)
         {
+            if (rawStatement.get())
+            {
+                getDecoded(instance);
+                return;
+            }
+
             const auto setter = [&instance]<typename M, typename V>(M, V&& val) {
                 if constexpr (M::is_instance_id || M::is_primitive || M::is_string || M::is_reference)
                     M::template get(instance) = std::forward<V>(val);
@@ -107,6 +142,25 @@ namespace alex
         }
 
     private:
+        void getDecoded(object_t& instance)
+        {
+            // Always reset the statement, also when decoding fails.
+            ScopedReset reset{rawStatement};
+
+            rawStatement.bind(1, *uuid);
+            if (!rawStatement.step())
+                throw std::runtime_error(std::format("Cannot retrieve instance {}. It does not exist.", *uuid));
+
+            // Add 1 to account for integer primary key column.
+            const auto f = [&]<size_t... Is>(std::index_sequence<Is...>)
+            {
+                (detail::readColumn<std::tuple_element_t<Is, members_t>>(
+                   rawStatement, static_cast<int32_t>(Is + 1), formats[Is], buffer, external, instance),
+                 ...);
+            };
+            f(std::make_index_sequence<std::tuple_size_v<members_t>>{});
+        }
+
         [[nodiscard]] static statement_t compile(const type_descriptor_t& desc, std::string& uuidParam)
         {
             const auto table = table_t(desc.getType().getInstanceTable());
@@ -117,6 +171,28 @@ namespace alex
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
+        std::string* uuid = nullptr;
+
         statement_t statement;
+
+        /**
+         * \brief Format of each member.
+         */
+        std::array<detail::BlobFormat, std::tuple_size_v<members_t>> formats;
+
+        /**
+         * \brief Statement selecting the raw row. Only prepared if any member is not plain.
+         */
+        RawStatement rawStatement;
+
+        /**
+         * \brief Store of external blobs. Only set if any member can be external.
+         */
+        const ExternalStore* external = nullptr;
+
+        /**
+         * \brief Scratch buffer for decoding.
+         */
+        std::vector<std::byte> buffer;
     };
 }  // namespace alex
@@ -4,12 +4,15 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <format>
+#include <string>
 #include <type_traits>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 
 ////////////////////////////////////////////////////////////////
@@ -134,29 +137,17 @@ namespace alex
              */
             using member_t = M;
 
-            /**
-             * \brief TypedTable for the reference array table.
-             */
-            using table_t = reference_array_table_t<member_t>;
-
-            /**
-             * \brief Select query type.
-             */
-            using query_t =
-              std::remove_cvref_t<decltype(std::declval<table_t>().template selectAs<sql::col_t<2, table_t>, 2>())>;
-
-            /**
-             * \brief Select statement type.
-             */
-            using statement_t = std::remove_cvref_t<decltype(std::declval<query_t>().compile())>;
-
             ////////////////////////////////////////////////////////////////
             // Constructors.
             ////////////////////////////////////////////////////////////////
 
-            explicit ReferenceArrayGetterImpl(const type_descriptor_t& desc, std::string& uuidParam) :
-                statement(compile(desc, uuidParam))
+            explicit ReferenceArrayGetterImpl(const type_descriptor_t& desc, std::string& uuidParam) : uuid(&uuidParam)
             {
+                // Compare instance with = instead of LIKE, so that the position index is used.
+                const auto& table = *desc.getType().getReferenceArrayTables()[I];
+                const auto  sql   = std::format("SELECT value FROM {} WHERE instance = ?1 ORDER BY position;",
+                                                quoteIdentifier(table.getName()));
+                statement         = RawStatement(table.getDatabase(), sql);
             }
 
             ////////////////////////////////////////////////////////////////
@@ -167,27 +158,21 @@ namespace alex
             {
                 auto& container = member_t::template get(instance).get();
                 container.clear();
-                for (auto v : statement.bind(sql::BindParameters::Dynamic)) { container.emplace_back(std::move(v)); }
 
-                statement.clearBindings();
-            }
+                ScopedReset reset{statement};
 
-        private:
-            [[nodiscard]] static statement_t compile(const type_descriptor_t& desc, std::string& uuidParam)
-            {
-                const Type& type   = desc.getType();
-                const auto& tables = type.getReferenceArrayTables();
-                const auto  table  = table_t(*tables[I]);
-                return table.template selectAs<sql::col_t<2, table_t>, 2>()
-                  .where(sql::like(table.template col<1>(), &uuidParam))
-                  .compile();
+                statement.bind(1, *uuid);
+                while (statement.step()) container.emplace_back(std::string(statement.getText(0)));
             }
 
+        private:
             ////////////////////////////////////////////////////////////////
             // Member variables.
             ////////////////////////////////////////////////////////////////
 
-            statement_t statement;
+            std::string* uuid = nullptr;
+
+            RawStatement statement;
         };
     }  // namespace detail
 
@@ -6,6 +6,7 @@
 
 #include "alexandria-core/library.h"
 #include "alexandria-core/namespace.h"
+#include "alexandria-core/query_observer.h"
 #include "alexandria-core/type.h"
 #include "cppql/core/transaction.h"
 
@@ -68,29 +69,56 @@ namespace alex
         // Invoke.
         ////////////////////////////////////////////////////////////////
 
-        virtual void operator()(object_t& instance)
+        virtual void operator()(object_t& instance) { insert(instance, nullptr); }
+
+        /**
+         * \brief Insert an instance with an ID that was generated beforehand, e.g. to choose the shard of a
+         * ShardedLibrary it is stored in.
+         * \param instance Instance. Must not have a valid ID yet.
+         * \param id Valid ID that is not used by another instance of this type.
+         */
+        void operator()(object_t& instance, const InstanceId& id)
+        {
+            if (!id.valid()) throw std::runtime_error("Cannot insert instance with an invalid UUID.");
+            insert(instance, &id);
+        }
+
+    private:
+        void insert(object_t& instance, const InstanceId* preset)
         {
             // Cannot insert an object that already has a valid ID.
             if (type_descriptor_t::uuid_member_t::template get(instance).valid())
                 throw std::runtime_error("Cannot insert instance. It already has a valid UUID.");
 
-            Type& type = descriptor.getType();
-            auto& db   = type.getNamespace().getLibrary().getDatabase();
+            Type&        type    = descriptor.getType();
+            auto&        library = type.getNamespace().getLibrary();
+            auto&        db      = library.getDatabase();
+            QueryProfile profile(library, type, QueryClass::Insert);
             try
             {
                 // Generate UUID.
+                profile.stage(QueryStage::Uuid);
                 InstanceId id;
-                id.regenerate();
+                if (preset)
+                    id = *preset;
+                else
+                    id.regenerate();
                 const std::string uuidstr = id.getAsString();
                 const auto        uuid    = sql::toStaticText(uuidstr);
 
+                profile.stage(QueryStage::Begin);
                 auto transaction = db.beginTransaction(sql::Transaction::Type::Deferred);
 
+                profile.stage(QueryStage::Primitive);
                 primitiveInserter(instance, uuid);
+                profile.stage(QueryStage::PrimitiveArray);
                 primitiveArrayInserter(instance, uuid);
+                profile.stage(QueryStage::BlobArray);
                 blobArrayInserter(instance, uuid);
+                profile.stage(QueryStage::ReferenceArray);
                 referenceArrayInserter(instance, uuid);
 
+                profile.stage(QueryStage::Commit);
                 transaction.commit();
 
                 // Assign UUID.
@@ -104,7 +132,6 @@ namespace alex
             }
         }
 
-    private:
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -4,18 +4,26 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <cstddef>
 #include <type_traits>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -153,7 +161,17 @@ namespace alex
             // Constructors.
             ////////////////////////////////////////////////////////////////
 
-            explicit BlobArrayInserterImpl(const type_descriptor_t& desc) : statement(compile(desc)) {}
+            explicit BlobArrayInserterImpl(const type_descriptor_t& desc) :
+                statement(compile(desc)),
+                format(getBlobArrayFormat(desc.getType(), I)),
+                stores(makeBlobStores(desc.getType(), std::array{format})),
+                externalIds(desc.getType().getInstanceTable().getDatabase(),
+                            desc.getType().getBlobArrayTables()[I]->getName(),
+                            {"value"},
+                            {format},
+                            "id = last_insert_rowid()")
+            {
+            }
 
             ////////////////////////////////////////////////////////////////
             // Invoke.
@@ -163,13 +181,26 @@ namespace alex
             {
                 const auto& blobArray = member_t::template get(instance);
 
+                // Encode, deduplicate or externalize each value separately, so that they can be retrieved one by one.
+                if (!format.isPlain())
+                {
+                    int64_t position = 0;
+                    for (const auto& v : blobArray.get())
+                    {
+                        statement(nullptr, uuid, writeBlob(format, v, buffer, stores, externalIds[0]), position++);
+                        externalIds.write([](RawStatement&) {});
+                    }
+                    statement.clearBindings();
+                    return;
+                }
+
                 // clang-format off
                 if constexpr (requires { { blobArray.getStaticBlob(std::declval<size_t>()) } -> std::same_as<sql::StaticBlob>;})
-                    for (size_t i = 0; i < blobArray.size(); i++) statement(nullptr, uuid, blobArray.getStaticBlob(i));
+                    for (size_t i = 0; i < blobArray.size(); i++) statement(nullptr, uuid, blobArray.getStaticBlob(i), static_cast<int64_t>(i));
                 else if constexpr (requires { { blobArray.getTransientBlob(std::declval<size_t>()) } -> std::same_as<sql::TransientBlob>; })
-                    for (size_t i = 0; i < blobArray.size(); i++) statement(nullptr, uuid, blobArray.getTransientBlob(i));
+                    for (size_t i = 0; i < blobArray.size(); i++) statement(nullptr, uuid, blobArray.getTransientBlob(i), static_cast<int64_t>(i));
                 else
-                    for (size_t i = 0; i < blobArray.size(); i++) statement(nullptr, uuid, blobArray.getBlob(i));
+                    for (size_t i = 0; i < blobArray.size(); i++) statement(nullptr, uuid, blobArray.getBlob(i), static_cast<int64_t>(i));
                 // clang-format on
 
                 statement.clearBindings();
@@ -189,6 +220,14 @@ namespace alex
             ////////////////////////////////////////////////////////////////
 
             statement_t statement;
+
+            BlobFormat format;
+
+            BlobStores stores;
+
+            ExternalIdWriter<1> externalIds;
+
+            std::vector<std::byte> buffer;
         };
     }  // namespace detail
 
@@ -4,18 +4,22 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <format>
 #include <type_traits>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/packed_array.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -153,7 +157,15 @@ namespace alex
             // Constructors.
             ////////////////////////////////////////////////////////////////
 
-            explicit PrimitiveArrayInserterImpl(const type_descriptor_t& desc) : statement(compile(desc)) {}
+            explicit PrimitiveArrayInserterImpl(const type_descriptor_t& desc) :
+                statement(compile(desc)), packed(isPackedArray(desc.getType(), I))
+            {
+                if (packed)
+                    packedStatement = RawStatement(
+                      desc.getType().getInstanceTable().getDatabase(),
+                      std::format("INSERT INTO {} (instance, value, position) VALUES (?1, ?2, 0);",
+                                  quoteIdentifier(desc.getType().getPrimitiveArrayTables()[I]->getName())));
+            }
 
             ////////////////////////////////////////////////////////////////
             // Invoke.
@@ -161,12 +173,28 @@ namespace alex
 
             void operator()(object_t& instance, const sql::StaticText& uuid)
             {
+                // Store the whole array as a single blob. Empty arrays do not get a row.
+                if (packed)
+                {
+                    const auto& values = member_t::template get(instance).get();
+                    if (values.empty()) return;
+
+                    ScopedReset reset{packedStatement};
+
+                    packArray(values, buffer);
+                    packedStatement.bind(1, type_descriptor_t::uuid_member_t::template get(instance).getAsString());
+                    packedStatement.bindBlob(2, buffer);
+                    packedStatement.step();
+                    return;
+                }
+
+                int64_t position = 0;
                 for (const auto& v : member_t::template get(instance))
                 {
                     if constexpr (member_t::is_string_array)
-                        statement(nullptr, uuid, sql::toStaticText(v));
+                        statement(nullptr, uuid, sql::toStaticText(v), position++);
                     else
-                        statement(nullptr, uuid, v);
+                        statement(nullptr, uuid, v, position++);
                 }
 
                 statement.clearBindings();
@@ -186,12 +214,18 @@ namespace alex
             ////////////////////////////////////////////////////////////////
 
             statement_t statement;
+
+            bool packed = false;
+
+            RawStatement packedStatement;
+
+            std::vector<std::byte> buffer;
         };
     }  // namespace detail
 
     /**
      * \brief The PrimitiveArrayInserter handles the insertion of PrimitiveArray members into their dedicated array
-     * table.
+     * table. Packed arrays are inserted as a single row.
      * \tparam T TypeDescriptor.
      */
     template<typename T>
@@ -4,19 +4,28 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <cstddef>
 #include <format>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/codec.h"
 #include "common/type_traits.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -24,7 +33,9 @@ namespace alex
 {
     /**
      * \brief The PrimitiveInserter handles the insertion of all columns of the instance table. This includes not
-     * just integers and floats, but also the UUID and single string, blob and reference columns.
+     * just integers and floats, but also the UUID and single string, blob and reference columns. Blobs of properties
+     * with a codec are encoded, deduplicated blobs are replaced by their content key, and large blobs of external
+     * properties are replaced by the id of their value in the external store, before they are inserted.
      * \tparam T TypeDescriptor.
      */
     template<typename T>
@@ -71,7 +82,13 @@ namespace alex
 
         PrimitiveInserter() = delete;
 
-        explicit PrimitiveInserter(const type_descriptor_t& desc) : statement(compile(desc)) {}
+        explicit PrimitiveInserter(const type_descriptor_t& desc) :
+            statement(compile(desc)),
+            formats(detail::getBlobFormats<members_t>(desc.getType())),
+            stores(detail::makeBlobStores(desc.getType(), formats)),
+            externalIds(desc.getType(), formats, "id = last_insert_rowid()")
+        {
+        }
 
         PrimitiveInserter(const PrimitiveInserter&) = delete;
 
@@ -89,11 +106,19 @@ namespace alex
 
         void operator()(object_t& instance, const sql::StaticText& uuid)
         {
-            const auto getter = [&]<is_member M>(M) {
+            const auto getter = [&]<is_member M>(M, const size_t index) {
                 if constexpr (M::is_primitive_blob || M::is_blob)
                 {
                     if constexpr (explicitly_convertible_to<decltype(M::template get(instance)), sql::StaticBlob>)
+                    {
+                        if (!formats[index].isPlain())
+                            return detail::writeBlob(formats[index],
+                                                     M::template get(instance).get(),
+                                                     buffers[index],
+                                                     stores,
+                                                     externalIds[index]);
                         return static_cast<sql::StaticBlob>(M::template get(instance));
+                    }
                     else if constexpr (explicitly_convertible_to<decltype(M::template get(instance)),
                                                                  sql::TransientBlob>)
                         return static_cast<sql::TransientBlob>(M::template get(instance));
@@ -110,12 +135,13 @@ namespace alex
                     constexpr_static_assert<false>();
             };
 
-            const auto f = [&]<is_member M, is_member... Ms>(std::tuple<M, Ms...>)
+            const auto f = [&]<size_t... Is>(std::index_sequence<Is...>)
             {
                 try
                 {
                     // Insert nullptr for autoincrement rowid, retrieve member values from instance for other columns.
-                    statement(nullptr, uuid, getter(Ms())...);
+                    // Add 1 to skip the UUID member.
+                    statement(nullptr, uuid, getter(std::tuple_element_t<Is + 1, members_t>(), Is + 1)...);
                 }
                 catch (const sql::SqliteError& e)
                 {
@@ -138,7 +164,10 @@ namespace alex
                 }
             };
 
-            f(members_t{});
+            f(std::make_index_sequence<std::tuple_size_v<members_t> - 1>{});
+
+            // Point the external blob columns of the new row to their values.
+            externalIds.write([](RawStatement&) {});
 
             statement.clearBindings();
         }
@@ -155,5 +184,25 @@ namespace alex
         ////////////////////////////////////////////////////////////////
 
         statement_t statement;
+
+        /**
+         * \brief Format of each member.
+         */
+        std::array<detail::BlobFormat, std::tuple_size_v<members_t>> formats;
+
+        /**
+         * \brief Stores for deduplicated and external blobs.
+         */
+        detail::BlobStores stores;
+
+        /**
+         * \brief Writes the ids of external blobs after the statement is executed.
+         */
+        detail::ExternalIdWriter<std::tuple_size_v<members_t>> externalIds;
+
+        /**
+         * \brief Buffers holding the encoded blobs or content keys of each member until the statement is executed.
+         */
+        std::array<std::vector<std::byte>, std::tuple_size_v<members_t>> buffers;
     };
 }  // namespace alex
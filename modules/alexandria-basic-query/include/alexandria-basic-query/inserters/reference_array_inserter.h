@@ -163,8 +163,9 @@ namespace alex
             {
                 try
                 {
+                    int64_t position = 0;
                     for (const auto& values = member_t::template get(instance).get(); const auto v : values)
-                        statement(nullptr, uuid, sql::toText(v.getAsString()));
+                        statement(nullptr, uuid, sql::toText(v.getAsString()), position++);
                 }
                 catch (const sql::SqliteError& e)
                 {
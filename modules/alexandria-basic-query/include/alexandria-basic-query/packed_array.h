@@ -0,0 +1,120 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type.h"
+
+namespace alex::detail
+{
+    /**
+     * \brief Returns whether the values of a primitive or string array property are packed into a single row.
+     * \param type Type.
+     * \param index Index of the primitive array table.
+     * \return True if packed.
+     */
+    [[nodiscard]] inline bool isPackedArray(const Type& type, const size_t index)
+    {
+        // Array table names are prefixed with the name of the instance table.
+        const auto& name = type.getPrimitiveArrayTables()[index]->getName();
+        return type.isPacked(name.substr(type.getInstanceTable().getName().size() + 1));
+    }
+
+    /**
+     * \brief Pack an array of primitive values. Values are stored back to back in native byte order.
+     * \tparam T Value type.
+     * \param values Values.
+     * \param out Buffer that is overwritten with the packed array.
+     */
+    template<typename T>
+        requires(std::floating_point<T> || std::integral<T>)
+    void packArray(const std::vector<T>& values, std::vector<std::byte>& out)
+    {
+        out.resize(values.size() * sizeof(T));
+        if (!values.empty()) std::memcpy(out.data(), values.data(), out.size());
+    }
+
+    /**
+     * \brief Pack an array of strings. Each string is prefixed with its length as an unsigned LEB128 varint.
+     * \param values Values.
+     * \param out Buffer that is overwritten with the packed array.
+     */
+    inline void packArray(const std::vector<std::string>& values, std::vector<std::byte>& out)
+    {
+        out.clear();
+        for (const auto& v : values)
+        {
+            auto size = static_cast<uint64_t>(v.size());
+            do {
+                auto b = static_cast<uint8_t>(size & 0x7f);
+                size >>= 7;
+                if (size) b |= 0x80;
+                out.push_back(static_cast<std::byte>(b));
+            } while (size);
+
+            const auto* bytes = reinterpret_cast<const std::byte*>(v.data());
+            out.insert(out.end(), bytes, bytes + v.size());
+        }
+    }
+
+    /**
+     * \brief Unpack an array of primitive values.
+     * \tparam T Value type.
+     * \param packed Packed array.
+     * \param values Vector that is overwritten with the values.
+     */
+    template<typename T>
+        requires(std::floating_point<T> || std::integral<T>)
+    void unpackArray(const std::span<const std::byte> packed, std::vector<T>& values)
+    {
+        if (packed.size() % sizeof(T) != 0)
+            throw std::runtime_error(
+              std::format("Size of packed array ({} bytes) is not a multiple of {} bytes.", packed.size(), sizeof(T)));
+
+        values.resize(packed.size() / sizeof(T));
+        if (!packed.empty()) std::memcpy(values.data(), packed.data(), packed.size());
+    }
+
+    /**
+     * \brief Unpack an array of strings.
+     * \param packed Packed array.
+     * \param values Vector that is overwritten with the values.
+     */
+    inline void unpackArray(std::span<const std::byte> packed, std::vector<std::string>& values)
+    {
+        values.clear();
+        while (!packed.empty())
+        {
+            uint64_t size  = 0;
+            uint32_t shift = 0;
+            while (true)
+            {
+                if (packed.empty() || shift > 63) throw std::runtime_error("Packed string array is malformed.");
+                const auto b = static_cast<uint8_t>(packed.front());
+                packed       = packed.subspan(1);
+                size |= static_cast<uint64_t>(b & 0x7f) << shift;
+                shift += 7;
+                if (!(b & 0x80)) break;
+            }
+
+            if (size > packed.size()) throw std::runtime_error("Packed string array is malformed.");
+            values.emplace_back(reinterpret_cast<const char*>(packed.data()), static_cast<size_t>(size));
+            packed = packed.subspan(static_cast<size_t>(size));
+        }
+    }
+}  // namespace alex::detail
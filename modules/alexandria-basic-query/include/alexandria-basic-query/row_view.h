@@ -0,0 +1,216 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/pack_file.h"
+#include "alexandria-core/raw_statement.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/utils.h"
+#include "alexandria-basic-query/types/member_extractor.h"
+
+namespace alex
+{
+    /**
+     * \brief Read only view of a row of an instance table, as passed to the callbacks of GetQuery::visit and
+     * SearchQuery::visit. Strings and blobs are returned as views into the buffers of the statement, so no memory is
+     * allocated or copied. A RowView and everything retrieved from it is only valid for the duration of the callback.
+     * Array members are stored in separate tables and are not part of the row.
+     * \tparam T TypeDescriptor.
+     */
+    template<typename T>
+    class RowView
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief TypeDescriptor.
+         */
+        using type_descriptor_t = T;
+
+        /**
+         * \brief Concatenation of the UUID member and all primitive members.
+         */
+        using members_t = detail::extract_primitive_members_t<typename type_descriptor_t::members_t>;
+
+        /**
+         * \brief Format of each member.
+         */
+        using formats_t = std::array<detail::BlobFormat, std::tuple_size_v<members_t>>;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        RowView() = delete;
+
+        /**
+         * \brief Construct a view of the current row of a statement that selects all columns of the instance table, in
+         * order, with deduplicated columns resolved to the shared blob (see detail::selectInstanceColumns).
+         * \param stmt Statement.
+         * \param fmts Format of each member.
+         * \param ext Store of external blobs. Only required if any member can be external.
+         */
+        RowView(const RawStatement& stmt, const formats_t& fmts, const ExternalStore* ext) noexcept :
+            statement(&stmt), formats(&fmts), external(ext)
+        {
+        }
+
+        RowView(const RowView&) = default;
+
+        RowView(RowView&&) noexcept = default;
+
+        ~RowView() noexcept = default;
+
+        RowView& operator=(const RowView&) = default;
+
+        RowView& operator=(RowView&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the rowid of the instance.
+         * \return Rowid.
+         */
+        [[nodiscard]] int64_t getRowid() const noexcept { return statement->getInt64(0); }
+
+        /**
+         * \brief Get the UUID of the instance.
+         * \return View of UUID string.
+         */
+        [[nodiscard]] std::string_view getId() const noexcept { return statement->getText(1); }
+
+        /**
+         * \brief Get the value of a member. Integers and floating point values are returned by value. UUIDs, strings
+         * and references are returned as std::string_view. Blobs and primitive blobs are returned as
+         * std::span<const std::byte>. Note that the blob buffer has no alignment guarantees, so use std::memcpy
+         * rather than reinterpreting it. Deduplicated blobs are views of the shared blob. Blobs that are stored
+         * externally are views into the pack file, which remain valid for as long as this RowView exists. Blobs of
+         * properties with a codec cannot be viewed without decoding them, and throw.
+         * \tparam M MemberName.
+         * \return Value or view.
+         */
+        template<detail::MemberName M>
+            requires(detail::is_primitive_member_name<M, T>)
+        [[nodiscard]] auto get() const
+        {
+            using member_t = std::tuple_element_t<detail::getColumnIndex<M, members_t>(), members_t>;
+
+            // Add 1 to account for integer primary key column.
+            constexpr auto index = static_cast<int32_t>(detail::getColumnIndex<M, members_t>() + 1);
+
+            if constexpr (member_t::is_instance_id || member_t::is_string || member_t::is_reference)
+                return statement->getText(index);
+            else if constexpr (member_t::is_blob || member_t::is_primitive_blob)
+            {
+                constexpr auto member = detail::getColumnIndex<M, members_t>();
+                const auto&    format = (*formats)[member];
+                if (format.codec != Codec::None)
+                    throw std::runtime_error(std::format(
+                      R"(Cannot view member "{}". It is encoded with codec "{}", retrieve the instance instead.)",
+                      M.name,
+                      toString(format.codec)));
+
+                // External values are stored as the integer id of the value in the external store. Keep the view, so
+                // that the pack file stays mapped.
+                if (format.externalThreshold > 0 && statement->isInteger(index))
+                {
+                    auto& view = externalViews[member];
+                    view       = external->get(statement->getInt64(index));
+                    return view.get();
+                }
+                return statement->getBlob(index);
+            }
+            else if constexpr (std::floating_point<typename member_t::value_t>)
+                return static_cast<typename member_t::value_t>(statement->getDouble(index));
+            else
+                return static_cast<typename member_t::value_t>(statement->getInt64(index));
+        }
+
+        /**
+         * \brief Check whether the value of a member is null, e.g. an unset reference.
+         * \tparam M MemberName.
+         * \return True if null.
+         */
+        template<detail::MemberName M>
+            requires(detail::is_primitive_member_name<M, T>)
+        [[nodiscard]] bool isNull() const noexcept
+        {
+            return statement->isNull(static_cast<int32_t>(detail::getColumnIndex<M, members_t>() + 1));
+        }
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        const RawStatement* statement = nullptr;
+
+        const formats_t* formats = nullptr;
+
+        const ExternalStore* external = nullptr;
+
+        /**
+         * \brief Views of the external values that were retrieved.
+         */
+        mutable std::array<BlobView, std::tuple_size_v<members_t>> externalViews;
+    };
+
+    namespace detail
+    {
+        /**
+         * \brief Invoke a visitor with a row. Visitors can return a bool, where false stops the visit.
+         * \tparam T TypeDescriptor.
+         * \tparam F Visitor type.
+         * \param f Visitor.
+         * \param stmt Statement positioned on a row.
+         * \param formats Format of each member.
+         * \param external Store of external blobs.
+         * \return True if the visit should continue.
+         */
+        template<typename T, typename F>
+            requires(std::invocable<F&, RowView<T>>)
+        bool visitRow(F&                                    f,
+                      const RawStatement&                   stmt,
+                      const typename RowView<T>::formats_t& formats,
+                      const ExternalStore*                  external)
+        {
+            if constexpr (std::same_as<std::invoke_result_t<F&, RowView<T>>, bool>)
+                return std::invoke(f, RowView<T>(stmt, formats, external));
+            else
+            {
+                std::invoke(f, RowView<T>(stmt, formats, external));
+                return true;
+            }
+        }
+    }  // namespace detail
+}  // namespace alex
@@ -0,0 +1,202 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/sharded_library.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+
+namespace alex
+{
+    namespace detail
+    {
+        /**
+         * \brief Holds one query per shard of a ShardedLibrary, and routes instances to them.
+         * \tparam Q Query type.
+         */
+        template<typename Q>
+        class ShardedQueries
+        {
+        public:
+            ////////////////////////////////////////////////////////////////
+            // Types.
+            ////////////////////////////////////////////////////////////////
+
+            using query_t           = Q;
+            using type_descriptor_t = typename query_t::type_descriptor_t;
+            using object_t          = typename query_t::object_t;
+
+            ////////////////////////////////////////////////////////////////
+            // Constructors.
+            ////////////////////////////////////////////////////////////////
+
+            ShardedQueries() = delete;
+
+            /**
+             * \brief Construct a query for a type on every shard.
+             * \param lib Library.
+             * \param nameSpace Namespace name.
+             * \param typeName Type name.
+             */
+            ShardedQueries(ShardedLibrary& lib, const std::string& nameSpace, const std::string& typeName) :
+                library(&lib)
+            {
+                for (size_t i = 0; i < lib.getShardCount(); i++)
+                    queries.emplace_back(std::make_unique<query_t>(
+                      type_descriptor_t(lib.getShard(i).getNamespace(nameSpace).getType(typeName))));
+            }
+
+            ShardedQueries(const ShardedQueries&) = delete;
+
+            ShardedQueries(ShardedQueries&&) noexcept = default;
+
+            ~ShardedQueries() noexcept = default;
+
+            ShardedQueries& operator=(const ShardedQueries&) = delete;
+
+            ShardedQueries& operator=(ShardedQueries&&) noexcept = default;
+
+            ////////////////////////////////////////////////////////////////
+            // Getters.
+            ////////////////////////////////////////////////////////////////
+
+            [[nodiscard]] ShardedLibrary& getLibrary() noexcept { return *library; }
+
+            /**
+             * \brief Get the query of a shard.
+             * \param index Shard index.
+             * \return Query.
+             */
+            [[nodiscard]] query_t& getQuery(const size_t index) { return *queries.at(index); }
+
+            /**
+             * \brief Get the query of the shard an instance is stored in.
+             * \param id Instance ID.
+             * \return Query.
+             */
+            [[nodiscard]] query_t& getQuery(const InstanceId& id) { return *queries[library->getShardIndex(id)]; }
+
+            /**
+             * \brief Get the query of the shard an instance is stored in.
+             * \param instance Instance.
+             * \return Query.
+             */
+            [[nodiscard]] query_t& getQuery(object_t& instance)
+            {
+                return getQuery(type_descriptor_t::uuid_member_t::template get(instance));
+            }
+
+        private:
+            ////////////////////////////////////////////////////////////////
+            // Member variables.
+            ////////////////////////////////////////////////////////////////
+
+            ShardedLibrary* library = nullptr;
+
+            std::vector<std::unique_ptr<query_t>> queries;
+        };
+    }  // namespace detail
+
+    /**
+     * \brief Inserts instances into the shard their ID is routed to.
+     * \tparam T TypeDescriptor.
+     */
+    template<typename T>
+    class ShardedInsertQuery : public detail::ShardedQueries<InsertQuery<T>>
+    {
+    public:
+        using base_t = detail::ShardedQueries<InsertQuery<T>>;
+        using typename base_t::object_t;
+        using base_t::base_t;
+
+        /**
+         * \brief Generate an ID for the instance and insert it into the shard that ID is routed to.
+         * \param instance Instance. Must not have a valid ID yet.
+         */
+        void operator()(object_t& instance)
+        {
+            InstanceId id;
+            id.regenerate();
+            this->getQuery(id)(instance, id);
+        }
+
+        /**
+         * \brief Insert an instance into the same shard as another instance, so that either can reference the other.
+         * \param instance Instance. Must not have a valid ID yet.
+         * \param other ID of an instance in the shard to insert into.
+         */
+        void insertColocated(object_t& instance, const InstanceId& other)
+        {
+            const auto index = this->getLibrary().getShardIndex(other);
+            this->getQuery(index)(instance, this->getLibrary().generateId(index));
+        }
+    };
+
+    /**
+     * \brief Retrieves instances from the shard their ID is routed to.
+     * \tparam T TypeDescriptor.
+     * \tparam B BlobLoading.
+     */
+    template<typename T, BlobLoading B = BlobLoading::Eager>
+    class ShardedGetQuery : public detail::ShardedQueries<GetQuery<T, B>>
+    {
+    public:
+        using base_t = detail::ShardedQueries<GetQuery<T, B>>;
+        using typename base_t::object_t;
+        using base_t::base_t;
+
+        [[nodiscard]] object_t operator()(const InstanceId& id) { return this->getQuery(id)(id); }
+
+        void operator()(object_t& instance) { this->getQuery(instance)(instance); }
+    };
+
+    /**
+     * \brief Updates instances in the shard their ID is routed to.
+     * \tparam T TypeDescriptor.
+     */
+    template<typename T>
+    class ShardedUpdateQuery : public detail::ShardedQueries<UpdateQuery<T>>
+    {
+    public:
+        using base_t = detail::ShardedQueries<UpdateQuery<T>>;
+        using typename base_t::object_t;
+        using base_t::base_t;
+
+        bool operator()(object_t& instance) { return this->getQuery(instance)(instance); }
+    };
+
+    /**
+     * \brief Deletes instances from the shard their ID is routed to.
+     * \tparam T TypeDescriptor.
+     */
+    template<typename T>
+    class ShardedDeleteQuery : public detail::ShardedQueries<DeleteQuery<T>>
+    {
+    public:
+        using base_t = detail::ShardedQueries<DeleteQuery<T>>;
+        using typename base_t::object_t;
+        using base_t::base_t;
+
+        bool operator()(object_t& instance) { return this->getQuery(instance)(instance); }
+
+        bool operator()(const InstanceId& id) { return this->getQuery(id)(id); }
+    };
+}  // namespace alex
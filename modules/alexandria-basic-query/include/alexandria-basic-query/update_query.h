@@ -12,6 +12,7 @@
 
 #include "alexandria-core/library.h"
 #include "alexandria-core/namespace.h"
+#include "alexandria-core/query_observer.h"
 #include "alexandria-core/type.h"
 #include "cppql/core/transaction.h"
 
@@ -95,27 +96,37 @@ namespace alex
             if (!type_descriptor_t::uuid_member_t::template get(instance).valid())
                 throw std::runtime_error("Cannot update instance. It does not have a valid UUID.");
 
-            Type& type = descriptor.getType();
-            auto& db   = type.getNamespace().getLibrary().getDatabase();
+            Type&        type    = descriptor.getType();
+            auto&        library = type.getNamespace().getLibrary();
+            auto&        db      = library.getDatabase();
+            QueryProfile profile(library, type, QueryClass::Update);
             try
             {
                 // Update parameter.
+                profile.stage(QueryStage::Uuid);
                 *uuidParam                = type_descriptor_t::uuid_member_t::template get(instance).getAsString();
                 const std::string uuidstr = type_descriptor_t::uuid_member_t::template get(instance).getAsString();
                 const auto        uuid    = sql::toStaticText(uuidstr);
 
                 // Start transaction.
+                profile.stage(QueryStage::Begin);
                 sql::Transaction transaction(db, sql::Transaction::Type::Deferred);
 
                 // Run all statements.
+                profile.stage(QueryStage::ArrayClear);
                 primitiveArrayDeleter();
                 blobArrayDeleter();
                 referenceArrayDeleter();
+                profile.stage(QueryStage::Primitive);
                 primitiveUpdater(instance);
+                profile.stage(QueryStage::PrimitiveArray);
                 primitiveArrayInserter(instance, uuid);
+                profile.stage(QueryStage::BlobArray);
                 blobArrayInserter(instance, uuid);
+                profile.stage(QueryStage::ReferenceArray);
                 referenceArrayInserter(instance, uuid);
 
+                profile.stage(QueryStage::Commit);
                 transaction.commit();
 
                 return db.getChanges() > 0;
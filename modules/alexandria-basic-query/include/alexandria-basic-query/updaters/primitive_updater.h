@@ -4,18 +4,32 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <cstddef>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/change_log.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/codec.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
 #include "common/type_traits.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-basic-query/blob_codec.h"
 #include "alexandria-basic-query/utils.h"
 #include "alexandria-basic-query/types/member_extractor.h"
 
@@ -50,7 +64,10 @@ namespace alex
 
     /**
      * \brief The PrimitiveUpdater handles the updating of all columns of the instance table. This includes not
-     * just integers and floats, but also the UUID and single string, blob and reference columns.
+     * just integers and floats, but also the UUID and single string, blob and reference columns. Blobs of properties
+     * with a codec are encoded, and deduplicated blobs are replaced by their content key, before they are written.
+     * Types without any column besides the UUID have nothing to update here, so the update is recorded in the change
+     * log of the library directly instead of by its update trigger.
      * \tparam T TypeDescriptor.
      */
     template<typename T>
@@ -97,7 +114,16 @@ namespace alex
 
         PrimitiveUpdater() = delete;
 
-        PrimitiveUpdater(const type_descriptor_t& desc, std::string& uuidParam) : statement(compile(desc, uuidParam)) {}
+        PrimitiveUpdater(const type_descriptor_t& desc, std::string& uuidParam) :
+            uuid(&uuidParam),
+            statement(compile(desc, uuidParam)),
+            formats(detail::getBlobFormats<members_t>(desc.getType())),
+            stores(detail::makeBlobStores(desc.getType(), formats)),
+            externalIds(desc.getType(), formats, "uuid = ?2"),
+            library(&desc.getType().getNamespace().getLibrary()),
+            typeId(desc.getType().getId())
+        {
+        }
 
         PrimitiveUpdater(const PrimitiveUpdater&) = delete;
 
@@ -117,11 +143,19 @@ namespace alex
         {
             statement.bind(sql::BindParameters::Dynamic);
 
-            const auto getter = [&]<is_member M>(M) {
+            const auto getter = [&]<is_member M>(M, const size_t index) {
                 if constexpr (M::is_primitive_blob || M::is_blob)
                 {
                     if constexpr (explicitly_convertible_to<decltype(M::template get(instance)), sql::StaticBlob>)
+                    {
+                        if (!formats[index].isPlain())
+                            return detail::writeBlob(formats[index],
+                                                     M::template get(instance).get(),
+                                                     buffers[index],
+                                                     stores,
+                                                     externalIds[index]);
                         return static_cast<sql::StaticBlob>(M::template get(instance));
+                    }
                     else if constexpr (explicitly_convertible_to<decltype(M::template get(instance)),
                                                                  sql::TransientBlob>)
                         return static_cast<sql::TransientBlob>(M::template get(instance));
@@ -138,17 +172,36 @@ namespace alex
                     constexpr_static_assert();
             };
 
-            const auto f = [&]<is_member M, is_member... Ms>(std::tuple<M, Ms...>) {
-                // Retrieve member values from instance for each column.
-                if constexpr (sizeof...(Ms) > 0) statement(getter(Ms())...);
+            const auto f = [&]<size_t... Is>(std::index_sequence<Is...>) {
+                // Retrieve member values from instance for each column. Add 1 to skip the UUID member.
+                if constexpr (sizeof...(Is) > 0)
+                    statement(getter(std::tuple_element_t<Is + 1, members_t>(), Is + 1)...);
+                else
+                    recordChange();
             };
 
-            f(members_t{});
+            f(std::make_index_sequence<std::tuple_size_v<members_t> - 1>{});
+
+            // Point the external blob columns of the row to their new values.
+            externalIds.write([this](RawStatement& stmt) { stmt.bind(2, *uuid); });
 
             statement.clearBindings();
         }
 
     private:
+        /**
+         * \brief Record an update of the instance in the change log, if the library has one.
+         */
+        void recordChange()
+        {
+            if (!library->isChangeLogEnabled()) return;
+            if (!changeLogStatement.get())
+                changeLogStatement = RawStatement(library->getDatabase(), ChangeLog::getUpdateSql(typeId));
+            ScopedReset reset{changeLogStatement};
+            changeLogStatement.bind(1, *uuid);
+            changeLogStatement.step();
+        }
+
         [[nodiscard]] static statement_t compile(const type_descriptor_t& desc, std::string& uuidParam)
         {
             const auto table = table_t(desc.getType().getInstanceTable());
@@ -169,6 +222,37 @@ namespace alex
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
+        std::string* uuid = nullptr;
+
         statement_t statement;
+
+        /**
+         * \brief Format of each member.
+         */
+        std::array<detail::BlobFormat, std::tuple_size_v<members_t>> formats;
+
+        /**
+         * \brief Stores for deduplicated and external blobs.
+         */
+        detail::BlobStores stores;
+
+        /**
+         * \brief Writes the ids of external blobs after the statement is executed.
+         */
+        detail::ExternalIdWriter<std::tuple_size_v<members_t>> externalIds;
+
+        /**
+         * \brief Buffers holding the encoded blobs or content keys of each member until the statement is executed.
+         */
+        std::array<std::vector<std::byte>, std::tuple_size_v<members_t>> buffers;
+
+        Library* library = nullptr;
+
+        sql::row_id typeId = 0;
+
+        /**
+         * \brief Statement recording an update in the change log. Only prepared for types without columns to update.
+         */
+        RawStatement changeLogStatement;
     };
 }  // namespace alex
@@ -6,6 +6,8 @@
 
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
@@ -112,34 +114,44 @@ namespace alex::detail
     using primitive_table_t = sql::tuple_to_table_t<member_tuple_to_column_t<T>>;
 
     /**
-     * \brief Generate a TypedTable for a Member<PrimitiveArray*>. Resulting table will have 3 columns:
+     * \brief Generate a TypedTable for a Member<PrimitiveArray*>. Resulting table will have 4 columns:
      * sql::rowid (row index)
      * std::string (foreign key to InstanceTable)
      * primitive  (element type held by array)
+     * int64_t (position of element in array)
      * \tparam M PrimitiveArray member type.
      */
     template<is_member M>
-    using primitive_array_table_t = sql::TypedTable<sql::row_id, std::string, member_to_column_t<M>>;
+    using primitive_array_table_t = sql::TypedTable<sql::row_id, std::string, member_to_column_t<M>, int64_t>;
 
     /**
-     * \brief Generate a TypedTable for a Member<ReferenceArray*>. Resulting table will have 3 columns:
+     * \brief Generate a TypedTable for a Member<ReferenceArray*>. Resulting table will have 4 columns:
      * sql::rowid (row index)
      * std::string (foreign key to InstanceTable)
      * std::string (foreign key to referenced InstanceTable)
+     * int64_t (position of element in array)
      * \tparam M PrimitiveArray member type.
      */
     template<is_member M>
-    using reference_array_table_t = sql::TypedTable<sql::row_id, std::string, std::string>;
+    using reference_array_table_t = sql::TypedTable<sql::row_id, std::string, std::string, int64_t>;
 
     /**
-     * \brief Generate a TypedTable for a Member<BlobArray*>. Resulting table will have 3 columns:
+     * \brief Generate a TypedTable for a Member<BlobArray*>. Resulting table will have 4 columns:
      * sql::rowid (row index)
      * std::string (foreign key to InstanceTable)
      * blob (element type held by array)
+     * int64_t (position of element in array)
      * \tparam M PrimitiveArray member type.
      */
     template<is_member M>
-    using blob_array_table_t = sql::TypedTable<sql::row_id, std::string, member_to_column_t<M>>;
+    using blob_array_table_t = sql::TypedTable<sql::row_id, std::string, member_to_column_t<M>, int64_t>;
+
+    /**
+     * \brief Element type of a primitive, string, blob or reference array member. References are InstanceIds.
+     * \tparam M Array member type.
+     */
+    template<is_member M>
+    using array_element_t = std::conditional_t<M::is_reference_array, InstanceId, member_to_column_t<M>>;
 
     ////////////////////////////////////////////////////////////////
     // ...
@@ -165,6 +177,25 @@ namespace alex::detail
         return getColumnIndexImpl<0, Name, T>();
     }
 
+    /**
+     * \brief Get the index of a member in a tuple of members. Unlike getColumnIndex, a missing member is not an error.
+     * \tparam Name Member name.
+     * \tparam T Tuple of members.
+     * \return Index, or -1 if there is no member with this name.
+     */
+    template<MemberName Name, typename T>
+    constexpr size_t findColumnIndex()
+    {
+        return []<size_t... Is>(std::index_sequence<Is...>)
+        {
+            auto index = static_cast<size_t>(-1);
+            static_cast<void>(
+              ((compare<Name, std::tuple_element_t<Is, T>::name_v>() ? (index = Is, true) : false) || ...));
+            return index;
+        }
+        (std::make_index_sequence<std::tuple_size_v<T>>{});
+    }
+
     ////////////////////////////////////////////////////////////////
     // ...
     ////////////////////////////////////////////////////////////////
@@ -174,4 +205,18 @@ namespace alex::detail
 
     template<MemberName Name, typename T>
     concept is_reference_array_member_name = getColumnIndex<Name, extract_reference_array_members_t<typename T::members_t>>() != -1;
+
+    /**
+     * \brief Get a member of a TypeDescriptor by name.
+     * \tparam Name Member name.
+     * \tparam T TypeDescriptor.
+     */
+    template<MemberName Name, typename T>
+    using member_by_name_t = std::tuple_element_t<getColumnIndex<Name, typename T::members_t>(), typename T::members_t>;
+
+    template<MemberName Name, typename T>
+    concept is_array_member_name =
+      findColumnIndex<Name, extract_primitive_array_members_t<typename T::members_t>>() != static_cast<size_t>(-1) ||
+      findColumnIndex<Name, extract_blob_array_members_t<typename T::members_t>>() != static_cast<size_t>(-1) ||
+      findColumnIndex<Name, extract_reference_array_members_t<typename T::members_t>>() != static_cast<size_t>(-1);
 }  // namespace alex::detail
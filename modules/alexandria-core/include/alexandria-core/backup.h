@@ -0,0 +1,42 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <functional>
+
+namespace alex
+{
+    /**
+     * \brief Progress of a backup, in pages. See Library::backupTo.
+     */
+    struct BackupProgress
+    {
+        /**
+         * \brief Number of pages that still have to be copied.
+         */
+        int64_t remaining = 0;
+
+        /**
+         * \brief Number of pages of the library. Can change while the backup runs.
+         */
+        int64_t total = 0;
+
+        /**
+         * \brief Get the fraction of pages that were copied.
+         * \return Fraction in [0, 1].
+         */
+        [[nodiscard]] double getFraction() const noexcept
+        {
+            return total == 0 ? 1.0 : static_cast<double>(total - remaining) / static_cast<double>(total);
+        }
+    };
+
+    /**
+     * \brief Called after each step of a backup. Sleeping in the callback throttles the backup, returning false
+     * cancels it.
+     */
+    using BackupCallback = std::function<bool(const BackupProgress&)>;
+}  // namespace alex
@@ -0,0 +1,157 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "cppql/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+
+namespace alex
+{
+    /**
+     * \brief Content key of a deduplicated blob.
+     */
+    using BlobKey = std::array<std::byte, 16>;
+
+    /**
+     * \brief Calculate the content key of a blob. Uses a fast, non-cryptographic 128-bit hash (MurmurHash3 x64 128).
+     * \param data Blob.
+     * \return Key.
+     */
+    [[nodiscard]] BlobKey hashBlob(std::span<const std::byte> data) noexcept;
+
+    /**
+     * \brief Shared, reference counted table of deduplicated blobs. Blobs are stored once per distinct content, keyed
+     * by their hash. Instance and array tables of deduplicated properties hold the key instead of the value. Triggers
+     * on those tables keep the reference counts up to date, and remove blobs that are no longer referenced.
+     */
+    class BlobStore
+    {
+    public:
+        /**
+         * \brief Statistics of the shared blob table.
+         */
+        struct Stats
+        {
+            /**
+             * \brief Number of distinct blobs.
+             */
+            int64_t blobs = 0;
+
+            /**
+             * \brief Number of references to blobs, i.e. the number of values that would be stored without
+             * deduplication.
+             */
+            int64_t references = 0;
+
+            /**
+             * \brief Total size of all distinct blobs in bytes.
+             */
+            int64_t storedBytes = 0;
+
+            /**
+             * \brief Total size of all referenced values in bytes.
+             */
+            int64_t referencedBytes = 0;
+
+            /**
+             * \brief Get the deduplication ratio, i.e. referenced bytes divided by stored bytes.
+             * \return Ratio. 1 if there are no blobs.
+             */
+            [[nodiscard]] double getRatio() const noexcept;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        BlobStore() = default;
+
+        /**
+         * \brief Construct a store. The shared blob table must exist.
+         * \param db Database.
+         */
+        explicit BlobStore(sql::Database& db);
+
+        BlobStore(const BlobStore&) = delete;
+
+        BlobStore(BlobStore&&) noexcept = default;
+
+        ~BlobStore() noexcept = default;
+
+        BlobStore& operator=(const BlobStore&) = delete;
+
+        BlobStore& operator=(BlobStore&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the name of the shared blob table.
+         * \return Table name.
+         */
+        [[nodiscard]] static const std::string& getTableName();
+
+        /**
+         * \brief Get the statistics of the shared blob table.
+         * \param db Database.
+         * \return Stats. Empty if the table does not exist.
+         */
+        [[nodiscard]] static Stats getStats(sql::Database& db);
+
+        ////////////////////////////////////////////////////////////////
+        // Blobs.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Store a blob, unless a blob with the same content key is already stored. The reference count is not
+         * changed. It is incremented by the triggers when the returned key is written to a deduplicated column.
+         * \param value Blob.
+         * \return Content key.
+         */
+        [[nodiscard]] BlobKey put(std::span<const std::byte> value);
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create the shared blob table, if it does not exist yet.
+         * \param db Database.
+         */
+        static void create(sql::Database& db);
+
+        /**
+         * \brief Create the triggers that maintain the reference counts of the blobs referenced by a deduplicated
+         * column.
+         * \param db Database.
+         * \param table Name of the instance or array table.
+         * \param column Name of the column holding the content keys.
+         */
+        static void createTriggers(sql::Database& db, const std::string& table, const std::string& column);
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        RawStatement insert;
+    };
+}  // namespace alex
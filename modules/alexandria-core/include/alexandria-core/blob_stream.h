@@ -0,0 +1,222 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "cppql/include_all.h"
+
+struct sqlite3;
+struct sqlite3_blob;
+
+namespace alex
+{
+    /**
+     * \brief Owning wrapper around an sqlite3 blob handle, which gives incremental access to a single blob value
+     * without copying it in full. The handle refers to a (table, column, rowid) triple. Its size is fixed: a blob
+     * cannot be resized through the handle, see allocateBlob. If the row is modified or deleted by anything other
+     * than the handle itself, the handle expires and further access throws.
+     */
+    class BlobHandle
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        BlobHandle() = default;
+
+        BlobHandle(const BlobHandle&) = delete;
+
+        BlobHandle(BlobHandle&& other) noexcept;
+
+        ~BlobHandle() noexcept;
+
+        BlobHandle& operator=(const BlobHandle&) = delete;
+
+        BlobHandle& operator=(BlobHandle&& other) noexcept;
+
+    protected:
+        /**
+         * \brief Open a blob.
+         * \param db Database.
+         * \param table Table name.
+         * \param column Column name.
+         * \param rowid Row.
+         * \param writable If true, open for reading and writing. Otherwise, read only.
+         */
+        BlobHandle(sql::Database& db, std::string table, std::string column, int64_t rowid, bool writable);
+
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] sqlite3_blob* get() const noexcept;
+
+        [[nodiscard]] int64_t getRowid() const noexcept;
+
+        /**
+         * \brief Get the size of the blob.
+         * \return Size in bytes.
+         */
+        [[nodiscard]] int64_t size() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // ...
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Point the handle to the same column of another row. Much faster than opening a new handle.
+         * \param rowid Row.
+         */
+        void reopen(int64_t rowid);
+
+    protected:
+        /**
+         * \brief Throw if the range [offset, offset + count) does not lie within the blob.
+         */
+        void checkRange(int64_t offset, size_t count) const;
+
+        /**
+         * \brief Throw if an sqlite3 result code is not SQLITE_OK.
+         */
+        void check(int32_t result, const char* action) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        sqlite3* db = nullptr;
+
+        sqlite3_blob* blob = nullptr;
+
+        std::string tableName;
+
+        std::string columnName;
+
+        int64_t row = 0;
+    };
+
+    /**
+     * \brief Read only blob handle. Supports reading arbitrary ranges of the blob.
+     */
+    class BlobReader : public BlobHandle
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        BlobReader() = default;
+
+        /**
+         * \brief Open a blob for reading.
+         * \param db Database.
+         * \param table Table name.
+         * \param column Column name.
+         * \param rowid Row.
+         */
+        BlobReader(sql::Database& db, std::string table, std::string column, int64_t rowid);
+
+        ////////////////////////////////////////////////////////////////
+        // Read.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Read a range of bytes.
+         * \param buffer Destination. Its size determines the number of bytes that is read.
+         * \param offset Offset in bytes into the blob.
+         */
+        void read(std::span<std::byte> buffer, int64_t offset) const;
+
+        /**
+         * \brief Read a range of values.
+         * \tparam T Value type.
+         * \param values Destination. Its size determines the number of values that is read.
+         * \param offset Offset in bytes into the blob.
+         */
+        template<typename T>
+            requires(std::is_trivially_copyable_v<T> && !std::is_const_v<T>)
+        void read(const std::span<T> values, const int64_t offset) const
+        {
+            read(std::as_writable_bytes(values), offset);
+        }
+    };
+
+    /**
+     * \brief Read and write blob handle. Supports reading and overwriting arbitrary ranges of the blob, e.g. to stream
+     * a large buffer into the database in chunks.
+     */
+    class BlobWriter : public BlobHandle
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        BlobWriter() = default;
+
+        /**
+         * \brief Open a blob for reading and writing.
+         * \param db Database.
+         * \param table Table name.
+         * \param column Column name.
+         * \param rowid Row.
+         */
+        BlobWriter(sql::Database& db, std::string table, std::string column, int64_t rowid);
+
+        ////////////////////////////////////////////////////////////////
+        // Read/write.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Read a range of bytes.
+         * \param buffer Destination. Its size determines the number of bytes that is read.
+         * \param offset Offset in bytes into the blob.
+         */
+        void read(std::span<std::byte> buffer, int64_t offset) const;
+
+        /**
+         * \brief Overwrite a range of bytes. Cannot write past the end of the blob.
+         * \param buffer Source. Its size determines the number of bytes that is written.
+         * \param offset Offset in bytes into the blob.
+         */
+        void write(std::span<const std::byte> buffer, int64_t offset);
+
+        /**
+         * \brief Overwrite a range of values. Cannot write past the end of the blob.
+         * \tparam T Value type.
+         * \param values Source. Its size determines the number of values that is written.
+         * \param offset Offset in bytes into the blob.
+         */
+        template<typename T>
+            requires(std::is_trivially_copyable_v<std::remove_const_t<T>>)
+        void write(const std::span<T> values, const int64_t offset)
+        {
+            write(std::as_bytes(values), offset);
+        }
+    };
+
+    /**
+     * \brief Replace the value of a blob column with a zero-filled blob of the given size, without materializing it in
+     * memory. The contents can then be written in chunks with a BlobWriter.
+     * \param db Database.
+     * \param table Table name.
+     * \param column Column name.
+     * \param rowid Row.
+     * \param size Size in bytes.
+     */
+    void allocateBlob(
+      sql::Database& db, const std::string& table, const std::string& column, int64_t rowid, int64_t size);
+}  // namespace alex
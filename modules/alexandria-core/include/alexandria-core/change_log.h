@@ -0,0 +1,242 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "cppql/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/fwd.h"
+#include "alexandria-core/raw_statement.h"
+
+namespace alex
+{
+    /**
+     * \brief Kind of change to an instance.
+     */
+    enum class ChangeOp : int32_t
+    {
+        Insert = 0,
+        Update = 1,
+        Delete = 2
+    };
+
+    /**
+     * \brief Entry of the change log.
+     */
+    struct Change
+    {
+        /**
+         * \brief Sequence number. Increases with every change and is never reused, not even after truncation.
+         */
+        int64_t seq = 0;
+
+        /**
+         * \brief ID of the type of the instance (see Type::getId).
+         */
+        sql::row_id type = 0;
+
+        /**
+         * \brief Instance.
+         */
+        InstanceId id;
+
+        ChangeOp op = ChangeOp::Insert;
+    };
+
+    /**
+     * \brief Table of changes to the instances of all types, in the order in which they were committed. Triggers on
+     * the instance tables record inserts, updates and deletes in the transaction that makes them. This includes
+     * references that are nulled because the referenced instance was deleted. Modifications of single array elements
+     * (ArrayAppendQuery etc.) are recorded as updates by the queries themselves. Consumers read the log with a
+     * ChangeFeed and acknowledge what they processed. Entries that all consumers acknowledged can be truncated.
+     */
+    class ChangeLog
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the name of the change log table.
+         * \return Table name.
+         */
+        [[nodiscard]] static const std::string& getTableName();
+
+        /**
+         * \brief Get the name of the table holding the acknowledged sequence number of each consumer.
+         * \return Table name.
+         */
+        [[nodiscard]] static const std::string& getConsumerTableName();
+
+        /**
+         * \brief Check whether the change log tables exist.
+         * \param db Database.
+         * \return True if they exist.
+         */
+        [[nodiscard]] static bool exists(sql::Database& db);
+
+        /**
+         * \brief Get the sequence number of the most recent change, including truncated changes.
+         * \param db Database.
+         * \return Sequence number. 0 if nothing was recorded yet.
+         */
+        [[nodiscard]] static int64_t getLatestSequence(sql::Database& db);
+
+        ////////////////////////////////////////////////////////////////
+        // Consumers.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Remove a consumer, so that it no longer holds back truncation.
+         * \param db Database.
+         * \param consumer Consumer name.
+         * \return True if the consumer existed.
+         */
+        static bool removeConsumer(sql::Database& db, const std::string& consumer);
+
+        /**
+         * \brief Delete all changes that every consumer acknowledged. Without consumers, all changes are deleted.
+         * \param db Database.
+         * \return Number of deleted changes.
+         */
+        static int64_t truncate(sql::Database& db);
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create the change log tables, if they do not exist yet.
+         * \param db Database.
+         */
+        static void create(sql::Database& db);
+
+        /**
+         * \brief Create the triggers that record the changes to an instance table, if they do not exist yet.
+         * \param db Database.
+         * \param type Type ID.
+         * \param table Name of the instance table.
+         */
+        static void createTriggers(sql::Database& db, sql::row_id type, const std::string& table);
+
+        /**
+         * \brief Get a statement that records an update of an instance of a type. The instance is bound to ?1.
+         * \param type Type ID.
+         * \return SQL string.
+         */
+        [[nodiscard]] static std::string getUpdateSql(sql::row_id type);
+    };
+
+    /**
+     * \brief Reads the change log on behalf of a named consumer. The position of the consumer is stored in the
+     * library, so that a new feed with the same name resumes after the last acknowledged change. A consumer that did
+     * not exist yet starts after the most recent change. Take a snapshot of the instances it is interested in after
+     * creating its feed, since changes made in between are reported again.
+     *
+     * \code
+     * alex::ChangeFeed feed(library, "cache");
+     * for (auto changes = feed.next(); !changes.empty(); changes = feed.next())
+     * {
+     *     for (const auto& change : changes) cache.invalidate(change.id);
+     *     feed.acknowledge();
+     * }
+     * \endcode
+     */
+    class ChangeFeed
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ChangeFeed() = delete;
+
+        /**
+         * \brief Open the feed of a consumer, registering the consumer if it does not exist yet. The change log of the
+         * library must be enabled (see Library::enableChangeLog).
+         * \param lib Library.
+         * \param consumer Consumer name.
+         */
+        ChangeFeed(Library& lib, std::string consumer);
+
+        ChangeFeed(const ChangeFeed&) = delete;
+
+        ChangeFeed(ChangeFeed&&) noexcept = default;
+
+        ~ChangeFeed() noexcept = default;
+
+        ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+        ChangeFeed& operator=(ChangeFeed&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] const std::string& getName() const noexcept;
+
+        /**
+         * \brief Get the sequence number of the last change returned by next.
+         * \return Sequence number.
+         */
+        [[nodiscard]] int64_t getPosition() const noexcept;
+
+        /**
+         * \brief Get the sequence number of the last acknowledged change.
+         * \return Sequence number.
+         */
+        [[nodiscard]] int64_t getAcknowledged() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Reading.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the next batch of changes after the current position, and advance the position past them.
+         * \param maxCount Maximum number of changes.
+         * \return Changes, ordered by sequence number. Empty if there are no new changes.
+         */
+        [[nodiscard]] std::vector<Change> next(size_t maxCount = 1000);
+
+        /**
+         * \brief Move the position back to the last acknowledged change, e.g. to retry after a failure.
+         */
+        void rewind() noexcept;
+
+        /**
+         * \brief Acknowledge all changes up to the current position. They are no longer returned by new feeds of this
+         * consumer, and can be truncated once all other consumers acknowledged them as well.
+         */
+        void acknowledge();
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::string name;
+
+        int64_t position = 0;
+
+        int64_t acknowledged = 0;
+
+        RawStatement select;
+
+        RawStatement update;
+    };
+}  // namespace alex
@@ -0,0 +1,59 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace alex
+{
+    /**
+     * \brief Compression codec of a blob, primitive blob or blob array property. Encoded values are self-describing:
+     * they start with a small header holding the codec, element size and decoded size.
+     */
+    enum class Codec : int32_t
+    {
+        /**
+         * \brief Values are stored as is.
+         */
+        None = 0,
+
+        /**
+         * \brief Bytes of all elements are transposed by significance (byte 0 of every element, then byte 1, etc.),
+         * followed by a fast LZ77 compressor. Suited for arrays of vectors, vertices and other structured data.
+         */
+        ShuffleLz = 1,
+
+        /**
+         * \brief Each integer is replaced by its difference to the previous one, which is zigzag and varint encoded.
+         * Suited for sorted or slowly changing integer sequences such as indices. Only allowed for primitive blobs of
+         * integers.
+         */
+        DeltaVarint = 2
+    };
+
+    [[nodiscard]] std::string toString(Codec codec);
+
+    void fromString(const std::string& s, Codec& codec);
+
+    /**
+     * \brief Encode a buffer.
+     * \param codec Codec. If Codec::None, the buffer is copied as is.
+     * \param elementSize Size of a single element of the buffer in bytes. Used for shuffling and delta encoding.
+     * \param data Buffer.
+     * \param out Encoded buffer. Existing contents are replaced.
+     */
+    void encode(Codec codec, size_t elementSize, std::span<const std::byte> data, std::vector<std::byte>& out);
+
+    /**
+     * \brief Decode a buffer that was encoded with a codec other than Codec::None.
+     * \param data Encoded buffer.
+     * \param out Decoded buffer. Existing contents are replaced.
+     */
+    void decode(std::span<const std::byte> data, std::vector<std::byte>& out);
+}  // namespace alex
@@ -0,0 +1,212 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "cppql/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/pack_file.h"
+#include "alexandria-core/raw_statement.h"
+
+namespace alex
+{
+    /**
+     * \brief Store of external blobs, i.e. values that are too large to be stored efficiently in the database. Values
+     * are appended to a pack file next to the library file. The external blob table holds the offset, length and
+     * checksum of each value, and instance and array tables of external properties hold the id of that row. Triggers
+     * on those tables remove rows that are no longer referenced. The space they used is reclaimed by compaction.
+     *
+     * Pack files are named "<library file>.<generation>.pack". Compaction writes the live values to the next
+     * generation and then switches to it, so that reads are never blocked for longer than an index lookup.
+     * All methods are thread-safe. Several processes can use the same store: each read checks the generation in the
+     * same snapshot as the offset of the value, and files of other generations are only removed when no process has
+     * them open.
+     */
+    class ExternalStore
+    {
+    public:
+        /**
+         * \brief Statistics of the external blob store.
+         */
+        struct Stats
+        {
+            /**
+             * \brief Number of stored values.
+             */
+            int64_t blobs = 0;
+
+            /**
+             * \brief Total size of all stored values in bytes.
+             */
+            int64_t liveBytes = 0;
+
+            /**
+             * \brief Size of the pack file in bytes. Space not used by live values is reclaimed by compaction.
+             */
+            int64_t fileBytes = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ExternalStore() = delete;
+
+        /**
+         * \brief Construct a store. Nothing is created until the first value is stored or read.
+         * \param database Database.
+         * \param file Path to library file. If empty, the pack file is written to a temporary file that is removed
+         * when the store is destroyed.
+         */
+        ExternalStore(sql::Database& database, const std::filesystem::path& file);
+
+        ExternalStore(const ExternalStore&) = delete;
+
+        ExternalStore(ExternalStore&&) = delete;
+
+        ~ExternalStore() noexcept;
+
+        ExternalStore& operator=(const ExternalStore&) = delete;
+
+        ExternalStore& operator=(ExternalStore&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the name of the external blob table.
+         * \return Table name.
+         */
+        [[nodiscard]] static const std::string& getTableName();
+
+        /**
+         * \brief Get the path of the current pack file.
+         * \return Path.
+         */
+        [[nodiscard]] std::filesystem::path getPath() const;
+
+        /**
+         * \brief Get the statistics of the external blob store.
+         * \return Stats. Empty if the external blob table does not exist.
+         */
+        [[nodiscard]] Stats getStats() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Blobs.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Append a value to the pack file and flush it to disk, before adding it to the external blob table.
+         * \param value Blob.
+         * \return Id of the value.
+         */
+        [[nodiscard]] int64_t put(std::span<const std::byte> value);
+
+        /**
+         * \brief Get a view of a value in the memory mapped pack file. The view stays valid after compaction.
+         * \param id Id of the value.
+         * \return BlobView.
+         */
+        [[nodiscard]] BlobView get(int64_t id) const;
+
+        /**
+         * \brief Check whether the checksum of a value matches its content.
+         * \param id Id of the value.
+         * \return True if the value is intact.
+         */
+        [[nodiscard]] bool verify(int64_t id) const;
+
+        /**
+         * \brief Copy all live values to a new pack file and remove the old one. Values can be read and stored while
+         * the copy is made. Must not be called while a transaction is active on the database.
+         * \return Number of bytes reclaimed.
+         */
+        int64_t compact();
+
+        /**
+         * \brief Copy the pack file to the store of a copy of the database, e.g. a backup. The copy must have been
+         * made from the current generation, i.e. without a compaction in between.
+         * \param target Store of the copy.
+         */
+        void copyTo(ExternalStore& target);
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create the external blob tables, if they do not exist yet.
+         * \param db Database.
+         */
+        static void create(sql::Database& db);
+
+        /**
+         * \brief Create the triggers that remove the values that are no longer referenced by an external column.
+         * \param db Database.
+         * \param table Name of the instance or array table.
+         * \param column Name of the column holding the ids.
+         */
+        static void createTriggers(sql::Database& db, const std::string& table, const std::string& column);
+
+    private:
+        [[nodiscard]] std::filesystem::path getPath(int64_t gen) const;
+
+        [[nodiscard]] bool exists() const;
+
+        [[nodiscard]] int64_t readGeneration() const;
+
+        /**
+         * \brief Get the pack file of a generation, opening it if another generation or no file is open.
+         * \param gen Generation.
+         * \return PackFile.
+         */
+        PackFile& open(int64_t gen) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        sql::Database* db = nullptr;
+
+        /**
+         * \brief Path of the library file, or of a temporary file for in-memory libraries.
+         */
+        std::filesystem::path base;
+
+        bool temporary = false;
+
+        mutable int64_t generation = 0;
+
+        mutable std::unique_ptr<PackFile> pack;
+
+        /**
+         * \brief Statements are prepared on first use, because the tables are only created with the first external
+         * property.
+         */
+        RawStatement insert;
+
+        mutable RawStatement select;
+
+        mutable std::mutex mutex;
+
+        std::mutex compactMutex;
+    };
+}  // namespace alex
@@ -4,6 +4,7 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <cstdint>
 #include <format>
 #include <memory>
 #include <string>
@@ -26,6 +27,7 @@ namespace alex
     class Namespace;
     class Property;
     class PropertyLayout;
+    class ShardedLibrary;
     class Type;
     class TypeLayout;
 
@@ -33,6 +35,7 @@ namespace alex
     using NamespacePtr      = std::unique_ptr<Namespace>;
     using PropertyPtr       = std::unique_ptr<Property>;
     using PropertyLayoutPtr = std::unique_ptr<PropertyLayout>;
+    using ShardedLibraryPtr = std::unique_ptr<ShardedLibrary>;
     using TypePtr           = std::unique_ptr<Type>;
     using TypeLayoutPtr     = std::unique_ptr<TypeLayout>;
     using NamespaceMap      = std::map<std::string, NamespacePtr>;
@@ -76,6 +79,38 @@ namespace alex
         }
     };
 
+    /**
+     * \brief Options of a property that are stored in the single options column of the properties table, so that new
+     * options do not change the schema. Flags are stored in the lowest byte, the codec in the second byte and the
+     * external threshold in the remaining bits. All options are disabled when the column is 0.
+     */
+    struct PropertyOptions
+    {
+        static constexpr int64_t fullTextFlag     = 1;
+        static constexpr int64_t spatialFlag      = 2;
+        static constexpr int64_t indexedFlag      = 4;
+        static constexpr int64_t deduplicatedFlag = 8;
+        static constexpr int64_t packedFlag       = 16;
+
+        int64_t flags             = 0;
+        int32_t codec             = 0;
+        int64_t externalThreshold = 0;
+
+        [[nodiscard]] int64_t encode() const noexcept
+        {
+            return (flags & 0xff) | (static_cast<int64_t>(codec & 0xff) << 8) | (externalThreshold << 16);
+        }
+
+        [[nodiscard]] static PropertyOptions decode(const int64_t options) noexcept
+        {
+            return {.flags             = options & 0xff,
+                    .codec             = static_cast<int32_t>((options >> 8) & 0xff),
+                    .externalThreshold = options >> 16};
+        }
+
+        [[nodiscard]] bool has(const int64_t flag) const noexcept { return (flags & flag) != 0; }
+    };
+
     struct PropertyRow
     {
         sql::row_id id;
@@ -85,24 +120,28 @@ namespace alex
         sql::row_id referenceType;
         int32_t     isArray;
         int32_t     isBlob;
+        int64_t     options = 0;
 
         [[nodiscard]] bool operator==(const PropertyRow& rhs) const noexcept
         {
             return id == rhs.id && type == rhs.type && name == rhs.name && dataType == rhs.dataType &&
-                   referenceType == rhs.referenceType && isArray == rhs.isArray && isBlob == rhs.isBlob;
+                   referenceType == rhs.referenceType && isArray == rhs.isArray && isBlob == rhs.isBlob &&
+                   options == rhs.options;
         }
 
         friend std::ostream& operator<<(std::ostream& out, const PropertyRow& prop)
         {
             return out << std::format(
-                     "Property(id={}, type={}, name={}, dataType={}, referenceType={}, isArray={}, isBlob={})",
+                     "Property(id={}, type={}, name={}, dataType={}, referenceType={}, isArray={}, isBlob={}, "
+                     "options={})",
                      prop.id,
                      prop.type,
                      prop.name,
                      prop.dataType,
                      prop.referenceType,
                      prop.isArray,
-                     prop.isBlob);
+                     prop.isBlob,
+                     prop.options);
         }
     };
 
@@ -138,7 +177,8 @@ namespace alex
                                           decltype(PropertyRow::dataType),
                                           decltype(PropertyRow::referenceType),
                                           decltype(PropertyRow::isBlob),
-                                          decltype(PropertyRow::isArray)>;
+                                          decltype(PropertyRow::isArray),
+                                          decltype(PropertyRow::options)>;
 
     using GeneratedTablesTable = sql::
       TypedTable<decltype(TableRow::id), decltype(TableRow::type), decltype(TableRow::name), decltype(TableRow::kind)>;
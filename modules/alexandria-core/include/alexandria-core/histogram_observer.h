@@ -0,0 +1,129 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/latency_histogram.h"
+#include "alexandria-core/query_observer.h"
+
+namespace alex
+{
+    /**
+     * \brief Query observer that records a latency histogram per type, query class and stage, and one for all
+     * statements. Recording is lock-free, so a single observer can be registered on the libraries of several threads.
+     * Histograms are allocated on first use.
+     *
+     * \code
+     * alex::HistogramObserver observer;
+     * library->setQueryObserver(&observer);
+     * ...
+     * observer.dump(std::cout);
+     * \endcode
+     */
+    class HistogramObserver final : public QueryObserver
+    {
+    public:
+        /**
+         * \brief Latencies and counters of a single stage.
+         */
+        struct Stage
+        {
+            LatencyHistogram latency;
+
+            std::atomic<uint64_t> failed = 0;
+
+            std::atomic<uint64_t> rows = 0;
+
+            std::atomic<uint64_t> bytes = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        HistogramObserver() = default;
+
+        HistogramObserver(const HistogramObserver&) = delete;
+
+        HistogramObserver(HistogramObserver&&) noexcept = delete;
+
+        ~HistogramObserver() noexcept override;
+
+        HistogramObserver& operator=(const HistogramObserver&) = delete;
+
+        HistogramObserver& operator=(HistogramObserver&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Events.
+        ////////////////////////////////////////////////////////////////
+
+        void onQuery(const QueryEvent& event) override;
+
+        void onStatement(const StatementEvent& event) override;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the recorded stage of a query on a type.
+         * \param type Type.
+         * \param query Query class.
+         * \param stage Stage.
+         * \return Stage, or nullptr if nothing was recorded for it.
+         */
+        [[nodiscard]] const Stage* getStage(const Type& type, QueryClass query, QueryStage stage) const noexcept;
+
+        /**
+         * \brief Get the latencies of all statements.
+         * \return Histogram.
+         */
+        [[nodiscard]] const LatencyHistogram& getStatements() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Dump.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write a table with the count, failures, rows, bytes and latency percentiles of all recorded stages.
+         * Latencies are in microseconds. Can be called while other threads are recording.
+         * \param out Ostream.
+         */
+        void dump(std::ostream& out) const;
+
+    private:
+        /**
+         * \brief Stages of a single type. Entries form a singly linked list that only grows at the front.
+         */
+        struct Entry
+        {
+            const Type* type = nullptr;
+
+            std::array<std::atomic<Stage*>, queryClassCount * queryStageCount> stages{};
+
+            Entry* next = nullptr;
+        };
+
+        [[nodiscard]] Entry* findEntry(const Type& type) const noexcept;
+
+        [[nodiscard]] Entry& getEntry(const Type& type);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::atomic<Entry*> entries = nullptr;
+
+        LatencyHistogram statements;
+    };
+}  // namespace alex
@@ -0,0 +1,84 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace alex
+{
+    /**
+     * \brief Latency histogram with logarithmic buckets that are each split into linear sub-buckets, like an HDR
+     * histogram. Values are recorded with a relative error of at most 1/16, in constant memory. All counters are
+     * atomics that are updated with relaxed ordering, so any number of threads can record concurrently without
+     * locking. Statistics read while other threads are recording are approximate.
+     */
+    class LatencyHistogram
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        LatencyHistogram() = default;
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+
+        LatencyHistogram(LatencyHistogram&&) noexcept = delete;
+
+        ~LatencyHistogram() noexcept = default;
+
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        LatencyHistogram& operator=(LatencyHistogram&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Recording.
+        ////////////////////////////////////////////////////////////////
+
+        void record(std::chrono::nanoseconds value) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Statistics.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] uint64_t count() const noexcept;
+
+        [[nodiscard]] std::chrono::nanoseconds mean() const noexcept;
+
+        [[nodiscard]] std::chrono::nanoseconds max() const noexcept;
+
+        /**
+         * \brief Get the value below which a percentage of the recorded values fall.
+         * \param percentile Percentile in [0, 100], e.g. 99.9.
+         * \return Upper bound of the bucket holding the percentile, or 0 if nothing was recorded.
+         */
+        [[nodiscard]] std::chrono::nanoseconds percentile(double percentile) const noexcept;
+
+    private:
+        static constexpr size_t subBucketBits = 4;
+
+        static constexpr size_t subBucketCount = size_t{1} << subBucketBits;
+
+        [[nodiscard]] static size_t getIndex(uint64_t value) noexcept;
+
+        [[nodiscard]] static uint64_t getUpperBound(size_t index) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::array<std::atomic<uint64_t>, 64 * subBucketCount> buckets{};
+
+        std::atomic<uint64_t> total = 0;
+
+        std::atomic<uint64_t> sum = 0;
+
+        std::atomic<uint64_t> maxValue = 0;
+    };
+}  // namespace alex
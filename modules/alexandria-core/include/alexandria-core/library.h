@@ -4,9 +4,14 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 ////////////////////////////////////////////////////////////////
@@ -19,7 +24,12 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/backup.h"
+#include "alexandria-core/external_store.h"
 #include "alexandria-core/fwd.h"
+#include "alexandria-core/query_observer.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/storage_stats.h"
 #include "alexandria-core/type.h"
 
 namespace alex
@@ -142,6 +152,38 @@ namespace alex
 
         [[nodiscard]] GeneratedTablesInsert& getGeneratedTablesInsert() noexcept;
 
+        /**
+         * \brief Get the store of external blobs. The store is internally synchronized, and can therefore be used
+         * through a const library.
+         * \return External store.
+         */
+        [[nodiscard]] ExternalStore& getExternalStore() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Instrumentation.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Register an observer that receives timing events of all queries and statements run through this
+         * library. While an observer is registered, a sqlite trace callback counts every returned row. Without one,
+         * queries only pay for a null check.
+         * \param observer Observer, or nullptr to remove the current one. Not owned, and must outlive its registration.
+         */
+        void setQueryObserver(QueryObserver* observer);
+
+        /**
+         * \brief Get the registered query observer.
+         * \return Observer, or nullptr.
+         */
+        [[nodiscard]] QueryObserver* getQueryObserver() const noexcept;
+
+        /**
+         * \brief Get the number of rows returned or modified and the number of bytes returned since the library was
+         * opened. Rows and bytes are only returned while an observer is registered.
+         * \return Counters.
+         */
+        [[nodiscard]] QueryCounters getQueryCounters() const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Namespaces.
         ////////////////////////////////////////////////////////////////
@@ -159,9 +201,157 @@ namespace alex
          */
         void writeGraph(std::ostream& out) const;
 
+        ////////////////////////////////////////////////////////////////
+        // Statistics.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the storage used by each type, generated table, index and column, and by the blob stores. Built
+         * on the dbstat virtual table and the generated table metadata. Visits every page of the database.
+         * \return Stats.
+         */
+        [[nodiscard]] StorageStats storageStats() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Backup.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Copy the library to a new file while it stays available to readers and writers. Pages are copied in
+         * steps, and the library is only locked during a step. Writes through this library are applied to the copy as
+         * well, writes through other connections restart the copy. The pack file of the external blob store is copied
+         * once all pages are copied, so the store must not be compacted during the backup.
+         * \param file Path to backup file. Must not exist.
+         * \param pagesPerStep Number of pages copied per step. If negative, all pages are copied in a single step.
+         * \param callback Called after each step. Can sleep to throttle the backup, or return false to cancel it.
+         * \return True if the backup completed, false if it was cancelled. A cancelled backup leaves no file behind.
+         */
+        bool backupTo(const std::filesystem::path& file,
+                      int32_t                      pagesPerStep = 128,
+                      const BackupCallback&        callback     = {}) const;
+
+        /**
+         * \brief Copy the library to a new in-memory library. Useful to start each test from the same populated
+         * library, without building it again.
+         * \param pagesPerStep Number of pages copied per step. If negative, all pages are copied in a single step.
+         * \param callback Called after each step. Can sleep to throttle the backup, or return false to cancel it.
+         * \return Library, or nullptr if the backup was cancelled.
+         */
+        [[nodiscard]] LibraryPtr backupToMemory(int32_t pagesPerStep = -1, const BackupCallback& callback = {}) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Change log.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Start recording the inserts, updates and deletes of the instances of all types, including types
+         * committed later, in the change log of the library (see ChangeLog and ChangeFeed). Changes are recorded in the
+         * same transaction that makes them. Stays enabled when the library is reopened and cannot be disabled.
+         */
+        void enableChangeLog();
+
+        [[nodiscard]] bool isChangeLogEnabled() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Modification tracking.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the version of the last modification of a table. Every inserted, updated or deleted row of a
+         * tracked table is assigned a new version by the sqlite update hook of the library, which is registered when
+         * the first table is tracked. Compare with the result of checkModifications to detect modifications since a
+         * point in time. Rows deleted by a DELETE without WHERE clause on a table without triggers are not reported by
+         * sqlite. Call invalidateTableVersions after such statements.
+         * \param table Table name.
+         * \return Version. The reference stays valid for the lifetime of the library.
+         */
+        [[nodiscard]] const uint64_t& getTableVersion(const std::string& table);
+
+        /**
+         * \brief Check whether another connection, possibly in another process, committed changes since the last
+         * check, using PRAGMA data_version. If so, all tracked tables are considered modified, since sqlite does not
+         * report which tables other connections modified.
+         * \return Current version, which is larger than or equal to the version of every tracked table.
+         */
+        uint64_t checkModifications();
+
+        /**
+         * \brief Consider all tracked tables modified.
+         */
+        void invalidateTableVersions() noexcept;
+
+        /**
+         * \brief Check whether a transaction is open on the connection of this library. Modifications made in an open
+         * transaction can still be rolled back.
+         * \return True if a transaction is open.
+         */
+        [[nodiscard]] bool isInTransaction() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Connections.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Open an additional read-only connection to the library file, e.g. to read on another thread. The
+         * connection does not see uncommitted changes of this library, and waits up to a second for locks held by
+         * writers. Combine with WAL mode to read while writing.
+         * \return Connection, or null if the library is in-memory.
+         */
+        [[nodiscard]] sql::DatabasePtr openReadConnection() const;
+
     private:
+        /**
+         * \brief State shared with the sqlite trace callback. Allocated separately, so that it does not move with the
+         * library.
+         */
+        struct QueryTrace
+        {
+            QueryObserver* observer = nullptr;
+
+            QueryCounters counters;
+        };
+
+        /**
+         * \brief State shared with the sqlite update hook. Allocated separately, so that it does not move with the
+         * library.
+         */
+        struct TableVersions
+        {
+            struct Hash
+            {
+                using is_transparent = void;
+
+                [[nodiscard]] size_t operator()(const std::string_view s) const noexcept
+                {
+                    return std::hash<std::string_view>{}(s);
+                }
+            };
+
+            /**
+             * \brief Most recently assigned version.
+             */
+            uint64_t version = 0;
+
+            /**
+             * \brief Last value of PRAGMA data_version.
+             */
+            int64_t dataVersion = 0;
+
+            /**
+             * \brief Statement reading PRAGMA data_version. Prepared when the first table is tracked.
+             */
+            RawStatement dataVersionStatement;
+
+            /**
+             * \brief Version of the last modification of each tracked table.
+             */
+            std::unordered_map<std::string, uint64_t, Hash, std::equal_to<>> tables;
+        };
+
         void readSpecification();
 
+        static int32_t trace(uint32_t event, void* context, void* p, void* x) noexcept;
+
         /**
          * \brief Sqlite database handle.
          */
@@ -206,5 +396,25 @@ namespace alex
          * \brief Sqlite statement for inserting generated table names.
          */
         GeneratedTablesInsert genTablesInsert;
+
+        /**
+         * \brief Pack file of external blobs.
+         */
+        std::unique_ptr<ExternalStore> externalStore;
+
+        /**
+         * \brief Query observer and counters.
+         */
+        std::unique_ptr<QueryTrace> queryTrace;
+
+        /**
+         * \brief Versions of tracked tables.
+         */
+        std::unique_ptr<TableVersions> tableVersions;
+
+        /**
+         * \brief Whether changes are recorded in the change log.
+         */
+        bool changeLog = false;
     };
 }  // namespace alex
@@ -0,0 +1,64 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/fwd.h"
+
+namespace alex
+{
+    /**
+     * \brief A dump holds the schema and all instances of a library in a file that does not depend on the sqlite
+     * version, page size or pack file of the library. Tables are found through the stored specification, so no code
+     * is needed per type.
+     */
+    class LibraryDump
+    {
+    public:
+        /**
+         * \brief Number of rows, tables and bytes written or read.
+         */
+        struct Stats
+        {
+            uint64_t rows = 0;
+
+            uint64_t tables = 0;
+
+            uint64_t bytes = 0;
+        };
+
+        /**
+         * \brief Write the schema and all instances of a library to a dump file. Rows are streamed one at a time as
+         * length-prefixed values, in a single transaction. Values of external properties are written inline, spatial
+         * and fulltext indices are left out.
+         * \param library Library.
+         * \param file Path to dump file. Overwritten if it exists.
+         * \return Stats.
+         */
+        static Stats write(Library& library, const std::filesystem::path& file);
+
+        /**
+         * \brief Read a dump file into a library. If the library does not exist, it is created from the schema in the
+         * dump, keeping all ids. Otherwise, the instances are appended and every table of the dump must exist with the
+         * same columns. Spatial and fulltext indices are rebuilt by their triggers. Rows are inserted in transactions
+         * of batchSize rows. Foreign keys are checked once all rows are inserted, and the import fails if any inserted
+         * row references an instance that does not exist. A failed import removes a newly created library, or deletes
+         * the rows that earlier batches appended to an existing library. Other connections must not insert into the
+         * library while the import runs.
+         * \param library Path to library file.
+         * \param file Path to dump file.
+         * \param batchSize Number of rows per transaction.
+         * \return Stats.
+         */
+        static Stats read(const std::filesystem::path& library, const std::filesystem::path& file, size_t batchSize);
+    };
+}  // namespace alex
@@ -0,0 +1,191 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+
+namespace alex
+{
+    /**
+     * \brief Read only view of a range of bytes that keeps the underlying memory alive, e.g. a memory mapped pack file
+     * that has since been replaced by compaction.
+     */
+    class BlobView
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        BlobView() = default;
+
+        /**
+         * \brief Construct a view.
+         * \param memoryOwner Object owning the memory.
+         * \param viewBytes Bytes.
+         */
+        BlobView(std::shared_ptr<const void> memoryOwner, std::span<const std::byte> viewBytes) noexcept;
+
+        BlobView(const BlobView&) = default;
+
+        BlobView(BlobView&&) noexcept = default;
+
+        ~BlobView() noexcept = default;
+
+        BlobView& operator=(const BlobView&) = default;
+
+        BlobView& operator=(BlobView&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] std::span<const std::byte> get() const noexcept;
+
+        [[nodiscard]] const std::byte* data() const noexcept;
+
+        [[nodiscard]] size_t size() const noexcept;
+
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * \brief Reinterpret the bytes as an array of elements, without copying.
+         * \tparam T Trivially copyable element type.
+         * \return Span of elements.
+         */
+        template<typename T>
+            requires(std::is_trivially_copyable_v<T>)
+        [[nodiscard]] std::span<const T> as() const
+        {
+            checkAs(alignof(T), sizeof(T));
+            return {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+        }
+
+    private:
+        void checkAs(size_t alignment, size_t size) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<const void> owner;
+
+        std::span<const std::byte> bytes;
+    };
+
+    /**
+     * \brief Append-only file of blobs that is read through a memory map. Values are aligned to 16 bytes, so that views
+     * of unencoded values can be reinterpreted as arrays without copying. The file is mapped as a whole and remapped
+     * when a read goes beyond the mapped size. Previous mappings stay alive as long as there are views into them.
+     * Appending and reading are thread-safe. Several processes can append to the same file: appends are serialized by
+     * an exclusive file lock, under which the current size of the file is read again. Each open PackFile also holds a
+     * shared lock on the file, which prevents removeIfUnused from removing it.
+     */
+    class PackFile
+    {
+    public:
+        /**
+         * \brief Alignment of values in bytes.
+         */
+        static constexpr uint64_t alignment = 16;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        PackFile() = delete;
+
+        /**
+         * \brief Open a pack file, creating it if it does not exist.
+         * \param file Path to pack file.
+         */
+        explicit PackFile(std::filesystem::path file);
+
+        PackFile(const PackFile&) = delete;
+
+        PackFile(PackFile&&) = delete;
+
+        ~PackFile() noexcept;
+
+        PackFile& operator=(const PackFile&) = delete;
+
+        PackFile& operator=(PackFile&&) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] const std::filesystem::path& getPath() const noexcept;
+
+        /**
+         * \brief Get the size of the file in bytes, including padding and values appended by other processes.
+         * \return Size.
+         */
+        [[nodiscard]] uint64_t size() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Removing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Remove a pack file, unless it is opened by a PackFile in this or another process. The file is removed
+         * while holding an exclusive lock on it.
+         * \param file Path to pack file.
+         * \return True if the file was removed or did not exist.
+         */
+        static bool removeIfUnused(const std::filesystem::path& file);
+
+        ////////////////////////////////////////////////////////////////
+        // Reading and writing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Append a value to the end of the file.
+         * \param data Value.
+         * \return Offset of the value.
+         */
+        [[nodiscard]] uint64_t append(std::span<const std::byte> data);
+
+        /**
+         * \brief Flush all appended values to disk.
+         */
+        void sync();
+
+        /**
+         * \brief Get a view of a range of the file.
+         * \param offset Offset in bytes.
+         * \param length Length in bytes.
+         * \return BlobView into the memory map.
+         */
+        [[nodiscard]] BlobView view(uint64_t offset, uint64_t length) const;
+
+    private:
+        struct Mapping;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::filesystem::path path;
+
+#ifdef WIN32
+        void* handle = nullptr;
+#else
+        int32_t handle = -1;
+#endif
+
+        mutable uint64_t fileSize = 0;
+
+        mutable std::mutex mutex;
+
+        mutable std::shared_ptr<const Mapping> mapping;
+    };
+}  // namespace alex
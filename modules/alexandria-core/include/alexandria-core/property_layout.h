@@ -11,6 +11,7 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/codec.h"
 #include "alexandria-core/data_type.h"
 #include "alexandria-core/fwd.h"
 
@@ -27,8 +28,19 @@ namespace alex
         // Constructors.
         ////////////////////////////////////////////////////////////////
 
-        PropertyLayout(
-          TypeLayout& layout, std::string propName, DataType type, Type* refType, bool isArray, bool isBlob);
+        PropertyLayout(TypeLayout& layout,
+                       std::string propName,
+                       DataType    type,
+                       Type*       refType,
+                       bool        isArray,
+                       bool        isBlob,
+                       bool        isFullText     = false,
+                       bool        isSpatial      = false,
+                       bool        isIndexed      = false,
+                       Codec       codec          = Codec::None,
+                       bool        isDeduplicated = false,
+                       int64_t     threshold      = 0,
+                       bool        isPacked       = false);
 
         PropertyLayout() = delete;
 
@@ -84,6 +96,144 @@ namespace alex
          */
         [[nodiscard]] bool isBlob() const noexcept;
 
+        /**
+         * \brief Returns whether this property has a full-text index.
+         * \return True if indexed.
+         */
+        [[nodiscard]] bool isFullText() const noexcept;
+
+        /**
+         * \brief Get the name of the full-text index table of a column.
+         * \param table Name of the table holding the indexed column.
+         * \param column Name of the indexed column.
+         * \return Table name.
+         */
+        [[nodiscard]] static std::string getFullTextTableName(const std::string& table, const std::string& column);
+
+        /**
+         * \brief Returns whether this property has a spatial index.
+         * \return True if indexed.
+         */
+        [[nodiscard]] bool isSpatial() const noexcept;
+
+        /**
+         * \brief Get the name of the spatial index table of a nested property.
+         * \param table Name of the instance table.
+         * \param column Name of the first indexed column, i.e. the column of the first property of the nested type.
+         * \return Table name.
+         */
+        [[nodiscard]] static std::string getSpatialTableName(const std::string& table, const std::string& column);
+
+        /**
+         * \brief Returns whether this property has a value index.
+         * \return True if indexed.
+         */
+        [[nodiscard]] bool isIndexed() const noexcept;
+
+        /**
+         * \brief Get the name of the value index of a property.
+         * \param table Name of the instance table.
+         * \param column Name of the indexed column.
+         * \return Index name.
+         */
+        [[nodiscard]] static std::string getIndexName(const std::string& table, const std::string& column);
+
+        /**
+         * \brief Get the compression codec of this property.
+         * \return Codec.
+         */
+        [[nodiscard]] Codec getCodec() const noexcept;
+
+        /**
+         * \brief Returns whether the values of this property are deduplicated.
+         * \return True if deduplicated.
+         */
+        [[nodiscard]] bool isDeduplicated() const noexcept;
+
+        /**
+         * \brief Get the size from which values of this property are stored in the pack file of the library.
+         * \return Threshold in bytes. 0 if values are never stored externally.
+         */
+        [[nodiscard]] int64_t getExternalThreshold() const noexcept;
+
+        /**
+         * \brief Returns whether the values of this array property are packed into a single row.
+         * \return True if packed.
+         */
+        [[nodiscard]] bool isPacked() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Enable or disable the full-text index of this property. When the type is committed, an FTS5 table is
+         * generated that indexes the instance column (or the values of the array table) and is kept in sync by
+         * triggers. Only allowed for string and string array properties.
+         * \param enabled Enable index.
+         * \return *this.
+         */
+        PropertyLayout& setFullText(bool enabled = true);
+
+        /**
+         * \brief Enable or disable the spatial index of this property. When the type is committed, an R*Tree table is
+         * generated that indexes the members of the nested type as a point, and is kept in sync by triggers. Only
+         * allowed for nested type properties whose type has 2 or 3 numeric properties.
+         * \param enabled Enable index.
+         * \return *this.
+         */
+        PropertyLayout& setSpatial(bool enabled = true);
+
+        /**
+         * \brief Enable or disable the value index of this property. When the type is committed, an index is created on
+         * the column of the property in the instance table, which is used by searches that filter or order on it. Only
+         * allowed for primitive and string properties that are not arrays or blobs.
+         * \param enabled Enable index.
+         * \return *this.
+         */
+        PropertyLayout& setIndexed(bool enabled = true);
+
+        /**
+         * \brief Set the compression codec of this property. Values are encoded when they are inserted and decoded when
+         * they are retrieved. Only allowed for blob, primitive blob and blob array properties. Codec::DeltaVarint is
+         * only allowed for primitive blobs of integers. Note that encoded values cannot be accessed incrementally.
+         * \param c Codec.
+         * \return *this.
+         */
+        PropertyLayout& setCodec(Codec c);
+
+        /**
+         * \brief Enable or disable deduplication of the values of this property. Deduplicated values are stored once
+         * per distinct content in a shared, reference counted table (see BlobStore), and the instance or array table
+         * only holds their content key. Values are encoded with the codec of the property before they are hashed. Only
+         * allowed for blob, primitive blob and blob array properties. Note that deduplicated values cannot be opened
+         * for incremental writing.
+         * \param enabled Enable deduplication.
+         * \return *this.
+         */
+        PropertyLayout& setDeduplicated(bool enabled = true);
+
+        /**
+         * \brief Store values of this property with an (encoded) size of at least threshold bytes in the pack file of
+         * the library (see ExternalStore), instead of in the database. The instance or array table then only holds the
+         * id of the value. External values can be read without copying through a memory map, but cannot be opened for
+         * incremental reading or writing. Only allowed for blob, primitive blob and blob array properties that are not
+         * deduplicated.
+         * \param threshold Threshold in bytes. 0 to store all values in the database.
+         * \return *this.
+         */
+        PropertyLayout& setExternal(int64_t threshold);
+
+        /**
+         * \brief Store all values of this array property in a single row of its array table, as one blob, instead of
+         * one row per element. Primitive values are stored back to back, strings are prefixed with their length. This
+         * makes inserting and retrieving large arrays much faster, but the elements can no longer be searched. Only
+         * allowed for primitive and string array properties without a full-text index.
+         * \param enabled Enable or disable.
+         * \return *this.
+         */
+        PropertyLayout& setPacked(bool enabled = true);
+
     private:
         /**
          * \brief Commit this property to the library. Inserts entries into the property table.
@@ -98,6 +248,15 @@ namespace alex
                       std::vector<sql::Table*>& referenceArrayTables,
                       const std::string&        prefix) const;
 
+        /**
+         * \brief Generate indices that require the instance and array tables to be committed (e.g. full-text indices
+         * and the triggers that keep them in sync).
+         */
+        void generateIndices(Library&           library,
+                             sql::row_id        currentType,
+                             const sql::Table&  instanceTable,
+                             const std::string& prefix) const;
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -131,6 +290,41 @@ namespace alex
          * \brief Indicates property is a blob type.
          */
         bool blob;
+
+        /**
+         * \brief Indicates property has a full-text index.
+         */
+        bool fullText = false;
+
+        /**
+         * \brief Indicates property has a spatial index.
+         */
+        bool spatial = false;
+
+        /**
+         * \brief Indicates property has a value index.
+         */
+        bool indexed = false;
+
+        /**
+         * \brief Compression codec.
+         */
+        Codec codec = Codec::None;
+
+        /**
+         * \brief Indicates property values are deduplicated.
+         */
+        bool deduplicated = false;
+
+        /**
+         * \brief Size from which values are stored externally.
+         */
+        int64_t externalThreshold = 0;
+
+        /**
+         * \brief Indicates array values are packed into a single row.
+         */
+        bool packed = false;
     };
 
     using PropertyLayoutPtr = std::unique_ptr<PropertyLayout>;
@@ -0,0 +1,257 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/fwd.h"
+
+namespace alex
+{
+    /**
+     * \brief Class of an instrumented query.
+     */
+    enum class QueryClass : uint8_t
+    {
+        Insert = 0,
+        Get    = 1,
+        Update = 2,
+        Delete = 3,
+        Search = 4
+    };
+
+    inline constexpr size_t queryClassCount = 5;
+
+    /**
+     * \brief Stage of an instrumented query.
+     *  - Total: the whole query, from start to finish.
+     *  - Uuid: generating and/or formatting the instance identifier.
+     *  - Begin: beginning the transaction.
+     *  - Primitive: inserting, getting, updating or deleting the instance table row.
+     *  - PrimitiveArray, BlobArray, ReferenceArray: inserting or getting the elements of all arrays of that kind.
+     *  - ArrayClear: deleting the old elements of all arrays before an update.
+     *  - Commit: committing the transaction.
+     *  - Bind: binding the parameters of a search.
+     *  - Execute: counting, checking or visiting the results of a search.
+     */
+    enum class QueryStage : uint8_t
+    {
+        Total          = 0,
+        Uuid           = 1,
+        Begin          = 2,
+        Primitive      = 3,
+        PrimitiveArray = 4,
+        BlobArray      = 5,
+        ReferenceArray = 6,
+        ArrayClear     = 7,
+        Commit         = 8,
+        Bind           = 9,
+        Execute        = 10
+    };
+
+    inline constexpr size_t queryStageCount = 11;
+
+    [[nodiscard]] std::string_view toString(QueryClass query) noexcept;
+
+    [[nodiscard]] std::string_view toString(QueryStage stage) noexcept;
+
+    /**
+     * \brief Timed stage of a query.
+     */
+    struct QueryEvent
+    {
+        /**
+         * \brief Type the query operates on.
+         */
+        const Type* type = nullptr;
+
+        QueryClass query = QueryClass::Get;
+
+        QueryStage stage = QueryStage::Total;
+
+        std::chrono::nanoseconds duration{};
+
+        /**
+         * \brief Number of rows returned by, plus the number of rows modified by, the statements of the stage.
+         */
+        uint64_t rows = 0;
+
+        /**
+         * \brief Number of bytes in the columns of the returned rows. Integers and floats count as 8 bytes.
+         */
+        uint64_t bytes = 0;
+
+        /**
+         * \brief Whether the stage was left by an exception.
+         */
+        bool failed = false;
+    };
+
+    /**
+     * \brief Finished sqlite statement, as reported by the profile callback of sqlite3_trace_v2. Includes statements
+     * that are not part of an instrumented query.
+     */
+    struct StatementEvent
+    {
+        /**
+         * \brief Unexpanded SQL of the statement. Only valid for the duration of the callback.
+         */
+        std::string_view sql;
+
+        std::chrono::nanoseconds duration{};
+    };
+
+    /**
+     * \brief Receives timing events of the queries and statements run through a library. Register an observer with
+     * Library::setQueryObserver. Callbacks are invoked synchronously on the thread that runs the query, so they should
+     * be cheap. An observer that is registered on several libraries must be thread-safe.
+     */
+    class QueryObserver
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        QueryObserver() = default;
+
+        QueryObserver(const QueryObserver&) = delete;
+
+        QueryObserver(QueryObserver&&) noexcept = delete;
+
+        virtual ~QueryObserver() noexcept = default;
+
+        QueryObserver& operator=(const QueryObserver&) = delete;
+
+        QueryObserver& operator=(QueryObserver&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Events.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Called when a stage of a query finishes. The Total stage of a query is reported last.
+         * \param event Event.
+         */
+        virtual void onQuery(const QueryEvent& event);
+
+        /**
+         * \brief Called when a statement finishes.
+         * \param event Event.
+         */
+        virtual void onStatement(const StatementEvent& event);
+    };
+
+    /**
+     * \brief Row and byte counters of a library. Only maintained while a query observer is registered.
+     */
+    struct QueryCounters
+    {
+        uint64_t rows = 0;
+
+        uint64_t bytes = 0;
+    };
+
+    /**
+     * \brief Times the consecutive stages of a query and reports them to the query observer of a library. Does
+     * nothing beyond a null check if no observer is registered.
+     *
+     * \code
+     * QueryProfile profile(library, type, QueryClass::Get);
+     * profile.stage(QueryStage::Begin);
+     * sql::Transaction transaction(db, sql::Transaction::Type::Deferred);
+     * profile.stage(QueryStage::Primitive);
+     * ...
+     * \endcode
+     */
+    class QueryProfile
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        QueryProfile() = delete;
+
+        /**
+         * \brief Start timing a query.
+         * \param library Library. Must outlive the profile.
+         * \param type Type.
+         * \param query Query class.
+         */
+        QueryProfile(const Library& library, const Type& type, QueryClass query) noexcept;
+
+        QueryProfile(const QueryProfile&) = delete;
+
+        QueryProfile(QueryProfile&&) noexcept = delete;
+
+        /**
+         * \brief Report the current stage and the whole query.
+         */
+        ~QueryProfile() noexcept
+        {
+            if (observer) finish();
+        }
+
+        QueryProfile& operator=(const QueryProfile&) = delete;
+
+        QueryProfile& operator=(QueryProfile&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Stages.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Report the current stage, if any, and start timing the next one.
+         * \param next Next stage.
+         */
+        void stage(const QueryStage next) noexcept
+        {
+            if (observer) enter(next);
+        }
+
+    private:
+        struct Mark
+        {
+            std::chrono::steady_clock::time_point time;
+            QueryCounters                         counters;
+        };
+
+        [[nodiscard]] Mark mark() const noexcept;
+
+        void report(QueryStage s, const Mark& from, const Mark& to, bool failed) const noexcept;
+
+        void enter(QueryStage next) noexcept;
+
+        void finish() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        QueryObserver* observer = nullptr;
+
+        const Library* library = nullptr;
+
+        const Type* type = nullptr;
+
+        QueryClass query = QueryClass::Get;
+
+        QueryStage current = QueryStage::Total;
+
+        int32_t exceptions = 0;
+
+        Mark start;
+
+        Mark stageStart;
+    };
+}  // namespace alex
@@ -0,0 +1,235 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "cppql/include_all.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace alex
+{
+    /**
+     * \brief Thin owning wrapper around a prepared sqlite3 statement. Used for generated SQL that cannot be expressed
+     * with the typed cppql query builders. Parameters are bound by (1-based) index or by name.
+     */
+    class RawStatement
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        RawStatement() = default;
+
+        /**
+         * \brief Prepare a statement.
+         * \param db Database.
+         * \param sql SQL string. Must contain a single statement.
+         * \param persistent If true, hints that the statement will be reused many times.
+         */
+        RawStatement(sql::Database& db, std::string sql, bool persistent = true);
+
+        RawStatement(const RawStatement&) = delete;
+
+        RawStatement(RawStatement&& other) noexcept;
+
+        ~RawStatement() noexcept;
+
+        RawStatement& operator=(const RawStatement&) = delete;
+
+        RawStatement& operator=(RawStatement&& other) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] sqlite3_stmt* get() const noexcept;
+
+        [[nodiscard]] const std::string& getSql() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Execution.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Step the statement.
+         * \return True if a row is available, false if the statement is done.
+         */
+        bool step();
+
+        /**
+         * \brief Reset the statement so that it can be stepped again. Bindings are retained.
+         */
+        void reset();
+
+        /**
+         * \brief Reset all bound parameters to null.
+         */
+        void clearBindings();
+
+        ////////////////////////////////////////////////////////////////
+        // Binding.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the index of a named parameter.
+         * \param name Parameter name, including prefix (e.g. ":p0").
+         * \return Index, or 0 if the statement does not use the parameter.
+         */
+        [[nodiscard]] int32_t getParameterIndex(const std::string& name) const;
+
+        void bindNull(int32_t index);
+
+        void bindInt64(int32_t index, int64_t value);
+
+        void bindDouble(int32_t index, double value);
+
+        void bindText(int32_t index, std::string_view value);
+
+        void bindBlob(int32_t index, std::span<const std::byte> value);
+
+        void bindZeroBlob(int32_t index, int64_t size);
+
+        /**
+         * \brief Bind a value, selecting the sqlite3 type from the C++ type.
+         * \tparam T Value type.
+         * \param index Parameter index.
+         * \param value Value.
+         */
+        template<typename T>
+        void bind(const int32_t index, const T& value)
+        {
+            if constexpr (std::same_as<T, std::nullptr_t>)
+                bindNull(index);
+            else if constexpr (std::integral<T>)
+                bindInt64(index, static_cast<int64_t>(value));
+            else if constexpr (std::floating_point<T>)
+                bindDouble(index, static_cast<double>(value));
+            else if constexpr (std::convertible_to<const T&, std::string_view>)
+                bindText(index, std::string_view(value));
+            else
+                bindBlob(index, std::as_bytes(std::span(value)));
+        }
+
+        /**
+         * \brief Bind a value to a named parameter. Does nothing if the statement does not use the parameter.
+         * \tparam T Value type.
+         * \param name Parameter name.
+         * \param value Value.
+         */
+        template<typename T>
+        void bind(const std::string& name, const T& value)
+        {
+            if (const auto index = getParameterIndex(name); index > 0) bind(index, value);
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Columns.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] int32_t getColumnCount() const noexcept;
+
+        [[nodiscard]] bool isNull(int32_t index) const noexcept;
+
+        [[nodiscard]] bool isInteger(int32_t index) const noexcept;
+
+        [[nodiscard]] bool isText(int32_t index) const noexcept;
+
+        [[nodiscard]] int64_t getInt64(int32_t index) const noexcept;
+
+        [[nodiscard]] double getDouble(int32_t index) const noexcept;
+
+        /**
+         * \brief Get text column. The view is valid until the statement is stepped, reset or destroyed.
+         * \param index Column index.
+         * \return View of text.
+         */
+        [[nodiscard]] std::string_view getText(int32_t index) const noexcept;
+
+        /**
+         * \brief Get blob column. The view is valid until the statement is stepped, reset or destroyed.
+         * \param index Column index.
+         * \return View of bytes.
+         */
+        [[nodiscard]] std::span<const std::byte> getBlob(int32_t index) const noexcept;
+
+    private:
+        void check(int32_t result) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        sqlite3* db = nullptr;
+
+        sqlite3_stmt* statement = nullptr;
+
+        std::string sqlString;
+    };
+
+    /**
+     * \brief Resets a statement and clears its bindings when going out of scope, so that the database is not kept
+     * locked by a pending statement, also when an exception is thrown.
+     */
+    class ScopedReset
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ScopedReset() = delete;
+
+        explicit ScopedReset(RawStatement& stmt) noexcept : statement(&stmt) {}
+
+        ScopedReset(const ScopedReset&) = delete;
+
+        ScopedReset(ScopedReset&&) = delete;
+
+        ~ScopedReset() noexcept
+        {
+            statement->reset();
+            statement->clearBindings();
+        }
+
+        ScopedReset& operator=(const ScopedReset&) = delete;
+
+        ScopedReset& operator=(ScopedReset&&) = delete;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        RawStatement* statement = nullptr;
+    };
+
+    /**
+     * \brief Execute one or more statements that do not return rows, e.g. schema modifications.
+     * \param db Database.
+     * \param sql SQL string.
+     */
+    void execute(sql::Database& db, const std::string& sql);
+
+    /**
+     * \brief Quote an identifier (table or column name) for use in generated SQL.
+     * \param name Identifier.
+     * \return Quoted identifier.
+     */
+    [[nodiscard]] std::string quoteIdentifier(std::string_view name);
+}  // namespace alex
@@ -0,0 +1,176 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/fwd.h"
+#include "alexandria-core/library.h"
+
+namespace alex
+{
+    /**
+     * \brief Set of libraries that share one specification and partition the instances of every type between them.
+     * Each library is a separate file with its own writer, so writes to different shards do not contend. Instances are
+     * routed to a shard by a hash of their ID, which is stable across processes and platforms. The sharded queries
+     * (ShardedInsertQuery, ShardedGetQuery, ..., ShardedSearchQuery) route to or fan out over the shards.
+     *
+     * References do not cross shards. The reference columns of a shard have foreign keys to the instance tables of
+     * that same shard, so inserting or updating an instance with a reference to an instance in another shard fails
+     * like a reference to an instance that does not exist. Instances that reference each other must be co-located,
+     * by inserting them with an ID generated for the shard of the referenced instance (see generateId). Deleting an
+     * instance only nulls or removes references to it within its own shard.
+     *
+     * \code
+     * auto library = alex::ShardedLibrary::create(alex::ShardedLibrary::getShardFiles("library.alex", 4));
+     * library->updateSpecification([](alex::Library& shard) {
+     *     auto& nameSpace = shard.createNamespace("main");
+     *     ...
+     * });
+     * \endcode
+     */
+    class ShardedLibrary
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ShardedLibrary() = delete;
+
+        /**
+         * \brief Construct from opened libraries. Their specifications must be equal.
+         * \param libraries Shards, in order. The order determines the routing, so it must never change.
+         */
+        explicit ShardedLibrary(std::vector<LibraryPtr> libraries);
+
+        ShardedLibrary(const ShardedLibrary&) = delete;
+
+        ShardedLibrary(ShardedLibrary&&) noexcept = default;
+
+        ~ShardedLibrary() noexcept = default;
+
+        ShardedLibrary& operator=(const ShardedLibrary&) = delete;
+
+        ShardedLibrary& operator=(ShardedLibrary&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Static open/create methods.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create new libraries.
+         * \param files Path to the library file of each shard. Empty paths create in-memory shards.
+         * \return ShardedLibrary.
+         */
+        static ShardedLibraryPtr create(const std::vector<std::filesystem::path>& files);
+
+        /**
+         * \brief Open existing libraries.
+         * \param files Path to the library file of each shard, in the order in which they were created.
+         * \return ShardedLibrary.
+         */
+        static ShardedLibraryPtr open(const std::vector<std::filesystem::path>& files);
+
+        /**
+         * \brief Open existing libraries or create them if none of them exist.
+         * \param files Path to the library file of each shard.
+         * \return ShardedLibrary and boolean indicating whether new libraries were created.
+         */
+        static std::pair<ShardedLibraryPtr, bool> openOrCreate(const std::vector<std::filesystem::path>& files);
+
+        /**
+         * \brief Get the paths of the files of a number of shards, i.e. "<file>.0", "<file>.1", etc.
+         * \param file Base path.
+         * \param count Number of shards.
+         * \return Paths.
+         */
+        [[nodiscard]] static std::vector<std::filesystem::path> getShardFiles(const std::filesystem::path& file,
+                                                                              size_t                       count);
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t getShardCount() const noexcept;
+
+        [[nodiscard]] Library& getShard(size_t index);
+
+        [[nodiscard]] const Library& getShard(size_t index) const;
+
+        /**
+         * \brief Get the shard an instance is stored in.
+         * \param id Valid instance ID.
+         * \return Library.
+         */
+        [[nodiscard]] Library& getShard(const InstanceId& id);
+
+        /**
+         * \brief Get the index of the shard an instance is stored in, from the FNV-1a hash of the bytes of its ID.
+         * \param id Valid instance ID.
+         * \return Index.
+         */
+        [[nodiscard]] size_t getShardIndex(const InstanceId& id) const;
+
+        /**
+         * \brief Generate a new ID that is routed to the given shard. Used to co-locate instances that reference each
+         * other. Takes the number of shards attempts on average.
+         * \param index Shard index.
+         * \return ID.
+         */
+        [[nodiscard]] InstanceId generateId(size_t index) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Specification.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Modify the specification of every shard in the same way, e.g. create namespaces and commit types, and
+         * verify that the specifications are still equal afterwards.
+         * \tparam F Callable taking a Library&.
+         * \param f Function that is called once for each shard.
+         */
+        template<std::invocable<Library&> F>
+        void updateSpecification(F&& f)
+        {
+            for (auto& shard : shards) f(*shard);
+            verifySpecification();
+        }
+
+        /**
+         * \brief Verify that all shards have the same namespaces, types, properties and generated tables, with the
+         * same ids. Throws if they do not.
+         */
+        void verifySpecification() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Execution.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Call a function for every shard, each on its own thread. Rethrows the first exception once all calls
+         * have returned. The shards must not be used by other threads in the meantime.
+         * \param f Function taking the shard index.
+         */
+        void parallel(const std::function<void(size_t)>& f) const;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::vector<LibraryPtr> shards;
+    };
+}  // namespace alex
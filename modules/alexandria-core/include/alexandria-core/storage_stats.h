@@ -0,0 +1,192 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "cppql/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/external_store.h"
+
+namespace alex
+{
+    /**
+     * \brief Storage used by one or more sqlite b-trees, as reported by the dbstat virtual table.
+     */
+    struct BtreeStats
+    {
+        /**
+         * \brief Number of rows of tables, or number of entries of indices.
+         */
+        uint64_t rows = 0;
+
+        /**
+         * \brief Number of pages, including overflow pages.
+         */
+        uint64_t pages = 0;
+
+        /**
+         * \brief Number of leaf pages, i.e. pages holding rows or entries.
+         */
+        uint64_t leafPages = 0;
+
+        /**
+         * \brief Number of overflow pages, i.e. pages holding the part of a row that does not fit on a leaf page.
+         */
+        uint64_t overflowPages = 0;
+
+        /**
+         * \brief Number of bytes of stored values and keys.
+         */
+        uint64_t payload = 0;
+
+        /**
+         * \brief Number of unused bytes in all pages.
+         */
+        uint64_t unused = 0;
+
+        /**
+         * \brief Size of all pages in bytes.
+         */
+        uint64_t size = 0;
+
+        /**
+         * \brief Number of leaf pages that do not directly follow the previous leaf page of the b-tree in the file.
+         */
+        uint64_t fragmentedPages = 0;
+
+        /**
+         * \brief Get the fraction of leaf pages that do not directly follow the previous leaf page of the b-tree in the
+         * file. Scans of a fragmented b-tree cause more random I/O. VACUUM defragments all b-trees.
+         * \return Fragmentation in [0, 1].
+         */
+        [[nodiscard]] double getFragmentation() const noexcept;
+
+        /**
+         * \brief Add the storage of another b-tree.
+         * \param other Stats.
+         */
+        void merge(const BtreeStats& other) noexcept;
+    };
+
+    /**
+     * \brief Size of the values in a column.
+     */
+    struct ColumnStats
+    {
+        std::string name;
+
+        /**
+         * \brief Number of bytes of all values. Text and blobs count their length, integers and floats count as 8
+         * bytes, although sqlite stores small integers in fewer bytes.
+         */
+        uint64_t bytes = 0;
+    };
+
+    /**
+     * \brief Storage used by a table and its indices.
+     */
+    struct TableStats
+    {
+        /**
+         * \brief Table name.
+         */
+        std::string name;
+
+        /**
+         * \brief Kind of generated table, i.e. "instance", "primitive_array", "blob_array", "reference_array",
+         * "spatial" or "fulltext". Empty for tables that do not belong to a type. The storage of spatial and fulltext
+         * tables is that of their shadow tables.
+         */
+        std::string kind;
+
+        BtreeStats table;
+
+        BtreeStats indices;
+
+        /**
+         * \brief Size of the values in each column of instance and array tables, in order of declaration. Shows which
+         * properties take up the payload of a table.
+         */
+        std::vector<ColumnStats> columns;
+    };
+
+    /**
+     * \brief Storage used by all generated tables of a type.
+     */
+    struct TypeStats
+    {
+        std::string nameSpace;
+
+        std::string name;
+
+        /**
+         * \brief Generated tables, in order of creation.
+         */
+        std::vector<TableStats> tables;
+
+        /**
+         * \brief Storage of all tables.
+         */
+        BtreeStats table;
+
+        /**
+         * \brief Storage of all indices.
+         */
+        BtreeStats indices;
+    };
+
+    /**
+     * \brief Storage statistics of a library. See Library::storageStats.
+     */
+    struct StorageStats
+    {
+        uint64_t pageSize = 0;
+
+        /**
+         * \brief Number of pages in the database file.
+         */
+        uint64_t pageCount = 0;
+
+        /**
+         * \brief Number of unused pages. These are reused before the file grows, or removed by VACUUM.
+         */
+        uint64_t freePages = 0;
+
+        /**
+         * \brief Types, sorted by namespace and name.
+         */
+        std::vector<TypeStats> types;
+
+        /**
+         * \brief Tables that do not belong to a type, e.g. the library metadata and the blob stores.
+         */
+        std::vector<TableStats> other;
+
+        BlobStore::Stats shared;
+
+        ExternalStore::Stats external;
+
+        /**
+         * \brief Read the storage statistics of a database. Requires sqlite to be compiled with
+         * SQLITE_ENABLE_DBSTAT_VTAB. Visits every page and scans every generated table, so it takes time proportional
+         * to the size of the database.
+         * \param db Database.
+         * \return Stats. The external blob statistics are left empty.
+         */
+        [[nodiscard]] static StorageStats read(sql::Database& db);
+    };
+}  // namespace alex
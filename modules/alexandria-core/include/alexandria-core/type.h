@@ -108,6 +108,38 @@ namespace alex
          */
         [[nodiscard]] const std::vector<sql::Table*>& getReferenceArrayTables() const;
 
+        /**
+         * \brief Get the compression codec of a blob, primitive blob or blob array property, including those of nested
+         * types.
+         * \param column Name of the column of the instance table holding the property, or for blob arrays, the name of
+         * the array table without the instance table prefix.
+         * \return Codec. Codec::None if there is no such property.
+         */
+        [[nodiscard]] Codec getCodec(const std::string& column) const;
+
+        /**
+         * \brief Returns whether the values of a blob, primitive blob or blob array property are deduplicated.
+         * \param column Name of the column of the instance table holding the property, or for blob arrays, the name of
+         * the array table without the instance table prefix.
+         * \return True if deduplicated. False if there is no such property.
+         */
+        [[nodiscard]] bool isDeduplicated(const std::string& column) const;
+
+        /**
+         * \brief Get the size from which values of a blob, primitive blob or blob array property are stored externally.
+         * \param column Name of the column of the instance table holding the property, or for blob arrays, the name of
+         * the array table without the instance table prefix.
+         * \return Threshold in bytes. 0 if values are never stored externally, or if there is no such property.
+         */
+        [[nodiscard]] int64_t getExternalThreshold(const std::string& column) const;
+
+        /**
+         * \brief Returns whether the values of a primitive or string array property are packed into a single row.
+         * \param column Name of the array table without the instance table prefix.
+         * \return True if packed. False if there is no such property.
+         */
+        [[nodiscard]] bool isPacked(const std::string& column) const;
+
     private:
         /**
          * \brief Row ID.
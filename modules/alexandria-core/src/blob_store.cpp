@@ -0,0 +1,208 @@
+#include "alexandria-core/blob_store.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <format>
+
+namespace
+{
+    [[nodiscard]] constexpr uint64_t rotl(const uint64_t x, const int32_t r) noexcept
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    [[nodiscard]] constexpr uint64_t fmix(uint64_t k) noexcept
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    [[nodiscard]] uint64_t load(const std::byte* data) noexcept
+    {
+        // Assemble explicitly to get the same keys on little and big endian platforms.
+        uint64_t v = 0;
+        for (int32_t i = 7; i >= 0; i--) v = (v << 8) | static_cast<uint64_t>(data[i]);
+        return v;
+    }
+
+    void store(std::byte* data, uint64_t v) noexcept
+    {
+        for (int32_t i = 0; i < 8; i++, v >>= 8) data[i] = static_cast<std::byte>(v & 0xff);
+    }
+}  // namespace
+
+namespace alex
+{
+    BlobKey hashBlob(const std::span<const std::byte> data) noexcept
+    {
+        constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+        constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+        uint64_t h1 = 0, h2 = 0;
+
+        const auto mix1 = [&](uint64_t k1) {
+            k1 *= c1;
+            k1 = rotl(k1, 31);
+            k1 *= c2;
+            h1 ^= k1;
+        };
+        const auto mix2 = [&](uint64_t k2) {
+            k2 *= c2;
+            k2 = rotl(k2, 33);
+            k2 *= c1;
+            h2 ^= k2;
+        };
+
+        // Body.
+        const auto blocks = data.size() / 16;
+        for (size_t i = 0; i < blocks; i++)
+        {
+            mix1(load(data.data() + i * 16));
+            h1 = rotl(h1, 27);
+            h1 += h2;
+            h1 = h1 * 5 + 0x52dce729;
+
+            mix2(load(data.data() + i * 16 + 8));
+            h2 = rotl(h2, 31);
+            h2 += h1;
+            h2 = h2 * 5 + 0x38495ab5;
+        }
+
+        // Tail. Zero padding is equivalent to mixing in only the remaining bytes.
+        if (const auto remaining = data.size() % 16; remaining > 0)
+        {
+            std::array<std::byte, 16> tail{};
+            std::memcpy(tail.data(), data.data() + blocks * 16, remaining);
+            if (remaining > 8) mix2(load(tail.data() + 8));
+            mix1(load(tail.data()));
+        }
+
+        // Finalization.
+        h1 ^= static_cast<uint64_t>(data.size());
+        h2 ^= static_cast<uint64_t>(data.size());
+        h1 += h2;
+        h2 += h1;
+        h1 = fmix(h1);
+        h2 = fmix(h2);
+        h1 += h2;
+        h2 += h1;
+
+        BlobKey key;
+        store(key.data(), h1);
+        store(key.data() + 8, h2);
+        return key;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    BlobStore::BlobStore(sql::Database& db) :
+        insert(db,
+               std::format("INSERT INTO {} (key, refcount, value) VALUES (?1, 0, ?2) ON CONFLICT(key) DO NOTHING;",
+                           quoteIdentifier(getTableName())))
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    double BlobStore::Stats::getRatio() const noexcept
+    {
+        return storedBytes == 0 ? 1.0 : static_cast<double>(referencedBytes) / static_cast<double>(storedBytes);
+    }
+
+    const std::string& BlobStore::getTableName()
+    {
+        static const std::string name = "shared_blobs";
+        return name;
+    }
+
+    BlobStore::Stats BlobStore::getStats(sql::Database& db)
+    {
+        Stats stats;
+
+        {
+            RawStatement stmt(db, "SELECT 1 FROM sqlite_schema WHERE type = 'table' AND name = ?1;", false);
+            stmt.bind(1, getTableName());
+            if (!stmt.step()) return stats;
+        }
+
+        RawStatement stmt(db,
+                          std::format("SELECT count(*), total(refcount), total(length(value)), "
+                                      "total(refcount * length(value)) FROM {};",
+                                      quoteIdentifier(getTableName())),
+                          false);
+        stmt.step();
+        stats.blobs           = stmt.getInt64(0);
+        stats.references      = static_cast<int64_t>(stmt.getDouble(1));
+        stats.storedBytes     = static_cast<int64_t>(stmt.getDouble(2));
+        stats.referencedBytes = static_cast<int64_t>(stmt.getDouble(3));
+        return stats;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Blobs.
+    ////////////////////////////////////////////////////////////////
+
+    BlobKey BlobStore::put(const std::span<const std::byte> value)
+    {
+        ScopedReset reset{insert};
+
+        const auto key = hashBlob(value);
+        insert.bind(1, key);
+        // Bind a zero length blob rather than null for empty values, so that they are read back as empty.
+        if (value.empty())
+            insert.bindZeroBlob(2, 0);
+        else
+            insert.bindBlob(2, value);
+        insert.step();
+        return key;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    void BlobStore::create(sql::Database& db)
+    {
+        execute(db,
+                std::format("CREATE TABLE IF NOT EXISTS {} (id INTEGER PRIMARY KEY, key BLOB NOT NULL UNIQUE, "
+                            "refcount INTEGER NOT NULL, value BLOB);",
+                            quoteIdentifier(getTableName())));
+    }
+
+    void BlobStore::createTriggers(sql::Database& db, const std::string& table, const std::string& column)
+    {
+        const auto qBlobs = quoteIdentifier(getTableName());
+        const auto qTab   = quoteIdentifier(table);
+        const auto qCol   = quoteIdentifier(column);
+        const auto name   = table + "_" + column + "_dedup";
+
+        const auto increment = std::format("UPDATE {} SET refcount = refcount + 1 WHERE key = new.{};", qBlobs, qCol);
+        const auto decrement = std::format("UPDATE {0} SET refcount = refcount - 1 WHERE key = old.{1}; "
+                                           "DELETE FROM {0} WHERE key = old.{1} AND refcount <= 0;",
+                                           qBlobs,
+                                           qCol);
+
+        execute(db,
+                std::format("CREATE TRIGGER {0} AFTER INSERT ON {3} BEGIN {5} END;"
+                            "CREATE TRIGGER {1} AFTER DELETE ON {3} BEGIN {6} END;"
+                            "CREATE TRIGGER {2} AFTER UPDATE OF {4} ON {3} BEGIN {5} {6} END;",
+                            quoteIdentifier(name + "_insert"),
+                            quoteIdentifier(name + "_delete"),
+                            quoteIdentifier(name + "_update"),
+                            qTab,
+                            qCol,
+                            increment,
+                            decrement));
+    }
+}  // namespace alex
@@ -0,0 +1,167 @@
+#include "alexandria-core/blob_stream.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// External includes.
+////////////////////////////////////////////////////////////////
+
+#include "sqlite3.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    BlobHandle::BlobHandle(
+      sql::Database& database, std::string table, std::string column, const int64_t rowid, const bool writable) :
+        db(database.get()), tableName(std::move(table)), columnName(std::move(column)), row(rowid)
+    {
+        if (const auto res =
+              sqlite3_blob_open(db, "main", tableName.c_str(), columnName.c_str(), row, writable ? 1 : 0, &blob);
+            res != SQLITE_OK)
+        {
+            sqlite3_blob_close(blob);
+            blob = nullptr;
+            throw std::runtime_error(std::format(
+              R"(Failed to open blob "{}"."{}" of row {}: {})", tableName, columnName, row, sqlite3_errmsg(db)));
+        }
+    }
+
+    BlobHandle::BlobHandle(BlobHandle&& other) noexcept :
+        db(std::exchange(other.db, nullptr)),
+        blob(std::exchange(other.blob, nullptr)),
+        tableName(std::move(other.tableName)),
+        columnName(std::move(other.columnName)),
+        row(other.row)
+    {
+    }
+
+    BlobHandle::~BlobHandle() noexcept { sqlite3_blob_close(blob); }
+
+    BlobHandle& BlobHandle::operator=(BlobHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            sqlite3_blob_close(blob);
+            db         = std::exchange(other.db, nullptr);
+            blob       = std::exchange(other.blob, nullptr);
+            tableName  = std::move(other.tableName);
+            columnName = std::move(other.columnName);
+            row        = other.row;
+        }
+        return *this;
+    }
+
+    BlobReader::BlobReader(sql::Database& db, std::string table, std::string column, const int64_t rowid) :
+        BlobHandle(db, std::move(table), std::move(column), rowid, false)
+    {
+    }
+
+    BlobWriter::BlobWriter(sql::Database& db, std::string table, std::string column, const int64_t rowid) :
+        BlobHandle(db, std::move(table), std::move(column), rowid, true)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    sqlite3_blob* BlobHandle::get() const noexcept { return blob; }
+
+    int64_t BlobHandle::getRowid() const noexcept { return row; }
+
+    int64_t BlobHandle::size() const noexcept { return blob ? sqlite3_blob_bytes(blob) : 0; }
+
+    ////////////////////////////////////////////////////////////////
+    // ...
+    ////////////////////////////////////////////////////////////////
+
+    void BlobHandle::reopen(const int64_t rowid)
+    {
+        if (!blob) throw std::runtime_error("Cannot reopen blob. Handle is not open.");
+        check(sqlite3_blob_reopen(blob, rowid), "reopen");
+        row = rowid;
+    }
+
+    void BlobHandle::checkRange(const int64_t offset, const size_t count) const
+    {
+        if (!blob) throw std::runtime_error("Cannot access blob. Handle is not open.");
+        if (offset < 0 || count > static_cast<size_t>(std::numeric_limits<int32_t>::max()) ||
+            offset + static_cast<int64_t>(count) > size())
+            throw std::runtime_error(std::format(R"(Range [{}, {}) is out of bounds of blob "{}"."{}" of size {}.)",
+                                                 offset,
+                                                 offset + static_cast<int64_t>(count),
+                                                 tableName,
+                                                 columnName,
+                                                 size()));
+    }
+
+    void BlobHandle::check(const int32_t result, const char* action) const
+    {
+        if (result != SQLITE_OK)
+            throw std::runtime_error(std::format(R"(Failed to {} blob "{}"."{}" of row {}: {})",
+                                                 action,
+                                                 tableName,
+                                                 columnName,
+                                                 row,
+                                                 result == SQLITE_ABORT ? "handle expired" : sqlite3_errmsg(db)));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Read/write.
+    ////////////////////////////////////////////////////////////////
+
+    void BlobReader::read(const std::span<std::byte> buffer, const int64_t offset) const
+    {
+        checkRange(offset, buffer.size());
+        check(sqlite3_blob_read(blob, buffer.data(), static_cast<int>(buffer.size()), static_cast<int>(offset)),
+              "read");
+    }
+
+    void BlobWriter::read(const std::span<std::byte> buffer, const int64_t offset) const
+    {
+        checkRange(offset, buffer.size());
+        check(sqlite3_blob_read(blob, buffer.data(), static_cast<int>(buffer.size()), static_cast<int>(offset)),
+              "read");
+    }
+
+    void BlobWriter::write(const std::span<const std::byte> buffer, const int64_t offset)
+    {
+        checkRange(offset, buffer.size());
+        check(sqlite3_blob_write(blob, buffer.data(), static_cast<int>(buffer.size()), static_cast<int>(offset)),
+              "write");
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Utilities.
+    ////////////////////////////////////////////////////////////////
+
+    void allocateBlob(
+      sql::Database& db, const std::string& table, const std::string& column, const int64_t rowid, const int64_t size)
+    {
+        const auto   sql = std::format(
+          "UPDATE {} SET {} = zeroblob(?1) WHERE rowid = ?2;", quoteIdentifier(table), quoteIdentifier(column));
+        RawStatement stmt(db, sql, false);
+        stmt.bind(1, size);
+        stmt.bind(2, rowid);
+        stmt.step();
+        if (sqlite3_changes(db.get()) == 0)
+            throw std::runtime_error(
+              std::format(R"(Failed to allocate blob "{}"."{}". Row {} does not exist.)", table, column, rowid));
+    }
+}  // namespace alex
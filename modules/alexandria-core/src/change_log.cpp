@@ -0,0 +1,208 @@
+#include "alexandria-core/change_log.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::string& ChangeLog::getTableName()
+    {
+        static const std::string name = "change_log";
+        return name;
+    }
+
+    const std::string& ChangeLog::getConsumerTableName()
+    {
+        static const std::string name = "change_consumers";
+        return name;
+    }
+
+    bool ChangeLog::exists(sql::Database& db)
+    {
+        RawStatement stmt(db, "SELECT 1 FROM sqlite_schema WHERE type = 'table' AND name = ?1;", false);
+        stmt.bind(1, getTableName());
+        return stmt.step();
+    }
+
+    int64_t ChangeLog::getLatestSequence(sql::Database& db)
+    {
+        // The sequence table also remembers the last number of changes that were truncated.
+        RawStatement stmt(db, "SELECT seq FROM sqlite_sequence WHERE name = ?1;", false);
+        stmt.bind(1, getTableName());
+        return stmt.step() ? stmt.getInt64(0) : 0;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Consumers.
+    ////////////////////////////////////////////////////////////////
+
+    bool ChangeLog::removeConsumer(sql::Database& db, const std::string& consumer)
+    {
+        RawStatement stmt(
+          db, std::format("DELETE FROM {} WHERE name = ?1;", quoteIdentifier(getConsumerTableName())), false);
+        stmt.bind(1, consumer);
+        stmt.step();
+        return db.getChanges() > 0;
+    }
+
+    int64_t ChangeLog::truncate(sql::Database& db)
+    {
+        RawStatement stmt(db,
+                          std::format("DELETE FROM {} WHERE seq <= (SELECT coalesce(min(seq), ?1) FROM {});",
+                                      quoteIdentifier(getTableName()),
+                                      quoteIdentifier(getConsumerTableName())),
+                          false);
+        stmt.bind(1, std::numeric_limits<int64_t>::max());
+        stmt.step();
+        return db.getChanges();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    void ChangeLog::create(sql::Database& db)
+    {
+        // AUTOINCREMENT, so that sequence numbers are not reused after truncation.
+        execute(db,
+                std::format("CREATE TABLE IF NOT EXISTS {} (seq INTEGER PRIMARY KEY AUTOINCREMENT, type INTEGER NOT "
+                            "NULL, instance TEXT NOT NULL, op INTEGER NOT NULL);"
+                            "CREATE TABLE IF NOT EXISTS {} (name TEXT PRIMARY KEY, seq INTEGER NOT NULL);",
+                            quoteIdentifier(getTableName()),
+                            quoteIdentifier(getConsumerTableName())));
+    }
+
+    void ChangeLog::createTriggers(sql::Database& db, const sql::row_id type, const std::string& table)
+    {
+        const auto qLog = quoteIdentifier(getTableName());
+        const auto qTab = quoteIdentifier(table);
+        const auto name = table + "_change";
+
+        const auto record = [&](const char* row, const ChangeOp op) {
+            return std::format("INSERT INTO {} (type, instance, op) VALUES ({}, {}.uuid, {});",
+                               qLog,
+                               type,
+                               row,
+                               static_cast<int32_t>(op));
+        };
+
+        execute(db,
+                std::format("CREATE TRIGGER IF NOT EXISTS {0} AFTER INSERT ON {3} BEGIN {4} END;"
+                            "CREATE TRIGGER IF NOT EXISTS {1} AFTER UPDATE ON {3} BEGIN {5} END;"
+                            "CREATE TRIGGER IF NOT EXISTS {2} AFTER DELETE ON {3} BEGIN {6} END;",
+                            quoteIdentifier(name + "_insert"),
+                            quoteIdentifier(name + "_update"),
+                            quoteIdentifier(name + "_delete"),
+                            qTab,
+                            record("new", ChangeOp::Insert),
+                            record("new", ChangeOp::Update),
+                            record("old", ChangeOp::Delete)));
+    }
+
+    std::string ChangeLog::getUpdateSql(const sql::row_id type)
+    {
+        return std::format("INSERT INTO {} (type, instance, op) VALUES ({}, ?1, {});",
+                           quoteIdentifier(getTableName()),
+                           type,
+                           static_cast<int32_t>(ChangeOp::Update));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    ChangeFeed::ChangeFeed(Library& lib, std::string consumer) : name(std::move(consumer))
+    {
+        if (!lib.isChangeLogEnabled())
+            throw std::runtime_error("Cannot open change feed. The change log of the library is not enabled.");
+
+        auto&      db         = lib.getDatabase();
+        const auto qLog       = quoteIdentifier(ChangeLog::getTableName());
+        const auto qConsumers = quoteIdentifier(ChangeLog::getConsumerTableName());
+
+        // Register new consumers at the most recent change.
+        {
+            RawStatement stmt(
+              db,
+              std::format("INSERT INTO {} (name, seq) VALUES (?1, ?2) ON CONFLICT(name) DO NOTHING;", qConsumers),
+              false);
+            stmt.bind(1, name);
+            stmt.bind(2, ChangeLog::getLatestSequence(db));
+            stmt.step();
+        }
+
+        {
+            RawStatement stmt(db, std::format("SELECT seq FROM {} WHERE name = ?1;", qConsumers), false);
+            stmt.bind(1, name);
+            if (!stmt.step()) throw std::runtime_error(std::format(R"(Failed to register consumer "{}".)", name));
+            acknowledged = stmt.getInt64(0);
+            position     = acknowledged;
+        }
+
+        select = RawStatement(
+          db, std::format("SELECT seq, type, instance, op FROM {} WHERE seq > ?1 ORDER BY seq LIMIT ?2;", qLog));
+        update = RawStatement(db, std::format("UPDATE {} SET seq = ?2 WHERE name = ?1;", qConsumers));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::string& ChangeFeed::getName() const noexcept { return name; }
+
+    int64_t ChangeFeed::getPosition() const noexcept { return position; }
+
+    int64_t ChangeFeed::getAcknowledged() const noexcept { return acknowledged; }
+
+    ////////////////////////////////////////////////////////////////
+    // Reading.
+    ////////////////////////////////////////////////////////////////
+
+    std::vector<Change> ChangeFeed::next(const size_t maxCount)
+    {
+        ScopedReset reset{select};
+
+        std::vector<Change> changes;
+        select.bind(1, position);
+        select.bind(2, static_cast<int64_t>(std::min<size_t>(maxCount, std::numeric_limits<int64_t>::max())));
+        while (select.step())
+        {
+            auto& change = changes.emplace_back();
+            change.seq   = select.getInt64(0);
+            change.type  = select.getInt64(1);
+            change.id    = InstanceId(std::string(select.getText(2)));
+            change.op    = static_cast<ChangeOp>(select.getInt64(3));
+        }
+
+        if (!changes.empty()) position = changes.back().seq;
+        return changes;
+    }
+
+    void ChangeFeed::rewind() noexcept { position = acknowledged; }
+
+    void ChangeFeed::acknowledge()
+    {
+        ScopedReset reset{update};
+
+        update.bind(1, name);
+        update.bind(2, position);
+        update.step();
+        acknowledged = position;
+    }
+}  // namespace alex
@@ -0,0 +1,380 @@
+#include "alexandria-core/codec.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * \brief Minimum length of an LZ match.
+     */
+    constexpr size_t min_match = 4;
+
+    /**
+     * \brief Maximum distance of an LZ match, limited by the 2 byte offset.
+     */
+    constexpr size_t max_offset = std::numeric_limits<uint16_t>::max();
+
+    /**
+     * \brief Number of bits of the LZ hash table.
+     */
+    constexpr uint32_t hash_bits = 16;
+
+    ////////////////////////////////////////////////////////////////
+    // Reader/writer.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Bounds checked cursor into an encoded buffer.
+     */
+    struct Reader
+    {
+        std::span<const std::byte> data;
+        size_t                     pos = 0;
+
+        [[nodiscard]] bool done() const noexcept { return pos == data.size(); }
+
+        [[nodiscard]] uint8_t byte()
+        {
+            if (pos >= data.size()) throw std::runtime_error("Cannot decode blob. Unexpected end of data.");
+            return static_cast<uint8_t>(data[pos++]);
+        }
+
+        [[nodiscard]] uint64_t varint()
+        {
+            uint64_t value = 0;
+            for (uint32_t shift = 0; shift < 64; shift += 7)
+            {
+                const auto b = byte();
+                value |= static_cast<uint64_t>(b & 0x7f) << shift;
+                if ((b & 0x80) == 0) return value;
+            }
+            throw std::runtime_error("Cannot decode blob. Invalid varint.");
+        }
+
+        [[nodiscard]] std::span<const std::byte> bytes(const size_t count)
+        {
+            if (count > data.size() - pos) throw std::runtime_error("Cannot decode blob. Unexpected end of data.");
+            const auto s = data.subspan(pos, count);
+            pos += count;
+            return s;
+        }
+    };
+
+    void putByte(std::vector<std::byte>& out, const uint8_t value) { out.push_back(static_cast<std::byte>(value)); }
+
+    void putVarint(std::vector<std::byte>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            putByte(out, static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        putByte(out, static_cast<uint8_t>(value));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Shuffle.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Transpose the bytes of all whole elements. Trailing bytes are copied as is.
+     */
+    void shuffle(const std::span<const std::byte> data, const size_t elementSize, std::byte* out)
+    {
+        const auto count = data.size() / elementSize;
+        for (size_t i = 0; i < count; i++)
+            for (size_t b = 0; b < elementSize; b++) out[b * count + i] = data[i * elementSize + b];
+        std::memcpy(out + count * elementSize, data.data() + count * elementSize, data.size() - count * elementSize);
+    }
+
+    void unshuffle(const std::span<const std::byte> data, const size_t elementSize, std::byte* out)
+    {
+        const auto count = data.size() / elementSize;
+        for (size_t i = 0; i < count; i++)
+            for (size_t b = 0; b < elementSize; b++) out[i * elementSize + b] = data[b * count + i];
+        std::memcpy(out + count * elementSize, data.data() + count * elementSize, data.size() - count * elementSize);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // LZ.
+    ////////////////////////////////////////////////////////////////
+
+    [[nodiscard]] uint32_t read32(const std::byte* p) noexcept
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    [[nodiscard]] uint32_t hash(const uint32_t v) noexcept { return (v * 2654435761u) >> (32 - hash_bits); }
+
+    /**
+     * \brief Write a length that does not fit in a token nibble as a sequence of 255 bytes and a remainder.
+     */
+    void putLength(std::vector<std::byte>& out, size_t length)
+    {
+        for (; length >= 255; length -= 255) putByte(out, 255);
+        putByte(out, static_cast<uint8_t>(length));
+    }
+
+    [[nodiscard]] size_t getLength(Reader& reader, size_t length)
+    {
+        if (length != 15) return length;
+        for (uint8_t b = 255; b == 255;)
+        {
+            b = reader.byte();
+            length += b;
+        }
+        return length;
+    }
+
+    /**
+     * \brief Write a sequence of literals optionally followed by a match. The token holds the literal length in the
+     * high nibble and the match length minus min_match in the low nibble. Lengths of 15 or more are extended with
+     * additional bytes.
+     */
+    void putSequence(std::vector<std::byte>&          out,
+                     const std::span<const std::byte> literals,
+                     const size_t                     offset,
+                     const size_t                     matchLength)
+    {
+        const auto lit   = literals.size();
+        const auto match = matchLength ? matchLength - min_match : 0;
+        putByte(out, static_cast<uint8_t>((std::min<size_t>(lit, 15) << 4) | std::min<size_t>(match, 15)));
+        if (lit >= 15) putLength(out, lit - 15);
+        out.insert(out.end(), literals.begin(), literals.end());
+        if (matchLength == 0) return;
+        putByte(out, static_cast<uint8_t>(offset & 0xff));
+        putByte(out, static_cast<uint8_t>(offset >> 8));
+        if (match >= 15) putLength(out, match - 15);
+    }
+
+    /**
+     * \brief Greedy single pass LZ77 compressor using a hash table of 4 byte sequences. The last sequence holds only
+     * literals.
+     */
+    void compress(const std::span<const std::byte> data, std::vector<std::byte>& out)
+    {
+        const auto            n = data.size();
+        const auto*           p = data.data();
+        std::vector<uint32_t> table(size_t{1} << hash_bits, 0);
+
+        size_t anchor = 0, i = 0;
+        while (i + min_match <= n)
+        {
+            const auto v     = read32(p + i);
+            auto&      entry = table[hash(v)];
+            const auto cand  = static_cast<size_t>(entry);
+            entry            = static_cast<uint32_t>(i + 1);
+
+            if (cand != 0 && i - (cand - 1) <= max_offset && read32(p + cand - 1) == v)
+            {
+                const auto m   = cand - 1;
+                auto       len = min_match;
+                while (i + len < n && p[m + len] == p[i + len]) len++;
+
+                putSequence(out, data.subspan(anchor, i - anchor), i - m, len);
+                i += len;
+                anchor = i;
+            }
+            else
+            {
+                // Skip ahead faster through data that does not compress.
+                i += 1 + ((i - anchor) >> 6);
+            }
+        }
+
+        putSequence(out, data.subspan(anchor), 0, 0);
+    }
+
+    void decompress(Reader& reader, std::byte* out, const size_t size)
+    {
+        size_t pos = 0;
+        while (!reader.done())
+        {
+            const auto token = reader.byte();
+
+            const auto literals = reader.bytes(getLength(reader, token >> 4));
+            if (literals.size() > size - pos) throw std::runtime_error("Cannot decode blob. Output overflow.");
+            std::memcpy(out + pos, literals.data(), literals.size());
+            pos += literals.size();
+            if (reader.done()) break;
+
+            const size_t lo     = reader.byte();
+            const size_t offset = lo | static_cast<size_t>(reader.byte()) << 8;
+            const auto   length = getLength(reader, token & 0x0f) + min_match;
+            if (offset == 0 || offset > pos) throw std::runtime_error("Cannot decode blob. Invalid match offset.");
+            if (length > size - pos) throw std::runtime_error("Cannot decode blob. Output overflow.");
+
+            // Copy byte by byte, since the source and destination ranges may overlap.
+            for (size_t j = 0; j < length; j++, pos++) out[pos] = out[pos - offset];
+        }
+
+        if (pos != size) throw std::runtime_error("Cannot decode blob. Size mismatch.");
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Delta varint.
+    ////////////////////////////////////////////////////////////////
+
+    [[nodiscard]] uint64_t load(const std::byte* p, const size_t size) noexcept
+    {
+        uint64_t v = 0;
+        std::memcpy(&v, p, size);
+        return v;
+    }
+
+    void encodeDelta(const std::span<const std::byte> data, const size_t elementSize, std::vector<std::byte>& out)
+    {
+        const auto bits = static_cast<uint32_t>(elementSize * 8);
+        const auto mask = bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+
+        uint64_t prev = 0;
+        for (size_t i = 0; i < data.size(); i += elementSize)
+        {
+            const auto v = load(data.data() + i, elementSize);
+
+            // Sign extend the wrapped difference and zigzag encode it, so that small negative deltas stay small.
+            const auto d = static_cast<int64_t>(((v - prev) & mask) << (64 - bits)) >> (64 - bits);
+            putVarint(out, (static_cast<uint64_t>(d) << 1) ^ static_cast<uint64_t>(d >> 63));
+            prev = v;
+        }
+    }
+
+    void decodeDelta(Reader& reader, const size_t elementSize, std::byte* out, const size_t size)
+    {
+        uint64_t prev = 0;
+        for (size_t i = 0; i < size; i += elementSize)
+        {
+            const auto z = reader.varint();
+            const auto d = (z >> 1) ^ (~(z & 1) + 1);
+            prev += d;
+            std::memcpy(out + i, &prev, elementSize);
+        }
+        if (!reader.done()) throw std::runtime_error("Cannot decode blob. Size mismatch.");
+    }
+}  // namespace
+
+namespace alex
+{
+    std::string toString(const Codec codec)
+    {
+        switch (codec)
+        {
+        case Codec::None: return "none";
+        case Codec::ShuffleLz: return "shuffle_lz";
+        case Codec::DeltaVarint: return "delta_varint";
+        }
+
+        throw std::runtime_error(std::format("Unknown codec {}.", static_cast<int32_t>(codec)));
+    }
+
+    void fromString(const std::string& s, Codec& codec)
+    {
+        if (s == "none")
+            codec = Codec::None;
+        else if (s == "shuffle_lz")
+            codec = Codec::ShuffleLz;
+        else if (s == "delta_varint")
+            codec = Codec::DeltaVarint;
+        else
+            throw std::runtime_error(std::format(R"(Unknown codec "{}".)", s));
+    }
+
+    void encode(const Codec                      codec,
+                const size_t                     elementSize,
+                const std::span<const std::byte> data,
+                std::vector<std::byte>&          out)
+    {
+        out.clear();
+
+        if (codec == Codec::None)
+        {
+            out.assign(data.begin(), data.end());
+            return;
+        }
+
+        if (elementSize == 0 || elementSize > std::numeric_limits<uint8_t>::max())
+            throw std::runtime_error(std::format("Cannot encode blob. Invalid element size {}.", elementSize));
+
+        // Header.
+        putByte(out, static_cast<uint8_t>(codec));
+        putByte(out, static_cast<uint8_t>(elementSize));
+        putVarint(out, data.size());
+
+        switch (codec)
+        {
+        case Codec::None: break;
+        case Codec::ShuffleLz:
+        {
+            if (elementSize == 1)
+                compress(data, out);
+            else
+            {
+                std::vector<std::byte> shuffled(data.size());
+                shuffle(data, elementSize, shuffled.data());
+                compress(shuffled, out);
+            }
+            break;
+        }
+        case Codec::DeltaVarint:
+        {
+            if (elementSize != 1 && elementSize != 2 && elementSize != 4 && elementSize != 8)
+                throw std::runtime_error(
+                  std::format("Cannot delta encode blob. Element size {} is not an integer size.", elementSize));
+            if (data.size() % elementSize != 0)
+                throw std::runtime_error(std::format(
+                  "Cannot delta encode blob. Size {} is not a multiple of {} bytes.", data.size(), elementSize));
+            encodeDelta(data, elementSize, out);
+            break;
+        }
+        }
+    }
+
+    void decode(const std::span<const std::byte> data, std::vector<std::byte>& out)
+    {
+        Reader     reader{.data = data};
+        const auto codec       = static_cast<Codec>(reader.byte());
+        const auto elementSize = static_cast<size_t>(reader.byte());
+        const auto size        = reader.varint();
+        if (elementSize == 0) throw std::runtime_error("Cannot decode blob. Invalid element size 0.");
+        // Every encoded byte expands to at most a few hundred decoded bytes, so reject absurd sizes before allocating.
+        if (size / 256 > data.size()) throw std::runtime_error("Cannot decode blob. Invalid size.");
+
+        out.resize(static_cast<size_t>(size));
+
+        switch (codec)
+        {
+        case Codec::ShuffleLz:
+        {
+            if (elementSize == 1)
+                decompress(reader, out.data(), out.size());
+            else
+            {
+                std::vector<std::byte> shuffled(out.size());
+                decompress(reader, shuffled.data(), shuffled.size());
+                unshuffle(shuffled, elementSize, out.data());
+            }
+            break;
+        }
+        case Codec::DeltaVarint:
+        {
+            if (elementSize > sizeof(uint64_t) || out.size() % elementSize != 0)
+                throw std::runtime_error("Cannot decode blob. Invalid element size.");
+            decodeDelta(reader, elementSize, out.data(), out.size());
+            break;
+        }
+        default:
+            throw std::runtime_error(
+              std::format("Cannot decode blob. Unknown codec {}.", static_cast<int32_t>(codec)));
+        }
+    }
+}  // namespace alex
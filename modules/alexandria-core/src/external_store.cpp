@@ -0,0 +1,359 @@
+#include "alexandria-core/external_store.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <random>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/raw_statement.h"
+
+namespace
+{
+    const std::string& getPackTableName()
+    {
+        static const std::string name = "external_pack";
+        return name;
+    }
+
+    /**
+     * \brief Calculate the checksum of a value, i.e. the first half of its content key.
+     * \param value Value.
+     * \return Checksum.
+     */
+    [[nodiscard]] int64_t checksum(const std::span<const std::byte> value) noexcept
+    {
+        const auto key = alex::hashBlob(value);
+        uint64_t   v   = 0;
+        for (int32_t i = 7; i >= 0; i--) v = (v << 8) | static_cast<uint64_t>(key[i]);
+        return static_cast<int64_t>(v);
+    }
+
+    struct Entry
+    {
+        int64_t id     = 0;
+        int64_t offset = 0;
+        int64_t length = 0;
+    };
+
+    /**
+     * \brief Copy values from one pack file to another.
+     * \param from Source file.
+     * \param to Destination file.
+     * \param entries Values. Offsets are updated to the destination file.
+     */
+    void copyEntries(const alex::PackFile& from, alex::PackFile& to, std::vector<Entry>& entries)
+    {
+        for (auto& entry : entries)
+        {
+            const auto view = from.view(static_cast<uint64_t>(entry.offset), static_cast<uint64_t>(entry.length));
+            entry.offset    = static_cast<int64_t>(to.append(view.get()));
+        }
+    }
+}  // namespace
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    ExternalStore::ExternalStore(sql::Database& database, const std::filesystem::path& file) :
+        db(&database), base(file)
+    {
+        if (base.empty())
+        {
+            std::random_device rd;
+            const auto         suffix = (static_cast<uint64_t>(rd()) << 32) | rd();
+            base      = std::filesystem::temp_directory_path() / std::format("alexandria-{:016x}", suffix);
+            temporary = true;
+        }
+    }
+
+    ExternalStore::~ExternalStore() noexcept
+    {
+        if (!temporary || !pack) return;
+
+        // Errors are ignored. On Windows, the file cannot be removed while views into it are still alive.
+        const auto path = pack->getPath();
+        pack.reset();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::string& ExternalStore::getTableName()
+    {
+        static const std::string name = "external_blobs";
+        return name;
+    }
+
+    std::filesystem::path ExternalStore::getPath() const
+    {
+        std::scoped_lock lock(mutex);
+        return open(readGeneration()).getPath();
+    }
+
+    std::filesystem::path ExternalStore::getPath(const int64_t gen) const
+    {
+        auto path = base;
+        path += std::format(".{}.pack", gen);
+        return path;
+    }
+
+    ExternalStore::Stats ExternalStore::getStats() const
+    {
+        std::scoped_lock lock(mutex);
+
+        Stats stats;
+        if (!exists()) return stats;
+
+        RawStatement stmt(
+          *db, std::format("SELECT count(*), total(length) FROM {};", quoteIdentifier(getTableName())), false);
+        stmt.step();
+        stats.blobs     = stmt.getInt64(0);
+        stats.liveBytes = static_cast<int64_t>(stmt.getDouble(1));
+        stats.fileBytes = static_cast<int64_t>(open(readGeneration()).size());
+        return stats;
+    }
+
+    bool ExternalStore::exists() const
+    {
+        RawStatement stmt(*db, "SELECT 1 FROM sqlite_schema WHERE type = 'table' AND name = ?1;", false);
+        stmt.bind(1, getTableName());
+        return stmt.step();
+    }
+
+    int64_t ExternalStore::readGeneration() const
+    {
+        if (!exists()) return 0;
+        RawStatement stmt(*db, std::format("SELECT generation FROM {};", quoteIdentifier(getPackTableName())), false);
+        return stmt.step() ? stmt.getInt64(0) : 0;
+    }
+
+    PackFile& ExternalStore::open(const int64_t gen) const
+    {
+        if (pack && gen == generation) return *pack;
+
+        // Switch files when another process compacted the store. Existing views keep the previous mapping alive.
+        pack.reset();
+        pack       = std::make_unique<PackFile>(getPath(gen));
+        generation = gen;
+
+        // Remove files of other generations, left behind by an interrupted compaction or replaced by a compaction in
+        // another process. Files that are still open elsewhere, e.g. by a compaction in progress, are kept.
+        std::error_code ec;
+        const auto      dir    = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+        const auto      prefix = base.filename().string() + ".";
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            const auto name = entry.path().filename().string();
+            if (name.starts_with(prefix) && name.ends_with(".pack") && entry.path() != pack->getPath())
+                PackFile::removeIfUnused(entry.path());
+        }
+
+        return *pack;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Blobs.
+    ////////////////////////////////////////////////////////////////
+
+    int64_t ExternalStore::put(const std::span<const std::byte> value)
+    {
+        std::scoped_lock lock(mutex);
+
+        // Make sure the value is on disk before the row that references it is committed.
+        auto&      file   = open(readGeneration());
+        const auto offset = file.append(value);
+        file.sync();
+
+        if (!insert.get())
+            insert = RawStatement(*db,
+                                  std::format("INSERT INTO {} (offset, length, checksum) VALUES (?1, ?2, ?3);",
+                                              quoteIdentifier(getTableName())));
+        ScopedReset reset{insert};
+
+        insert.bind(1, static_cast<int64_t>(offset));
+        insert.bind(2, static_cast<int64_t>(value.size()));
+        insert.bind(3, checksum(value));
+        insert.step();
+        return db->getLastInsertRowId();
+    }
+
+    BlobView ExternalStore::get(const int64_t id) const
+    {
+        std::scoped_lock lock(mutex);
+
+        // The generation is read in the same statement as the offset, so that both come from the same snapshot, even
+        // when another process compacted the store in the meantime.
+        if (!select.get())
+            select = RawStatement(*db,
+                                  std::format("SELECT b.offset, b.length, p.generation FROM {} AS b, {} AS p WHERE "
+                                              "b.id = ?1;",
+                                              quoteIdentifier(getTableName()),
+                                              quoteIdentifier(getPackTableName())));
+        ScopedReset reset{select};
+
+        select.bind(1, id);
+        if (!select.step()) throw std::runtime_error(std::format("There is no external blob with id {}.", id));
+        return open(select.getInt64(2))
+          .view(static_cast<uint64_t>(select.getInt64(0)), static_cast<uint64_t>(select.getInt64(1)));
+    }
+
+    bool ExternalStore::verify(const int64_t id) const
+    {
+        int64_t expected = 0;
+        {
+            std::scoped_lock lock(mutex);
+            RawStatement     stmt(
+              *db, std::format("SELECT checksum FROM {} WHERE id = ?1;", quoteIdentifier(getTableName())), false);
+            stmt.bind(1, id);
+            if (!stmt.step()) throw std::runtime_error(std::format("There is no external blob with id {}.", id));
+            expected = stmt.getInt64(0);
+        }
+
+        return checksum(get(id).get()) == expected;
+    }
+
+    int64_t ExternalStore::compact()
+    {
+        // Only one compaction at a time. Other methods only wait for the lock while the copy is not being made.
+        std::scoped_lock compactLock(compactMutex);
+        std::unique_lock lock(mutex);
+        if (!exists()) return 0;
+
+        const auto& current = open(readGeneration());
+        const auto  sql     = std::format("SELECT id, offset, length FROM {} WHERE id > ?1 ORDER BY offset;",
+                                     quoteIdentifier(getTableName()));
+        const auto  collect = [&](const int64_t after) {
+            std::vector<Entry> entries;
+            RawStatement       stmt(*db, sql, false);
+            stmt.bind(1, after);
+            while (stmt.step()) entries.push_back({stmt.getInt64(0), stmt.getInt64(1), stmt.getInt64(2)});
+            return entries;
+        };
+
+        // Ids are never reused, so values stored during the copy can be found by id.
+        auto    entries = collect(0);
+        int64_t maxId   = 0;
+        for (const auto& entry : entries) maxId = std::max(maxId, entry.id);
+
+        const auto nextGeneration = generation + 1;
+        const auto nextPath       = getPath(nextGeneration);
+        if (!PackFile::removeIfUnused(nextPath))
+            throw std::runtime_error("Cannot compact external blobs. Another compaction is in progress.");
+        auto next = std::make_unique<PackFile>(nextPath);
+
+        // Copy the bulk of the values without holding the lock. Reads go to the current file in the meantime.
+        lock.unlock();
+        copyEntries(current, *next, entries);
+        lock.lock();
+
+        // Point the rows to the new file. Rows deleted during the copy are simply not updated. The write lock is
+        // taken before collecting the values stored during the copy, so that other processes cannot store values in
+        // the current file that are not copied.
+        {
+            auto transaction = db->beginTransaction(sql::Transaction::Type::Immediate);
+            auto appended    = collect(maxId);
+            copyEntries(current, *next, appended);
+            next->sync();
+
+            RawStatement update(
+              *db, std::format("UPDATE {} SET offset = ?1 WHERE id = ?2;", quoteIdentifier(getTableName())), false);
+            for (const auto* list : {&entries, &appended})
+            {
+                for (const auto& entry : *list)
+                {
+                    update.bind(1, entry.offset);
+                    update.bind(2, entry.id);
+                    update.step();
+                    update.reset();
+                }
+            }
+            RawStatement gen(
+              *db, std::format("UPDATE {} SET generation = ?1;", quoteIdentifier(getPackTableName())), false);
+            gen.bind(1, nextGeneration);
+            gen.step();
+            transaction.commit();
+        }
+
+        // Swap files. Existing views keep the old mapping alive.
+        const auto reclaimed = static_cast<int64_t>(current.size()) - static_cast<int64_t>(next->size());
+        const auto oldPath   = current.getPath();
+        pack                 = std::move(next);
+        generation           = nextGeneration;
+
+        // Readers in other processes that still have the old file open remove it once they switched generations.
+        PackFile::removeIfUnused(oldPath);
+
+        return reclaimed;
+    }
+
+    void ExternalStore::copyTo(ExternalStore& target)
+    {
+        // Values cannot be appended and the file cannot be replaced while it is copied.
+        std::scoped_lock lock(compactMutex, mutex, target.mutex);
+        if (!exists() || !target.exists()) return;
+
+        // Rows of the copy hold offsets into the generation that was current when the copy was made.
+        RawStatement stmt(
+          *target.db, std::format("SELECT generation FROM {};", quoteIdentifier(getPackTableName())), false);
+        const auto  targetGeneration = stmt.step() ? stmt.getInt64(0) : 0;
+        const auto& current          = open(readGeneration());
+        if (targetGeneration != generation)
+            throw std::runtime_error("Cannot copy external blobs. The store was compacted while the copy was made.");
+
+        target.pack.reset();
+        target.generation = targetGeneration;
+        std::filesystem::copy_file(
+          current.getPath(), target.getPath(targetGeneration), std::filesystem::copy_options::overwrite_existing);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    void ExternalStore::create(sql::Database& db)
+    {
+        // AUTOINCREMENT prevents ids from being reused, which compaction relies on.
+        execute(db,
+                std::format("CREATE TABLE IF NOT EXISTS {0} (id INTEGER PRIMARY KEY AUTOINCREMENT, offset INTEGER NOT "
+                            "NULL, length INTEGER NOT NULL, checksum INTEGER NOT NULL);"
+                            "CREATE TABLE IF NOT EXISTS {1} (id INTEGER PRIMARY KEY CHECK (id = 1), generation INTEGER "
+                            "NOT NULL);"
+                            "INSERT OR IGNORE INTO {1} (id, generation) VALUES (1, 0);",
+                            quoteIdentifier(getTableName()),
+                            quoteIdentifier(getPackTableName())));
+    }
+
+    void ExternalStore::createTriggers(sql::Database& db, const std::string& table, const std::string& column)
+    {
+        const auto qBlobs = quoteIdentifier(getTableName());
+        const auto qTab   = quoteIdentifier(table);
+        const auto qCol   = quoteIdentifier(column);
+        const auto name   = table + "_" + column + "_external";
+
+        execute(db,
+                std::format("CREATE TRIGGER {0} AFTER DELETE ON {2} WHEN typeof(old.{3}) = 'integer' "
+                            "BEGIN DELETE FROM {4} WHERE id = old.{3}; END;"
+                            "CREATE TRIGGER {1} AFTER UPDATE OF {3} ON {2} WHEN typeof(old.{3}) = 'integer' AND "
+                            "old.{3} IS NOT new.{3} BEGIN DELETE FROM {4} WHERE id = old.{3}; END;",
+                            quoteIdentifier(name + "_delete"),
+                            quoteIdentifier(name + "_update"),
+                            qTab,
+                            qCol,
+                            qBlobs));
+    }
+}  // namespace alex
@@ -0,0 +1,198 @@
+#include "alexandria-core/histogram_observer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/type.h"
+
+namespace
+{
+    [[nodiscard]] size_t getSlot(const alex::QueryClass query, const alex::QueryStage stage) noexcept
+    {
+        return static_cast<size_t>(query) * alex::queryStageCount + static_cast<size_t>(stage);
+    }
+
+    [[nodiscard]] double toMicroseconds(const std::chrono::nanoseconds value) noexcept
+    {
+        return static_cast<double>(value.count()) / 1000.0;
+    }
+}  // namespace
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    HistogramObserver::~HistogramObserver() noexcept
+    {
+        auto* entry = entries.load(std::memory_order_acquire);
+        while (entry)
+        {
+            for (auto& stage : entry->stages) delete stage.load(std::memory_order_acquire);
+            delete std::exchange(entry, entry->next);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Events.
+    ////////////////////////////////////////////////////////////////
+
+    void HistogramObserver::onQuery(const QueryEvent& event)
+    {
+        auto& slot  = getEntry(*event.type).stages[getSlot(event.query, event.stage)];
+        auto* stage = slot.load(std::memory_order_acquire);
+
+        // Allocate stage on first use. If another thread wins the race, use its stage instead.
+        if (!stage)
+        {
+            auto created = std::make_unique<Stage>();
+            if (slot.compare_exchange_strong(stage, created.get(), std::memory_order_acq_rel))
+                stage = created.release();
+        }
+
+        // Failed stages are counted, but not included in the latencies.
+        if (event.failed)
+        {
+            stage->failed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        stage->latency.record(event.duration);
+        stage->rows.fetch_add(event.rows, std::memory_order_relaxed);
+        stage->bytes.fetch_add(event.bytes, std::memory_order_relaxed);
+    }
+
+    void HistogramObserver::onStatement(const StatementEvent& event) { statements.record(event.duration); }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const HistogramObserver::Stage*
+      HistogramObserver::getStage(const Type& type, const QueryClass query, const QueryStage stage) const noexcept
+    {
+        const auto* entry = findEntry(type);
+        return entry ? entry->stages[getSlot(query, stage)].load(std::memory_order_acquire) : nullptr;
+    }
+
+    const LatencyHistogram& HistogramObserver::getStatements() const noexcept { return statements; }
+
+    HistogramObserver::Entry* HistogramObserver::findEntry(const Type& type) const noexcept
+    {
+        for (auto* entry = entries.load(std::memory_order_acquire); entry; entry = entry->next)
+            if (entry->type == &type) return entry;
+        return nullptr;
+    }
+
+    HistogramObserver::Entry& HistogramObserver::getEntry(const Type& type)
+    {
+        auto*                  head = entries.load(std::memory_order_acquire);
+        std::unique_ptr<Entry> created;
+        while (true)
+        {
+            for (auto* entry = head; entry; entry = entry->next)
+                if (entry->type == &type) return *entry;
+
+            // Prepend a new entry. On failure, head is updated and the entries added in the meantime are searched.
+            if (!created)
+            {
+                created       = std::make_unique<Entry>();
+                created->type = &type;
+            }
+            created->next = head;
+            if (entries.compare_exchange_weak(head, created.get(), std::memory_order_acq_rel))
+                return *created.release();
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Dump.
+    ////////////////////////////////////////////////////////////////
+
+    void HistogramObserver::dump(std::ostream& out) const
+    {
+        // Sort types by name, since entries are in reverse order of first use.
+        std::vector<std::pair<std::string, const Entry*>> sorted;
+        for (const auto* entry = entries.load(std::memory_order_acquire); entry; entry = entry->next)
+            sorted.emplace_back(entry->type->getNamespace().getName() + "." + entry->type->getName(), entry);
+        std::ranges::sort(sorted, {}, [](const auto& pair) { return pair.first; });
+
+        out << std::format("{:<24} {:<7} {:<16} {:>9} {:>7} {:>10} {:>12} "
+                           "{:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                           "type",
+                           "query",
+                           "stage",
+                           "count",
+                           "failed",
+                           "rows",
+                           "bytes",
+                           "mean(us)",
+                           "p50",
+                           "p90",
+                           "p99",
+                           "p99.9",
+                           "max");
+
+        const auto row = [&out](const std::string_view  name,
+                                const std::string_view  query,
+                                const std::string_view  stage,
+                                const LatencyHistogram& latency,
+                                const uint64_t          failed,
+                                const uint64_t          rows,
+                                const uint64_t          bytes) {
+            out << std::format("{:<24} {:<7} {:<16} {:>9} {:>7} {:>10} {:>12} "
+                               "{:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+                               name,
+                               query,
+                               stage,
+                               latency.count(),
+                               failed,
+                               rows,
+                               bytes,
+                               toMicroseconds(latency.mean()),
+                               toMicroseconds(latency.percentile(50.0)),
+                               toMicroseconds(latency.percentile(90.0)),
+                               toMicroseconds(latency.percentile(99.0)),
+                               toMicroseconds(latency.percentile(99.9)),
+                               toMicroseconds(latency.max()));
+        };
+
+        for (const auto& [name, entry] : sorted)
+        {
+            for (size_t q = 0; q < queryClassCount; q++)
+            {
+                for (size_t s = 0; s < queryStageCount; s++)
+                {
+                    const auto  query = static_cast<QueryClass>(q);
+                    const auto  stage = static_cast<QueryStage>(s);
+                    const auto* data  = entry->stages[getSlot(query, stage)].load(std::memory_order_acquire);
+                    if (!data) continue;
+
+                    row(name,
+                        toString(query),
+                        toString(stage),
+                        data->latency,
+                        data->failed.load(std::memory_order_relaxed),
+                        data->rows.load(std::memory_order_relaxed),
+                        data->bytes.load(std::memory_order_relaxed));
+                }
+            }
+        }
+
+        if (statements.count() > 0) row("", "", "statement", statements, 0, 0, 0);
+    }
+}  // namespace alex
@@ -0,0 +1,86 @@
+#include "alexandria-core/latency_histogram.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Recording.
+    ////////////////////////////////////////////////////////////////
+
+    void LatencyHistogram::record(const std::chrono::nanoseconds value) noexcept
+    {
+        const auto v = static_cast<uint64_t>(std::max<int64_t>(value.count(), 0));
+        buckets[getIndex(v)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+
+        auto current = maxValue.load(std::memory_order_relaxed);
+        while (current < v && !maxValue.compare_exchange_weak(current, v, std::memory_order_relaxed)) {}
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Statistics.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t LatencyHistogram::count() const noexcept { return total.load(std::memory_order_relaxed); }
+
+    std::chrono::nanoseconds LatencyHistogram::mean() const noexcept
+    {
+        const auto n = count();
+        return std::chrono::nanoseconds(n == 0 ? 0 : static_cast<int64_t>(sum.load(std::memory_order_relaxed) / n));
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::max() const noexcept
+    {
+        return std::chrono::nanoseconds(static_cast<int64_t>(maxValue.load(std::memory_order_relaxed)));
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::percentile(const double percentile) const noexcept
+    {
+        // Sum the buckets instead of using the total, which may be ahead of them while other threads record.
+        uint64_t n = 0;
+        for (const auto& bucket : buckets) n += bucket.load(std::memory_order_relaxed);
+        if (n == 0) return std::chrono::nanoseconds(0);
+
+        const auto target =
+          std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(n))), 1, n);
+        const auto maximum = maxValue.load(std::memory_order_relaxed);
+        uint64_t   seen    = 0;
+        for (size_t i = 0; i < buckets.size(); i++)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target)
+                return std::chrono::nanoseconds(static_cast<int64_t>(std::min(getUpperBound(i), maximum)));
+        }
+
+        return max();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Buckets.
+    ////////////////////////////////////////////////////////////////
+
+    size_t LatencyHistogram::getIndex(const uint64_t value) noexcept
+    {
+        // Values below the sub-bucket count are stored exactly. Larger values are shifted so that their top bits fall
+        // in [subBucketCount, 2 * subBucketCount), and the shift selects the logarithmic bucket.
+        if (value < subBucketCount) return static_cast<size_t>(value);
+        const auto shift = static_cast<size_t>(std::bit_width(value)) - subBucketBits - 1;
+        return (shift + 1) * subBucketCount + static_cast<size_t>(value >> shift) - subBucketCount;
+    }
+
+    uint64_t LatencyHistogram::getUpperBound(const size_t index) noexcept
+    {
+        if (index < subBucketCount) return index;
+        const auto shift = index / subBucketCount - 1;
+        const auto sub   = static_cast<uint64_t>(index % subBucketCount + subBucketCount);
+        return ((sub + 1) << shift) - 1;
+    }
+}  // namespace alex
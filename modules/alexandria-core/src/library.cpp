@@ -4,7 +4,14 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <ranges>
 #include <regex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // External includes.
@@ -22,12 +29,19 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/change_log.h"
 #include "alexandria-core/namespace.h"
 #include "alexandria-core/property_layout.h"
 #include "alexandria-core/type_layout.h"
 
 namespace
 {
+    /**
+     * \brief Version of the schema of the specification and array tables, stored in PRAGMA user_version. Libraries
+     * of version 0 have no options column in the properties table and no position column in the array tables.
+     */
+    constexpr int64_t schemaVersion = 1;
+
     void enableForeignKeyConstraints(sql::Database& db)
     {
         int32_t enabled = 0;
@@ -43,6 +57,129 @@ namespace
         stmt1.column(0, res);
         if (res != 1) throw std::runtime_error("Failed to enable foreign key constraints.");
     }
+
+    [[nodiscard]] bool hasColumn(sql::Database& db, const std::string& table, const std::string& column)
+    {
+        alex::RawStatement stmt(db, "SELECT 1 FROM pragma_table_info(?1) WHERE name = ?2;", false);
+        stmt.bind(1, table);
+        stmt.bind(2, column);
+        return stmt.step();
+    }
+
+    /**
+     * \brief Upgrade the schema of a library file to the current version. Must be done before the library is opened,
+     * because the tables are only read when opening the database.
+     * \param file Path to library file.
+     */
+    void upgradeSchema(const std::filesystem::path& file)
+    {
+        const auto db = sql::Database::open(file);
+
+        int64_t version = 0;
+        {
+            alex::RawStatement stmt(*db, "PRAGMA user_version;", false);
+            if (stmt.step()) version = stmt.getInt64(0);
+        }
+        if (version == schemaVersion) return;
+        if (version > schemaVersion)
+            throw std::runtime_error(std::format(
+              "Library file has schema version {}. Only versions up to {} are supported.", version, schemaVersion));
+
+        auto transaction = db->beginTransaction(sql::Transaction::Type::Immediate);
+
+        // Version 1: all options of a property are stored in a single column.
+        if (!hasColumn(*db, "properties", "options"))
+            alex::execute(*db, "ALTER TABLE properties ADD COLUMN options INTEGER NOT NULL DEFAULT 0;");
+
+        // Version 1: array elements have a position. Number the elements of each array in order of insertion, which
+        // is the order in which they were read before.
+        std::vector<std::pair<std::string, std::string>> arrayTables;
+        {
+            alex::RawStatement stmt(*db, "SELECT name, kind FROM tables WHERE kind != 'instance';", false);
+            while (stmt.step()) arrayTables.emplace_back(stmt.getText(0), stmt.getText(1));
+        }
+        for (const auto& [name, kind] : arrayTables)
+        {
+            if (hasColumn(*db, name, "position")) continue;
+
+            const auto qTable = alex::quoteIdentifier(name);
+            alex::execute(*db,
+                          std::format("ALTER TABLE {0} ADD COLUMN position INTEGER NOT NULL DEFAULT 0;"
+                                      "UPDATE {0} SET position = p.position FROM (SELECT id, row_number() OVER "
+                                      "(PARTITION BY instance ORDER BY id) - 1 AS position FROM {0}) AS p WHERE "
+                                      "{0}.id = p.id;"
+                                      "CREATE INDEX IF NOT EXISTS {1} ON {0}(instance, position{2});",
+                                      qTable,
+                                      alex::quoteIdentifier(name + "_position"),
+                                      kind == "blob_array" ? "" : ", value"));
+            if (kind != "blob_array")
+                alex::execute(*db,
+                              std::format("CREATE INDEX IF NOT EXISTS {} ON {}(value, instance);",
+                                          alex::quoteIdentifier(name + "_value"),
+                                          qTable));
+        }
+
+        alex::execute(*db, std::format("PRAGMA user_version = {};", schemaVersion));
+        transaction.commit();
+    }
+
+    std::filesystem::path getDatabaseFile(sql::Database& db)
+    {
+        // Null or empty for in-memory databases.
+        const auto* file = sqlite3_db_filename(db.get(), "main");
+        return file ? std::filesystem::path(file) : std::filesystem::path();
+    }
+
+    using SqlitePtr = std::unique_ptr<sqlite3, decltype(&sqlite3_close)>;
+
+    [[nodiscard]] SqlitePtr openDestination(const std::string& file, const int32_t flags)
+    {
+        sqlite3*   handle = nullptr;
+        const auto result = sqlite3_open_v2(file.c_str(), &handle, flags, nullptr);
+        SqlitePtr  db(handle, &sqlite3_close);
+        if (result != SQLITE_OK)
+            throw std::runtime_error(std::format("Failed to open backup database: {}", sqlite3_errstr(result)));
+        return db;
+    }
+
+    /**
+     * \brief Copy all pages of the main database of source to destination.
+     * \param source Source.
+     * \param destination Destination.
+     * \param pagesPerStep Number of pages per step.
+     * \param callback Optional callback.
+     * \return True if all pages were copied, false if the callback cancelled the backup.
+     */
+    bool backup(sqlite3* source, sqlite3* destination, const int32_t pagesPerStep, const alex::BackupCallback& callback)
+    {
+        std::unique_ptr<sqlite3_backup, decltype(&sqlite3_backup_finish)> handle(
+          sqlite3_backup_init(destination, "main", source, "main"), &sqlite3_backup_finish);
+        if (!handle)
+            throw std::runtime_error(std::format("Failed to start backup: {}", sqlite3_errmsg(destination)));
+
+        int32_t result = SQLITE_OK;
+        while (true)
+        {
+            // Locks on the source are only held during a step.
+            result = sqlite3_backup_step(handle.get(), pagesPerStep);
+            if (result != SQLITE_OK && result != SQLITE_DONE && result != SQLITE_BUSY && result != SQLITE_LOCKED) break;
+
+            const auto proceed = !callback || callback(alex::BackupProgress{
+                                                .remaining = sqlite3_backup_remaining(handle.get()),
+                                                .total     = sqlite3_backup_pagecount(handle.get())});
+            if (result == SQLITE_DONE) break;
+            if (!proceed) return false;
+
+            // Another connection holds a lock on the source or destination.
+            if (result != SQLITE_OK) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if (const auto finish = sqlite3_backup_finish(handle.release()); result == SQLITE_DONE && finish != SQLITE_OK)
+            result = finish;
+        if (result != SQLITE_DONE)
+            throw std::runtime_error(std::format("Failed to back up library: {}", sqlite3_errstr(result)));
+        return true;
+    }
 }  // namespace
 
 namespace alex
@@ -59,11 +196,19 @@ namespace alex
         genTablesTable(database->getTable("tables")),
         namespaceInsert(namespaceTable.insert().compile()),
         typeInsert(typeTable.insert().compile()),
-        genTablesInsert(genTablesTable.insert().compile())
+        genTablesInsert(genTablesTable.insert().compile()),
+        externalStore(std::make_unique<ExternalStore>(*database, getDatabaseFile(*database))),
+        queryTrace(std::make_unique<QueryTrace>()),
+        tableVersions(std::make_unique<TableVersions>())
     {
     }
 
-    Library::~Library() noexcept = default;
+    Library::~Library() noexcept
+    {
+        // The connection can outlive the library if statements are still alive, so unregister the update hook.
+        if (database && tableVersions && tableVersions->dataVersionStatement.get())
+            sqlite3_update_hook(database->get(), nullptr, nullptr);
+    }
 
     ////////////////////////////////////////////////////////////////
     // Static open/create methods.
@@ -110,6 +255,7 @@ namespace alex
         propsTable.createColumn("reference_type", sql::Column::Type::Int).foreignKey(typesCol);
         propsTable.createColumn("is_array", sql::Column::Type::Int);
         propsTable.createColumn("is_blob", sql::Column::Type::Int);
+        propsTable.createColumn("options", sql::Column::Type::Int).notNull();
         propsTable.commit();
 
         // Create table holding generated table names.
@@ -122,6 +268,8 @@ namespace alex
         namesTable.createColumn("kind", sql::Column::Type::Text);
         namesTable.commit();
 
+        execute(*db, std::format("PRAGMA user_version = {};", schemaVersion));
+
         return std::make_unique<Library>(std::move(db));
     }
 
@@ -129,6 +277,8 @@ namespace alex
     {
         if (!exists(file)) throw std::runtime_error("Library file does not exist");
 
+        upgradeSchema(file);
+
         auto db = sql::Database::open(file);
         db->setClose(sql::Database::Close::V2);
         db->setShutdown(sql::Database::Shutdown::Off);
@@ -189,6 +339,68 @@ namespace alex
 
     GeneratedTablesInsert& Library::getGeneratedTablesInsert() noexcept { return genTablesInsert; }
 
+    ExternalStore& Library::getExternalStore() const noexcept { return *externalStore; }
+
+    ////////////////////////////////////////////////////////////////
+    // Instrumentation.
+    ////////////////////////////////////////////////////////////////
+
+    void Library::setQueryObserver(QueryObserver* observer)
+    {
+        const auto mask = observer ? static_cast<uint32_t>(SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE) : uint32_t{0};
+        if (sqlite3_trace_v2(database->get(), mask, observer ? &Library::trace : nullptr, queryTrace.get()) !=
+            SQLITE_OK)
+            throw std::runtime_error("Failed to register query observer.");
+        queryTrace->observer = observer;
+    }
+
+    QueryObserver* Library::getQueryObserver() const noexcept { return queryTrace->observer; }
+
+    QueryCounters Library::getQueryCounters() const noexcept
+    {
+        // Modified rows are counted by sqlite itself.
+        return {.rows  = queryTrace->counters.rows + static_cast<uint64_t>(sqlite3_total_changes64(database->get())),
+                .bytes = queryTrace->counters.bytes};
+    }
+
+    int32_t Library::trace(const uint32_t event, void* context, void* p, void* x) noexcept
+    {
+        auto& state = *static_cast<QueryTrace*>(context);
+        auto* stmt  = static_cast<sqlite3_stmt*>(p);
+
+        if (event == SQLITE_TRACE_ROW)
+        {
+            state.counters.rows++;
+            for (int32_t i = 0, count = sqlite3_column_count(stmt); i < count; i++)
+            {
+                // Only ask for the size of text and blobs. Doing so for numbers would convert them to text.
+                switch (sqlite3_column_type(stmt, i))
+                {
+                case SQLITE_NULL: break;
+                case SQLITE_TEXT:
+                case SQLITE_BLOB: state.counters.bytes += static_cast<uint64_t>(sqlite3_column_bytes(stmt, i)); break;
+                default: state.counters.bytes += 8; break;
+                }
+            }
+        }
+        else if (event == SQLITE_TRACE_PROFILE && state.observer)
+        {
+            try
+            {
+                const auto* sql = sqlite3_sql(stmt);
+                state.observer->onStatement(
+                  StatementEvent{.sql      = sql ? std::string_view(sql) : std::string_view(),
+                                 .duration = std::chrono::nanoseconds(*static_cast<const sqlite3_int64*>(x))});
+            }
+            catch (...)
+            {
+                // Exceptions cannot propagate through sqlite.
+            }
+        }
+
+        return 0;
+    }
+
     ////////////////////////////////////////////////////////////////
     // Namespaces.
     ////////////////////////////////////////////////////////////////
@@ -291,8 +503,176 @@ namespace alex
 #endif
     }
 
+    ////////////////////////////////////////////////////////////////
+    // Statistics.
+    ////////////////////////////////////////////////////////////////
+
+    StorageStats Library::storageStats() const
+    {
+        auto stats     = StorageStats::read(*database);
+        stats.external = externalStore->getStats();
+        return stats;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Backup.
+    ////////////////////////////////////////////////////////////////
+
+    bool Library::backupTo(const std::filesystem::path& file,
+                           const int32_t                pagesPerStep,
+                           const BackupCallback&        callback) const
+    {
+        if (file.empty()) throw std::runtime_error("Backup file path is empty. Use backupToMemory instead.");
+        if (exists(file)) throw std::runtime_error("Backup file already exists");
+
+        try
+        {
+            {
+                auto destination = openDestination(file.string(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+                if (!backup(database->get(), destination.get(), pagesPerStep, callback))
+                {
+                    destination.reset();
+                    std::filesystem::remove(file);
+                    return false;
+                }
+            }
+
+            // Copy the external blobs next to the backup.
+            const auto db = sql::Database::open(file);
+            db->setClose(sql::Database::Close::V2);
+            db->setShutdown(sql::Database::Shutdown::Off);
+            ExternalStore store(*db, file);
+            externalStore->copyTo(store);
+
+            return true;
+        }
+        catch (...)
+        {
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+            throw;
+        }
+    }
+
+    LibraryPtr Library::backupToMemory(const int32_t pagesPerStep, const BackupCallback& callback) const
+    {
+        // Copy the pages into a named in-memory database, and open the library on that database once it is complete.
+        // The connection used for the copy keeps the database alive until then.
+        static std::atomic<uint64_t> counter = 0;
+        const auto name        = std::format("alexandria_backup_{}", counter.fetch_add(1, std::memory_order_relaxed));
+        const auto flags       = SQLITE_OPEN_READWRITE | SQLITE_OPEN_MEMORY | SQLITE_OPEN_SHAREDCACHE;
+        const auto destination = openDestination(name, flags | SQLITE_OPEN_CREATE);
+        if (!backup(database->get(), destination.get(), pagesPerStep, callback)) return nullptr;
+
+        auto db = sql::Database::open(name, flags | SQLITE_OPEN_NOMUTEX);
+        db->setClose(sql::Database::Close::V2);
+        db->setShutdown(sql::Database::Shutdown::Off);
+        enableForeignKeyConstraints(*db);
+        auto lib = std::make_unique<Library>(std::move(db));
+        lib->readSpecification();
+        externalStore->copyTo(*lib->externalStore);
+
+        return lib;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Change log.
+    ////////////////////////////////////////////////////////////////
+
+    void Library::enableChangeLog()
+    {
+        if (changeLog) return;
+
+        auto transaction = database->beginTransaction(sql::Transaction::Type::Deferred);
+        ChangeLog::create(*database);
+
+        // Record changes to the instance tables of existing types.
+        RawStatement stmt(*database, "SELECT type, name FROM tables WHERE kind = 'instance';", false);
+        while (stmt.step()) ChangeLog::createTriggers(*database, stmt.getInt64(0), std::string(stmt.getText(1)));
+        stmt.reset();
+
+        transaction.commit();
+        changeLog = true;
+    }
+
+    bool Library::isChangeLogEnabled() const noexcept { return changeLog; }
+
+    ////////////////////////////////////////////////////////////////
+    // Modification tracking.
+    ////////////////////////////////////////////////////////////////
+
+    const uint64_t& Library::getTableVersion(const std::string& table)
+    {
+        auto& versions = *tableVersions;
+        if (!versions.dataVersionStatement.get())
+        {
+            versions.dataVersionStatement = RawStatement(*database, "PRAGMA data_version;");
+            versions.dataVersionStatement.step();
+            versions.dataVersion = versions.dataVersionStatement.getInt64(0);
+            versions.dataVersionStatement.reset();
+
+            // Modifications of untracked tables are ignored.
+            sqlite3_update_hook(
+              database->get(),
+              [](void* context, int32_t, const char*, const char* name, sqlite3_int64) noexcept {
+                  auto& state = *static_cast<TableVersions*>(context);
+                  if (const auto it = state.tables.find(std::string_view(name)); it != state.tables.end())
+                      it->second = ++state.version;
+              },
+              &versions);
+        }
+
+        // The table could have been modified before it was tracked.
+        return versions.tables.try_emplace(table, versions.version).first->second;
+    }
+
+    uint64_t Library::checkModifications()
+    {
+        auto& versions = *tableVersions;
+        if (!versions.dataVersionStatement.get()) return versions.version;
+
+        auto& stmt = versions.dataVersionStatement;
+        stmt.step();
+        const auto dataVersion = stmt.getInt64(0);
+        stmt.reset();
+
+        if (dataVersion != versions.dataVersion)
+        {
+            versions.dataVersion = dataVersion;
+            invalidateTableVersions();
+        }
+        return versions.version;
+    }
+
+    void Library::invalidateTableVersions() noexcept
+    {
+        auto&      versions = *tableVersions;
+        const auto version  = ++versions.version;
+        for (auto& v : versions.tables | std::views::values) v = version;
+    }
+
+    bool Library::isInTransaction() const noexcept { return sqlite3_get_autocommit(database->get()) == 0; }
+
+    ////////////////////////////////////////////////////////////////
+    // Connections.
+    ////////////////////////////////////////////////////////////////
+
+    sql::DatabasePtr Library::openReadConnection() const
+    {
+        const auto file = getDatabaseFile(*database);
+        if (file.empty()) return nullptr;
+
+        auto db = sql::Database::open(file, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX);
+        db->setClose(sql::Database::Close::V2);
+        db->setShutdown(sql::Database::Shutdown::Off);
+        sqlite3_busy_timeout(db->get(), 1000);
+        return db;
+    }
+
     void Library::readSpecification()
     {
+        changeLog = ChangeLog::exists(*database);
+
         std::unordered_map<sql::row_id, Namespace*> namespacemap;
         std::unordered_map<sql::row_id, Type*>      typemap;
 
@@ -326,21 +706,28 @@ namespace alex
         {
             DataType dataType;
             fromString(row.dataType, dataType);
+            const auto options = PropertyOptions::decode(row.options);
 
             auto& type = *typemap.at(row.type);
             type.propertyIds.push_back(row.id);
 
-            if (dataType == DataType::Reference)
-            {
-                auto refType = typemap.at(row.referenceType);
-                type.typeLayout->addProperty(std::make_unique<PropertyLayout>(
-                  *type.typeLayout, std::move(row.name), dataType, refType, row.isArray, row.isBlob));
-            }
-            else
-            {
-                type.typeLayout->addProperty(std::make_unique<PropertyLayout>(
-                  *type.typeLayout, std::move(row.name), dataType, nullptr, row.isArray, row.isBlob));
-            }
+            auto* refType = dataType == DataType::Reference || dataType == DataType::Nested ?
+                              typemap.at(row.referenceType) :
+                              nullptr;
+            type.typeLayout->addProperty(
+              std::make_unique<PropertyLayout>(*type.typeLayout,
+                                               std::move(row.name),
+                                               dataType,
+                                               refType,
+                                               row.isArray,
+                                               row.isBlob,
+                                               options.has(PropertyOptions::fullTextFlag),
+                                               options.has(PropertyOptions::spatialFlag),
+                                               options.has(PropertyOptions::indexedFlag),
+                                               static_cast<Codec>(options.codec),
+                                               options.has(PropertyOptions::deduplicatedFlag),
+                                               options.externalThreshold,
+                                               options.has(PropertyOptions::packedFlag)));
         }
 
         // Read generated table names.
@@ -0,0 +1,748 @@
+#include "alexandria-core/library_dump.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/raw_statement.h"
+
+namespace
+{
+    /*
+     * Dump format. Unsigned integers and lengths are LEB128 varints, signed integers are zigzag encoded varints and
+     * floats are 8 bytes in little-endian order. Text and blobs are prefixed with their length.
+     *
+     *   dump   : "ALEXDUMP" version schema* (table row*)* 'Z'
+     *   schema : 'S' name sql               Table, index, trigger or view, in order of creation.
+     *   table  : 'T' name count column*     Rows that follow belong to this table.
+     *   row    : 'R' value*                 One value per column.
+     *   value  : type payload
+     */
+    constexpr std::array<char, 8> magic   = {'A', 'L', 'E', 'X', 'D', 'U', 'M', 'P'};
+    constexpr uint64_t            version = 1;
+
+    /**
+     * \brief Tables holding the specification. These are only imported into new libraries.
+     */
+    constexpr std::array<std::string_view, 4> metadataTables = {"namespaces", "types", "properties", "tables"};
+
+    enum class Record : uint8_t
+    {
+        Schema = 'S',
+        Table  = 'T',
+        Row    = 'R',
+        End    = 'Z'
+    };
+
+    enum class Value : uint8_t
+    {
+        Null     = 0,
+        Integer  = 1,
+        Real     = 2,
+        Text     = 3,
+        Blob     = 4,
+        External = 5
+    };
+
+    /**
+     * \brief Table of which the rows are dumped.
+     */
+    struct Table
+    {
+        std::string name;
+
+        /**
+         * \brief Columns, in order of declaration.
+         */
+        std::vector<std::string> columns;
+
+        /**
+         * \brief Whether each column holds the ids of external blobs.
+         */
+        std::vector<bool> external;
+    };
+
+    class Writer
+    {
+    public:
+        explicit Writer(const std::filesystem::path& path) : file(path, std::ios::binary)
+        {
+            if (!file) throw std::runtime_error(std::format("Could not open {}", path.string()));
+        }
+
+        void header()
+        {
+            file.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+            bytes += magic.size();
+            varint(version);
+        }
+
+        void byte(const uint8_t value)
+        {
+            file.put(static_cast<char>(value));
+            bytes++;
+        }
+
+        void record(const Record value) { byte(static_cast<uint8_t>(value)); }
+
+        void type(const Value value) { byte(static_cast<uint8_t>(value)); }
+
+        void varint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                byte(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            byte(static_cast<uint8_t>(value));
+        }
+
+        void integer(const int64_t value)
+        {
+            varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void real(const double value)
+        {
+            const auto bits = std::bit_cast<uint64_t>(value);
+            for (int32_t i = 0; i < 8; i++) byte(static_cast<uint8_t>(bits >> (i * 8)));
+        }
+
+        void data(const std::span<const std::byte> value)
+        {
+            varint(value.size());
+            file.write(reinterpret_cast<const char*>(value.data()), static_cast<std::streamsize>(value.size()));
+            bytes += value.size();
+        }
+
+        void text(const std::string_view value) { data(std::as_bytes(std::span(value))); }
+
+        void finish()
+        {
+            file.flush();
+            if (!file) throw std::runtime_error("Failed to write dump");
+        }
+
+        [[nodiscard]] uint64_t getBytes() const noexcept { return bytes; }
+
+    private:
+        std::ofstream file;
+
+        uint64_t bytes = 0;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(const std::filesystem::path& path) : file(path, std::ios::binary)
+        {
+            if (!file) throw std::runtime_error(std::format("Could not open {}", path.string()));
+        }
+
+        void header()
+        {
+            std::array<char, magic.size()> value{};
+            read(value.data(), value.size());
+            if (value != magic) throw std::runtime_error("File is not a library dump");
+            if (const auto v = varint(); v != version)
+                throw std::runtime_error(std::format("Unsupported dump version {}", v));
+        }
+
+        uint8_t byte()
+        {
+            char value = 0;
+            read(&value, 1);
+            return static_cast<uint8_t>(value);
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+            for (int32_t shift = 0; shift < 64; shift += 7)
+            {
+                const auto b = byte();
+                value |= static_cast<uint64_t>(b & 0x7f) << shift;
+                if (!(b & 0x80)) return value;
+            }
+            throw std::runtime_error("Invalid integer in dump");
+        }
+
+        int64_t integer()
+        {
+            const auto value = varint();
+            return static_cast<int64_t>((value >> 1) ^ (0 - (value & 1)));
+        }
+
+        double real()
+        {
+            uint64_t bits = 0;
+            for (int32_t i = 0; i < 8; i++) bits |= static_cast<uint64_t>(byte()) << (i * 8);
+            return std::bit_cast<double>(bits);
+        }
+
+        /**
+         * \brief Read a blob into a buffer that is reused for all values, so that memory use is bound by the largest
+         * value instead of by the size of the dump.
+         * \param buffer Buffer.
+         */
+        void data(std::vector<std::byte>& buffer)
+        {
+            buffer.resize(varint());
+            read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        }
+
+        void text(std::string& buffer)
+        {
+            buffer.resize(varint());
+            read(buffer.data(), buffer.size());
+        }
+
+        [[nodiscard]] uint64_t getBytes() const noexcept { return bytes; }
+
+    private:
+        void read(char* dst, const size_t size)
+        {
+            file.read(dst, static_cast<std::streamsize>(size));
+            if (static_cast<size_t>(file.gcount()) != size) throw std::runtime_error("Unexpected end of dump");
+            bytes += size;
+        }
+
+        std::ifstream file;
+
+        uint64_t bytes = 0;
+    };
+
+    [[nodiscard]] bool isMetadata(const std::string_view table)
+    {
+        return std::ranges::find(metadataTables, table) != metadataTables.end();
+    }
+
+    [[nodiscard]] bool tableExists(sql::Database& db, const std::string& table)
+    {
+        alex::RawStatement stmt(db, "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?1;", false);
+        stmt.bind(1, table);
+        return stmt.step();
+    }
+
+    [[nodiscard]] std::vector<std::string> getColumns(sql::Database& db, const std::string& table)
+    {
+        std::vector<std::string> columns;
+        alex::RawStatement       stmt(db, std::format("PRAGMA table_info({});", alex::quoteIdentifier(table)), false);
+        while (stmt.step()) columns.emplace_back(stmt.getText(1));
+        return columns;
+    }
+
+    /**
+     * \brief Get the columns holding ids of external blobs, from the names of the triggers that remove them.
+     * \param db Database.
+     * \return Set of "<table>.<column>".
+     */
+    [[nodiscard]] std::unordered_set<std::string> getExternalColumns(sql::Database& db)
+    {
+        constexpr std::string_view suffix = "_external_delete";
+
+        std::unordered_set<std::string> columns;
+        alex::RawStatement              stmt(db,
+                                    "SELECT name, tbl_name FROM sqlite_master WHERE type = 'trigger' AND name LIKE "
+                                    R"('%\_external\_delete' ESCAPE '\';)",
+                                    false);
+        while (stmt.step())
+        {
+            const auto name  = stmt.getText(0);
+            const auto table = stmt.getText(1);
+            if (!name.starts_with(table) || name.size() <= table.size() + 1 + suffix.size()) continue;
+            const auto column = name.substr(table.size() + 1, name.size() - table.size() - 1 - suffix.size());
+            columns.emplace(std::format("{}.{}", table, column));
+        }
+        return columns;
+    }
+
+    /**
+     * \brief Get the tables with rows to dump: the specification, the shared blobs and all instance and array tables.
+     * Spatial and fulltext indices are rebuilt by their triggers on import.
+     * \param db Database.
+     * \return Tables, in order of import.
+     */
+    [[nodiscard]] std::vector<Table> getTables(sql::Database& db)
+    {
+        std::vector<std::string> names(metadataTables.begin(), metadataTables.end());
+
+        // Shared blobs must precede the tables referencing them, whose triggers restore the reference counts.
+        if (tableExists(db, alex::BlobStore::getTableName())) names.emplace_back(alex::BlobStore::getTableName());
+
+        {
+            alex::RawStatement stmt(db,
+                                    "SELECT name FROM tables WHERE kind IN ('instance', 'primitive_array', "
+                                    "'blob_array', 'reference_array') ORDER BY id;",
+                                    false);
+            while (stmt.step()) names.emplace_back(stmt.getText(0));
+        }
+
+        const auto         external = getExternalColumns(db);
+        std::vector<Table> tables;
+        for (auto& name : names)
+        {
+            auto& table   = tables.emplace_back();
+            table.columns = getColumns(db, name);
+            for (const auto& column : table.columns) table.external.push_back(external.contains(name + "." + column));
+            table.name = std::move(name);
+        }
+        return tables;
+    }
+
+    void writeSchema(sql::Database& db, Writer& writer)
+    {
+        // Shadow tables are created by their virtual table.
+        std::vector<std::string> virtualTables;
+        {
+            alex::RawStatement stmt(
+              db, "SELECT name FROM sqlite_master WHERE type = 'table' AND sql LIKE 'CREATE VIRTUAL TABLE%';", false);
+            while (stmt.step()) virtualTables.emplace_back(std::string(stmt.getText(0)) + "_");
+        }
+
+        alex::RawStatement stmt(db,
+                                "SELECT type, name, sql FROM sqlite_master WHERE sql IS NOT NULL AND name NOT LIKE "
+                                R"('sqlite\_%' ESCAPE '\' ORDER BY rowid;)",
+                                false);
+        while (stmt.step())
+        {
+            const auto name = stmt.getText(1);
+            if (stmt.getText(0) == "table" &&
+                std::ranges::any_of(virtualTables, [&name](const auto& vtab) { return name.starts_with(vtab); }))
+                continue;
+
+            writer.record(Record::Schema);
+            writer.text(name);
+            writer.text(stmt.getText(2));
+        }
+    }
+
+    [[nodiscard]] uint64_t
+      writeTable(sql::Database& db, const alex::ExternalStore& store, const Table& table, Writer& writer)
+    {
+        writer.record(Record::Table);
+        writer.text(table.name);
+        writer.varint(table.columns.size());
+        for (const auto& column : table.columns) writer.text(column);
+
+        // Select the type of each value along with the value. Reference counts of shared blobs are written as 0,
+        // because the triggers of the tables referencing them increment them again on import.
+        const bool  shared = table.name == alex::BlobStore::getTableName();
+        std::string sql    = "SELECT ";
+        for (size_t i = 0; i < table.columns.size(); i++)
+        {
+            const auto column =
+              shared && table.columns[i] == "refcount" ? std::string("0") : alex::quoteIdentifier(table.columns[i]);
+            sql += std::format("{0}typeof({1}), {1}", i == 0 ? "" : ", ", column);
+        }
+        sql += std::format(" FROM {} ORDER BY rowid;", alex::quoteIdentifier(table.name));
+
+        alex::RawStatement stmt(db, sql, false);
+        uint64_t           rows = 0;
+        while (stmt.step())
+        {
+            writer.record(Record::Row);
+            for (size_t i = 0; i < table.columns.size(); i++)
+            {
+                const auto index = static_cast<int32_t>(i * 2 + 1);
+                const auto type  = stmt.getText(index - 1);
+                if (type == "null")
+                    writer.type(Value::Null);
+                else if (type == "integer" && table.external[i])
+                {
+                    // Write the value instead of its id, which is only valid for the pack file of this library.
+                    const auto value = store.get(stmt.getInt64(index));
+                    writer.type(Value::External);
+                    writer.data(value.get());
+                }
+                else if (type == "integer")
+                {
+                    writer.type(Value::Integer);
+                    writer.integer(stmt.getInt64(index));
+                }
+                else if (type == "real")
+                {
+                    writer.type(Value::Real);
+                    writer.real(stmt.getDouble(index));
+                }
+                else if (type == "text")
+                {
+                    writer.type(Value::Text);
+                    writer.text(stmt.getText(index));
+                }
+                else
+                {
+                    writer.type(Value::Blob);
+                    writer.data(stmt.getBlob(index));
+                }
+            }
+            rows++;
+        }
+
+        return rows;
+    }
+
+    /**
+     * \brief Inserts the records of a dump into a library.
+     */
+    class Importer
+    {
+    public:
+        Importer(alex::Library& library, const bool create, const size_t batch) :
+            db(&library.getDatabase()),
+            store(&library.getExternalStore()),
+            restore(create),
+            batchSize(std::max<size_t>(batch, 1)),
+            schemaExists(*db, "SELECT 1 FROM sqlite_master WHERE name = ?1;")
+        {
+        }
+
+        void operator()(Reader& reader)
+        {
+            alex::execute(*db, "BEGIN;");
+            try
+            {
+                while (true)
+                {
+                    const auto record = static_cast<Record>(reader.byte());
+                    if (record == Record::End) break;
+
+                    switch (record)
+                    {
+                    case Record::Schema: readSchema(reader); break;
+                    case Record::Table: readTable(reader); break;
+                    case Record::Row: readRow(reader); break;
+                    default:
+                        throw std::runtime_error(
+                          std::format("Invalid record {} in dump", static_cast<uint32_t>(record)));
+                    }
+                }
+
+                insert = {};
+
+                // Tables are not dumped in order of their references, so foreign keys are checked once all rows are
+                // inserted, before the last batch is committed.
+                if (const auto violations = countViolations(); violations > 0)
+                    throw std::runtime_error(
+                      std::format("{} imported rows reference instances that do not exist", violations));
+
+                alex::execute(*db, "COMMIT;");
+            }
+            catch (...)
+            {
+                insert = {};
+                alex::execute(*db, "ROLLBACK;");
+                if (!restore) removeAppended();
+                throw;
+            }
+        }
+
+        [[nodiscard]] uint64_t getRows() const noexcept { return rows; }
+
+        [[nodiscard]] uint64_t getTables() const noexcept { return tables; }
+
+    private:
+        void readSchema(Reader& reader)
+        {
+            reader.text(name);
+            reader.text(text);
+
+            // The schema is only created for new libraries. Existing objects, i.e. the specification tables, are kept.
+            if (!restore) return;
+            schemaExists.bind(1, name);
+            const auto exists = schemaExists.step();
+            schemaExists.reset();
+            if (!exists) alex::execute(*db, text);
+        }
+
+        void readTable(Reader& reader)
+        {
+            insert = {};
+            reader.text(name);
+            columns.resize(reader.varint());
+            for (auto& column : columns) reader.text(column);
+            parameters.assign(columns.size(), 0);
+
+            // The specification of an existing library must already match that of the dump.
+            if (!restore && isMetadata(name)) return;
+
+            std::vector<std::string> target;
+            size_t                   key = columns.size();
+            {
+                alex::RawStatement info(*db, std::format("PRAGMA table_info({});", alex::quoteIdentifier(name)), false);
+                while (info.step())
+                {
+                    if (info.getInt64(5) == 1) key = target.size();
+                    target.emplace_back(info.getText(1));
+                }
+            }
+            if (target != columns)
+                throw std::runtime_error(
+                  std::format(R"(Table "{}" of the dump does not match the specification of the library.)", name));
+
+            recordAppended(name);
+
+            // Rows appended to an existing library get new row ids. Instances and arrays are linked by uuid.
+            std::string names;
+            std::string values;
+            int32_t     index = 0;
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                if (!restore && i == key) continue;
+                parameters[i] = ++index;
+                names += std::format("{}{}", index == 1 ? "" : ", ", alex::quoteIdentifier(columns[i]));
+                values += std::format("{}?{}", index == 1 ? "" : ", ", index);
+            }
+
+            // Shared blobs that already exist are kept, along with their reference count.
+            const auto conflict = name == alex::BlobStore::getTableName() ? " OR IGNORE" : "";
+            insert              = alex::RawStatement(*db,
+                                        std::format("INSERT{} INTO {} ({}) VALUES ({});",
+                                                    conflict,
+                                                    alex::quoteIdentifier(name),
+                                                    names,
+                                                    values));
+            tables++;
+        }
+
+        void readRow(Reader& reader)
+        {
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                const auto index = parameters[i];
+                switch (static_cast<Value>(reader.byte()))
+                {
+                case Value::Null:
+                    if (index) insert.bindNull(index);
+                    break;
+                case Value::Integer:
+                    if (const auto value = reader.integer(); index) insert.bindInt64(index, value);
+                    break;
+                case Value::Real:
+                    if (const auto value = reader.real(); index) insert.bindDouble(index, value);
+                    break;
+                case Value::Text:
+                    reader.text(text);
+                    if (index) insert.bindText(index, text);
+                    break;
+                case Value::Blob:
+                    reader.data(blob);
+                    if (index) insert.bindBlob(index, blob);
+                    break;
+                case Value::External:
+                    reader.data(blob);
+                    if (index) insert.bindInt64(index, putExternal());
+                    break;
+                default: throw std::runtime_error("Invalid value in dump");
+                }
+            }
+
+            if (!insert.get()) return;
+            insert.step();
+            insert.reset();
+            insert.clearBindings();
+            rows++;
+
+            if (++pending == batchSize)
+            {
+                alex::execute(*db, "COMMIT; BEGIN;");
+                pending = 0;
+            }
+        }
+
+        [[nodiscard]] int64_t putExternal()
+        {
+            // Make sure the table with the generation of the pack file is filled, which is not part of the schema.
+            if (!externalCreated)
+            {
+                alex::ExternalStore::create(*db);
+                recordAppended(alex::ExternalStore::getTableName());
+                externalCreated = true;
+            }
+            return store->put(blob);
+        }
+
+        /**
+         * \brief Remember the last rowid of a table of an existing library before rows are appended to it, so that
+         * the rows of committed batches can be removed again if the import fails.
+         * \param table Table name.
+         */
+        void recordAppended(const std::string& table)
+        {
+            if (restore || appended.contains(table)) return;
+            alex::RawStatement last(
+              *db, std::format("SELECT coalesce(max(rowid), 0) FROM {};", alex::quoteIdentifier(table)), false);
+            last.step();
+            appended.emplace(table, last.getInt64(0));
+        }
+
+        /**
+         * \brief Delete all rows that committed batches appended to an existing library. Values that were written to
+         * the pack file of the external store are reclaimed by the next compaction.
+         */
+        void removeAppended()
+        {
+            alex::execute(*db, "BEGIN;");
+            for (const auto& [table, last] : appended)
+                alex::execute(*db,
+                              std::format("DELETE FROM {} WHERE rowid > {};", alex::quoteIdentifier(table), last));
+            alex::execute(*db, "COMMIT;");
+        }
+
+        /**
+         * \brief Count the rows inserted by the import that reference rows that do not exist. Violations that were
+         * already present in an existing library are not counted.
+         * \return Number of rows.
+         */
+        [[nodiscard]] uint64_t countViolations() const
+        {
+            uint64_t           violations = 0;
+            alex::RawStatement stmt(*db, "PRAGMA foreign_key_check;", false);
+            while (stmt.step())
+            {
+                if (restore)
+                {
+                    violations++;
+                    continue;
+                }
+                const auto it = appended.find(std::string(stmt.getText(0)));
+                if (it != appended.end() && stmt.getInt64(1) > it->second) violations++;
+            }
+            return violations;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        sql::Database* db = nullptr;
+
+        alex::ExternalStore* store = nullptr;
+
+        bool restore = false;
+
+        size_t batchSize = 0;
+
+        alex::RawStatement schemaExists;
+
+        /**
+         * \brief Insert statement of the current table. Empty if its rows are skipped.
+         */
+        alex::RawStatement insert;
+
+        std::vector<std::string> columns;
+
+        /**
+         * \brief Parameter index of each column of the current table, or 0 if the column is skipped.
+         */
+        std::vector<int32_t> parameters;
+
+        std::string name;
+
+        std::string text;
+
+        std::vector<std::byte> blob;
+
+        bool externalCreated = false;
+
+        /**
+         * \brief Last rowid before the import of each table rows were appended to. Only used for existing libraries.
+         */
+        std::map<std::string, int64_t> appended;
+
+        uint64_t rows = 0;
+
+        uint64_t tables = 0;
+
+        size_t pending = 0;
+    };
+}  // namespace
+
+namespace alex
+{
+    LibraryDump::Stats LibraryDump::write(Library& library, const std::filesystem::path& file)
+    {
+        auto&  db = library.getDatabase();
+        Writer writer(file);
+        writer.header();
+
+        // Read everything in a single transaction, so that the dump is a consistent snapshot.
+        execute(db, "BEGIN;");
+        Stats stats;
+        try
+        {
+            writeSchema(db, writer);
+            const auto tables = getTables(db);
+            for (const auto& table : tables) stats.rows += writeTable(db, library.getExternalStore(), table, writer);
+            writer.record(Record::End);
+            stats.tables = tables.size();
+        }
+        catch (...)
+        {
+            execute(db, "ROLLBACK;");
+            throw;
+        }
+        execute(db, "COMMIT;");
+        writer.finish();
+
+        stats.bytes = writer.getBytes();
+        return stats;
+    }
+
+    LibraryDump::Stats
+      LibraryDump::read(const std::filesystem::path& library, const std::filesystem::path& file, const size_t batchSize)
+    {
+        const auto restore = !std::filesystem::exists(library);
+        LibraryPtr lib;
+        try
+        {
+            Reader reader(file);
+            reader.header();
+            lib      = restore ? Library::create(library) : Library::open(library);
+            auto& db = lib->getDatabase();
+
+            // Tables are not dumped in order of their references, so foreign keys are checked after all rows are
+            // inserted.
+            execute(db, "PRAGMA foreign_keys = OFF;");
+            Importer importer(*lib, restore, batchSize);
+            importer(reader);
+            execute(db, "PRAGMA foreign_keys = ON;");
+
+            // Make sure the imported specification can be read.
+            if (restore)
+            {
+                lib.reset();
+                lib = Library::open(library);
+            }
+
+            return {.rows = importer.getRows(), .tables = importer.getTables(), .bytes = reader.getBytes()};
+        }
+        catch (...)
+        {
+            // Do not leave a partially created library behind.
+            lib.reset();
+            if (restore) std::filesystem::remove(library);
+            throw;
+        }
+    }
+}  // namespace alex
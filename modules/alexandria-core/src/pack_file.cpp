@@ -0,0 +1,410 @@
+#include "alexandria-core/pack_file.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// External includes.
+////////////////////////////////////////////////////////////////
+
+#ifdef WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * \brief Offset of the byte that every PackFile holds a shared lock on while the file is open. Removing a file
+     * requires an exclusive lock on it. Both lock bytes lie far beyond the data, so that they never overlap with
+     * reads and writes.
+     */
+    constexpr uint64_t openLockOffset = uint64_t{1} << 62;
+
+    /**
+     * \brief Offset of the byte that is locked exclusively while appending.
+     */
+    constexpr uint64_t appendLockOffset = openLockOffset + 1;
+
+#ifdef WIN32
+    [[nodiscard]] bool lockByte(const HANDLE handle, const uint64_t offset, const bool exclusive, const bool wait)
+    {
+        OVERLAPPED overlapped{};
+        overlapped.Offset     = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        const DWORD flags     = (exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0) | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+        return LockFileEx(handle, flags, 0, 1, 0, &overlapped);
+    }
+
+    void unlockByte(const HANDLE handle, const uint64_t offset) noexcept
+    {
+        OVERLAPPED overlapped{};
+        overlapped.Offset     = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        UnlockFileEx(handle, 0, 1, 0, &overlapped);
+    }
+
+    [[nodiscard]] uint64_t getFileSize(const HANDLE handle, const std::filesystem::path& path)
+    {
+        LARGE_INTEGER s;
+        if (!GetFileSizeEx(handle, &s))
+            throw std::runtime_error(std::format(R"(Failed to get size of pack file "{}".)", path.string()));
+        return static_cast<uint64_t>(s.QuadPart);
+    }
+#else
+    /**
+     * \brief Lock a single byte of a file. Open file description locks are used where available, so that locks also
+     * exclude other PackFiles in the same process and are not released when another descriptor of the file is closed.
+     */
+    [[nodiscard]] bool lockByte(const int32_t handle, const uint64_t offset, const bool exclusive, const bool wait)
+    {
+        struct flock lock{};
+        lock.l_type   = exclusive ? F_WRLCK : F_RDLCK;
+        lock.l_whence = SEEK_SET;
+        lock.l_start  = static_cast<off_t>(offset);
+        lock.l_len    = 1;
+#ifdef F_OFD_SETLKW
+        const auto command = wait ? F_OFD_SETLKW : F_OFD_SETLK;
+#else
+        const auto command = wait ? F_SETLKW : F_SETLK;
+#endif
+        while (fcntl(handle, command, &lock) != 0)
+            if (errno != EINTR) return false;
+        return true;
+    }
+
+    void unlockByte(const int32_t handle, const uint64_t offset) noexcept
+    {
+        struct flock lock{};
+        lock.l_type   = F_UNLCK;
+        lock.l_whence = SEEK_SET;
+        lock.l_start  = static_cast<off_t>(offset);
+        lock.l_len    = 1;
+#ifdef F_OFD_SETLK
+        fcntl(handle, F_OFD_SETLK, &lock);
+#else
+        fcntl(handle, F_SETLK, &lock);
+#endif
+    }
+
+    [[nodiscard]] uint64_t getFileSize(const int32_t handle, const std::filesystem::path& path)
+    {
+        struct stat s;
+        if (fstat(handle, &s) != 0)
+            throw std::runtime_error(std::format(R"(Failed to get size of pack file "{}".)", path.string()));
+        return static_cast<uint64_t>(s.st_size);
+    }
+#endif
+}  // namespace
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // BlobView.
+    ////////////////////////////////////////////////////////////////
+
+    BlobView::BlobView(std::shared_ptr<const void> memoryOwner, const std::span<const std::byte> viewBytes) noexcept :
+        owner(std::move(memoryOwner)), bytes(viewBytes)
+    {
+    }
+
+    std::span<const std::byte> BlobView::get() const noexcept { return bytes; }
+
+    const std::byte* BlobView::data() const noexcept { return bytes.data(); }
+
+    size_t BlobView::size() const noexcept { return bytes.size(); }
+
+    bool BlobView::empty() const noexcept { return bytes.empty(); }
+
+    void BlobView::checkAs(const size_t alignment, const size_t size) const
+    {
+        if (bytes.size() % size != 0)
+            throw std::runtime_error(std::format("Size of blob view is not a multiple of {} bytes.", size));
+        if (reinterpret_cast<uintptr_t>(bytes.data()) % alignment != 0)
+            throw std::runtime_error(std::format("Blob view is not aligned to {} bytes.", alignment));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Mapping.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Read only memory map of the first size bytes of a file. Unmapped when the last view into it is released.
+     */
+    struct PackFile::Mapping
+    {
+#ifdef WIN32
+        HANDLE handle = nullptr;
+#endif
+        const std::byte* address = nullptr;
+        uint64_t         size    = 0;
+
+        Mapping() = default;
+
+        Mapping(const Mapping&) = delete;
+
+        Mapping& operator=(const Mapping&) = delete;
+
+        ~Mapping() noexcept
+        {
+#ifdef WIN32
+            if (address) UnmapViewOfFile(address);
+            if (handle) CloseHandle(handle);
+#else
+            if (address) munmap(const_cast<std::byte*>(address), static_cast<size_t>(size));
+#endif
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    PackFile::PackFile(std::filesystem::path file) : path(std::move(file))
+    {
+#ifdef WIN32
+        handle = CreateFileW(path.c_str(),
+                             GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr,
+                             OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            handle = nullptr;
+            throw std::runtime_error(
+              std::format(R"(Failed to open pack file "{}": error {}.)", path.string(), GetLastError()));
+        }
+
+        if (!lockByte(handle, openLockOffset, false, true))
+        {
+            CloseHandle(handle);
+            throw std::runtime_error(
+              std::format(R"(Failed to lock pack file "{}": error {}.)", path.string(), GetLastError()));
+        }
+
+        try
+        {
+            fileSize = getFileSize(handle, path);
+        }
+        catch (...)
+        {
+            CloseHandle(handle);
+            throw;
+        }
+#else
+        while (true)
+        {
+            handle = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (handle < 0)
+                throw std::runtime_error(
+                  std::format(R"(Failed to open pack file "{}": {}.)", path.string(), std::strerror(errno)));
+
+            if (!lockByte(handle, openLockOffset, false, true))
+            {
+                const auto error = errno;
+                ::close(handle);
+                throw std::runtime_error(
+                  std::format(R"(Failed to lock pack file "{}": {}.)", path.string(), std::strerror(error)));
+            }
+
+            struct stat opened;
+            if (fstat(handle, &opened) != 0)
+            {
+                ::close(handle);
+                throw std::runtime_error(std::format(R"(Failed to get size of pack file "{}".)", path.string()));
+            }
+
+            // The file may have been removed by another process between opening and locking it. Open it again in
+            // that case.
+            struct stat current;
+            if (::stat(path.c_str(), &current) == 0 && current.st_dev == opened.st_dev &&
+                current.st_ino == opened.st_ino)
+            {
+                fileSize = static_cast<uint64_t>(opened.st_size);
+                break;
+            }
+
+            ::close(handle);
+        }
+#endif
+    }
+
+    PackFile::~PackFile() noexcept
+    {
+#ifdef WIN32
+        if (handle) CloseHandle(handle);
+#else
+        if (handle >= 0) ::close(handle);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::filesystem::path& PackFile::getPath() const noexcept { return path; }
+
+    uint64_t PackFile::size() const
+    {
+        std::scoped_lock lock(mutex);
+        fileSize = getFileSize(handle, path);
+        return fileSize;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Removing.
+    ////////////////////////////////////////////////////////////////
+
+    bool PackFile::removeIfUnused(const std::filesystem::path& file)
+    {
+        std::error_code ec;
+        if (!std::filesystem::exists(file, ec)) return !ec;
+
+#ifdef WIN32
+        const auto h = CreateFileW(file.c_str(),
+                                   GENERIC_READ | GENERIC_WRITE,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   nullptr,
+                                   OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL,
+                                   nullptr);
+        if (h == INVALID_HANDLE_VALUE) return false;
+        const auto removed = lockByte(h, openLockOffset, true, false) && std::filesystem::remove(file, ec);
+        CloseHandle(h);
+#else
+        const auto h = ::open(file.c_str(), O_RDWR | O_CLOEXEC);
+        if (h < 0) return false;
+        const auto removed = lockByte(h, openLockOffset, true, false) && std::filesystem::remove(file, ec);
+        ::close(h);
+#endif
+        return removed;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Reading and writing.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t PackFile::append(const std::span<const std::byte> data)
+    {
+        std::scoped_lock lock(mutex);
+
+        // Other processes can append to the same file. Lock the file and get its current size before writing.
+        if (!lockByte(handle, appendLockOffset, true, true))
+            throw std::runtime_error(std::format(R"(Failed to lock pack file "{}".)", path.string()));
+        struct Unlock
+        {
+            decltype(handle) h;
+
+            ~Unlock() noexcept { unlockByte(h, appendLockOffset); }
+        } unlock{handle};
+        fileSize = getFileSize(handle, path);
+
+        const auto write = [&](std::span<const std::byte> bytes, uint64_t offset) {
+            while (!bytes.empty())
+            {
+#ifdef WIN32
+                OVERLAPPED overlapped{};
+                overlapped.Offset     = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD      written    = 0;
+                const auto count      = static_cast<DWORD>(std::min<size_t>(bytes.size(), 1u << 30));
+                if (!WriteFile(handle, bytes.data(), count, &written, &overlapped))
+                    throw std::runtime_error(std::format(
+                      R"(Failed to write to pack file "{}": error {}.)", path.string(), GetLastError()));
+#else
+                const auto written = ::pwrite(handle, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+                if (written < 0)
+                {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error(
+                      std::format(R"(Failed to write to pack file "{}": {}.)", path.string(), std::strerror(errno)));
+                }
+#endif
+                bytes = bytes.subspan(static_cast<size_t>(written));
+                offset += static_cast<uint64_t>(written);
+            }
+        };
+
+        // Pad the end of the file up to the alignment.
+        const auto offset = (fileSize + alignment - 1) / alignment * alignment;
+        if (offset > fileSize)
+        {
+            constexpr std::array<std::byte, alignment> padding{};
+            write(std::span(padding).first(static_cast<size_t>(offset - fileSize)), fileSize);
+            fileSize = offset;
+        }
+
+        write(data, offset);
+        fileSize = offset + data.size();
+        return offset;
+    }
+
+    void PackFile::sync()
+    {
+        std::scoped_lock lock(mutex);
+#ifdef WIN32
+        if (!FlushFileBuffers(handle))
+#else
+        if (fsync(handle) != 0)
+#endif
+            throw std::runtime_error(std::format(R"(Failed to flush pack file "{}".)", path.string()));
+    }
+
+    BlobView PackFile::view(const uint64_t offset, const uint64_t length) const
+    {
+        std::scoped_lock lock(mutex);
+
+        // The range may have been appended by another process.
+        if (offset > fileSize || length > fileSize - offset) fileSize = getFileSize(handle, path);
+        if (offset > fileSize || length > fileSize - offset)
+            throw std::runtime_error(std::format(
+              R"(Range [{}, {}) is outside of pack file "{}".)", offset, offset + length, path.string()));
+        if (length == 0) return {};
+
+        // Map the whole file again if the range was appended after the current mapping was made.
+        if (!mapping || offset + length > mapping->size)
+        {
+            auto m  = std::make_shared<Mapping>();
+            m->size = fileSize;
+#ifdef WIN32
+            m->handle = CreateFileMappingW(handle,
+                                           nullptr,
+                                           PAGE_READONLY,
+                                           static_cast<DWORD>(fileSize >> 32),
+                                           static_cast<DWORD>(fileSize),
+                                           nullptr);
+            if (m->handle)
+                m->address = static_cast<const std::byte*>(MapViewOfFile(m->handle, FILE_MAP_READ, 0, 0, 0));
+            if (!m->address)
+                throw std::runtime_error(
+                  std::format(R"(Failed to map pack file "{}": error {}.)", path.string(), GetLastError()));
+#else
+            void* address = mmap(nullptr, static_cast<size_t>(fileSize), PROT_READ, MAP_SHARED, handle, 0);
+            if (address == MAP_FAILED)
+                throw std::runtime_error(
+                  std::format(R"(Failed to map pack file "{}": {}.)", path.string(), std::strerror(errno)));
+            m->address = static_cast<const std::byte*>(address);
+#endif
+            mapping = std::move(m);
+        }
+
+        const auto bytes = std::span(mapping->address + offset, static_cast<size_t>(length));
+        return {mapping, bytes};
+    }
+}  // namespace alex
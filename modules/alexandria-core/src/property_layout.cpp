@@ -1,14 +1,139 @@
 #include "alexandria-core/property_layout.h"
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/external_store.h"
 #include "alexandria-core/library.h"
 #include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
 #include "alexandria-core/type.h"
 #include "alexandria-core/type_layout.h"
 
+namespace
+{
+    /**
+     * \brief Create an index on the (value, instance) columns of an array table. Searches on array values are
+     * compiled to semi-joins that can be answered from this index alone.
+     * \param db Database.
+     * \param arrayTable Array table.
+     */
+    void createValueIndex(sql::Database& db, const sql::Table& arrayTable)
+    {
+        alex::execute(db,
+                      std::format("CREATE INDEX {} ON {}(value, instance);",
+                                  alex::quoteIdentifier(arrayTable.getName() + "_value"),
+                                  alex::quoteIdentifier(arrayTable.getName())));
+    }
+
+    /**
+     * \brief Create an index on the (instance, position) columns of an array table, so that arrays and slices of
+     * arrays are read in order without sorting. If the index covers the value column as well, reads do not have to
+     * visit the table at all, which effectively clusters the elements of an array.
+     * \param db Database.
+     * \param arrayTable Array table.
+     * \param covering Include the value column.
+     */
+    void createPositionIndex(sql::Database& db, const sql::Table& arrayTable, const bool covering)
+    {
+        alex::execute(db,
+                      std::format("CREATE INDEX {} ON {}(instance, position{});",
+                                  alex::quoteIdentifier(arrayTable.getName() + "_position"),
+                                  alex::quoteIdentifier(arrayTable.getName()),
+                                  covering ? ", value" : ""));
+    }
+
+    /**
+     * \brief Create an FTS5 table that indexes a text column of another table as external content, and the triggers
+     * that keep the index in sync with inserts, updates and deletes of that table.
+     * \param db Database.
+     * \param table Name of the content table. Must have an integer primary key column named "id".
+     * \param column Name of the indexed column.
+     * \return Name of the FTS5 table.
+     */
+    std::string createFullTextIndex(sql::Database& db, const std::string& table, const std::string& column)
+    {
+        const auto fts  = alex::PropertyLayout::getFullTextTableName(table, column);
+        const auto qFts = alex::quoteIdentifier(fts);
+        const auto qTab = alex::quoteIdentifier(table);
+        const auto qCol = alex::quoteIdentifier(column);
+
+        alex::execute(db,
+                      std::format("CREATE VIRTUAL TABLE {0} USING fts5({1}, content={2}, content_rowid='id');"
+                                  "CREATE TRIGGER {3} AFTER INSERT ON {2} BEGIN "
+                                  "INSERT INTO {0}(rowid, {1}) VALUES (new.id, new.{1}); END;"
+                                  "CREATE TRIGGER {4} AFTER DELETE ON {2} BEGIN "
+                                  "INSERT INTO {0}({0}, rowid, {1}) VALUES ('delete', old.id, old.{1}); END;"
+                                  "CREATE TRIGGER {5} AFTER UPDATE OF {1} ON {2} BEGIN "
+                                  "INSERT INTO {0}({0}, rowid, {1}) VALUES ('delete', old.id, old.{1}); "
+                                  "INSERT INTO {0}(rowid, {1}) VALUES (new.id, new.{1}); END;",
+                                  qFts,
+                                  qCol,
+                                  qTab,
+                                  alex::quoteIdentifier(fts + "_insert"),
+                                  alex::quoteIdentifier(fts + "_delete"),
+                                  alex::quoteIdentifier(fts + "_update")));
+        return fts;
+    }
+
+    /**
+     * \brief Create an R*Tree table that indexes a set of numeric columns of the instance table as a point, and the
+     * triggers that keep the index in sync. Rows in which any of the columns is null are not indexed.
+     * \param db Database.
+     * \param table Name of the instance table.
+     * \param columns Names of the indexed columns.
+     * \return Name of the R*Tree table.
+     */
+    std::string
+      createSpatialIndex(sql::Database& db, const std::string& table, const std::vector<std::string>& columns)
+    {
+        const auto rtree  = alex::PropertyLayout::getSpatialTableName(table, columns.front());
+        const auto qRtree = alex::quoteIdentifier(rtree);
+        const auto qTab   = alex::quoteIdentifier(table);
+
+        // Build the list of dimensions, the list of values and the null check.
+        std::string dimensions, values, notNull, updateOf;
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            const auto col = alex::quoteIdentifier(columns[i]);
+            dimensions += std::format(", min{0}, max{0}", i);
+            values += std::format(", new.{0}, new.{0}", col);
+            notNull += std::format("{}new.{} IS NOT NULL", i == 0 ? "" : " AND ", col);
+            updateOf += std::format("{}{}", i == 0 ? "" : ", ", col);
+        }
+
+        const auto insert = std::format("INSERT INTO {} SELECT new.id{} WHERE {};", qRtree, values, notNull);
+        alex::execute(db,
+                      std::format("CREATE VIRTUAL TABLE {0} USING rtree(id{1});"
+                                  "CREATE TRIGGER {3} AFTER INSERT ON {2} BEGIN {7} END;"
+                                  "CREATE TRIGGER {4} AFTER DELETE ON {2} BEGIN DELETE FROM {0} WHERE id = old.id; END;"
+                                  "CREATE TRIGGER {5} AFTER UPDATE OF {6} ON {2} BEGIN "
+                                  "DELETE FROM {0} WHERE id = old.id; {7} END;",
+                                  qRtree,
+                                  dimensions,
+                                  qTab,
+                                  alex::quoteIdentifier(rtree + "_insert"),
+                                  alex::quoteIdentifier(rtree + "_delete"),
+                                  alex::quoteIdentifier(rtree + "_update"),
+                                  updateOf,
+                                  insert));
+        return rtree;
+    }
+}  // namespace
+
 namespace alex
 {
     ////////////////////////////////////////////////////////////////
@@ -20,20 +145,36 @@ namespace alex
                                    const DataType type,
                                    Type*          refType,
                                    const bool     isArray,
-                                   const bool     isBlob) :
+                                   const bool     isBlob,
+                                   const bool     isFullText,
+                                   const bool     isSpatial,
+                                   const bool     isIndexed,
+                                   const Codec    c,
+                                   const bool     isDeduplicated,
+                                   const int64_t  threshold,
+                                   const bool     isPacked) :
         typeLayout(&layout),
         name(std::move(propName)),
         dataType(type),
         referenceType(refType),
         array(isArray),
-        blob(isBlob)
+        blob(isBlob),
+        fullText(isFullText),
+        spatial(isSpatial),
+        indexed(isIndexed),
+        codec(c),
+        deduplicated(isDeduplicated),
+        externalThreshold(threshold),
+        packed(isPacked)
     {
     }
 
     bool PropertyLayout::operator==(const PropertyLayout& rhs) const noexcept
     {
         return name == rhs.name && dataType == rhs.dataType && referenceType == rhs.referenceType &&
-               array == rhs.array && blob == rhs.blob;
+               array == rhs.array && blob == rhs.blob && fullText == rhs.fullText &&
+               spatial == rhs.spatial && indexed == rhs.indexed && codec == rhs.codec &&
+               deduplicated == rhs.deduplicated && externalThreshold == rhs.externalThreshold && packed == rhs.packed;
     }
 
     ////////////////////////////////////////////////////////////////
@@ -52,12 +193,162 @@ namespace alex
 
     bool PropertyLayout::isBlob() const noexcept { return blob; }
 
+    bool PropertyLayout::isFullText() const noexcept { return fullText; }
+
+    std::string PropertyLayout::getFullTextTableName(const std::string& table, const std::string& column)
+    {
+        return table + "_" + column + "_fts";
+    }
+
+    bool PropertyLayout::isSpatial() const noexcept { return spatial; }
+
+    std::string PropertyLayout::getSpatialTableName(const std::string& table, const std::string& column)
+    {
+        return table + "_" + column + "_rtree";
+    }
+
+    bool PropertyLayout::isIndexed() const noexcept { return indexed; }
+
+    std::string PropertyLayout::getIndexName(const std::string& table, const std::string& column)
+    {
+        return table + "_" + column + "_index";
+    }
+
+    Codec PropertyLayout::getCodec() const noexcept { return codec; }
+
+    bool PropertyLayout::isDeduplicated() const noexcept { return deduplicated; }
+
+    int64_t PropertyLayout::getExternalThreshold() const noexcept { return externalThreshold; }
+
+    bool PropertyLayout::isPacked() const noexcept { return packed; }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    PropertyLayout& PropertyLayout::setFullText(const bool enabled)
+    {
+        if (enabled && dataType != DataType::String)
+            throw std::runtime_error(std::format(
+              R"(Cannot enable full-text index on property "{}". It is not a string or string array property.)", name));
+        if (enabled && packed)
+            throw std::runtime_error(
+              std::format(R"(Cannot enable full-text index on property "{}". Its values are packed.)", name));
+
+        fullText = enabled;
+        return *this;
+    }
+
+    PropertyLayout& PropertyLayout::setSpatial(const bool enabled)
+    {
+        if (enabled)
+        {
+            if (dataType != DataType::Nested)
+                throw std::runtime_error(std::format(
+                  R"(Cannot enable spatial index on property "{}". It is not a nested type property.)", name));
+
+            const auto& props = referenceType->getLayout().getProperties();
+            const auto  valid = props.size() >= 2 && props.size() <= 3 &&
+                               std::ranges::all_of(props, [](const auto& prop) {
+                                   return isPrimitiveDataType(prop->getDataType()) && !prop->isArray() &&
+                                          !prop->isBlob();
+                               });
+            if (!valid)
+                throw std::runtime_error(
+                  std::format(R"(Cannot enable spatial index on property "{}". The nested type must have 2 or 3 )"
+                              R"(numeric properties.)",
+                              name));
+        }
+
+        spatial = enabled;
+        return *this;
+    }
+
+    PropertyLayout& PropertyLayout::setIndexed(const bool enabled)
+    {
+        if (enabled && !(isPrimitiveDataType(dataType) || dataType == DataType::String))
+            throw std::runtime_error(std::format(
+              R"(Cannot enable value index on property "{}". It is not a primitive or string property.)", name));
+        if (enabled && (array || blob))
+            throw std::runtime_error(
+              std::format(R"(Cannot enable value index on property "{}". It is an array or blob property.)", name));
+
+        indexed = enabled;
+        return *this;
+    }
+
+    PropertyLayout& PropertyLayout::setCodec(const Codec c)
+    {
+        if (c != Codec::None && !(dataType == DataType::Blob || blob))
+            throw std::runtime_error(std::format(
+              R"(Cannot set codec of property "{}". It is not a blob, primitive blob or blob array property.)", name));
+        if (c == Codec::DeltaVarint && (dataType == DataType::Blob || dataType == DataType::Float ||
+                                        dataType == DataType::Double))
+            throw std::runtime_error(std::format(
+              R"(Cannot set delta varint codec of property "{}". It is not a primitive blob of integers.)", name));
+
+        codec = c;
+        return *this;
+    }
+
+    PropertyLayout& PropertyLayout::setDeduplicated(const bool enabled)
+    {
+        if (enabled && !(dataType == DataType::Blob || blob))
+            throw std::runtime_error(std::format(
+              R"(Cannot deduplicate property "{}". It is not a blob, primitive blob or blob array property.)", name));
+        if (enabled && externalThreshold > 0)
+            throw std::runtime_error(
+              std::format(R"(Cannot deduplicate property "{}". Its values are stored externally.)", name));
+
+        deduplicated = enabled;
+        return *this;
+    }
+
+    PropertyLayout& PropertyLayout::setExternal(const int64_t threshold)
+    {
+        if (threshold < 0)
+            throw std::runtime_error(
+              std::format(R"(Cannot set external threshold of property "{}". It is negative.)", name));
+        if (threshold > std::numeric_limits<int64_t>::max() >> 16)
+            throw std::runtime_error(
+              std::format(R"(Cannot set external threshold of property "{}". It is too large.)", name));
+        if (threshold > 0 && !(dataType == DataType::Blob || blob))
+            throw std::runtime_error(std::format(
+              R"(Cannot store property "{}" externally. It is not a blob, primitive blob or blob array property.)",
+              name));
+        if (threshold > 0 && deduplicated)
+            throw std::runtime_error(
+              std::format(R"(Cannot store property "{}" externally. Its values are deduplicated.)", name));
+
+        externalThreshold = threshold;
+        return *this;
+    }
+
+    PropertyLayout& PropertyLayout::setPacked(const bool enabled)
+    {
+        if (enabled && !(array && (isPrimitiveDataType(dataType) || dataType == DataType::String)))
+            throw std::runtime_error(
+              std::format(R"(Cannot pack property "{}". It is not a primitive or string array property.)", name));
+        if (enabled && fullText)
+            throw std::runtime_error(std::format(R"(Cannot pack property "{}". It has a full-text index.)", name));
+
+        packed = enabled;
+        return *this;
+    }
+
     sql::row_id PropertyLayout::commit(Namespace& nameSpace, sql::row_id typeId) const
     {
         const auto& library       = nameSpace.getLibrary();
         const auto& db            = library.getDatabase();
         const auto& propertyTable = library.getPropertyTable();
 
+        PropertyOptions options{.codec = static_cast<int32_t>(getCodec()), .externalThreshold = getExternalThreshold()};
+        if (isFullText()) options.flags |= PropertyOptions::fullTextFlag;
+        if (isSpatial()) options.flags |= PropertyOptions::spatialFlag;
+        if (isIndexed()) options.flags |= PropertyOptions::indexedFlag;
+        if (isDeduplicated()) options.flags |= PropertyOptions::deduplicatedFlag;
+        if (isPacked()) options.flags |= PropertyOptions::packedFlag;
+
         // Add property to table.
         auto       insert     = propertyTable.insert().compile();
         const auto typeString = toString(dataType);
@@ -67,7 +358,8 @@ namespace alex
                sql::toStaticText(typeString),
                referenceType ? std::make_optional(referenceType->getId()) : std::optional<sql::row_id>(),
                isArray() ? 1 : 0,
-               isBlob() ? 1 : 0);
+               isBlob() ? 1 : 0,
+               options.encode());
 
         // Set ID.
         return db.getLastInsertRowId();
@@ -94,8 +386,12 @@ namespace alex
                   .foreignKey(instanceTable.getColumn("uuid"), sql::ForeignKeyAction::Cascade)
                   .notNull();
                 arrayTable.createColumn("value", toColumnType(dataType));
+                arrayTable.createColumn("position", sql::Column::Type::Int).notNull();
                 arrayTable.commit();
 
+                // Include small values in the position index. Blobs and packed arrays are only stored in the table.
+                createPositionIndex(db, arrayTable, dataType != DataType::Blob && !packed);
+
                 if (dataType == DataType::Blob)
                 {
                     blobArrayTables.emplace_back(&arrayTable);
@@ -104,6 +400,9 @@ namespace alex
                 }
                 else
                 {
+                    // Index values to allow searching arrays without scanning them. Packed arrays cannot be searched.
+                    if (!packed) createValueIndex(db, arrayTable);
+
                     primitiveArrayTables.emplace_back(&arrayTable);
                     library.getGeneratedTablesInsert()(
                       nullptr, currentType, sql::toText(arrayTable.getName()), sql::toText("primitive_array"));
@@ -147,8 +446,14 @@ namespace alex
                   .notNull();
                 arrayTable.createColumn("value", sql::Column::Type::Text)
                   .foreignKey(refColumn, sql::ForeignKeyAction::Cascade);
+                arrayTable.createColumn("position", sql::Column::Type::Int).notNull();
                 arrayTable.commit();
 
+                createPositionIndex(db, arrayTable, true);
+
+                // Index values to allow searching arrays without scanning them.
+                createValueIndex(db, arrayTable);
+
                 referenceArrayTables.emplace_back(&arrayTable);
                 library.getGeneratedTablesInsert()(
                   nullptr, currentType, sql::toText(arrayTable.getName()), sql::toText("reference_array"));
@@ -162,4 +467,74 @@ namespace alex
             }
         }
     }
+
+    void PropertyLayout::generateIndices(Library&           library,
+                                         const sql::row_id  currentType,
+                                         const sql::Table&  instanceTable,
+                                         const std::string& prefix) const
+    {
+        if (dataType == DataType::Nested)
+        {
+            const auto prefix2 = prefix + "_" + name;
+
+            // Index the columns of the nested type as a point.
+            if (spatial)
+            {
+                std::vector<std::string> columns;
+                for (const auto& prop : referenceType->getLayout().getProperties())
+                    columns.emplace_back(prefix2 + prop->getName());
+
+                const auto rtree = createSpatialIndex(library.getDatabase(), instanceTable.getName(), columns);
+                library.getGeneratedTablesInsert()(nullptr, currentType, sql::toText(rtree), sql::toText("spatial"));
+            }
+
+            // Recurse.
+            for (const auto& prop : referenceType->getLayout().getProperties())
+                prop->generateIndices(library, currentType, instanceTable, prefix2);
+        }
+        else
+        {
+            auto& db = library.getDatabase();
+
+            if (fullText)
+            {
+                // Index either the value column of the array table or the column of the instance table.
+                const auto fts = array ?
+                                   createFullTextIndex(db, instanceTable.getName() + "_" + prefix + name, "value") :
+                                   createFullTextIndex(db, instanceTable.getName(), prefix + name);
+
+                library.getGeneratedTablesInsert()(nullptr, currentType, sql::toText(fts), sql::toText("fulltext"));
+            }
+
+            if (deduplicated)
+            {
+                // Keep the reference counts of the shared blobs up to date.
+                BlobStore::create(db);
+                if (array)
+                    BlobStore::createTriggers(db, instanceTable.getName() + "_" + prefix + name, "value");
+                else
+                    BlobStore::createTriggers(db, instanceTable.getName(), prefix + name);
+            }
+
+            if (externalThreshold > 0)
+            {
+                // Remove values from the external store when they are no longer referenced.
+                ExternalStore::create(db);
+                if (array)
+                    ExternalStore::createTriggers(db, instanceTable.getName() + "_" + prefix + name, "value");
+                else
+                    ExternalStore::createTriggers(db, instanceTable.getName(), prefix + name);
+            }
+
+            if (indexed)
+            {
+                const auto column = prefix + name;
+                alex::execute(db,
+                              std::format("CREATE INDEX {} ON {}({});",
+                                          quoteIdentifier(getIndexName(instanceTable.getName(), column)),
+                                          quoteIdentifier(instanceTable.getName()),
+                                          quoteIdentifier(column)));
+            }
+        }
+    }
 }  // namespace alex
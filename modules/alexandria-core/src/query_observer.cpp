@@ -0,0 +1,109 @@
+#include "alexandria-core/query_observer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <exception>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+
+namespace alex
+{
+    std::string_view toString(const QueryClass query) noexcept
+    {
+        switch (query)
+        {
+        case QueryClass::Insert: return "insert";
+        case QueryClass::Get: return "get";
+        case QueryClass::Update: return "update";
+        case QueryClass::Delete: return "delete";
+        case QueryClass::Search: return "search";
+        }
+        return "";
+    }
+
+    std::string_view toString(const QueryStage stage) noexcept
+    {
+        switch (stage)
+        {
+        case QueryStage::Total: return "total";
+        case QueryStage::Uuid: return "uuid";
+        case QueryStage::Begin: return "begin";
+        case QueryStage::Primitive: return "primitive";
+        case QueryStage::PrimitiveArray: return "primitive_array";
+        case QueryStage::BlobArray: return "blob_array";
+        case QueryStage::ReferenceArray: return "reference_array";
+        case QueryStage::ArrayClear: return "array_clear";
+        case QueryStage::Commit: return "commit";
+        case QueryStage::Bind: return "bind";
+        case QueryStage::Execute: return "execute";
+        }
+        return "";
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // QueryObserver.
+    ////////////////////////////////////////////////////////////////
+
+    void QueryObserver::onQuery(const QueryEvent&) {}
+
+    void QueryObserver::onStatement(const StatementEvent&) {}
+
+    ////////////////////////////////////////////////////////////////
+    // QueryProfile.
+    ////////////////////////////////////////////////////////////////
+
+    QueryProfile::QueryProfile(const Library& lib, const Type& t, const QueryClass q) noexcept :
+        observer(lib.getQueryObserver()), library(&lib), type(&t), query(q)
+    {
+        if (!observer) return;
+        exceptions = std::uncaught_exceptions();
+        start      = mark();
+        stageStart = start;
+    }
+
+    QueryProfile::Mark QueryProfile::mark() const noexcept
+    {
+        return {std::chrono::steady_clock::now(), library->getQueryCounters()};
+    }
+
+    void QueryProfile::report(const QueryStage s, const Mark& from, const Mark& to, const bool failed) const noexcept
+    {
+        // An observer that throws must not turn a successful query into a failed one, or terminate the application
+        // while the profile is destroyed during unwinding.
+        try
+        {
+            observer->onQuery(QueryEvent{.type     = type,
+                                         .query    = query,
+                                         .stage    = s,
+                                         .duration = to.time - from.time,
+                                         .rows     = to.counters.rows - from.counters.rows,
+                                         .bytes    = to.counters.bytes - from.counters.bytes,
+                                         .failed   = failed});
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void QueryProfile::enter(const QueryStage next) noexcept
+    {
+        const auto now = mark();
+        if (current != QueryStage::Total) report(current, stageStart, now, false);
+        current    = next;
+        stageStart = now;
+    }
+
+    void QueryProfile::finish() noexcept
+    {
+        const auto now    = mark();
+        const auto failed = std::uncaught_exceptions() > exceptions;
+        if (current != QueryStage::Total) report(current, stageStart, now, failed);
+        report(QueryStage::Total, start, now, failed);
+    }
+}  // namespace alex
@@ -0,0 +1,204 @@
+#include "alexandria-core/raw_statement.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// External includes.
+////////////////////////////////////////////////////////////////
+
+#include "sqlite3.h"
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    RawStatement::RawStatement(sql::Database& database, std::string sql, const bool persistent) :
+        db(database.get()), sqlString(std::move(sql))
+    {
+        if (const auto res = sqlite3_prepare_v3(db,
+                                                sqlString.c_str(),
+                                                static_cast<int32_t>(sqlString.size() + 1),
+                                                persistent ? SQLITE_PREPARE_PERSISTENT : 0,
+                                                &statement,
+                                                nullptr);
+            res != SQLITE_OK)
+        {
+            sqlite3_finalize(statement);
+            statement = nullptr;
+            throw std::runtime_error(
+              std::format("Failed to prepare statement \"{}\": {}", sqlString, sqlite3_errmsg(db)));
+        }
+    }
+
+    RawStatement::RawStatement(RawStatement&& other) noexcept :
+        db(std::exchange(other.db, nullptr)),
+        statement(std::exchange(other.statement, nullptr)),
+        sqlString(std::move(other.sqlString))
+    {
+    }
+
+    RawStatement::~RawStatement() noexcept { sqlite3_finalize(statement); }
+
+    RawStatement& RawStatement::operator=(RawStatement&& other) noexcept
+    {
+        if (this != &other)
+        {
+            sqlite3_finalize(statement);
+            db        = std::exchange(other.db, nullptr);
+            statement = std::exchange(other.statement, nullptr);
+            sqlString = std::move(other.sqlString);
+        }
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    sqlite3_stmt* RawStatement::get() const noexcept { return statement; }
+
+    const std::string& RawStatement::getSql() const noexcept { return sqlString; }
+
+    ////////////////////////////////////////////////////////////////
+    // Execution.
+    ////////////////////////////////////////////////////////////////
+
+    bool RawStatement::step()
+    {
+        const auto res = sqlite3_step(statement);
+        if (res == SQLITE_ROW) return true;
+        if (res == SQLITE_DONE) return false;
+        throw std::runtime_error(std::format("Failed to step statement \"{}\": {}", sqlString, sqlite3_errmsg(db)));
+    }
+
+    void RawStatement::reset() { sqlite3_reset(statement); }
+
+    void RawStatement::clearBindings() { sqlite3_clear_bindings(statement); }
+
+    ////////////////////////////////////////////////////////////////
+    // Binding.
+    ////////////////////////////////////////////////////////////////
+
+    int32_t RawStatement::getParameterIndex(const std::string& name) const
+    {
+        return sqlite3_bind_parameter_index(statement, name.c_str());
+    }
+
+    void RawStatement::bindNull(const int32_t index) { check(sqlite3_bind_null(statement, index)); }
+
+    void RawStatement::bindInt64(const int32_t index, const int64_t value)
+    {
+        check(sqlite3_bind_int64(statement, index, value));
+    }
+
+    void RawStatement::bindDouble(const int32_t index, const double value)
+    {
+        check(sqlite3_bind_double(statement, index, value));
+    }
+
+    void RawStatement::bindText(const int32_t index, const std::string_view value)
+    {
+        check(sqlite3_bind_text64(
+          statement, index, value.data(), static_cast<sqlite3_uint64>(value.size()), SQLITE_TRANSIENT, SQLITE_UTF8));
+    }
+
+    void RawStatement::bindBlob(const int32_t index, const std::span<const std::byte> value)
+    {
+        check(sqlite3_bind_blob64(
+          statement, index, value.data(), static_cast<sqlite3_uint64>(value.size()), SQLITE_TRANSIENT));
+    }
+
+    void RawStatement::bindZeroBlob(const int32_t index, const int64_t size)
+    {
+        check(sqlite3_bind_zeroblob64(statement, index, static_cast<sqlite3_uint64>(size)));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Columns.
+    ////////////////////////////////////////////////////////////////
+
+    int32_t RawStatement::getColumnCount() const noexcept { return sqlite3_column_count(statement); }
+
+    bool RawStatement::isNull(const int32_t index) const noexcept
+    {
+        return sqlite3_column_type(statement, index) == SQLITE_NULL;
+    }
+
+    bool RawStatement::isInteger(const int32_t index) const noexcept
+    {
+        return sqlite3_column_type(statement, index) == SQLITE_INTEGER;
+    }
+
+    bool RawStatement::isText(const int32_t index) const noexcept
+    {
+        return sqlite3_column_type(statement, index) == SQLITE_TEXT;
+    }
+
+    int64_t RawStatement::getInt64(const int32_t index) const noexcept
+    {
+        return sqlite3_column_int64(statement, index);
+    }
+
+    double RawStatement::getDouble(const int32_t index) const noexcept
+    {
+        return sqlite3_column_double(statement, index);
+    }
+
+    std::string_view RawStatement::getText(const int32_t index) const noexcept
+    {
+        const auto* data = reinterpret_cast<const char*>(sqlite3_column_text(statement, index));
+        const auto  size = sqlite3_column_bytes(statement, index);
+        if (!data) return {};
+        return {data, static_cast<size_t>(size)};
+    }
+
+    std::span<const std::byte> RawStatement::getBlob(const int32_t index) const noexcept
+    {
+        const auto* data = static_cast<const std::byte*>(sqlite3_column_blob(statement, index));
+        const auto  size = sqlite3_column_bytes(statement, index);
+        if (!data) return {};
+        return {data, static_cast<size_t>(size)};
+    }
+
+    void RawStatement::check(const int32_t result) const
+    {
+        if (result != SQLITE_OK)
+            throw std::runtime_error(
+              std::format("Failed to bind parameter of statement \"{}\": {}", sqlString, sqlite3_errmsg(db)));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Utilities.
+    ////////////////////////////////////////////////////////////////
+
+    void execute(sql::Database& db, const std::string& sql)
+    {
+        char* error = nullptr;
+        if (sqlite3_exec(db.get(), sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK)
+        {
+            const std::string message = error ? error : "unknown error";
+            sqlite3_free(error);
+            throw std::runtime_error(std::format("Failed to execute \"{}\": {}", sql, message));
+        }
+    }
+
+    std::string quoteIdentifier(const std::string_view name)
+    {
+        std::string quoted = "\"";
+        for (const auto c : name)
+        {
+            if (c == '"') quoted += '"';
+            quoted += c;
+        }
+        quoted += '"';
+        return quoted;
+    }
+}  // namespace alex
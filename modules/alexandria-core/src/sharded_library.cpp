@@ -0,0 +1,209 @@
+#include "alexandria-core/sharded_library.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+
+namespace
+{
+    /**
+     * \brief Read the rows of all specification tables as a single string.
+     * \param library Library.
+     * \return Specification.
+     */
+    [[nodiscard]] std::string readSpecification(alex::Library& library)
+    {
+        std::string spec;
+        for (const auto* table : {"namespaces", "types", "properties", "tables"})
+        {
+            alex::RawStatement stmt(library.getDatabase(), std::format("SELECT * FROM {} ORDER BY id;", table), false);
+            while (stmt.step())
+            {
+                for (int32_t i = 0; i < stmt.getColumnCount(); i++)
+                    spec += std::format("{}\x1f", stmt.isNull(i) ? std::string_view("<null>") : stmt.getText(i));
+                spec += '\n';
+            }
+            spec += '\x1e';
+        }
+        return spec;
+    }
+}  // namespace
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    ShardedLibrary::ShardedLibrary(std::vector<LibraryPtr> libraries) : shards(std::move(libraries))
+    {
+        if (shards.empty()) throw std::runtime_error("A ShardedLibrary needs at least one shard.");
+        if (std::ranges::any_of(shards, [](const auto& shard) { return shard == nullptr; }))
+            throw std::runtime_error("Cannot construct a ShardedLibrary from a null library.");
+        verifySpecification();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Static open/create methods.
+    ////////////////////////////////////////////////////////////////
+
+    ShardedLibraryPtr ShardedLibrary::create(const std::vector<std::filesystem::path>& files)
+    {
+        std::vector<LibraryPtr> libraries;
+        try
+        {
+            for (const auto& file : files) libraries.emplace_back(Library::create(file));
+            return std::make_unique<ShardedLibrary>(std::move(libraries));
+        }
+        catch (...)
+        {
+            // Remove the files that were created before the failure.
+            const auto created = libraries.size();
+            libraries.clear();
+            std::error_code ec;
+            for (size_t i = 0; i < created; i++)
+                if (!files[i].empty()) std::filesystem::remove(files[i], ec);
+            throw;
+        }
+    }
+
+    ShardedLibraryPtr ShardedLibrary::open(const std::vector<std::filesystem::path>& files)
+    {
+        std::vector<LibraryPtr> libraries;
+        for (const auto& file : files) libraries.emplace_back(Library::open(file));
+        return std::make_unique<ShardedLibrary>(std::move(libraries));
+    }
+
+    std::pair<ShardedLibraryPtr, bool> ShardedLibrary::openOrCreate(const std::vector<std::filesystem::path>& files)
+    {
+        const auto existing = std::ranges::count_if(
+          files, [](const std::filesystem::path& file) { return !file.empty() && exists(file); });
+
+        if (existing == 0) return std::make_pair(create(files), true);
+        if (static_cast<size_t>(existing) == files.size()) return std::make_pair(open(files), false);
+        throw std::runtime_error(
+          std::format("Cannot open sharded library. Only {} of the {} shard files exist.", existing, files.size()));
+    }
+
+    std::vector<std::filesystem::path> ShardedLibrary::getShardFiles(const std::filesystem::path& file,
+                                                                     const size_t                 count)
+    {
+        std::vector<std::filesystem::path> files;
+        for (size_t i = 0; i < count; i++)
+        {
+            auto path = file;
+            path += std::format(".{}", i);
+            files.emplace_back(std::move(path));
+        }
+        return files;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t ShardedLibrary::getShardCount() const noexcept { return shards.size(); }
+
+    Library& ShardedLibrary::getShard(const size_t index)
+    {
+        if (index >= shards.size())
+            throw std::runtime_error(std::format("Shard index {} is out of range [0, {}).", index, shards.size()));
+        return *shards[index];
+    }
+
+    const Library& ShardedLibrary::getShard(const size_t index) const
+    {
+        if (index >= shards.size())
+            throw std::runtime_error(std::format("Shard index {} is out of range [0, {}).", index, shards.size()));
+        return *shards[index];
+    }
+
+    Library& ShardedLibrary::getShard(const InstanceId& id) { return *shards[getShardIndex(id)]; }
+
+    size_t ShardedLibrary::getShardIndex(const InstanceId& id) const
+    {
+        if (!id.valid()) throw std::runtime_error("Cannot route instance to a shard. It does not have a valid UUID.");
+
+        // FNV-1a, so that the routing does not depend on the standard library implementation.
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto byte : id.get().as_bytes())
+        {
+            hash ^= static_cast<uint64_t>(byte);
+            hash *= 1099511628211ull;
+        }
+        return static_cast<size_t>(hash % shards.size());
+    }
+
+    InstanceId ShardedLibrary::generateId(const size_t index) const
+    {
+        if (index >= shards.size())
+            throw std::runtime_error(std::format("Shard index {} is out of range [0, {}).", index, shards.size()));
+
+        InstanceId id;
+        id.regenerate();
+        while (getShardIndex(id) != index) id.regenerate();
+        return id;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Specification.
+    ////////////////////////////////////////////////////////////////
+
+    void ShardedLibrary::verifySpecification() const
+    {
+        const auto expected = readSpecification(*shards.front());
+        for (size_t i = 1; i < shards.size(); i++)
+        {
+            if (readSpecification(*shards[i]) != expected)
+                throw std::runtime_error(std::format("Shard {} does not have the same specification as shard 0.", i));
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Execution.
+    ////////////////////////////////////////////////////////////////
+
+    void ShardedLibrary::parallel(const std::function<void(size_t)>& f) const
+    {
+        if (shards.size() == 1)
+        {
+            f(0);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(shards.size());
+        std::vector<std::thread>         threads;
+        threads.reserve(shards.size());
+        for (size_t i = 0; i < shards.size(); i++)
+        {
+            threads.emplace_back([&f, &errors, i] {
+                try
+                {
+                    f(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        for (const auto& error : errors)
+            if (error) std::rethrow_exception(error);
+    }
+}  // namespace alex
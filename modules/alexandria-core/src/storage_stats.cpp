@@ -0,0 +1,230 @@
+#include "alexandria-core/storage_stats.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+
+namespace
+{
+    [[nodiscard]] uint64_t readPragma(sql::Database& db, const std::string& name)
+    {
+        alex::RawStatement stmt(db, std::format("PRAGMA {};", name), false);
+        return stmt.step() ? static_cast<uint64_t>(stmt.getInt64(0)) : 0;
+    }
+
+    /**
+     * \brief Table or index of the sqlite schema.
+     */
+    struct SchemaEntry
+    {
+        /**
+         * \brief Name of the table, or of the table of the index.
+         */
+        std::string table;
+
+        bool index = false;
+    };
+}  // namespace
+
+namespace alex
+{
+    ////////////////////////////////////////////////////////////////
+    // BtreeStats.
+    ////////////////////////////////////////////////////////////////
+
+    double BtreeStats::getFragmentation() const noexcept
+    {
+        return leafPages == 0 ? 0.0 : static_cast<double>(fragmentedPages) / static_cast<double>(leafPages);
+    }
+
+    void BtreeStats::merge(const BtreeStats& other) noexcept
+    {
+        rows += other.rows;
+        pages += other.pages;
+        leafPages += other.leafPages;
+        overflowPages += other.overflowPages;
+        payload += other.payload;
+        unused += other.unused;
+        size += other.size;
+        fragmentedPages += other.fragmentedPages;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // StorageStats.
+    ////////////////////////////////////////////////////////////////
+
+    StorageStats StorageStats::read(sql::Database& db)
+    {
+        StorageStats stats;
+        stats.pageSize  = readPragma(db, "page_size");
+        stats.pageCount = readPragma(db, "page_count");
+        stats.freePages = readPragma(db, "freelist_count");
+
+        // Get the generated tables of all types. Tables are addressed by index, since the vectors still grow.
+        std::unordered_map<std::string, std::pair<size_t, size_t>> generated;
+        std::vector<std::string>                                    virtualTables;
+        {
+            RawStatement stmt(db,
+                              "SELECT n.name, t.name, g.name, g.kind FROM tables g JOIN types t ON g.type = t.id JOIN "
+                              "namespaces n ON t.namespace = n.id ORDER BY n.name, t.name, g.id;",
+                              false);
+            while (stmt.step())
+            {
+                const auto nameSpace = stmt.getText(0);
+                const auto typeName  = stmt.getText(1);
+                if (stats.types.empty() || stats.types.back().nameSpace != nameSpace ||
+                    stats.types.back().name != typeName)
+                    stats.types.emplace_back(
+                      TypeStats{.nameSpace = std::string(nameSpace), .name = std::string(typeName)});
+
+                auto&      type = stats.types.back();
+                const auto kind = std::string(stmt.getText(3));
+                auto&      table =
+                  type.tables.emplace_back(TableStats{.name = std::string(stmt.getText(2)), .kind = kind});
+                generated.emplace(table.name, std::make_pair(stats.types.size() - 1, type.tables.size() - 1));
+                if (kind == "spatial" || kind == "fulltext") virtualTables.emplace_back(table.name);
+            }
+        }
+
+        // Sum the size of the values in each column of instance and array tables in a single scan per table.
+        for (auto& type : stats.types)
+        {
+            for (auto& table : type.tables)
+            {
+                if (table.kind == "spatial" || table.kind == "fulltext") continue;
+
+                const auto   quotedTable = quoteIdentifier(table.name);
+                RawStatement info(db, std::format("PRAGMA table_info({});", quotedTable), false);
+                while (info.step()) table.columns.emplace_back(ColumnStats{.name = std::string(info.getText(1))});
+                if (table.columns.empty()) continue;
+
+                std::string sql = "SELECT ";
+                for (size_t i = 0; i < table.columns.size(); i++)
+                    sql += std::format("{0}sum(CASE typeof({1}) WHEN 'null' THEN 0 WHEN 'integer' THEN 8 WHEN 'real' "
+                                       "THEN 8 ELSE length(CAST({1} AS BLOB)) END)",
+                                       i == 0 ? "" : ", ",
+                                       quoteIdentifier(table.columns[i].name));
+                sql += std::format(" FROM {};", quotedTable);
+
+                RawStatement sums(db, sql, false);
+                if (!sums.step()) continue;
+                for (size_t i = 0; i < table.columns.size(); i++)
+                {
+                    const auto index = static_cast<int32_t>(i);
+                    if (!sums.isNull(index)) table.columns[i].bytes = static_cast<uint64_t>(sums.getInt64(index));
+                }
+            }
+        }
+
+        // Get the table of every index, and the virtual table of every shadow table.
+        std::unordered_map<std::string, SchemaEntry> schema;
+        {
+            RawStatement stmt(
+              db, "SELECT type, name, tbl_name FROM sqlite_master WHERE type IN ('table', 'index');", false);
+            while (stmt.step())
+            {
+                auto entry = SchemaEntry{.table = std::string(stmt.getText(2)), .index = stmt.getText(0) == "index"};
+                for (const auto& vtab : virtualTables)
+                    if (entry.table.starts_with(vtab + "_")) entry.table = vtab;
+                schema.emplace(std::string(stmt.getText(1)), std::move(entry));
+            }
+        }
+
+        std::unordered_map<std::string, size_t> otherTables;
+        const auto getTable = [&](const std::string& name) -> TableStats& {
+            if (const auto it = generated.find(name); it != generated.end())
+                return stats.types[it->second.first].tables[it->second.second];
+            const auto [it, inserted] = otherTables.try_emplace(name, stats.other.size());
+            if (inserted) stats.other.emplace_back(TableStats{.name = name});
+            return stats.other[it->second];
+        };
+
+        // Visit all pages. Pages of a b-tree are returned consecutively, in the order of their path from the root.
+        std::optional<RawStatement> pages;
+        try
+        {
+            pages.emplace(db, "SELECT name, pagetype, pageno, ncell, payload, unused, pgsize FROM dbstat;", false);
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw std::runtime_error(
+              std::format("Cannot read storage statistics. Sqlite was not compiled with the dbstat virtual table: {}",
+                          e.what()));
+        }
+
+        std::string current;
+        BtreeStats  btree;
+        bool        index    = false;
+        int64_t     lastLeaf = -1;
+        const auto  flush    = [&] {
+            if (current.empty()) return;
+            const auto it    = schema.find(current);
+            auto&      table = getTable(it == schema.end() ? current : it->second.table);
+            (index ? table.indices : table.table).merge(btree);
+        };
+
+        while (pages->step())
+        {
+            if (const auto name = pages->getText(0); name != current)
+            {
+                flush();
+                current       = std::string(name);
+                btree         = {};
+                const auto it = schema.find(current);
+                index         = it != schema.end() && it->second.index;
+                lastLeaf      = -1;
+            }
+
+            const auto type   = pages->getText(1);
+            const auto pageNo = pages->getInt64(2);
+            const auto cells  = static_cast<uint64_t>(pages->getInt64(3));
+            btree.pages++;
+            btree.payload += static_cast<uint64_t>(pages->getInt64(4));
+            btree.unused += static_cast<uint64_t>(pages->getInt64(5));
+            btree.size += static_cast<uint64_t>(pages->getInt64(6));
+
+            if (type == "leaf")
+            {
+                btree.rows += cells;
+                btree.leafPages++;
+                if (lastLeaf >= 0 && pageNo != lastLeaf + 1) btree.fragmentedPages++;
+                lastLeaf = pageNo;
+            }
+            else if (type == "overflow")
+                btree.overflowPages++;
+            else if (index)
+            {
+                // Internal pages of indices hold entries as well. Those of tables only hold rowids.
+                btree.rows += cells;
+            }
+        }
+        flush();
+
+        for (auto& type : stats.types)
+        {
+            for (const auto& table : type.tables)
+            {
+                type.table.merge(table.table);
+                type.indices.merge(table.indices);
+            }
+        }
+        std::ranges::sort(stats.other, {}, &TableStats::name);
+
+        stats.shared = BlobStore::getStats(db);
+
+        return stats;
+    }
+}  // namespace alex
@@ -7,10 +7,36 @@
 #include "cppql/include_all.h"
 
 ////////////////////////////////////////////////////////////////
-// Standard includes.
+// Current target includes.
 ////////////////////////////////////////////////////////////////
 
 #include "alexandria-core/library.h"
+#include "alexandria-core/property_layout.h"
+
+namespace
+{
+    /**
+     * \brief Find the property that is stored in a column, recursing into nested types.
+     */
+    const alex::PropertyLayout*
+      findProperty(const alex::TypeLayout& layout, const std::string& prefix, const std::string& column)
+    {
+        for (const auto& prop : layout.getProperties())
+        {
+            if (prop->getDataType() == alex::DataType::Nested)
+            {
+                if (const auto* ref = prop->getReferenceType(); ref)
+                    if (const auto* nested = findProperty(ref->getLayout(), prefix + "_" + prop->getName(), column);
+                        nested)
+                        return nested;
+            }
+            else if (prefix + prop->getName() == column)
+                return prop.get();
+        }
+
+        return nullptr;
+    }
+}  // namespace
 
 namespace alex
 {
@@ -37,4 +63,28 @@ namespace alex
     const std::vector<sql::Table*>& Type::getBlobArrayTables() const { return tables.blobArrays; }
 
     const std::vector<sql::Table*>& Type::getReferenceArrayTables() const { return tables.referenceArrays; }
+
+    Codec Type::getCodec(const std::string& column) const
+    {
+        const auto* prop = findProperty(*typeLayout, "", column);
+        return prop ? prop->getCodec() : Codec::None;
+    }
+
+    bool Type::isDeduplicated(const std::string& column) const
+    {
+        const auto* prop = findProperty(*typeLayout, "", column);
+        return prop && prop->isDeduplicated();
+    }
+
+    int64_t Type::getExternalThreshold(const std::string& column) const
+    {
+        const auto* prop = findProperty(*typeLayout, "", column);
+        return prop ? prop->getExternalThreshold() : 0;
+    }
+
+    bool Type::isPacked(const std::string& column) const
+    {
+        const auto* prop = findProperty(*typeLayout, "", column);
+        return prop && prop->isPacked();
+    }
 }  // namespace alex
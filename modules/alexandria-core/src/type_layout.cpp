@@ -19,6 +19,7 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/change_log.h"
 #include "alexandria-core/library.h"
 #include "alexandria-core/namespace.h"
 
@@ -188,6 +189,11 @@ namespace alex
 
                 // Commit instance table.
                 instanceTable->commit();
+
+                // Generate indices over the committed tables.
+                for (const auto& prop : properties) prop->generateIndices(library, typeId, *instanceTable, "");
+
+                if (library.isChangeLogEnabled()) ChangeLog::createTriggers(db, typeId, instanceTable->getName());
             }
 
             auto& type                  = nameSpace.createType(name);
@@ -0,0 +1,577 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/packed_array.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_expression.h"
+
+namespace alex
+{
+    namespace detail
+    {
+        enum class AggregateFunction
+        {
+            Count   = 0,
+            Minimum = 1,
+            Maximum = 2,
+            Sum     = 3,
+            Average = 4,
+            Group   = 5
+        };
+
+        /**
+         * \brief Get the column type of a primitive or primitive array member.
+         * \tparam T TypeDescriptor.
+         * \tparam M MemberName.
+         * \return std::type_identity of the column type, or of void if the member does not exist.
+         */
+        template<typename T, MemberName M>
+        [[nodiscard]] consteval auto getAggregateValueType()
+        {
+            using primitive_t = extract_primitive_members_t<typename T::members_t>;
+            using array_t     = extract_primitive_array_members_t<typename T::members_t>;
+            if constexpr (getColumnIndex<M, primitive_t>() != -1)
+                return std::type_identity<
+                  member_to_column_t<std::tuple_element_t<getColumnIndex<M, primitive_t>(), primitive_t>>>{};
+            else if constexpr (getColumnIndex<M, array_t>() != -1)
+                return std::type_identity<
+                  member_to_column_t<std::tuple_element_t<getColumnIndex<M, array_t>(), array_t>>>{};
+            else
+                return std::type_identity<void>{};
+        }
+
+        template<typename T, MemberName M>
+        using aggregate_value_t = typename decltype(getAggregateValueType<T, M>())::type;
+
+        /**
+         * \brief Members that can be counted, compared and grouped on: numbers and strings.
+         */
+        template<MemberName Name, typename T>
+        concept is_aggregate_member_name =
+          std::is_arithmetic_v<aggregate_value_t<T, Name>> || std::same_as<aggregate_value_t<T, Name>, std::string>;
+
+        /**
+         * \brief Members that can be summed and averaged: numbers.
+         */
+        template<MemberName Name, typename T>
+        concept is_numeric_aggregate_member_name = std::is_arithmetic_v<aggregate_value_t<T, Name>>;
+
+        /**
+         * \brief Members that can be grouped on: numbers and strings stored in the instance table.
+         */
+        template<MemberName Name, typename T>
+        concept is_group_member_name = is_aggregate_member_name<Name, T> &&
+                                       getColumnIndex<Name, extract_primitive_members_t<typename T::members_t>>() != -1;
+
+        template<typename V>
+        struct IsOptional : std::false_type
+        {
+        };
+
+        template<typename V>
+        struct IsOptional<std::optional<V>> : std::true_type
+        {
+        };
+
+        /**
+         * \brief Read a column of the current row of a statement.
+         * \tparam V Value type.
+         * \param stmt Statement.
+         * \param index Column index.
+         * \return Value.
+         */
+        template<typename V>
+        [[nodiscard]] V readAggregateColumn(const RawStatement& stmt, const int32_t index)
+        {
+            if constexpr (IsOptional<V>::value)
+            {
+                if (stmt.isNull(index)) return std::nullopt;
+                return readAggregateColumn<typename V::value_type>(stmt, index);
+            }
+            else if constexpr (std::same_as<V, std::string>)
+                return std::string(stmt.getText(index));
+            else if constexpr (std::floating_point<V>)
+                return static_cast<V>(stmt.getDouble(index));
+            else
+                return static_cast<V>(stmt.getInt64(index));
+        }
+
+        /**
+         * \brief Number of instances.
+         * \tparam T TypeDescriptor.
+         */
+        template<typename T>
+        struct AggregateCount
+        {
+            using descriptor_t            = T;
+            using result_t                = int64_t;
+            static constexpr bool grouped = false;
+
+            [[nodiscard]] static std::string toSql(SearchContext&) { return "COUNT(*)"; }
+        };
+
+        /**
+         * \brief Aggregate over a member. Members stored in the instance table are aggregated directly. For array
+         * members, the values of each instance are aggregated in a correlated subquery first, so that arrays never
+         * multiply the rows seen by other aggregates in the same query.
+         * \tparam T TypeDescriptor.
+         * \tparam M MemberName.
+         * \tparam F Aggregate function.
+         */
+        template<typename T, MemberName M, AggregateFunction F>
+        struct AggregateMember
+        {
+            using descriptor_t = T;
+            using value_t      = aggregate_value_t<T, M>;
+            using result_t     = std::conditional_t<
+              F == AggregateFunction::Count,
+              int64_t,
+              std::conditional_t<F == AggregateFunction::Sum,
+                                 std::conditional_t<std::floating_point<value_t>, double, int64_t>,
+                                 std::conditional_t<F == AggregateFunction::Average,
+                                                    std::optional<double>,
+                                                    std::conditional_t<F == AggregateFunction::Group,
+                                                                       value_t,
+                                                                       std::optional<value_t>>>>>;
+            static constexpr bool grouped = F == AggregateFunction::Group;
+            static constexpr auto name() { return M; }
+
+            /**
+             * \brief Whether the member is stored in an array table.
+             */
+            static constexpr bool array =
+              getColumnIndex<M, extract_primitive_members_t<typename T::members_t>>() == -1;
+
+            /**
+             * \brief Generate the aggregate expression.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSql(SearchContext& ctx)
+            {
+                if constexpr (!array)
+                {
+                    // Add 1 to account for integer primary key column.
+                    using members_t  = extract_primitive_members_t<typename T::members_t>;
+                    const auto value = ctx.getInstanceColumn(getColumnIndex<M, members_t>() + 1);
+
+                    if constexpr (F == AggregateFunction::Count)
+                        return std::format("COUNT({})", value);
+                    else if constexpr (F == AggregateFunction::Minimum)
+                        return std::format("MIN({})", value);
+                    else if constexpr (F == AggregateFunction::Maximum)
+                        return std::format("MAX({})", value);
+                    else if constexpr (F == AggregateFunction::Sum)
+                        return toSumSql(value);
+                    else if constexpr (F == AggregateFunction::Average)
+                        return std::format("AVG({})", value);
+                    else
+                        return value;
+                }
+                else
+                {
+                    using members_t      = extract_primitive_array_members_t<typename T::members_t>;
+                    constexpr auto index = getColumnIndex<M, members_t>();
+                    if (isPackedArray(ctx.getType(), index))
+                        throw std::runtime_error(
+                          std::format(R"(Member "{}" of type "{}" is packed and cannot be aggregated.)",
+                                      M.name,
+                                      ctx.getType().getName()));
+
+                    const auto& arrayTable = *ctx.getType().getPrimitiveArrayTables()[index];
+                    const auto  perInstance =
+                      [&, table = quoteIdentifier(arrayTable.getName())](const std::string& function) {
+                          const auto alias = ctx.createAlias();
+                          return std::format("(SELECT {2}({0}.value) FROM {1} AS {0} WHERE {0}.instance = {3})",
+                                             alias,
+                                             table,
+                                             function,
+                                             ctx.getInstanceColumn(1));
+                      };
+
+                    if constexpr (F == AggregateFunction::Count)
+                        return std::format("COALESCE(SUM({}), 0)", perInstance("COUNT"));
+                    else if constexpr (F == AggregateFunction::Minimum)
+                        return std::format("MIN({})", perInstance("MIN"));
+                    else if constexpr (F == AggregateFunction::Maximum)
+                        return std::format("MAX({})", perInstance("MAX"));
+                    else if constexpr (F == AggregateFunction::Sum)
+                        return toSumSql(perInstance(std::floating_point<value_t> ? "TOTAL" : "SUM"));
+                    else
+                    {
+                        const auto total = perInstance("TOTAL");
+                        const auto count = perInstance("COUNT");
+                        return std::format("(SUM({}) / NULLIF(SUM({}), 0))", total, count);
+                    }
+                }
+            }
+
+        private:
+            /**
+             * \brief Sum values. SUM returns null for empty sets and TOTAL always returns a floating point value, so
+             * integers are summed with SUM and coalesced, floating point values with TOTAL.
+             * \param value Expression to sum.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSumSql(const std::string& value)
+            {
+                if constexpr (std::floating_point<value_t>)
+                    return std::format("TOTAL({})", value);
+                else
+                    return std::format("COALESCE(SUM({}), 0)", value);
+            }
+        };
+
+        template<typename A>
+        concept is_aggregate = requires(SearchContext& ctx) {
+            typename A::descriptor_t;
+            typename A::result_t;
+            {
+                A::grouped
+            } -> std::convertible_to<bool>;
+            {
+                A::toSql(ctx)
+            } -> std::convertible_to<std::string>;
+        };
+    }  // namespace detail
+
+    /**
+     * \brief AggregateQuery. Computes a list of aggregates over all instances of a type that match an optional search
+     * expression, in a single statement. If any of the aggregates is a groupBy, one row is returned per group, ordered
+     * by the group values. Otherwise, exactly one row is returned.
+     * \tparam T TypeDescriptor.
+     * \tparam A Tuple of aggregates.
+     * \tparam L Tuple of leaf operators of the search expression.
+     */
+    template<typename T, typename A, typename L>
+    class AggregateQuery
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using type_descriptor_t = T;
+        using aggregates_t      = A;
+        using leaves_t          = L;
+        using row_t             = decltype([]<typename... As>(std::tuple<As...>*) {
+            return std::tuple<typename As::result_t...>{};
+        }(static_cast<A*>(nullptr)));
+        using parameters_t      = decltype([]<typename... Ls>(std::tuple<Ls...>*) {
+            return std::tuple<std::unique_ptr<typename Ls::param_t>...>{};
+        }(static_cast<L*>(nullptr)));
+        static constexpr bool grouped = []<typename... As>(std::tuple<As...>*) {
+            return (As::grouped || ...);
+        }(static_cast<A*>(nullptr));
+        using result_t = std::conditional_t<grouped, std::vector<row_t>, row_t>;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        AggregateQuery() = delete;
+
+        AggregateQuery(type_descriptor_t desc, sql::Database& db, const std::string& sql) :
+            descriptor(desc),
+            statement(db, sql),
+            parameters([]<typename... Ls>(std::tuple<Ls...>*) {
+                return std::make_tuple(std::make_unique<typename Ls::param_t>()...);
+            }(static_cast<L*>(nullptr))),
+            binders(detail::createBinders<L>(parameters))
+        {
+        }
+
+        AggregateQuery(const AggregateQuery&) = delete;
+
+        AggregateQuery(AggregateQuery&&) noexcept = default;
+
+        ~AggregateQuery() noexcept = default;
+
+        AggregateQuery& operator=(const AggregateQuery&) = delete;
+
+        AggregateQuery& operator=(AggregateQuery&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] const std::string& getSql() const noexcept { return statement.getSql(); }
+
+        ////////////////////////////////////////////////////////////////
+        // ...
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Run the query.
+         * \tparam Ts Parameter types.
+         * \param params Values of the parameters of the search expression, in order.
+         * \return Single row, or list of rows if grouped.
+         */
+        template<typename... Ts>
+            requires(sizeof...(Ts) == std::tuple_size_v<L>)
+        [[nodiscard]] result_t operator()(Ts&&... params)
+        {
+            // InstanceId needs to be explicitly turned into a string.
+            // Other parameters can be forwarded as-is.
+            constexpr auto get = []<typename P>(P&& param) {
+                if constexpr (std::same_as<InstanceId, std::decay_t<P>>)
+                    return param.getAsString();
+                else
+                    return std::forward<P>(param);
+            };
+
+            [&]<size_t... Is>(std::index_sequence<Is...>, auto&&... values)
+            {
+                ((*std::get<Is>(parameters) =
+                    static_cast<typename std::tuple_element_t<Is, parameters_t>::element_type>(values)),
+                 ...);
+            }
+            (std::index_sequence_for<Ts...>{}, get(std::forward<Ts>(params))...);
+
+            // Reset the statement after reading the result, so that the connection does not keep a read transaction
+            // open.
+            ScopedReset reset{statement};
+            for (const auto& binder : binders) binder(statement);
+
+            if constexpr (grouped)
+            {
+                result_t rows;
+                while (statement.step()) rows.emplace_back(readRow());
+                return rows;
+            }
+            else
+            {
+                statement.step();
+                return readRow();
+            }
+        }
+
+    private:
+        [[nodiscard]] row_t readRow() const
+        {
+            return [&]<size_t... Is>(std::index_sequence<Is...>) {
+                return row_t(detail::readAggregateColumn<std::tuple_element_t<Is, row_t>>(statement,
+                                                                                         static_cast<int32_t>(Is))...);
+            }(std::make_index_sequence<std::tuple_size_v<row_t>>{});
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        type_descriptor_t                              descriptor;
+        RawStatement                                   statement;
+        parameters_t                                   parameters;
+        std::vector<detail::SearchStatement::binder_t> binders;
+    };
+
+    namespace detail
+    {
+        /**
+         * \brief Compile an AggregateQuery.
+         * \tparam E Search expression, or void for no filter.
+         * \tparam D TypeDescriptor.
+         * \tparam As Aggregates.
+         * \param desc TypeDescriptor instance.
+         * \return AggregateQuery.
+         */
+        template<typename E, is_type_descriptor D, is_aggregate... As>
+        [[nodiscard]] auto compileAggregate(D desc)
+        {
+            static_assert(sizeof...(As) > 0, "At least one aggregate is required.");
+            static_assert((std::same_as<typename As::descriptor_t, D> && ...), "Aggregate is for a different type.");
+
+            SearchContext ctx(desc.getType());
+
+            std::string columns, groups;
+            (
+              [&] {
+                  const auto sql = As::toSql(ctx);
+                  columns += (columns.empty() ? "" : ", ") + sql;
+                  if constexpr (As::grouped) groups += (groups.empty() ? "" : ", ") + sql;
+              }(),
+              ...);
+
+            std::string where = "1";
+            if constexpr (!std::same_as<E, void>) where = E::toSql(ctx);
+
+            auto sql = std::format("SELECT {} FROM {} AS i WHERE {}", columns, ctx.getInstanceTable(), where);
+            if (!groups.empty()) sql += std::format(" GROUP BY {0} ORDER BY {0}", groups);
+            sql += ";";
+
+            using leaves_t = std::conditional_t<std::same_as<E, void>, std::tuple<>, typename E::leaves_t>;
+            return AggregateQuery<D, std::tuple<As...>, leaves_t>(desc, ctx.getDatabase(), sql);
+        }
+    }  // namespace detail
+
+    /**
+     * \brief Count instances.
+     * \tparam T TypeDescriptor.
+     * \return Aggregate with result type int64_t.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto count()
+    {
+        return detail::AggregateCount<T>{};
+    }
+
+    /**
+     * \brief Count the non-null values of a member. For array members, counts all array elements.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return Aggregate with result type int64_t.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_aggregate_member_name<M, T>)
+    [[nodiscard]] auto count()
+    {
+        return detail::AggregateMember<T, M, detail::AggregateFunction::Count>{};
+    }
+
+    /**
+     * \brief Smallest value of a member. The name avoids clashing with min/max macros.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return Aggregate with result type std::optional of the member type. Empty if there are no values.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_aggregate_member_name<M, T>)
+    [[nodiscard]] auto minimum()
+    {
+        return detail::AggregateMember<T, M, detail::AggregateFunction::Minimum>{};
+    }
+
+    /**
+     * \brief Largest value of a member.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return Aggregate with result type std::optional of the member type. Empty if there are no values.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_aggregate_member_name<M, T>)
+    [[nodiscard]] auto maximum()
+    {
+        return detail::AggregateMember<T, M, detail::AggregateFunction::Maximum>{};
+    }
+
+    /**
+     * \brief Sum of the values of a numeric member.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return Aggregate with result type int64_t for integers and double for floating point members. 0 if there are no
+     * values.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_numeric_aggregate_member_name<M, T>)
+    [[nodiscard]] auto sum()
+    {
+        return detail::AggregateMember<T, M, detail::AggregateFunction::Sum>{};
+    }
+
+    /**
+     * \brief Mean of the values of a numeric member. For array members, this is the mean over all elements.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return Aggregate with result type std::optional<double>. Empty if there are no values.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_numeric_aggregate_member_name<M, T>)
+    [[nodiscard]] auto average()
+    {
+        return detail::AggregateMember<T, M, detail::AggregateFunction::Average>{};
+    }
+
+    /**
+     * \brief Group on the value of a member. The value of the group is returned in the position of this aggregate.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return Aggregate with result type of the member.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_group_member_name<M, T>)
+    [[nodiscard]] auto groupBy()
+    {
+        return detail::AggregateMember<T, M, detail::AggregateFunction::Group>{};
+    }
+
+    /**
+     * \brief Construct an AggregateQuery over all instances.
+     *
+     * \code
+     * auto query = alex::aggregate(desc, alex::groupBy<D, "name">(), alex::count<D>(), alex::maximum<D, "radius">());
+     * for (const auto& [name, count, radius] : query()) ...
+     * \endcode
+     *
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param aggregates Aggregates.
+     * \return AggregateQuery.
+     */
+    template<is_type_descriptor T, detail::is_aggregate... As>
+    [[nodiscard]] auto aggregate(T desc, As...)
+    {
+        return detail::compileAggregate<void, T, As...>(desc);
+    }
+
+    /**
+     * \brief Construct an AggregateQuery over all instances for which a search expression is true. The parameters of
+     * the search expression are passed when running the query.
+     *
+     * \code
+     * auto query = alex::aggregate(desc, alex::greater<D, "radius">(), alex::count<D>());
+     * const auto [count] = query(10.0f);
+     * \endcode
+     *
+     * \tparam T TypeDescriptor type.
+     * \tparam E Search expression type.
+     * \param desc TypeDescriptor instance.
+     * \param filter Search expression.
+     * \param aggregates Aggregates.
+     * \return AggregateQuery.
+     */
+    template<is_type_descriptor T, typename E, detail::is_aggregate... As>
+        requires(detail::is_search_expression_for<E, T>)
+    [[nodiscard]] auto aggregate(T desc, E, As...)
+    {
+        return detail::compileAggregate<E, T, As...>(desc);
+    }
+
+    /**
+     * \brief Construct an AggregateQuery, optionally filtered by a search expression.
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param args Optional search expression, followed by aggregates.
+     * \return AggregateQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto aggregate(T& tables, auto... args)
+    {
+        return aggregate(tables.getTypeDescriptor(), args...);
+    }
+}  // namespace alex
@@ -0,0 +1,180 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/properties/instance_id.h"
+
+namespace alex::detail
+{
+    /**
+     * \brief Results of a SearchQuery, keyed by the values of its parameters and its paging state. An entry is valid
+     * as long as none of the tables of the searched type were modified since it was stored (see
+     * Library::getTableVersion). Results found while a transaction is open are not stored, since the transaction can
+     * still be rolled back.
+     * \tparam K Key type.
+     */
+    template<typename K>
+    class SearchCache
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        SearchCache() = delete;
+
+        /**
+         * \brief Construct a cache for searches over a type.
+         * \param lib Library.
+         * \param type Searched type. Its instance table and array tables are tracked.
+         * \param cap Maximum number of entries.
+         */
+        SearchCache(Library& lib, const Type& type, const size_t cap) :
+            library(&lib), capacity(std::max<size_t>(cap, 1))
+        {
+            tables.emplace_back(&lib.getTableVersion(type.getInstanceTable().getName()));
+            for (const auto* table : type.getPrimitiveArrayTables())
+                tables.emplace_back(&lib.getTableVersion(table->getName()));
+            for (const auto* table : type.getBlobArrayTables())
+                tables.emplace_back(&lib.getTableVersion(table->getName()));
+            for (const auto* table : type.getReferenceArrayTables())
+                tables.emplace_back(&lib.getTableVersion(table->getName()));
+        }
+
+        SearchCache(const SearchCache&) = delete;
+
+        SearchCache(SearchCache&&) noexcept = default;
+
+        ~SearchCache() noexcept = default;
+
+        SearchCache& operator=(const SearchCache&) = delete;
+
+        SearchCache& operator=(SearchCache&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t getCapacity() const noexcept { return capacity; }
+
+        /**
+         * \brief Get the number of stored entries, including entries that were invalidated but not evicted yet.
+         * \return Number of entries.
+         */
+        [[nodiscard]] size_t size() const noexcept { return entries.size(); }
+
+        [[nodiscard]] uint64_t getHits() const noexcept { return hits; }
+
+        [[nodiscard]] uint64_t getMisses() const noexcept { return misses; }
+
+        ////////////////////////////////////////////////////////////////
+        // Lookup.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Find the results for a key. Checks for modifications by other connections first.
+         * \param key Key.
+         * \return Results, or nullptr if there is no valid entry.
+         */
+        [[nodiscard]] const std::vector<InstanceId>* find(const K& key)
+        {
+            version = library->checkModifications();
+
+            const auto it = entries.find(key);
+            if (it == entries.end() || !isValid(it->second))
+            {
+                misses++;
+                return nullptr;
+            }
+
+            hits++;
+            it->second.lastUse = ++uses;
+            return &it->second.ids;
+        }
+
+        /**
+         * \brief Store the results for a key that were found after the last call to find. When the cache is full,
+         * invalid entries are evicted, or the least recently used entry if all are valid.
+         * \param key Key.
+         * \param ids Results.
+         * \return Stored results.
+         */
+        const std::vector<InstanceId>& insert(K key, std::vector<InstanceId> ids)
+        {
+            if (library->isInTransaction())
+            {
+                uncached = std::move(ids);
+                return uncached;
+            }
+
+            if (!entries.contains(key) && entries.size() >= capacity)
+            {
+                std::erase_if(entries, [this](const auto& entry) { return !isValid(entry.second); });
+                if (entries.size() >= capacity)
+                    entries.erase(
+                      std::ranges::min_element(entries, {}, [](const auto& entry) { return entry.second.lastUse; }));
+            }
+
+            const auto it = entries.insert_or_assign(std::move(key), Entry{std::move(ids), version, ++uses}).first;
+            return it->second.ids;
+        }
+
+        /**
+         * \brief Remove all entries, e.g. after the statement was changed.
+         */
+        void clear() noexcept { entries.clear(); }
+
+    private:
+        struct Entry
+        {
+            /**
+             * \brief Results.
+             */
+            std::vector<InstanceId> ids;
+
+            /**
+             * \brief Version of the library when the results were found.
+             */
+            uint64_t version = 0;
+
+            /**
+             * \brief Value of the use counter on the last lookup.
+             */
+            uint64_t lastUse = 0;
+        };
+
+        [[nodiscard]] bool isValid(const Entry& entry) const noexcept
+        {
+            return std::ranges::all_of(tables, [&entry](const uint64_t* table) { return *table <= entry.version; });
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        Library*                     library = nullptr;
+        std::vector<const uint64_t*> tables;
+        size_t                       capacity = 0;
+        uint64_t                     version  = 0;
+        uint64_t                     uses     = 0;
+        uint64_t                     hits     = 0;
+        uint64_t                     misses   = 0;
+        std::map<K, Entry>           entries;
+        std::vector<InstanceId>      uncached;
+    };
+}  // namespace alex::detail
@@ -0,0 +1,308 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/type_descriptor.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_query.h"
+#include "alexandria-extended-query/search_statement.h"
+
+namespace alex::detail
+{
+    /**
+     * \brief State used while generating the SQL of a search expression. Resolves table and column names and hands
+     * out unique table aliases and parameter names.
+     */
+    class SearchContext
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        SearchContext() = delete;
+
+        explicit SearchContext(Type& t) : type(&t)
+        {
+            // Look up the names of all columns of the instance table, in order.
+            RawStatement stmt(getDatabase(), "SELECT name FROM pragma_table_info(?1) ORDER BY cid;", false);
+            stmt.bind(1, type->getInstanceTable().getName());
+            while (stmt.step()) columns.emplace_back(stmt.getText(0));
+        }
+
+        SearchContext(const SearchContext&) = delete;
+
+        SearchContext(SearchContext&&) noexcept = default;
+
+        ~SearchContext() noexcept = default;
+
+        SearchContext& operator=(const SearchContext&) = delete;
+
+        SearchContext& operator=(SearchContext&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] Type& getType() const noexcept { return *type; }
+
+        [[nodiscard]] sql::Database& getDatabase() const { return type->getNamespace().getLibrary().getDatabase(); }
+
+        /**
+         * \brief Get the quoted name of the instance table.
+         * \return Table name.
+         */
+        [[nodiscard]] std::string getInstanceTable() const
+        {
+            return quoteIdentifier(type->getInstanceTable().getName());
+        }
+
+        /**
+         * \brief Get the qualified name of a column of the instance table.
+         * \param index Column index. 0 is the rowid, 1 the uuid, followed by all primitive members.
+         * \return Column name.
+         */
+        [[nodiscard]] std::string getInstanceColumn(const size_t index) const
+        {
+            return "i." + quoteIdentifier(columns.at(index));
+        }
+
+        /**
+         * \brief Get the unqualified names of all columns of the instance table.
+         * \return Column names.
+         */
+        [[nodiscard]] const std::vector<std::string>& getInstanceColumnNames() const noexcept { return columns; }
+
+        /**
+         * \brief Check whether a table exists in the database.
+         * \param name Unquoted table name.
+         * \return True if the table exists.
+         */
+        [[nodiscard]] bool hasTable(const std::string& name) const
+        {
+            RawStatement stmt(getDatabase(), "SELECT 1 FROM sqlite_master WHERE name = ?1;", false);
+            stmt.bind(1, name);
+            return stmt.step();
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Names.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create a new unique table alias.
+         * \return Alias.
+         */
+        [[nodiscard]] std::string createAlias() { return std::format("t{}", aliasCount++); }
+
+        /**
+         * \brief Create the name of the next parameter. Leaf operators must call this exactly once, in the order they
+         * appear in the expression.
+         * \return Parameter name.
+         */
+        [[nodiscard]] std::string createParameter() { return std::format(":p{}", parameterCount++); }
+
+        /**
+         * \brief Get the name of the most recently created parameter.
+         * \return Parameter name.
+         */
+        [[nodiscard]] std::string getLastParameter() const
+        {
+            if (parameterCount == 0) throw std::runtime_error("No parameters were created.");
+            return std::format(":p{}", parameterCount - 1);
+        }
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        Type*                    type = nullptr;
+        std::vector<std::string> columns;
+        size_t                   aliasCount     = 0;
+        size_t                   parameterCount = 0;
+    };
+
+    /**
+     * \brief A search expression is a type that can generate a boolean SQL expression over the instance table and
+     * lists its leaf operators, each of which takes one parameter. Leaf operators whose parameter is bound as several
+     * values (e.g. the coordinates of a box) derive their names from the parameter name and provide a static
+     * bind(RawStatement&, const std::string& name, const param_t&) method.
+     */
+    template<typename E>
+    concept is_search_expression = requires(SearchContext& ctx) {
+        typename E::leaves_t;
+        {
+            E::toSql(ctx)
+        } -> std::convertible_to<std::string>;
+    };
+
+    /**
+     * \brief Conjunction or disjunction of search expressions.
+     * \tparam And If true, conjunction. Otherwise disjunction.
+     * \tparam Es Search expressions.
+     */
+    template<bool And, is_search_expression... Es>
+    struct SearchJunction
+    {
+        using leaves_t = decltype(std::tuple_cat(std::declval<typename Es::leaves_t>()...));
+
+        [[nodiscard]] static std::string toSql(SearchContext& ctx)
+        {
+            std::string sql;
+            ((sql += (sql.empty() ? "" : And ? " AND " : " OR ") + Es::toSql(ctx)), ...);
+            return "(" + sql + ")";
+        }
+    };
+
+    /**
+     * \brief Negation of a search expression.
+     * \tparam E Search expression.
+     */
+    template<is_search_expression E>
+    struct SearchNegation
+    {
+        using leaves_t = typename E::leaves_t;
+
+        [[nodiscard]] static std::string toSql(SearchContext& ctx) { return "(NOT " + E::toSql(ctx) + ")"; }
+    };
+
+    /**
+     * \brief Combine two search expressions into a conjunction.
+     */
+    template<is_search_expression L, is_search_expression R>
+    [[nodiscard]] constexpr auto operator&&(L, R) noexcept
+    {
+        return SearchJunction<true, L, R>{};
+    }
+
+    /**
+     * \brief Combine two search expressions into a disjunction.
+     */
+    template<is_search_expression L, is_search_expression R>
+    [[nodiscard]] constexpr auto operator||(L, R) noexcept
+    {
+        return SearchJunction<false, L, R>{};
+    }
+
+    /**
+     * \brief Negate a search expression.
+     */
+    template<is_search_expression E>
+    [[nodiscard]] constexpr auto operator!(E) noexcept
+    {
+        return SearchNegation<E>{};
+    }
+
+    template<typename L, typename D>
+    struct IsSearchOverDescriptor : std::false_type
+    {
+    };
+
+    template<typename... Ls, typename D>
+    struct IsSearchOverDescriptor<std::tuple<Ls...>, D>
+        : std::bool_constant<(std::same_as<typename Ls::descriptor_t, D> && ...)>
+    {
+    };
+
+    /**
+     * \brief Search expression of which all leaf operators operate on the same type.
+     */
+    template<typename E, typename D>
+    concept is_search_expression_for =
+      is_search_expression<E> && IsSearchOverDescriptor<typename E::leaves_t, D>::value;
+
+    /**
+     * \brief Create the functions that bind the parameters of the leaf operators of a search expression.
+     * \tparam L Tuple of leaf operators, in the order in which they created their parameters.
+     * \tparam P Tuple of pointers to parameters.
+     * \param params Parameters. Must outlive the binders.
+     * \return List of binders.
+     */
+    template<typename L, typename P>
+    [[nodiscard]] std::vector<SearchStatement::binder_t> createBinders(const P& params)
+    {
+        std::vector<SearchStatement::binder_t> binders;
+        [&]<size_t... Is>(std::index_sequence<Is...>)
+        {
+            (binders.emplace_back(
+               [name = std::format(":p{}", Is), param = std::get<Is>(params).get()](RawStatement& stmt) {
+                   using leaf_t = std::tuple_element_t<Is, L>;
+                   if constexpr (requires { leaf_t::bind(stmt, name, *param); })
+                       leaf_t::bind(stmt, name, *param);
+                   else
+                       stmt.bind(name, *param);
+               }),
+             ...);
+        }
+        (std::make_index_sequence<std::tuple_size_v<L>>{});
+        return binders;
+    }
+
+    /**
+     * \brief Compile a SearchQuery from generated SQL.
+     * \tparam L Tuple of leaf operators, in the order in which they created their parameters.
+     * \tparam D TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \param ctx Context the SQL was generated with.
+     * \param parts Generated SQL.
+     * \return SearchQuery.
+     */
+    template<typename L, is_type_descriptor D>
+    [[nodiscard]] auto compileSearch(D desc, const SearchContext& ctx, SearchSql parts)
+    {
+        return [&]<typename... Ls>(std::tuple<Ls...>*) {
+            // Construct the list of parameters as pointers to allow dynamic binding.
+            auto params  = std::make_tuple(std::make_unique<typename Ls::param_t>()...);
+            auto binders = createBinders<L>(params);
+
+            auto paging    = std::make_unique<SearchPaging>();
+            paging->keyset = parts.keyset;
+            parts.columns  = ctx.getInstanceColumnNames();
+
+            auto stmt = SearchStatement(ctx.getDatabase(), std::move(parts), std::move(binders), *paging);
+            return SearchQuery(desc, std::move(stmt), std::move(params), std::move(paging));
+        }(static_cast<L*>(nullptr));
+    }
+
+    /**
+     * \brief Compile a SearchQuery that returns all instances for which a search expression is true, ordered by rowid.
+     * \tparam E Search expression.
+     * \tparam D TypeDescriptor.
+     * \param desc TypeDescriptor instance.
+     * \return SearchQuery.
+     */
+    template<is_search_expression E, is_type_descriptor D>
+        requires(is_search_expression_for<E, D>)
+    [[nodiscard]] auto compileSearch(D desc)
+    {
+        SearchContext ctx(desc.getType());
+        SearchSql     parts{.table = ctx.getInstanceTable(), .where = E::toSql(ctx)};
+        return compileSearch<typename E::leaves_t>(desc, ctx, std::move(parts));
+    }
+}  // namespace alex::detail
@@ -0,0 +1,251 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/packed_array.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_expression.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+#include "alexandria-extended-query/table_sets.h"
+
+namespace alex
+{
+    namespace detail
+    {
+        enum class ArraySearchQuantifier
+        {
+            Any = 0,
+            All = 1
+        };
+
+        template<MemberName Name, typename T>
+        concept is_primitive_array_member_name =
+          getColumnIndex<Name, extract_primitive_array_members_t<typename T::members_t>>() != -1;
+
+        template<typename T, MemberName M, ArraySearchQuantifier Q, PrimitiveSearchOp O>
+        struct ArraySearchOperator
+        {
+            using descriptor_t = T;
+            using members_t    = extract_primitive_array_members_t<typename T::members_t>;
+            using param_t      = member_to_column_t<std::tuple_element_t<getColumnIndex<M, members_t>(), members_t>>;
+            using leaves_t     = std::tuple<ArraySearchOperator>;
+            static constexpr auto name() { return M; }
+            static constexpr auto op() { return O; }
+            static constexpr auto quantifier() { return Q; }
+
+            /**
+             * \brief Generate a semi-join between the instance table and the array table. Any is written as EXISTS
+             * over matching values, All as NOT EXISTS over non-matching values. Both can be answered from the
+             * (value, instance) index of the array table. NULL values never match, so they violate All.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSql(SearchContext& ctx)
+            {
+                constexpr auto index = getColumnIndex<M, members_t>();
+                if (isPackedArray(ctx.getType(), index))
+                    throw std::runtime_error(std::format(
+                      R"(Member "{}" of type "{}" is packed and not searchable.)", M.name, ctx.getType().getName()));
+
+                const auto& arrayTable = *ctx.getType().getPrimitiveArrayTables()[index];
+                const auto  alias      = ctx.createAlias();
+                const auto  param      = ctx.createParameter();
+                const auto  cmp        = std::format("{}.value {} {}", alias, toSqlOperator(O, false), param);
+
+                if constexpr (Q == ArraySearchQuantifier::Any)
+                    return std::format("EXISTS (SELECT 1 FROM {1} AS {0} WHERE {2} AND {0}.instance = {3})",
+                                       alias,
+                                       quoteIdentifier(arrayTable.getName()),
+                                       cmp,
+                                       ctx.getInstanceColumn(1));
+                else
+                    return std::format(
+                      "NOT EXISTS (SELECT 1 FROM {1} AS {0} WHERE {0}.instance = {3} AND coalesce({2}, 0) = 0)",
+                      alias,
+                      quoteIdentifier(arrayTable.getName()),
+                      cmp,
+                      ctx.getInstanceColumn(1));
+            }
+        };
+
+        template<typename O>
+        struct IsArraySearchOperator : std::false_type
+        {
+        };
+
+        template<typename T, MemberName M, ArraySearchQuantifier Q, PrimitiveSearchOp O>
+        struct IsArraySearchOperator<ArraySearchOperator<T, M, Q, O>> : std::true_type
+        {
+        };
+
+        /**
+         * \brief Construct the SearchQuery of an array search. Array operators compile to EXISTS semi-joins, which
+         * cppql cannot express, so those searches are compiled from generated SQL. Searches that only hold primitive
+         * operators are compiled as primitive searches.
+         * \tparam And If true, conjunction. Otherwise disjunction.
+         * \tparam T TableSets type.
+         * \param tables TableSets instance.
+         * \param operators ArraySearchOperators or PrimitiveSearchOperators.
+         * \return SearchQuery.
+         */
+        template<bool And, typename T>
+        [[nodiscard]] auto arraySearchImpl(T& tables, auto... operators)
+        {
+            if constexpr ((IsArraySearchOperator<decltype(operators)>::value || ...))
+                return compileSearch<SearchJunction<And, decltype(operators)...>>(tables.getTypeDescriptor());
+            else
+                return primitiveSearchImpl<And>(tables, std::move(operators)...);
+        }
+    }  // namespace detail
+
+    /**
+     * \brief Check if a primitive or string array property contains a value. Strings are compared exactly (not with
+     * LIKE), so that the value index can be used.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return ArraySearchOperator which can be passed to the arraySearch* functions.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_primitive_array_member_name<M, T>)
+    [[nodiscard]] auto contains()
+    {
+        return detail::ArraySearchOperator<T, M, detail::ArraySearchQuantifier::Any, SearchOp::Equal>{};
+    }
+
+    /**
+     * \brief Check if at least one value of a primitive or string array property satisfies a comparison.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \tparam O Comparison operator.
+     * \return ArraySearchOperator which can be passed to the arraySearch* functions.
+     */
+    template<is_type_descriptor T, detail::MemberName M, SearchOp O>
+        requires(detail::is_primitive_array_member_name<M, T> && O != SearchOp::None)
+    [[nodiscard]] auto any()
+    {
+        return detail::ArraySearchOperator<T, M, detail::ArraySearchQuantifier::Any, O>{};
+    }
+
+    /**
+     * \brief Check if all values of a primitive or string array property satisfy a comparison. Empty arrays always
+     * satisfy the comparison, arrays containing NULL values never do.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \tparam O Comparison operator.
+     * \return ArraySearchOperator which can be passed to the arraySearch* functions.
+     */
+    template<is_type_descriptor T, detail::MemberName M, SearchOp O>
+        requires(detail::is_primitive_array_member_name<M, T> && O != SearchOp::None)
+    [[nodiscard]] auto all()
+    {
+        return detail::ArraySearchOperator<T, M, detail::ArraySearchQuantifier::All, O>{};
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the array search operator is true.
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param op Single ArraySearchOperator or PrimitiveSearchOperator.
+     * \return SearchQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto arraySearch(T& tables, auto op)
+    {
+        return detail::arraySearchImpl<true>(tables, std::move(op));
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the conjunction (&&) of array and primitive
+     * search operators is true.
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param op Single ArraySearchOperator or PrimitiveSearchOperator.
+     * \param operators ArraySearchOperators or PrimitiveSearchOperators.
+     * \return SearchQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto arraySearchAnd(T& tables, auto op, auto... operators)
+    {
+        return detail::arraySearchImpl<true>(tables, std::move(op), std::move(operators)...);
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the disjunction (||) of array and primitive
+     * search operators is true.
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param op Single ArraySearchOperator or PrimitiveSearchOperator.
+     * \param operators ArraySearchOperators or PrimitiveSearchOperators.
+     * \return SearchQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto arraySearchOr(T& tables, auto op, auto... operators)
+    {
+        return detail::arraySearchImpl<false>(tables, std::move(op), std::move(operators)...);
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the array search operator is true.
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param op Single ArraySearchOperator or PrimitiveSearchOperator.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto arraySearch(T desc, auto op)
+    {
+        auto tables = TableSets(desc);
+        return arraySearch(tables, std::move(op));
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the conjunction (&&) of array and primitive
+     * search operators is true.
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param op Single ArraySearchOperator or PrimitiveSearchOperator.
+     * \param operators ArraySearchOperators or PrimitiveSearchOperators.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto arraySearchAnd(T desc, auto op, auto... operators)
+    {
+        auto tables = TableSets(desc);
+        return arraySearchAnd(tables, std::move(op), std::move(operators)...);
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the disjunction (||) of array and primitive
+     * search operators is true.
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param op Single ArraySearchOperator or PrimitiveSearchOperator.
+     * \param operators ArraySearchOperators or PrimitiveSearchOperators.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto arraySearchOr(T desc, auto op, auto... operators)
+    {
+        auto tables = TableSets(desc);
+        return arraySearchOr(tables, std::move(op), std::move(operators)...);
+    }
+}  // namespace alex
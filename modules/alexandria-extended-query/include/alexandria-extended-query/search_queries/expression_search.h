@@ -0,0 +1,61 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_expression.h"
+#include "alexandria-extended-query/search_queries/array_search.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+#include "alexandria-extended-query/search_queries/reference_search.h"
+#include "alexandria-extended-query/search_queries/spatial_search.h"
+#include "alexandria-extended-query/search_queries/text_search.h"
+
+namespace alex
+{
+    /**
+     * \brief Construct a SearchQuery to find all instances for which a search expression is true. Expressions are
+     * built from primitive, array, reference and full-text search operators combined with &&, || and !, and are
+     * compiled into a single statement. Parameters are passed in the order in which the operators appear in the
+     * expression.
+     *
+     * \code
+     * auto query = alex::search(desc, (alex::greater<D, "radius">() || alex::equal<D, "name">()) &&
+     *                                   alex::references<D, "nodes">());
+     * query(1.0f, "x", nodeId);
+     * \endcode
+     *
+     * \tparam T TableSets type.
+     * \tparam E Search expression type.
+     * \param tables TableSets instance.
+     * \param expr Search expression.
+     * \return SearchQuery.
+     */
+    template<typename T, detail::is_search_expression E>
+    [[nodiscard]] auto search(T& tables, [[maybe_unused]] E expr)
+    {
+        return detail::compileSearch<E>(tables.getTypeDescriptor());
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which a search expression is true. Expressions are
+     * built from primitive, array and reference search operators combined with &&, || and !, and are compiled into a
+     * single statement. Parameters are passed in the order in which the operators appear in the expression.
+     * \tparam T TypeDescriptor type.
+     * \tparam E Search expression type.
+     * \param desc TypeDescriptor instance.
+     * \param expr Search expression.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T, detail::is_search_expression E>
+    [[nodiscard]] auto search(T desc, [[maybe_unused]] E expr)
+    {
+        return detail::compileSearch<E>(desc);
+    }
+}  // namespace alex
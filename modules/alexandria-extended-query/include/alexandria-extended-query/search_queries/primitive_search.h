@@ -4,6 +4,8 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <format>
+#include <string>
 #include <tuple>
 #include <type_traits>
 
@@ -11,13 +13,13 @@
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
-#include "common/static_assert.h"
 #include "alexandria-core/type_descriptor.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-extended-query/search_expression.h"
 #include "alexandria-extended-query/search_query.h"
 #include "alexandria-extended-query/table_sets.h"
 
@@ -36,73 +38,70 @@ namespace alex
             None         = 6
         };
 
+        /**
+         * \brief Get the SQL comparison operator for a search operator.
+         * \param op Search operator. Must not be None.
+         * \param text If true, equality is tested with LIKE.
+         * \return SQL operator.
+         */
+        [[nodiscard]] constexpr const char* toSqlOperator(const PrimitiveSearchOp op, const bool text) noexcept
+        {
+            switch (op)
+            {
+            case PrimitiveSearchOp::Equal: return text ? "LIKE" : "=";
+            case PrimitiveSearchOp::NotEqual: return "!=";
+            case PrimitiveSearchOp::Less: return "<";
+            case PrimitiveSearchOp::Greater: return ">";
+            case PrimitiveSearchOp::LessEqual: return "<=";
+            case PrimitiveSearchOp::GreaterEqual: return ">=";
+            case PrimitiveSearchOp::None: return "IS";
+            }
+            return "";
+        }
+
         template<typename T, MemberName M, PrimitiveSearchOp O>
         struct PrimitiveSearchOperator
         {
             using descriptor_t = T;
+            using members_t    = extract_primitive_members_t<typename T::members_t>;
+            using param_t      = member_to_column_t<std::tuple_element_t<getColumnIndex<M, members_t>(), members_t>>;
+            using leaves_t     = std::tuple<PrimitiveSearchOperator>;
             static constexpr auto name() { return M; }
             static constexpr auto op() { return O; }
+
+            /**
+             * \brief Generate a comparison between the instance table column and a parameter.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSql(SearchContext& ctx)
+            {
+                // Add 1 to account for integer primary key column.
+                const auto col   = ctx.getInstanceColumn(getColumnIndex<M, members_t>() + 1);
+                const auto param = ctx.createParameter();
+                if constexpr (O == PrimitiveSearchOp::None)
+                    return std::format("({} IS NULL)", col);
+                else
+                    return std::format(
+                      "({} {} {})", col, toSqlOperator(O, std::same_as<std::string, param_t>), param);
+            }
         };
 
         // TODO: Constrain operators to PrimitiveSearchOperators for primitive properties of T.
         template<bool And, typename T>
         [[nodiscard]] auto primitiveSearchImpl(T& tables, auto... operators)
         {
-            auto& instTable = tables.getInstanceTable();
-            auto  cols =
-              std::make_tuple(tables.template getInstanceColumn<std::decay_t<decltype(operators)>::name()>()...);
-            auto ops = std::make_tuple(operators...);
-
-            // Construct the list of parameters as pointers to allow dynamic binding.
-            auto params =
-              std::make_tuple(std::make_unique<decltype(tables.template getInstanceColumn<
-                                                        std::decay_t<decltype(operators)>::name()>())::value_t>()...);
-
-            constexpr auto op = []<typename O>(O) {
-                if constexpr (O::op() == PrimitiveSearchOp::Equal)
-                    return [](const auto& col, const auto& param) {
-                        if constexpr (std::same_as<std::string, std::remove_pointer_t<std::decay_t<decltype(param)>>>)
-                            return sql::like(col, param);
-                        else
-                            return col == param;
-                    };
-                else if constexpr (O::op() == PrimitiveSearchOp::NotEqual)
-                    return [](const auto& col, const auto& param) { return col != param; };
-                else if constexpr (O::op() == PrimitiveSearchOp::Less)
-                    return [](const auto& col, const auto& param) { return col < param; };
-                else if constexpr (O::op() == PrimitiveSearchOp::Greater)
-                    return [](const auto& col, const auto& param) { return col > param; };
-                else if constexpr (O::op() == PrimitiveSearchOp::LessEqual)
-                    return [](const auto& col, const auto& param) { return col <= param; };
-                else if constexpr (O::op() == PrimitiveSearchOp::GreaterEqual)
-                    return [](const auto& col, const auto& param) { return col >= param; };
-                else if constexpr (O::op() == PrimitiveSearchOp::None)
-                    return [](const auto& col, const auto&) { return col == nullptr; };
-                else
-                    constexpr_static_assert<false>();
-            };
-
-            // Construct an expression with all column-parameter pairs of the form:
-            // col[0] op[0] param[0] &&/|| ... &&/|| col[N] op[N] param[N]
-            auto expr = [&]<size_t... Is>(std::index_sequence<Is...>)
-            {
-                if constexpr (And)
-                    return (op(std::get<Is>(ops))(std::get<Is>(cols), std::get<Is>(params).get()) && ...);
-                else
-                    return (op(std::get<Is>(ops))(std::get<Is>(cols), std::get<Is>(params).get()) || ...);
-            }
-            (std::make_index_sequence<sizeof...(operators)>{});
-
-            // Compile statement that selects instance identifiers.
-            auto stmt = instTable.template selectAs<InstanceId>(tables.template getInstanceColumn<"id">())
-                          .where(std::move(expr))
-                          .orderBy(sql::ascending(instTable.template col<0>()))
-                          .compile();
-
-            return SearchQuery(tables.getTypeDescriptor(), std::move(stmt), std::move(params));
+            // Compiled to generated SQL, so that results can be ordered by member values (see SearchQuery::orderBy).
+            // By default, results are ordered by rowid, which allows keyset pagination.
+            return compileSearch<SearchJunction<And, std::decay_t<decltype(operators)>...>>(tables.getTypeDescriptor());
         }
     }  // namespace detail
 
+    /**
+     * \brief Comparison operators that can be applied to array values.
+     */
+    using SearchOp = detail::PrimitiveSearchOp;
+
     /**
      * \brief Compare a primitive property using the == operator.
      * \tparam T TypeDescriptor.
@@ -4,6 +4,8 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <format>
+#include <string>
 #include <tuple>
 #include <type_traits>
 
@@ -17,7 +19,9 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-extended-query/search_expression.h"
 #include "alexandria-extended-query/search_query.h"
+#include "alexandria-extended-query/search_statement.h"
 #include "alexandria-extended-query/table_sets.h"
 
 namespace alex
@@ -28,64 +32,64 @@ namespace alex
         struct ReferenceSearchOperator
         {
             using descriptor_t = T;
+            using members_t    = extract_reference_array_members_t<typename T::members_t>;
+            using param_t      = std::string;
+            using leaves_t     = std::tuple<ReferenceSearchOperator>;
             static constexpr auto name() { return M; }
-        };
-
-        template<bool Intersect, typename U>
-        struct UnionWrapper
-        {
-            U u;
-        };
-
-        template<bool Intersect, typename U, typename J>
-        [[nodiscard]] auto operator+(UnionWrapper<Intersect, U>&& wrapper, J&& join)
-        {
-            using U2 = decltype(wrapper.u.unions(sql::UnionOperator::Intersect, std::forward<J>(join)));
-            return UnionWrapper<Intersect, U2>{wrapper.u.unions(
-              Intersect ? sql::UnionOperator::Intersect : sql::UnionOperator::Union, std::forward<J>(join))};
-        }
-
-        // TODO: Constrain operators to ReferenceSearchOperator for reference array properties of T.
-        template<bool And, typename T>
-        [[nodiscard]] auto referenceSearchImpl(T& tables, auto... operators)
-        {
-            auto& instTable = tables.getInstanceTable();
-            auto  ops       = std::make_tuple(operators...);
 
-            // Construct the list of parameters as pointers to allow dynamic binding.
-            auto params =
-              std::make_tuple(std::make_unique<std::conditional_t<true, std::string, decltype(operators)>>()...);
-
-            // For each reference array table, create a join between it and the instance table.
-            // Join on the uuid column of the instance table and the instance column of the reference array table.
-            // Then filter by the value column of the reference array table.
-            auto joins = [&]<size_t... Is>(std::index_sequence<Is...>)
+            /**
+             * \brief Generate a semi-join between the instance table and the reference array table. Identifiers are
+             * compared exactly, so that the value index of the reference array table can be used.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSql(SearchContext& ctx)
             {
-                return std::make_tuple(
-                  instTable
-                    .join(sql::InnerJoin,
-                          tables.getReferenceArrayTable<std::decay_t<decltype(std::get<Is>(ops))>::name()>())
-                    .on(tables.template getInstanceColumn<"id">() ==
-                          tables.getReferenceArrayTable<std::decay_t<decltype(std::get<Is>(ops))>::name()>().col<1>() &&
-                        sql::like(
-                          tables.getReferenceArrayTable<std::decay_t<decltype(std::get<Is>(ops))>::name()>().col<2>(),
-                          std::get<Is>(params).get()))
-                    .selectAs<InstanceId>(tables.template getInstanceColumn<"id">())
-                    .groupBy(instTable.template col<0>())...);
+                const auto& arrayTable = *ctx.getType().getReferenceArrayTables()[getColumnIndex<M, members_t>()];
+                const auto  alias      = ctx.createAlias();
+                const auto  param      = ctx.createParameter();
+                return std::format("EXISTS (SELECT 1 FROM {1} AS {0} WHERE {0}.value = {2} AND {0}.instance = {3})",
+                                   alias,
+                                   quoteIdentifier(arrayTable.getName()),
+                                   param,
+                                   ctx.getInstanceColumn(1));
             }
-            (std::make_index_sequence<sizeof...(operators)>{});
 
-            // Create union of all selects.
-            auto query = [&]<size_t I, size_t... Is>(std::index_sequence<I, Is...>)
+            /**
+             * \brief Generate a select of the identifiers of all instances referencing a parameter, to be combined
+             * with the selects of other operators.
+             * \param ctx SearchContext.
+             * \return SQL select.
+             */
+            [[nodiscard]] static std::string toUnionSql(SearchContext& ctx)
             {
-                return (UnionWrapper<And, std::decay_t<decltype(std::get<I>(joins))>>{.u = std::get<I>(joins)} + ... +
-                        std::get<Is>(joins))
-                  .u;
+                const auto& arrayTable = *ctx.getType().getReferenceArrayTables()[getColumnIndex<M, members_t>()];
+                return std::format("SELECT instance FROM {} WHERE value = {}",
+                                   quoteIdentifier(arrayTable.getName()),
+                                   ctx.createParameter());
             }
-            (std::make_index_sequence<sizeof...(operators)>{});
+        };
 
-            auto stmt = query.compile();
-            return SearchQuery(tables.getTypeDescriptor(), std::move(stmt), std::move(params));
+        // TODO: Constrain operators to ReferenceSearchOperator for reference array properties of T.
+        template<bool And, typename T>
+        [[nodiscard]] auto referenceSearchImpl(T& tables, auto... operators)
+        {
+            using leaves_t = std::tuple<std::decay_t<decltype(operators)>...>;
+
+            // Select the instances referencing each value from the reference array tables, and combine them with
+            // INTERSECT or UNION. The instance table is then filtered on the combined set.
+            constexpr auto separator = And ? " INTERSECT " : " UNION ";
+            SearchContext  ctx(tables.getTypeDescriptor().getType());
+            std::string    selects;
+            [&]<typename... Os>(std::tuple<Os...>*) {
+                ((selects += (selects.empty() ? "" : separator) + Os::toUnionSql(ctx)), ...);
+            }(static_cast<leaves_t*>(nullptr));
+
+            // Results are ordered by rowid, but keyset pagination is not supported for reference searches.
+            SearchSql parts{.table  = ctx.getInstanceTable(),
+                            .where  = std::format("({} IN ({}))", ctx.getInstanceColumn(1), selects),
+                            .keyset = false};
+            return compileSearch<leaves_t>(tables.getTypeDescriptor(), ctx, std::move(parts));
         }
     }  // namespace detail
 
@@ -0,0 +1,394 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/property_layout.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/type_descriptor.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_expression.h"
+
+namespace alex
+{
+    /**
+     * \brief Axis-aligned box. Parameter of the withinBox search operator.
+     * \tparam D Number of dimensions.
+     */
+    template<size_t D>
+    struct SpatialBox
+    {
+        std::array<double, D> min{};
+        std::array<double, D> max{};
+    };
+
+    /**
+     * \brief Sphere (or circle). Parameter of the withinRadius search operator.
+     * \tparam D Number of dimensions.
+     */
+    template<size_t D>
+    struct SpatialSphere
+    {
+        std::array<double, D> center{};
+        double                radius = 0;
+    };
+
+    namespace detail
+    {
+        /**
+         * \brief Returns whether a member name is a direct child of a nested member name, i.e. of the form "A.b".
+         * \tparam Parent Name of the nested member.
+         * \tparam Name Name of the (flattened) member.
+         * \return True if direct child.
+         */
+        template<MemberName Parent, MemberName Name>
+        [[nodiscard]] consteval bool isNestedMemberOf()
+        {
+            size_t i = 0;
+            for (; Parent.name[i]; i++)
+                if (Name.name[i] != Parent.name[i]) return false;
+            if (Name.name[i] != '.') return false;
+            for (i++; Name.name[i]; i++)
+                if (Name.name[i] == '.') return false;
+            return true;
+        }
+
+        /**
+         * \brief Get the instance table column indices of the numeric members of a nested member.
+         * \tparam T TypeDescriptor.
+         * \tparam M MemberName of the nested member.
+         * \return Array of column indices.
+         */
+        template<typename T, MemberName M>
+        [[nodiscard]] consteval auto getNestedColumnIndices()
+        {
+            using members_t = extract_primitive_members_t<typename T::members_t>;
+            return []<size_t... Is>(std::index_sequence<Is...>) {
+                constexpr auto matches = []<typename U>(std::type_identity<U>) {
+                    return isNestedMemberOf<M, U::name_v>() && std::is_arithmetic_v<typename U::value_t>;
+                };
+
+                constexpr size_t count =
+                  ((matches(std::type_identity<std::tuple_element_t<Is, members_t>>{}) ? 1 : 0) + ... + 0);
+                std::array<size_t, count> indices{};
+                size_t                    n = 0;
+                (
+                  [&] {
+                      // Add 1 to account for integer primary key column.
+                      if (matches(std::type_identity<std::tuple_element_t<Is, members_t>>{})) indices[n++] = Is + 1;
+                  }(),
+                  ...);
+                return indices;
+            }(std::make_index_sequence<std::tuple_size_v<members_t>>{});
+        }
+
+        template<MemberName Name, typename T>
+        concept is_spatial_member_name =
+          getNestedColumnIndices<T, Name>().size() >= 2 && getNestedColumnIndices<T, Name>().size() <= 3;
+
+        enum class SpatialSearchShape
+        {
+            Box    = 0,
+            Sphere = 1
+        };
+
+        template<typename T, MemberName M, SpatialSearchShape S>
+        struct SpatialSearchOperator
+        {
+            static constexpr auto   columns    = getNestedColumnIndices<T, M>();
+            static constexpr size_t dimensions = columns.size();
+
+            using descriptor_t = T;
+            using param_t =
+              std::conditional_t<S == SpatialSearchShape::Box, SpatialBox<dimensions>, SpatialSphere<dimensions>>;
+            using leaves_t = std::tuple<SpatialSearchOperator>;
+            static constexpr auto name() { return M; }
+
+            /**
+             * \brief Get the quoted name of the R*Tree table of the member.
+             * \param ctx SearchContext.
+             * \return Table name.
+             */
+            [[nodiscard]] static std::string getIndexTable(const SearchContext& ctx)
+            {
+                // The index is named after the first column of the nested type.
+                const auto rtree = PropertyLayout::getSpatialTableName(ctx.getType().getInstanceTable().getName(),
+                                                                       ctx.getInstanceColumnNames().at(columns[0]));
+                if (!ctx.hasTable(rtree))
+                    throw std::runtime_error(std::format(
+                      R"(Member "{}" of type "{}" has no spatial index.)", M.name, ctx.getType().getName()));
+
+                return quoteIdentifier(rtree);
+            }
+
+            /**
+             * \brief Generate a lookup in the R*Tree, followed by an exact test on the instance columns. The R*Tree
+             * stores 32-bit floating point coordinates that are rounded outwards, so it can only be used to prefilter.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSql(SearchContext& ctx)
+            {
+                const auto  rtree = getIndexTable(ctx);
+                const auto  param = ctx.createParameter();
+                std::string box, exact;
+                for (size_t i = 0; i < dimensions; i++)
+                {
+                    const auto [lo, hi] = getBounds(param, i);
+                    box += std::format(" AND min{0} <= {2} AND max{0} >= {1}", i, lo, hi);
+                    if constexpr (S == SpatialSearchShape::Box)
+                        exact += std::format(" AND {} BETWEEN {} AND {}", ctx.getInstanceColumn(columns[i]), lo, hi);
+                }
+
+                if constexpr (S == SpatialSearchShape::Sphere)
+                    exact = std::format(" AND {} <= {}_r * {}_r", toDistanceSql(ctx, param), param, param);
+
+                return std::format(
+                  "({} IN (SELECT id FROM {} WHERE 1{}){})", ctx.getInstanceColumn(0), rtree, box, exact);
+            }
+
+            /**
+             * \brief Generate a k-nearest neighbour lookup. Starting at the radius of the sphere, the radius is doubled
+             * until the sphere holds at least k instances or all instances in the R*Tree, where k is the limit plus
+             * offset of the query. Without a limit, only the radius of the sphere is used.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toNearestSql(SearchContext& ctx)
+                requires(S == SpatialSearchShape::Sphere)
+            {
+                const auto rtree    = getIndexTable(ctx);
+                const auto param    = ctx.createParameter();
+                const auto radii    = ctx.createAlias();
+                const auto index    = ctx.createAlias();
+                const auto instance = ctx.createAlias();
+                const auto last     = ctx.createAlias();
+
+                // Number of instances within a radius. The box lookup is followed by an exact test.
+                const auto found = [&](const std::string& radius) {
+                    std::string box;
+                    for (size_t i = 0; i < dimensions; i++)
+                        box += std::format(
+                          " AND {0}.min{1} <= {2}_{1} + {3} AND {0}.max{1} >= {2}_{1} - {3}", index, i, param, radius);
+                    return std::format("(SELECT count(*) FROM {} AS {} JOIN {} AS {} ON {}.id = {}.id WHERE {} <= "
+                                       "{} * {}{})",
+                                       rtree,
+                                       index,
+                                       ctx.getInstanceTable(),
+                                       instance,
+                                       instance,
+                                       index,
+                                       toDistanceSql(ctx, param, instance),
+                                       radius,
+                                       radius,
+                                       box);
+                };
+
+                // A sphere of radius 0 is widened to a radius of 1.
+                const auto next = std::format("(CASE WHEN {0}.r > 0 THEN {0}.r * 2 ELSE 1 END)", radii);
+                const auto k    = "(CASE WHEN :limit < 0 THEN 0 ELSE :limit + ifnull(:offset, 0) END)";
+
+                // The index is searched once more with the final radius to retrieve the instances.
+                std::string box;
+                for (size_t i = 0; i < dimensions; i++)
+                    box += std::format(
+                      " AND {0}.min{1} <= {2}_{1} + {3}.r AND {0}.max{1} >= {2}_{1} - {3}.r", index, i, param, last);
+
+                return std::format(
+                  "({0} IN (WITH RECURSIVE {1}(r, found) AS (SELECT {2}_r, {3} UNION ALL SELECT {4}, {5} FROM {1} "
+                  "WHERE {1}.found < {6} AND {1}.found < (SELECT count(*) FROM {7})) SELECT {8}.id FROM (SELECT "
+                  "max(r) AS r FROM {1}) AS {13}, {7} AS {8} JOIN {9} AS {10} ON {10}.id = {8}.id WHERE {11} <= "
+                  "{13}.r * {13}.r{12}))",
+                  ctx.getInstanceColumn(0),
+                  radii,
+                  param,
+                  found(param + "_r"),
+                  next,
+                  found(next),
+                  k,
+                  rtree,
+                  index,
+                  ctx.getInstanceTable(),
+                  instance,
+                  toDistanceSql(ctx, param, instance),
+                  box,
+                  last);
+            }
+
+            /**
+             * \brief Generate an expression calculating the squared distance between the instance and the center of
+             * the sphere.
+             * \param ctx SearchContext.
+             * \param param Name of the parameter of this operator.
+             * \param alias Alias of the instance table.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string
+              toDistanceSql(const SearchContext& ctx, const std::string& param, const std::string& alias = "i")
+                requires(S == SpatialSearchShape::Sphere)
+            {
+                std::string sql;
+                for (size_t i = 0; i < dimensions; i++)
+                {
+                    const auto diff = std::format(
+                      "({}.{} - {}_{})", alias, quoteIdentifier(ctx.getInstanceColumnNames().at(columns[i])), param, i);
+                    sql += std::format("{}{} * {}", i == 0 ? "" : " + ", diff, diff);
+                }
+                return "(" + sql + ")";
+            }
+
+            /**
+             * \brief Bind the coordinates of the box or sphere.
+             * \param stmt Statement.
+             * \param name Parameter name.
+             * \param value Box or sphere.
+             */
+            static void bind(RawStatement& stmt, const std::string& name, const param_t& value)
+            {
+                for (size_t i = 0; i < dimensions; i++)
+                {
+                    if constexpr (S == SpatialSearchShape::Box)
+                    {
+                        stmt.bind(std::format("{}_min{}", name, i), value.min[i]);
+                        stmt.bind(std::format("{}_max{}", name, i), value.max[i]);
+                    }
+                    else
+                        stmt.bind(std::format("{}_{}", name, i), value.center[i]);
+                }
+                if constexpr (S == SpatialSearchShape::Sphere) stmt.bind(name + "_r", value.radius);
+            }
+
+        private:
+            /**
+             * \brief Get expressions for the lower and upper bound of a dimension.
+             */
+            [[nodiscard]] static std::pair<std::string, std::string> getBounds(const std::string& param,
+                                                                               const size_t       i)
+            {
+                if constexpr (S == SpatialSearchShape::Box)
+                    return {std::format("{}_min{}", param, i), std::format("{}_max{}", param, i)};
+                else
+                    return {std::format("({0}_{1} - {0}_r)", param, i), std::format("({0}_{1} + {0}_r)", param, i)};
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * \brief Check if a nested member lies within an axis-aligned box (bounds inclusive). The nested property must
+     * have a spatial index, see PropertyLayout::setSpatial. The parameter is a SpatialBox.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName of the nested member.
+     * \return SpatialSearchOperator.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_spatial_member_name<M, T>)
+    [[nodiscard]] auto withinBox()
+    {
+        return detail::SpatialSearchOperator<T, M, detail::SpatialSearchShape::Box>{};
+    }
+
+    /**
+     * \brief Check if a nested member lies within a distance of a point. The nested property must have a spatial
+     * index, see PropertyLayout::setSpatial. The parameter is a SpatialSphere.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName of the nested member.
+     * \return SpatialSearchOperator.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_spatial_member_name<M, T>)
+    [[nodiscard]] auto withinRadius()
+    {
+        return detail::SpatialSearchOperator<T, M, detail::SpatialSearchShape::Sphere>{};
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the spatial search operator is true, ordered by
+     * rowid. Can also be combined with other search operators in search expressions.
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param op Result of withinBox or withinRadius.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto spatialSearch(T desc, auto op)
+    {
+        return detail::compileSearch<decltype(op)>(desc);
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find the instances nearest to a point, ordered by increasing distance. Combine
+     * with SearchQuery::limit to find the k nearest instances. The search starts with the radius of the sphere, which
+     * is doubled until k instances are found or the index is exhausted. A radius close to the distance of the k-th
+     * instance keeps the number of widening steps small. Without a limit, all instances within the radius are
+     * returned.
+     *
+     * \code
+     * auto query = alex::nearestSearch(desc, alex::withinRadius<D, "translation">());
+     * query.limit(10);
+     * query(alex::SpatialSphere<3>{.center = {0, 0, 0}, .radius = 1});
+     * \endcode
+     *
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param op Result of withinRadius.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto nearestSearch(T desc, auto op)
+    {
+        using op_t = decltype(op);
+        static_assert(std::same_as<T, typename op_t::descriptor_t>, "Operator is for a different type.");
+
+        detail::SearchContext ctx(desc.getType());
+        detail::SearchSql     parts{.table = ctx.getInstanceTable(), .where = op_t::toNearestSql(ctx)};
+        parts.orderBy = {{op_t::toDistanceSql(ctx, ctx.getLastParameter()), Order::Ascending},
+                         {"i.id", Order::Ascending}};
+        parts.keyset  = false;
+        return detail::compileSearch<typename op_t::leaves_t>(desc, ctx, std::move(parts));
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances for which the spatial search operator is true.
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param op Result of withinBox or withinRadius.
+     * \return SearchQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto spatialSearch(T& tables, auto op)
+    {
+        return spatialSearch(tables.getTypeDescriptor(), op);
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find the instances nearest to a point, ordered by increasing distance.
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param op Result of withinRadius.
+     * \return SearchQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto nearestSearch(T& tables, auto op)
+    {
+        return nearestSearch(tables.getTypeDescriptor(), op);
+    }
+}  // namespace alex
@@ -0,0 +1,225 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <concepts>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/property_layout.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-core/type_descriptor.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_expression.h"
+
+namespace alex
+{
+    namespace detail
+    {
+        /**
+         * \brief Returns whether a member is a string or string array member.
+         * \tparam T TypeDescriptor.
+         * \tparam M MemberName.
+         * \return True if string or string array.
+         */
+        template<typename T, MemberName M>
+        [[nodiscard]] consteval bool isTextMember()
+        {
+            using primitive_t = extract_primitive_members_t<typename T::members_t>;
+            using array_t     = extract_primitive_array_members_t<typename T::members_t>;
+            if constexpr (getColumnIndex<M, primitive_t>() != -1)
+                return std::same_as<
+                  member_to_column_t<std::tuple_element_t<getColumnIndex<M, primitive_t>(), primitive_t>>,
+                  std::string>;
+            else if constexpr (getColumnIndex<M, array_t>() != -1)
+                return std::same_as<member_to_column_t<std::tuple_element_t<getColumnIndex<M, array_t>(), array_t>>,
+                                    std::string>;
+            else
+                return false;
+        }
+
+        template<MemberName Name, typename T>
+        concept is_text_member_name = isTextMember<T, Name>();
+
+        template<typename T, MemberName M>
+        struct TextSearchOperator
+        {
+            using descriptor_t = T;
+            using param_t      = std::string;
+            using leaves_t     = std::tuple<TextSearchOperator>;
+            static constexpr auto name() { return M; }
+
+            /**
+             * \brief Whether the member is a string array, which is indexed through its array table.
+             */
+            static constexpr bool array =
+              getColumnIndex<M, extract_primitive_members_t<typename T::members_t>>() == -1;
+
+            /**
+             * \brief Get the quoted name of the full-text index of the member.
+             * \param ctx SearchContext.
+             * \return Table name.
+             */
+            [[nodiscard]] static std::string getIndexTable(const SearchContext& ctx)
+            {
+                std::string fts;
+                if constexpr (array)
+                {
+                    using members_t        = extract_primitive_array_members_t<typename T::members_t>;
+                    const auto& arrayTable = *ctx.getType().getPrimitiveArrayTables()[getColumnIndex<M, members_t>()];
+                    fts                    = PropertyLayout::getFullTextTableName(arrayTable.getName(), "value");
+                }
+                else
+                {
+                    // Add 1 to account for integer primary key column.
+                    using members_t = extract_primitive_members_t<typename T::members_t>;
+                    fts             = PropertyLayout::getFullTextTableName(
+                      ctx.getType().getInstanceTable().getName(),
+                      ctx.getInstanceColumnNames().at(getColumnIndex<M, members_t>() + 1));
+                }
+
+                if (!ctx.hasTable(fts))
+                    throw std::runtime_error(std::format(R"(Member "{}" of type "{}" has no full-text index.)",
+                                                         M.name,
+                                                         ctx.getType().getName()));
+
+                return quoteIdentifier(fts);
+            }
+
+            /**
+             * \brief Generate a subquery that selects the instances matching the full-text query. For string arrays,
+             * an instance matches if any of its values matches.
+             * \param ctx SearchContext.
+             * \return SQL expression.
+             */
+            [[nodiscard]] static std::string toSql(SearchContext& ctx)
+            {
+                const auto fts   = getIndexTable(ctx);
+                const auto param = ctx.createParameter();
+
+                if constexpr (array)
+                {
+                    using members_t        = extract_primitive_array_members_t<typename T::members_t>;
+                    const auto& arrayTable = *ctx.getType().getPrimitiveArrayTables()[getColumnIndex<M, members_t>()];
+                    const auto  alias      = ctx.createAlias();
+                    return std::format(
+                      "({3} IN (SELECT {0}.instance FROM {1} AS {0} WHERE {0}.id IN (SELECT rowid FROM {2} WHERE {2} "
+                      "MATCH {4})))",
+                      alias,
+                      quoteIdentifier(arrayTable.getName()),
+                      fts,
+                      ctx.getInstanceColumn(1),
+                      param);
+                }
+                else
+                    return std::format(
+                      "({} IN (SELECT rowid FROM {} WHERE {} MATCH {}))", ctx.getInstanceColumn(0), fts, fts, param);
+            }
+
+            /**
+             * \brief Generate a join with the ranked matches of the full-text query. The joined table has a rank
+             * column, where lower is better. For string arrays, the best rank of all values is used.
+             * \param ctx SearchContext.
+             * \param alias Alias of the joined table.
+             * \return SQL join clause.
+             */
+            [[nodiscard]] static std::string toRankedJoin(SearchContext& ctx, const std::string& alias)
+            {
+                const auto fts   = getIndexTable(ctx);
+                const auto param = ctx.createParameter();
+
+                if constexpr (array)
+                {
+                    using members_t        = extract_primitive_array_members_t<typename T::members_t>;
+                    const auto& arrayTable = *ctx.getType().getPrimitiveArrayTables()[getColumnIndex<M, members_t>()];
+                    return std::format(
+                      " JOIN (SELECT a.instance AS instance, min({1}.rank) AS rank FROM {1} JOIN {2} AS a ON a.id = "
+                      "{1}.rowid WHERE {1} MATCH {3} GROUP BY a.instance) AS {0} ON {0}.instance = {4}",
+                      alias,
+                      fts,
+                      quoteIdentifier(arrayTable.getName()),
+                      param,
+                      ctx.getInstanceColumn(1));
+                }
+                else
+                    return std::format(
+                      " JOIN (SELECT rowid AS id, rank FROM {1} WHERE {1} MATCH {2}) AS {0} ON {0}.id = {3}",
+                      alias,
+                      fts,
+                      param,
+                      ctx.getInstanceColumn(0));
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * \brief Match a string or string array property against an FTS5 full-text query (e.g. "red OR blue", "cub*").
+     * The property must have a full-text index, see PropertyLayout::setFullText. Can be passed to textSearch, or
+     * combined with other search operators in search expressions.
+     * \tparam T TypeDescriptor.
+     * \tparam M MemberName.
+     * \return TextSearchOperator.
+     */
+    template<is_type_descriptor T, detail::MemberName M>
+        requires(detail::is_text_member_name<M, T>)
+    [[nodiscard]] auto matches()
+    {
+        return detail::TextSearchOperator<T, M>{};
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances matching a full-text query, ordered by relevance (bm25).
+     * Since results are not ordered by rowid, keyset pagination is not available. Use limit and offset instead.
+     *
+     * \code
+     * auto query = alex::textSearch(desc, alex::matches<D, "description">());
+     * query("red AND cub*");
+     * \endcode
+     *
+     * \tparam T TypeDescriptor type.
+     * \param desc TypeDescriptor instance.
+     * \param op TextSearchOperator.
+     * \return SearchQuery.
+     */
+    template<is_type_descriptor T>
+    [[nodiscard]] auto textSearch(T desc, auto op)
+    {
+        using op_t = decltype(op);
+        static_assert(std::same_as<T, typename op_t::descriptor_t>, "Operator is for a different type.");
+
+        detail::SearchContext ctx(desc.getType());
+        const auto            alias = ctx.createAlias();
+        detail::SearchSql     parts{.table   = ctx.getInstanceTable(),
+                                    .join    = op_t::toRankedJoin(ctx, alias),
+                                    .where   = "1",
+                                    .orderBy = {{alias + ".rank", Order::Ascending}, {"i.id", Order::Ascending}},
+                                    .keyset  = false};
+        return detail::compileSearch<typename op_t::leaves_t>(desc, ctx, std::move(parts));
+    }
+
+    /**
+     * \brief Construct a SearchQuery to find all instances matching a full-text query, ordered by relevance (bm25).
+     * \tparam T TableSets type.
+     * \param tables TableSets instance.
+     * \param op TextSearchOperator.
+     * \return SearchQuery.
+     */
+    template<typename T>
+    [[nodiscard]] auto textSearch(T& tables, auto op)
+    {
+        return textSearch(tables.getTypeDescriptor(), op);
+    }
+}  // namespace alex
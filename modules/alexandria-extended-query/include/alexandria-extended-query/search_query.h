@@ -4,16 +4,275 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <variant>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/query_observer.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type.h"
+#include "alexandria-basic-query/blob_codec.h"
+#include "alexandria-basic-query/row_view.h"
+#include "alexandria-basic-query/utils.h"
 #include "cppql/statements/select_statement.h"
 
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_cache.h"
+
 namespace alex
 {
+    /**
+     * \brief Sort direction of an ordering key.
+     */
+    enum class Order
+    {
+        Ascending  = 0,
+        Descending = 1
+    };
+
+    /**
+     * \brief Order of the results of a parallel search (see SearchQuery::parallel).
+     */
+    enum class ParallelOrder
+    {
+        /**
+         * \brief Results are merged in rowid order, i.e. the same order as a serial search.
+         */
+        Rowid = 0,
+
+        /**
+         * \brief Results are merged in the order in which threads finish. With a limit, threads stop as soon as
+         * enough results were found.
+         */
+        Unordered = 1
+    };
+
+    namespace detail
+    {
+        /**
+         * \brief Paging state of a SearchQuery. Owned through a pointer by the query, so that compiled statements can
+         * bind to it dynamically and a single statement serves every page.
+         */
+        struct SearchPaging
+        {
+            /**
+             * \brief Maximum number of results. Negative for no limit.
+             */
+            int64_t limit = -1;
+
+            /**
+             * \brief Number of results to skip.
+             */
+            int64_t offset = 0;
+
+            /**
+             * \brief Only instances with a rowid larger than this value are returned.
+             */
+            sql::row_id after = std::numeric_limits<sql::row_id>::min();
+
+            /**
+             * \brief Whether the statement filters on the after value. Only statements that order by rowid can.
+             */
+            bool keyset = false;
+        };
+
+        /**
+         * \brief Value of an ordering term of a search result.
+         */
+        using SortValue = std::variant<std::monostate, int64_t, double, std::string>;
+
+        /**
+         * \brief Compare two values of an ordering term the way SQLite does: NULL sorts before numbers, which sort
+         * before text. Integers and reals are compared by value, text byte by byte.
+         * \param lhs Left value.
+         * \param rhs Right value.
+         * \return Negative, zero or positive if lhs sorts before, together with or after rhs.
+         */
+        [[nodiscard]] inline int compareSortValues(const SortValue& lhs, const SortValue& rhs) noexcept
+        {
+            constexpr auto storageClass = [](const SortValue& value) {
+                return std::holds_alternative<std::monostate>(value) ? 0 :
+                       std::holds_alternative<std::string>(value)    ? 2 :
+                                                                       1;
+            };
+            if (storageClass(lhs) != storageClass(rhs)) return storageClass(lhs) < storageClass(rhs) ? -1 : 1;
+
+            if (std::holds_alternative<std::monostate>(lhs)) return 0;
+            if (std::holds_alternative<std::string>(lhs)) return lhs < rhs ? -1 : rhs < lhs ? 1 : 0;
+            if (std::holds_alternative<int64_t>(lhs) && std::holds_alternative<int64_t>(rhs))
+            {
+                const auto l = std::get<int64_t>(lhs);
+                const auto r = std::get<int64_t>(rhs);
+                return l < r ? -1 : r < l ? 1 : 0;
+            }
+
+            constexpr auto toDouble = [](const SortValue& value) {
+                return std::holds_alternative<int64_t>(value) ? static_cast<double>(std::get<int64_t>(value)) :
+                                                                std::get<double>(value);
+            };
+            const auto l = toDouble(lhs);
+            const auto r = toDouble(rhs);
+            return l < r ? -1 : r < l ? 1 : 0;
+        }
+
+        /**
+         * \brief Results of a search together with the values of their ordering terms, so that the results of the same
+         * search on several libraries can be merged (see ShardedSearchQuery).
+         */
+        struct OrderedResults
+        {
+            /**
+             * \brief Sort directions of the ordering terms. Empty if the results are ordered by rowid or not at all,
+             * since rowids have no meaning outside of the searched library.
+             */
+            std::vector<Order> order;
+
+            /**
+             * \brief Identifiers, in order. Ties on all ordering terms are ordered by identifier.
+             */
+            std::vector<InstanceId> ids;
+
+            /**
+             * \brief Values of the ordering terms, order.size() per result.
+             */
+            std::vector<SortValue> values;
+
+            /**
+             * \brief Compare a result with a result of the same search on another library. Ties are broken by
+             * identifier.
+             * \param index Index of the result.
+             * \param other Results of the other search.
+             * \param otherIndex Index of the other result.
+             * \return Negative, zero or positive if this result sorts before, together with or after the other.
+             */
+            [[nodiscard]] int compare(const size_t index, const OrderedResults& other, const size_t otherIndex) const
+            {
+                const auto n = order.size();
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto c = compareSortValues(values[index * n + i], other.values[otherIndex * n + i]);
+                    if (c != 0) return order[i] == Order::Ascending ? c : -c;
+                }
+
+                const auto& lhs = ids[index].get();
+                const auto& rhs = other.ids[otherIndex].get();
+                return lhs < rhs ? -1 : rhs < lhs ? 1 : 0;
+            }
+        };
+
+        /**
+         * \brief Iterator wrapping a statement iterator that applies the offset and limit of a SearchQuery. Rows are
+         * stepped lazily, so results past the limit are never produced. Cached results are walked directly instead.
+         * \tparam I Statement iterator type.
+         */
+        template<typename I>
+        class SearchIterator
+        {
+        public:
+            ////////////////////////////////////////////////////////////////
+            // Types.
+            ////////////////////////////////////////////////////////////////
+
+            using iterator_category = std::input_iterator_tag;
+            using reference         = decltype(*std::declval<const I&>());
+            using value_type        = std::remove_cvref_t<reference>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+
+            ////////////////////////////////////////////////////////////////
+            // Constructors.
+            ////////////////////////////////////////////////////////////////
+
+            SearchIterator() = default;
+
+            SearchIterator(I current, I last, const uint64_t skip, const uint64_t count) :
+                it(std::move(current)), end(std::move(last)), remaining(count)
+            {
+                for (uint64_t i = 0; i < skip && it != end; i++) ++it;
+            }
+
+            SearchIterator(const InstanceId* first, const InstanceId* last, I done) :
+                it(done), end(std::move(done)), cached(first), cachedEnd(last)
+            {
+            }
+
+            ////////////////////////////////////////////////////////////////
+            // Operators.
+            ////////////////////////////////////////////////////////////////
+
+            [[nodiscard]] reference operator*() const
+            {
+                if (cached) return *cached;
+                return *it;
+            }
+
+            SearchIterator& operator++()
+            {
+                if (cached)
+                {
+                    ++cached;
+                    return *this;
+                }
+
+                ++it;
+                if (remaining != std::numeric_limits<uint64_t>::max()) remaining--;
+                return *this;
+            }
+
+            SearchIterator operator++(int)
+            {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            [[nodiscard]] bool operator==(const SearchIterator& other) const
+            {
+                const auto done      = isDone();
+                const auto otherDone = other.isDone();
+                if (done || otherDone) return done == otherDone;
+                if (cached || other.cached) return cached == other.cached;
+                return it == other.it;
+            }
+
+        private:
+            [[nodiscard]] bool isDone() const
+            {
+                if (cached) return cached == cachedEnd;
+                return remaining == 0 || it == end;
+            }
+
+            ////////////////////////////////////////////////////////////////
+            // Member variables.
+            ////////////////////////////////////////////////////////////////
+
+            I                 it;
+            I                 end;
+            uint64_t          remaining = 0;
+            const InstanceId* cached    = nullptr;
+            const InstanceId* cachedEnd = nullptr;
+        };
+    }  // namespace detail
+
     /**
      * \brief SearchQuery.
      * \tparam T TypeDescriptor.
@@ -32,6 +291,9 @@ namespace alex
         using object_t          = typename type_descriptor_t::object_t;
         using statement_t       = S;
         using parameters_t      = std::tuple<std::unique_ptr<Ps>...>;
+        using iterator_t        = detail::SearchIterator<decltype(std::declval<statement_t&>().begin())>;
+        using cache_key_t       = std::tuple<Ps..., int64_t, int64_t, sql::row_id>;
+        using cache_t           = detail::SearchCache<cache_key_t>;
 
         ////////////////////////////////////////////////////////////////
         // Constructors.
@@ -40,7 +302,15 @@ namespace alex
         SearchQuery() = delete;
 
         SearchQuery(type_descriptor_t desc, statement_t stmt, parameters_t params) :
-            descriptor(desc), statement(std::move(stmt)), parameters(std::move(params))
+            SearchQuery(desc, std::move(stmt), std::move(params), std::make_unique<detail::SearchPaging>())
+        {
+        }
+
+        SearchQuery(type_descriptor_t                     desc,
+                    statement_t                           stmt,
+                    parameters_t                          params,
+                    std::unique_ptr<detail::SearchPaging> pag) :
+            descriptor(desc), statement(std::move(stmt)), parameters(std::move(params)), paging(std::move(pag))
         {
         }
 
@@ -54,13 +324,313 @@ namespace alex
 
         SearchQuery& operator=(SearchQuery&& other) noexcept = default;
 
+        ////////////////////////////////////////////////////////////////
+        // Paging.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Limit the number of returned instances. Applies to all following iterations. Searches compiled by
+         * this library bind the limit as a statement parameter when iteration starts.
+         * \param count Maximum number of instances. Negative to remove the limit.
+         * \return *this.
+         */
+        SearchQuery& limit(const int64_t count) noexcept
+        {
+            paging->limit = count;
+            return *this;
+        }
+
+        /**
+         * \brief Skip a number of instances. Applies to all following iterations. Searches compiled by this library
+         * bind the offset as a statement parameter when iteration starts. Note that skipped rows are still evaluated.
+         * Prefer after() for deep pagination.
+         * \param count Number of instances to skip.
+         * \return *this.
+         */
+        SearchQuery& offset(const int64_t count) noexcept
+        {
+            paging->offset = count;
+            return *this;
+        }
+
+        /**
+         * \brief Only return instances that were inserted after the instance with the given rowid. Applies to all
+         * following iterations. The value is bound immediately, together with the current parameter values.
+         * \param rowid Rowid of the last instance of the previous page.
+         * \return *this.
+         */
+        SearchQuery& after(const sql::row_id rowid)
+        {
+            if (!paging->keyset) throw std::runtime_error("This SearchQuery does not support keyset pagination.");
+            paging->after = rowid;
+            statement.bind(sql::BindParameters::Dynamic);
+            return *this;
+        }
+
+        /**
+         * \brief Only return instances that were inserted after the given instance. Applies to all following
+         * iterations. The value is bound immediately, together with the current parameter values.
+         * \param id Identifier of the last instance of the previous page.
+         * \return *this.
+         */
+        SearchQuery& after(const InstanceId& id)
+        {
+            using table_t =
+              detail::primitive_table_t<detail::extract_primitive_members_t<typename type_descriptor_t::members_t>>;
+
+            if (!paging->keyset) throw std::runtime_error("This SearchQuery does not support keyset pagination.");
+            if (!id.valid()) throw std::runtime_error("Cannot page after an instance without a valid UUID.");
+
+            // Look up rowid of instance.
+            auto       uuid  = id.getAsString();
+            const auto table = table_t(descriptor.getType().getInstanceTable());
+            auto       stmt  = table.template selectAs<sql::row_id, 0>()
+                            .where(sql::like(table.template col<1>(), &uuid))
+                            .compileOne();
+            paging->after = stmt.bind(sql::BindParameters::Dynamic)();
+            statement.bind(sql::BindParameters::Dynamic);
+            return *this;
+        }
+
+        /**
+         * \brief Remove limit, offset and keyset filter. The keyset filter is unbound immediately, together with the
+         * current parameter values.
+         * \return *this.
+         */
+        SearchQuery& resetPaging()
+        {
+            paging->limit  = -1;
+            paging->offset = 0;
+            paging->after  = std::numeric_limits<sql::row_id>::min();
+            statement.bind(sql::BindParameters::Dynamic);
+            return *this;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Ordering.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Order results by the value of a member. Can be called multiple times to add keys, which are applied in
+         * the order in which they were added. Remaining ties are broken by rowid. The statement is recompiled once per
+         * call and stays reusable across parameter values. Declare an index on the member (see
+         * PropertyLayout::setIndexed) to let top-N queries read the index in order instead of sorting all matches.
+         * Ordering by a member disables keyset pagination. Use limit and offset instead.
+         * \tparam M MemberName.
+         * \param order Sort direction.
+         * \return *this.
+         */
+        template<detail::MemberName M>
+            requires(detail::is_primitive_member_name<M, T> &&
+                     requires(statement_t& stmt) { stmt.orderBy(size_t{0}, Order::Ascending); })
+        SearchQuery& orderBy(const Order order = Order::Ascending)
+        {
+            // Add 1 to account for integer primary key column.
+            using members_t = detail::extract_primitive_members_t<typename type_descriptor_t::members_t>;
+            statement.orderBy(detail::getColumnIndex<M, members_t>() + 1, order);
+
+            paging->keyset = false;
+            paging->after  = std::numeric_limits<sql::row_id>::min();
+            if (resultCache) resultCache->clear();
+            return *this;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Parallel execution.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Run the search on several threads during iteration. The rowid range of the instance table is split
+         * into chunks, which threads evaluate on their own read-only connection (see Library::openReadConnection).
+         * Results are collected before the first one is returned. Worthwhile for predicates that scan large tables,
+         * not for searches that an index answers directly. Only searches ordered by rowid run in parallel, and only on
+         * libraries that are stored in a file. Others keep running serially, as do count, exists and visit.
+         *
+         * Each thread reads its own snapshot of the library, taken when it starts. Changes committed by other
+         * connections while the search runs can therefore be visible to some chunks and not to others, so that the
+         * results can differ from those of a serial search. Uncommitted changes of the library's own connection are
+         * never visible to the threads, which is why iterations that start while a transaction is open on that
+         * connection run serially.
+         * \param threads Number of threads. 0 uses the number of hardware threads. 1 disables parallel execution.
+         * \param order Order of the results.
+         * \return *this.
+         */
+        SearchQuery& parallel(const size_t threads = 0, const ParallelOrder order = ParallelOrder::Rowid)
+            requires(requires(statement_t& stmt, const Library& lib) {
+                stmt.setParallel(lib, size_t{0}, ParallelOrder::Rowid);
+            })
+        {
+            const auto count = threads == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : threads;
+            statement.setParallel(getLibrary(), count, order);
+            if (resultCache) resultCache->clear();
+            return *this;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Caching.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Cache the results of iterations, keyed by the values of the parameters and the limit, offset and
+         * keyset filter. Iterating again with the same values returns the stored results without running the
+         * statement, until a table of the searched type is modified. Modifications through this library are detected
+         * by its sqlite update hook, modifications by other connections by PRAGMA data_version, which is checked on
+         * every iteration. Results are fully collected before the first one is returned. Results found while a
+         * transaction is open are not stored. Count, exists and visit are not cached.
+         * \param capacity Maximum number of cached parameter combinations. 0 disables the cache.
+         * \return *this.
+         */
+        SearchQuery& cache(const size_t capacity = 64)
+            requires(std::totally_ordered<Ps> && ...)
+        {
+            if (capacity == 0)
+                resultCache.reset();
+            else
+                resultCache = std::make_unique<cache_t>(getLibrary(), descriptor.getType(), capacity);
+            return *this;
+        }
+
+        /**
+         * \brief Get the result cache.
+         * \return Cache, or nullptr if caching is disabled.
+         */
+        [[nodiscard]] const cache_t* getCache() const noexcept { return resultCache.get(); }
+
+        ////////////////////////////////////////////////////////////////
+        // Aggregation.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Count the instances matching the current parameters, without retrieving their identifiers. Limit and
+         * offset are ignored. The keyset filter is ignored by searches compiled by this library. Other statements are
+         * iterated instead, so a keyset filter in their WHERE clause applies. Must be called after invoking the query
+         * with its parameters.
+         * \return Number of instances.
+         */
+        [[nodiscard]] int64_t count()
+        {
+            QueryProfile profile(getLibrary(), descriptor.getType(), QueryClass::Search);
+            profile.stage(QueryStage::Execute);
+            if constexpr (requires { statement.count(); })
+                return statement.count();
+            else
+            {
+                int64_t n = 0;
+                for (auto it = statement.begin(); it != statement.end(); ++it) n++;
+                return n;
+            }
+        }
+
+        /**
+         * \brief Check whether any instance matches the current parameters. Stops at the first match. Limit and offset
+         * are ignored. The keyset filter is ignored by searches compiled by this library. Other statements are
+         * iterated instead, so a keyset filter in their WHERE clause applies. Must be called after invoking the query
+         * with its parameters.
+         * \return True if at least one instance matches.
+         */
+        [[nodiscard]] bool exists()
+        {
+            QueryProfile profile(getLibrary(), descriptor.getType(), QueryClass::Search);
+            profile.stage(QueryStage::Execute);
+            if constexpr (requires { statement.exists(); })
+                return statement.exists();
+            else
+                return statement.begin() != statement.end();
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Merging.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Retrieve the first results matching the current parameters in order, together with the values they are
+         * ordered by. Limit, offset and keyset filter of the query are neither applied nor changed. Used to merge the
+         * results of the same search on several libraries (see ShardedSearchQuery). Must be called after invoking the
+         * query with its parameters.
+         * \param count Maximum number of results. Negative for no limit.
+         * \return Results.
+         */
+        [[nodiscard]] detail::OrderedResults collect(const int64_t count)
+        {
+            QueryProfile profile(getLibrary(), descriptor.getType(), QueryClass::Search);
+            profile.stage(QueryStage::Execute);
+            if constexpr (requires { statement.collect(count); })
+                return statement.collect(count);
+            else
+            {
+                // Other statements are ordered by rowid or not at all, so there are no values to return.
+                detail::OrderedResults results;
+                const auto max = count < 0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(count);
+                for (auto it = iterator_t(statement.begin(), statement.end(), 0, max); it != end(); ++it)
+                    results.ids.emplace_back(*it);
+                return results;
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Visit.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Visit the instances matching the current parameters without materializing them. The callback receives
+         * a RowView of each instance table row, which exposes strings and blobs as views directly into the statement
+         * buffers, the shared blobs of deduplicated members and the pack file of external members. These are only
+         * valid for the duration of the callback. Members with a codec cannot be viewed. The callback can return false
+         * to stop the visit early. Limit, offset, keyset filter and ordering are applied. Must be called after invoking
+         * the query with its parameters.
+         *
+         * \code
+         * query(10.0f).visit([&](const alex::RowView<D>& row) { total += row.get<"name">().size(); });
+         * \endcode
+         *
+         * \tparam F Callback type.
+         * \param f Callback.
+         */
+        template<typename F>
+            requires(std::invocable<F&, RowView<T>> &&
+                     requires(statement_t& stmt, const std::string& columns, bool (*row)(const RawStatement&)) {
+                         stmt.visit(columns, row);
+                     })
+        void visit(F&& f)
+        {
+            QueryProfile profile(getLibrary(), descriptor.getType(), QueryClass::Search);
+            profile.stage(QueryStage::Execute);
+
+            // Resolve deduplicated members to the shared blob.
+            const auto&          type     = descriptor.getType();
+            const auto           formats  = detail::getBlobFormats<typename RowView<T>::members_t>(type);
+            const ExternalStore* external = detail::hasExternal(formats) ? &detail::getExternalStore(type) : nullptr;
+            statement.visit(detail::selectInstanceColumns(type, formats, "i."), [&](const RawStatement& row) {
+                return detail::visitRow<type_descriptor_t>(f, row, formats, external);
+            });
+        }
+
         ////////////////////////////////////////////////////////////////
         // ...
         ////////////////////////////////////////////////////////////////
 
-        auto begin() { return statement.begin(); }
+        /**
+         * \brief Iterate over the results. Rows are stepped lazily, so iteration is not reported as a query stage. The
+         * statement is still reported to the query observer of the library when it finishes. With a result cache (see
+         * cache), the results are looked up or collected first.
+         * \return Iterator.
+         */
+        iterator_t begin()
+        {
+            if (!resultCache) return beginStatement();
 
-        auto end() { return statement.end(); }
+            auto  key = getCacheKey();
+            auto* ids = resultCache->find(key);
+            if (!ids)
+            {
+                std::vector<InstanceId> found;
+                for (auto it = beginStatement(); it != end(); ++it) found.emplace_back(*it);
+                ids = &resultCache->insert(std::move(key), std::move(found));
+            }
+            return iterator_t(ids->data(), ids->data() + ids->size(), statement.end());
+        }
+
+        iterator_t end() { return iterator_t(statement.end(), statement.end(), 0, 0); }
 
         template<typename... Ts>
             requires(sizeof...(Ts) == sizeof...(Ps))
@@ -75,12 +645,39 @@ namespace alex
                     return std::forward<P>(param);
             };
 
+            QueryProfile profile(getLibrary(), descriptor.getType(), QueryClass::Search);
+            profile.stage(QueryStage::Bind);
             bind<0>(get(std::forward<Ts>(params))...);
             statement.bind(sql::BindParameters::Dynamic);
             return *this;
         }
 
     private:
+        [[nodiscard]] Library& getLibrary() { return descriptor.getType().getNamespace().getLibrary(); }
+
+        iterator_t beginStatement()
+        {
+            // Statements that apply paging themselves are iterated as-is.
+            if constexpr (requires { requires statement_t::paged; })
+                return iterator_t(statement.begin(), statement.end(), 0, std::numeric_limits<uint64_t>::max());
+            else
+            {
+                const auto skip  = static_cast<uint64_t>(std::max<int64_t>(paging->offset, 0));
+                const auto count = paging->limit < 0 ? std::numeric_limits<uint64_t>::max() :
+                                                       static_cast<uint64_t>(paging->limit);
+                return iterator_t(statement.begin(), statement.end(), skip, count);
+            }
+        }
+
+        [[nodiscard]] cache_key_t getCacheKey() const
+        {
+            return std::apply(
+              [this](const auto&... params) {
+                  return cache_key_t(*params..., paging->limit, paging->offset, paging->after);
+              },
+              parameters);
+        }
+
         template<size_t I, typename Param, typename... Params>
         void bind(Param&& param, Params&&... params)
         {
@@ -100,8 +697,10 @@ namespace alex
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
-        type_descriptor_t descriptor;
-        statement_t       statement;
-        parameters_t      parameters;
+        type_descriptor_t                     descriptor;
+        statement_t                           statement;
+        parameters_t                          parameters;
+        std::unique_ptr<detail::SearchPaging> paging;
+        std::unique_ptr<cache_t>              resultCache;
     };
 }  // namespace alex
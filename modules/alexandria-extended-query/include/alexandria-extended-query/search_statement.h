@@ -0,0 +1,661 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/properties/instance_id.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_query.h"
+
+namespace alex::detail
+{
+    /**
+     * \brief Term of the order of a search.
+     */
+    struct OrderTerm
+    {
+        /**
+         * \brief SQL expression.
+         */
+        std::string expression;
+
+        /**
+         * \brief Sort direction.
+         */
+        Order order = Order::Ascending;
+    };
+
+    /**
+     * \brief Generated SQL of a search, split into its clauses so that other statements (e.g. counts) can be derived
+     * from it. The instance table is always aliased as "i".
+     */
+    struct SearchSql
+    {
+        /**
+         * \brief Quoted name of the instance table.
+         */
+        std::string table;
+
+        /**
+         * \brief Joins with other tables, appended to the instance table. Either empty or starting with a space.
+         */
+        std::string join;
+
+        /**
+         * \brief Boolean expression selecting instances.
+         */
+        std::string where;
+
+        /**
+         * \brief Ordering terms.
+         */
+        std::vector<OrderTerm> orderBy = {{"i.id", Order::Ascending}};
+
+        /**
+         * \brief Whether results are ordered by rowid, making keyset pagination possible.
+         */
+        bool keyset = true;
+
+        /**
+         * \brief Unqualified names of all columns of the instance table, used to resolve ordering keys.
+         */
+        std::vector<std::string> columns;
+
+        /**
+         * \brief Build a statement selecting the given columns of all matching instances. Keyset filter and paging
+         * parameters are included when requested.
+         * \param columns Result columns.
+         * \param paged Include keyset filter, order and limit.
+         * \return SQL string.
+         */
+        [[nodiscard]] std::string select(const std::string& columns, const bool paged = true) const
+        {
+            if (!paged) return std::format("SELECT {} FROM {} AS i{} WHERE {};", columns, table, join, where);
+
+            std::string order;
+            for (const auto& term : orderBy)
+                order += std::format("{}{} {}",
+                                     order.empty() ? "" : ", ",
+                                     term.expression,
+                                     term.order == Order::Ascending ? "ASC" : "DESC");
+
+            return std::format("SELECT {} FROM {} AS i{} WHERE ({}){} ORDER BY {} LIMIT :limit OFFSET :offset;",
+                               columns,
+                               table,
+                               join,
+                               where,
+                               keyset ? " AND i.id > :after" : "",
+                               order);
+        }
+
+        /**
+         * \brief Build a statement selecting the given columns of the matching instances within a range of rowids,
+         * ordered by rowid. Used to evaluate a search in chunks on several threads.
+         * \param columns Result columns.
+         * \return SQL string.
+         */
+        [[nodiscard]] std::string range(const std::string& columns) const
+        {
+            return std::format(
+              "SELECT {} FROM {} AS i{} WHERE ({}) AND i.id BETWEEN :lo AND :hi ORDER BY i.id ASC LIMIT :limit;",
+              columns,
+              table,
+              join,
+              where);
+        }
+
+        /**
+         * \brief Build a statement that counts all matching instances.
+         * \return SQL string.
+         */
+        [[nodiscard]] std::string count() const { return select("COUNT(*)", false); }
+
+        /**
+         * \brief Build a statement that returns whether there is at least one matching instance.
+         * \return SQL string.
+         */
+        [[nodiscard]] std::string exists() const
+        {
+            return std::format("SELECT EXISTS (SELECT 1 FROM {} AS i{} WHERE {});", table, join, where);
+        }
+    };
+
+    /**
+     * \brief Statement backing a SearchQuery that was compiled from generated SQL. Iterating it yields InstanceIds.
+     * Limit, offset and keyset filter are part of the SQL and are rebound every time iteration starts. In parallel
+     * mode, iteration evaluates the search on all threads first and then walks the collected results.
+     */
+    class SearchStatement
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Function binding a search parameter to a statement.
+         */
+        using binder_t = std::function<void(RawStatement&)>;
+
+        /**
+         * \brief Paging is applied by the statement itself.
+         */
+        static constexpr bool paged = true;
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = InstanceId;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = InstanceId;
+
+            iterator() = default;
+
+            explicit iterator(RawStatement& stmt) : statement(&stmt) { advance(); }
+
+            iterator(const InstanceId* first, const InstanceId* last) :
+                position(first == last ? nullptr : first), end(last)
+            {
+            }
+
+            [[nodiscard]] InstanceId operator*() const
+            {
+                return position ? *position : InstanceId(std::string(statement->getText(0)));
+            }
+
+            iterator& operator++()
+            {
+                advance();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                auto tmp = *this;
+                advance();
+                return tmp;
+            }
+
+            [[nodiscard]] bool operator==(const iterator& other) const noexcept
+            {
+                return statement == other.statement && position == other.position;
+            }
+
+        private:
+            void advance()
+            {
+                if (position)
+                {
+                    if (++position == end) position = nullptr;
+                }
+                else if (!statement->step())
+                    statement = nullptr;
+            }
+
+            RawStatement*     statement = nullptr;
+            const InstanceId* position  = nullptr;
+            const InstanceId* end       = nullptr;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        SearchStatement() = delete;
+
+        SearchStatement(sql::Database& db, SearchSql searchSql, std::vector<binder_t> bs, const SearchPaging& pag) :
+            database(&db),
+            parts(std::move(searchSql)),
+            defaultOrder(parts.orderBy),
+            statement(db, parts.select("i.uuid")),
+            binders(std::move(bs)),
+            paging(&pag)
+        {
+        }
+
+        SearchStatement(const SearchStatement&) = delete;
+
+        SearchStatement(SearchStatement&&) noexcept = default;
+
+        ~SearchStatement() noexcept = default;
+
+        SearchStatement& operator=(const SearchStatement&) = delete;
+
+        SearchStatement& operator=(SearchStatement&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] sql::Database& getDatabase() const noexcept { return *database; }
+
+        [[nodiscard]] const SearchSql& getSearchSql() const noexcept { return parts; }
+
+        [[nodiscard]] const std::string& getSql() const noexcept { return statement.getSql(); }
+
+        ////////////////////////////////////////////////////////////////
+        // Binding.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Bind the current values of all search parameters.
+         * \return *this.
+         */
+        SearchStatement& bind(sql::BindParameters)
+        {
+            statement.reset();
+            statement.clearBindings();
+            bindParameters(statement);
+            return *this;
+        }
+
+        /**
+         * \brief Bind the current values of all search parameters to a statement derived from the same SQL.
+         * \param stmt Statement.
+         */
+        void bindParameters(RawStatement& stmt) const
+        {
+            for (const auto& binder : binders) binder(stmt);
+        }
+
+        /**
+         * \brief Bind the current paging values to a statement derived from the same SQL.
+         * \param stmt Statement.
+         */
+        void bindPaging(RawStatement& stmt) const
+        {
+            stmt.bind(":limit", paging->limit);
+            stmt.bind(":offset", std::max<int64_t>(paging->offset, 0));
+            stmt.bind(":after", paging->after);
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Ordering.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add an ordering key on a column of the instance table and recompile the statement. Keys take
+         * precedence over the default order of the search. The current parameter values are bound to the new
+         * statement.
+         * \param column Column index.
+         * \param order Sort direction.
+         */
+        void orderBy(const size_t column, const Order order)
+        {
+            orderKeys.push_back({"i." + quoteIdentifier(parts.columns.at(column)), order});
+
+            // Break ties by rowid in the direction of the last key. An index on a single key then produces the
+            // complete order without a separate sort, since index entries are ordered by (value, rowid).
+            parts.orderBy = orderKeys;
+            if (defaultOrder.size() == 1 && defaultOrder.front().expression == "i.id")
+                parts.orderBy.push_back({"i.id", order});
+            else
+                parts.orderBy.insert(parts.orderBy.end(), defaultOrder.begin(), defaultOrder.end());
+            parts.keyset = false;
+
+            statement = RawStatement(*database, parts.select("i.uuid"));
+            bindParameters(statement);
+            visitStatement   = RawStatement();
+            collectStatement = RawStatement();
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Parallel execution.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Evaluate the search on several threads during iteration, each with its own read-only connection to the
+         * library. Has no effect on in-memory libraries, since they cannot be opened by another connection, and on
+         * searches that are not ordered by rowid. Iterations that start while a transaction is open on the connection
+         * of the library run serially.
+         * \param library Library.
+         * \param threads Number of threads. Values smaller than 2 disable parallel execution.
+         * \param order Order of the results.
+         */
+        void setParallel(const Library& library, const size_t threads, const ParallelOrder order)
+        {
+            parallelLibrary = &library;
+            boundsStatement = RawStatement();
+            readers.clear();
+            results.clear();
+            parallelOrder = order;
+            if (threads < 2) return;
+
+            for (size_t i = 0; i < threads; i++)
+            {
+                auto db = library.openReadConnection();
+                if (!db)
+                {
+                    readers.clear();
+                    return;
+                }
+                auto stmt = RawStatement(*db, parts.range("i.uuid"));
+                readers.push_back(Reader{std::move(db), std::move(stmt)});
+            }
+
+            boundsStatement =
+              RawStatement(*readers.front().database, std::format("SELECT min(id), max(id) FROM {};", parts.table));
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Aggregation.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Count all instances matching the current parameter values. Paging is ignored. The statement is
+         * prepared on first use.
+         * \return Number of instances.
+         */
+        [[nodiscard]] int64_t count()
+        {
+            if (!countStatement.get()) countStatement = RawStatement(*database, parts.count());
+            countStatement.reset();
+            countStatement.clearBindings();
+            bindParameters(countStatement);
+            countStatement.step();
+            return countStatement.getInt64(0);
+        }
+
+        /**
+         * \brief Check whether any instance matches the current parameter values. Paging is ignored. The statement is
+         * prepared on first use.
+         * \return True if at least one instance matches.
+         */
+        [[nodiscard]] bool exists()
+        {
+            if (!existsStatement.get()) existsStatement = RawStatement(*database, parts.exists());
+            existsStatement.reset();
+            existsStatement.clearBindings();
+            bindParameters(existsStatement);
+            existsStatement.step();
+            return existsStatement.getInt64(0) != 0;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Visit.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Step through all matching instances in order, applying paging, and invoke a callback for each row.
+         * The statement is prepared on first use, and again when the selected columns change.
+         * \tparam F Callback type. Invoked with a const RawStatement& positioned on the row. Returns false to stop.
+         * \param columns Selected columns of the instance table, which has alias i.
+         * \param f Callback.
+         */
+        template<typename F>
+        void visit(const std::string& columns, F&& f)
+        {
+            if (!visitStatement.get() || columns != visitColumns)
+            {
+                visitStatement = RawStatement(*database, parts.select(columns));
+                visitColumns   = columns;
+            }
+
+            // Always reset the statement, so that the database is not kept locked by a pending read.
+            ScopedReset reset{visitStatement};
+
+            visitStatement.reset();
+            visitStatement.clearBindings();
+            bindParameters(visitStatement);
+            bindPaging(visitStatement);
+            while (visitStatement.step())
+                if (!f(std::as_const(visitStatement))) break;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Merging.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Retrieve the first matching instances in order, together with the values of their ordering terms.
+         * Paging is ignored. Ties are broken by uuid instead of rowid, so that results of the same search on several
+         * libraries can be merged. Results that are only ordered by rowid are returned without values. The statement
+         * is prepared on first use.
+         * \param count Maximum number of results. Negative for no limit.
+         * \return Results.
+         */
+        [[nodiscard]] OrderedResults collect(const int64_t count)
+        {
+            OrderedResults ordered;
+            std::string    columns = "i.uuid";
+            SearchSql      merged  = parts;
+            merged.orderBy.clear();
+            for (const auto& term : parts.orderBy)
+            {
+                if (term.expression == "i.id") continue;
+                columns += ", " + term.expression;
+                ordered.order.emplace_back(term.order);
+                merged.orderBy.emplace_back(term);
+            }
+            if (ordered.order.empty())
+                merged.orderBy = parts.orderBy;
+            else
+                merged.orderBy.push_back({"i.uuid", Order::Ascending});
+
+            if (!collectStatement.get()) collectStatement = RawStatement(*database, merged.select(columns));
+
+            // Always reset the statement, so that the database is not kept locked by a pending read.
+            ScopedReset reset{collectStatement};
+
+            collectStatement.reset();
+            collectStatement.clearBindings();
+            bindParameters(collectStatement);
+            collectStatement.bind(":limit", count);
+            collectStatement.bind(":offset", int64_t{0});
+            collectStatement.bind(":after", std::numeric_limits<sql::row_id>::min());
+
+            const auto n = static_cast<int32_t>(ordered.order.size());
+            while (collectStatement.step())
+            {
+                ordered.ids.emplace_back(std::string(collectStatement.getText(0)));
+                for (int32_t i = 1; i <= n; i++)
+                {
+                    if (collectStatement.isNull(i))
+                        ordered.values.emplace_back();
+                    else if (collectStatement.isInteger(i))
+                        ordered.values.emplace_back(collectStatement.getInt64(i));
+                    else if (collectStatement.isText(i))
+                        ordered.values.emplace_back(std::string(collectStatement.getText(i)));
+                    else
+                        ordered.values.emplace_back(collectStatement.getDouble(i));
+                }
+            }
+
+            return ordered;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Iteration.
+        ////////////////////////////////////////////////////////////////
+
+        iterator begin()
+        {
+            // Readers cannot see the changes of an open transaction on the connection of the library.
+            if (!readers.empty() && parts.keyset && !parallelLibrary->isInTransaction())
+            {
+                runParallel();
+                return iterator(results.data(), results.data() + results.size());
+            }
+
+            statement.reset();
+            bindPaging(statement);
+            return iterator(statement);
+        }
+
+        iterator end() { return iterator(); }
+
+    private:
+        /**
+         * \brief Read-only connection used by one thread of a parallel search, with the statement that evaluates a
+         * chunk. The statement is declared last, so that it is finalized before the connection is closed.
+         */
+        struct Reader
+        {
+            sql::DatabasePtr database;
+            RawStatement     statement;
+        };
+
+        /**
+         * \brief Evaluate the search on all readers and collect the page of results.
+         */
+        void runParallel()
+        {
+            results.clear();
+
+            // Get the range of rowids to search, taking the keyset filter into account.
+            boundsStatement.reset();
+            if (!boundsStatement.step() || boundsStatement.isNull(0))
+            {
+                boundsStatement.reset();
+                return;
+            }
+            const auto lowest = boundsStatement.getInt64(0);
+            const auto last   = boundsStatement.getInt64(1);
+            boundsStatement.reset();
+            if (paging->after >= last) return;
+            const auto first = std::max<int64_t>(lowest, paging->after + 1);
+
+            // Each chunk returns at most the number of results needed to fill the page. There are several chunks per
+            // thread, so that threads that finish early take over the work of threads with expensive chunks.
+            const auto skip       = std::max<int64_t>(paging->offset, 0);
+            const auto needed     = paging->limit < 0 ? int64_t{-1} : skip + paging->limit;
+            const auto span       = static_cast<uint64_t>(last) - static_cast<uint64_t>(first) + 1;
+            const auto chunkCount = std::min<uint64_t>(readers.size() * 4, span);
+            const auto chunkSize  = (span + chunkCount - 1) / chunkCount;
+            const auto ordered    = parallelOrder == ParallelOrder::Rowid;
+
+            // Ordered results are collected per chunk and unordered results per thread.
+            std::vector<std::vector<InstanceId>> collected(ordered ? chunkCount : readers.size());
+            std::vector<std::exception_ptr>      errors(readers.size());
+            std::atomic<uint64_t>                nextChunk = 0;
+            std::atomic<int64_t>                 found     = 0;
+            std::atomic<bool>                    stop      = false;
+
+            // Without ordering, threads stop as soon as enough results were found to fill the page. With ordering,
+            // they stop once the finished chunks preceding all unfinished chunks hold enough results.
+            const auto enough = [&] {
+                if (stop.load(std::memory_order_relaxed)) return true;
+                return !ordered && needed >= 0 && found.load(std::memory_order_relaxed) >= needed;
+            };
+
+            std::mutex        prefixMutex;
+            std::vector<char> finished(ordered ? chunkCount : 0, 0);
+            uint64_t          prefixChunks  = 0;
+            int64_t           prefixResults = 0;
+
+            const auto finishChunk = [&](const uint64_t c) {
+                std::scoped_lock lock(prefixMutex);
+                finished[c] = 1;
+                for (; prefixChunks < chunkCount && finished[prefixChunks]; prefixChunks++)
+                    prefixResults += static_cast<int64_t>(collected[prefixChunks].size());
+                if (needed >= 0 && prefixResults >= needed) stop.store(true, std::memory_order_relaxed);
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(readers.size());
+            for (size_t t = 0; t < readers.size(); t++)
+            {
+                threads.emplace_back([&, t] {
+                    try
+                    {
+                        // Always reset the statement, so that the connection does not keep a read transaction open.
+                        ScopedReset reset{readers[t].statement};
+
+                        auto& stmt = readers[t].statement;
+                        stmt.reset();
+                        stmt.clearBindings();
+                        bindParameters(stmt);
+                        stmt.bind(":limit", needed);
+
+                        for (auto c = nextChunk++; c < chunkCount && !enough(); c = nextChunk++)
+                        {
+                            const auto lo = static_cast<uint64_t>(first) + c * chunkSize;
+                            const auto hi = std::min(lo + chunkSize - 1, static_cast<uint64_t>(last));
+                            stmt.reset();
+                            stmt.bind(":lo", static_cast<int64_t>(lo));
+                            stmt.bind(":hi", static_cast<int64_t>(hi));
+
+                            auto& out      = collected[ordered ? c : t];
+                            auto  complete = false;
+                            while (!enough())
+                            {
+                                if (!stmt.step())
+                                {
+                                    complete = true;
+                                    break;
+                                }
+                                out.emplace_back(std::string(stmt.getText(0)));
+                                found.fetch_add(1, std::memory_order_relaxed);
+                            }
+                            if (ordered && complete) finishChunk(c);
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+            for (auto& thread : threads) thread.join();
+            for (const auto& error : errors)
+                if (error) std::rethrow_exception(error);
+
+            for (auto& ids : collected)
+                results.insert(results.end(), std::make_move_iterator(ids.begin()), std::make_move_iterator(ids.end()));
+
+            const auto from = std::min(static_cast<size_t>(skip), results.size());
+            const auto to   = needed < 0 ? results.size() : std::min(static_cast<size_t>(needed), results.size());
+            results.erase(results.begin() + static_cast<std::ptrdiff_t>(to), results.end());
+            results.erase(results.begin(), results.begin() + static_cast<std::ptrdiff_t>(from));
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        sql::Database*          database = nullptr;
+        SearchSql               parts;
+        std::vector<OrderTerm>  defaultOrder;
+        std::vector<OrderTerm>  orderKeys;
+        RawStatement            statement;
+        RawStatement            countStatement;
+        RawStatement            existsStatement;
+        RawStatement            visitStatement;
+        std::string             visitColumns;
+        RawStatement            collectStatement;
+        std::vector<binder_t>   binders;
+        const SearchPaging*     paging          = nullptr;
+        const Library*          parallelLibrary = nullptr;
+        ParallelOrder           parallelOrder   = ParallelOrder::Rowid;
+        std::vector<Reader>     readers;
+        RawStatement            boundsStatement;
+        std::vector<InstanceId> results;
+    };
+}  // namespace alex::detail
@@ -0,0 +1,265 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/properties/instance_id.h"
+#include "alexandria-core/sharded_library.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-extended-query/search_query.h"
+
+namespace alex
+{
+    /**
+     * \brief Runs a SearchQuery on every shard of a ShardedLibrary in parallel and merges the results. Results of
+     * ordered queries (SearchQuery::orderBy, textSearch, nearestSearch) are merged by the values they are ordered by,
+     * with ties broken by identifier. Note that the rank of a text search is computed from the statistics of each
+     * shard. Results of queries that are ordered by rowid are concatenated in shard order, since rowids are only
+     * unique within a shard. Limit and offset apply to the merged results. The paging of the per-shard queries is
+     * ignored. Keyset pagination (SearchQuery::after) is not supported.
+     * \tparam Q SearchQuery type.
+     */
+    template<typename Q>
+    class ShardedSearchQuery
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using query_t = Q;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ShardedSearchQuery() = delete;
+
+        /**
+         * \brief Construct from one query per shard.
+         * \param lib Library.
+         * \param qs Queries, in shard order.
+         */
+        ShardedSearchQuery(ShardedLibrary& lib, std::vector<query_t> qs) : library(&lib), queries(std::move(qs))
+        {
+            if (queries.size() != library->getShardCount())
+                throw std::runtime_error("A ShardedSearchQuery needs exactly one query per shard.");
+        }
+
+        ShardedSearchQuery(const ShardedSearchQuery&) = delete;
+
+        ShardedSearchQuery(ShardedSearchQuery&& other) noexcept = default;
+
+        ~ShardedSearchQuery() noexcept = default;
+
+        ShardedSearchQuery& operator=(const ShardedSearchQuery&) = delete;
+
+        ShardedSearchQuery& operator=(ShardedSearchQuery&& other) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] query_t& getQuery(const size_t index) { return queries.at(index); }
+
+        ////////////////////////////////////////////////////////////////
+        // Paging.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Limit the number of returned instances. Applies to all following calls to get.
+         * \param count Maximum number of instances. Negative to remove the limit.
+         * \return *this.
+         */
+        ShardedSearchQuery& limit(const int64_t count) noexcept
+        {
+            maxCount = count;
+            return *this;
+        }
+
+        /**
+         * \brief Skip a number of instances. Applies to all following calls to get. Each shard still retrieves the
+         * skipped instances.
+         * \param count Number of instances to skip.
+         * \return *this.
+         */
+        ShardedSearchQuery& offset(const int64_t count) noexcept
+        {
+            skipCount = count;
+            return *this;
+        }
+
+        /**
+         * \brief Remove limit and offset.
+         * \return *this.
+         */
+        ShardedSearchQuery& resetPaging() noexcept
+        {
+            maxCount  = -1;
+            skipCount = 0;
+            return *this;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Execution.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Bind the same parameters to the query of every shard.
+         * \tparam Ts Parameter types.
+         * \param params Parameters.
+         * \return *this.
+         */
+        template<typename... Ts>
+        ShardedSearchQuery& operator()(const Ts&... params)
+        {
+            for (auto& query : queries) query(params...);
+            return *this;
+        }
+
+        /**
+         * \brief Retrieve the identifiers of the matching instances from all shards. Must be called after invoking the
+         * query with its parameters.
+         * \return Identifiers.
+         */
+        [[nodiscard]] std::vector<InstanceId> get()
+        {
+            // Every shard must return enough instances to fill the page on its own.
+            const auto skip     = std::max<int64_t>(skipCount, 0);
+            const auto perShard = maxCount < 0 ? int64_t{-1} : skip + maxCount;
+
+            std::vector<detail::OrderedResults> results(queries.size());
+            library->parallel([&](const size_t i) { results[i] = queries[i].collect(perShard); });
+
+            auto       ids   = merge(results, perShard);
+            const auto first = std::min(static_cast<size_t>(skip), ids.size());
+            const auto last  = maxCount < 0 ? ids.size() : std::min(first + static_cast<size_t>(maxCount), ids.size());
+            ids.erase(ids.begin() + static_cast<std::ptrdiff_t>(last), ids.end());
+            ids.erase(ids.begin(), ids.begin() + static_cast<std::ptrdiff_t>(first));
+            return ids;
+        }
+
+        /**
+         * \brief Count the instances matching the current parameters on all shards. Limit and offset are ignored.
+         * \return Number of instances.
+         */
+        [[nodiscard]] int64_t count()
+        {
+            std::vector<int64_t> counts(queries.size());
+            library->parallel([&](const size_t i) { counts[i] = queries[i].count(); });
+            int64_t total = 0;
+            for (const auto n : counts) total += n;
+            return total;
+        }
+
+        /**
+         * \brief Check whether any instance on any shard matches the current parameters. Limit and offset are ignored.
+         * \return True if at least one instance matches.
+         */
+        [[nodiscard]] bool exists()
+        {
+            // Not std::vector<bool>, since the shards write to it concurrently.
+            std::vector<uint8_t> found(queries.size());
+            library->parallel([&](const size_t i) { found[i] = queries[i].exists() ? 1 : 0; });
+            return std::ranges::any_of(found, [](const uint8_t f) { return f != 0; });
+        }
+
+    private:
+        /**
+         * \brief Merge the results of all shards.
+         * \param results Results of each shard. Identifiers are moved out.
+         * \param count Maximum number of merged results. Negative for no limit.
+         * \return Identifiers.
+         */
+        [[nodiscard]] static std::vector<InstanceId> merge(std::vector<detail::OrderedResults>& results,
+                                                           const int64_t                        count)
+        {
+            std::vector<InstanceId> ids;
+            if (results.empty() || results.front().order.empty())
+            {
+                for (auto& result : results)
+                    ids.insert(ids.end(),
+                               std::make_move_iterator(result.ids.begin()),
+                               std::make_move_iterator(result.ids.end()));
+                return ids;
+            }
+
+            // k-way merge. The heap holds the position of the next result of every shard that has results left.
+            using cursor_t     = std::pair<size_t, size_t>;
+            const auto greater = [&results](const cursor_t& lhs, const cursor_t& rhs) {
+                return results[lhs.first].compare(lhs.second, results[rhs.first], rhs.second) > 0;
+            };
+            std::priority_queue<cursor_t, std::vector<cursor_t>, decltype(greater)> heap(greater);
+            for (size_t i = 0; i < results.size(); i++)
+                if (!results[i].ids.empty()) heap.emplace(i, 0);
+
+            while (!heap.empty() && (count < 0 || ids.size() < static_cast<size_t>(count)))
+            {
+                const auto [shard, index] = heap.top();
+                heap.pop();
+                ids.emplace_back(std::move(results[shard].ids[index]));
+                if (index + 1 < results[shard].ids.size()) heap.emplace(shard, index + 1);
+            }
+
+            return ids;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        ShardedLibrary* library = nullptr;
+
+        std::vector<query_t> queries;
+
+        int64_t maxCount = -1;
+
+        int64_t skipCount = 0;
+    };
+
+    /**
+     * \brief Construct a ShardedSearchQuery from a function that constructs the SearchQuery of a single shard.
+     *
+     * \code
+     * auto search = alex::shardedSearch(*library, [](alex::Library& shard) {
+     *     return alex::primitiveSearch(FooDescriptor(shard.getNamespace("main").getType("foo")),
+     *                                  alex::equal<FooDescriptor, "a">());
+     * });
+     * const auto ids = search(10).get();
+     * \endcode
+     *
+     * \tparam F Callable taking a Library& and returning a SearchQuery.
+     * \param library Library.
+     * \param makeQuery Function that is called once for each shard.
+     * \return ShardedSearchQuery.
+     */
+    template<std::invocable<Library&> F>
+    [[nodiscard]] auto shardedSearch(ShardedLibrary& library, F&& makeQuery)
+    {
+        using query_t = std::invoke_result_t<F&, Library&>;
+
+        std::vector<query_t> queries;
+        queries.reserve(library.getShardCount());
+        for (size_t i = 0; i < library.getShardCount(); i++) queries.emplace_back(makeQuery(library.getShard(i)));
+        return ShardedSearchQuery<query_t>(library, std::move(queries));
+    }
+}  // namespace alex
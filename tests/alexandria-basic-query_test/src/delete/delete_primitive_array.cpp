@@ -79,7 +79,7 @@ void DeletePrimitiveArray::operator()()
 
     // Delete Foo.
     {
-        const sql::TypedTable<sql::row_id, std::string, float> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, float, int64_t> arrayTable(
           library->getDatabase().getTable("main_foo_prop0"));
 
         auto inserter = alex::InsertQuery(FooDescriptor(fooType));
@@ -113,7 +113,7 @@ void DeletePrimitiveArray::operator()()
 
     // Delete Bar.
     {
-        const sql::TypedTable<sql::row_id, std::string, int32_t> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, int32_t, int64_t> arrayTable(
           library->getDatabase().getTable("main_bar_prop0"));
 
         auto inserter = alex::InsertQuery(BarDescriptor(barType));
@@ -147,9 +147,9 @@ void DeletePrimitiveArray::operator()()
 
     // Delete Baz.
     {
-        const sql::TypedTable<sql::row_id, std::string, uint32_t> array0Table(
+        const sql::TypedTable<sql::row_id, std::string, uint32_t, int64_t> array0Table(
           library->getDatabase().getTable("main_baz_prop0"));
-        const sql::TypedTable<sql::row_id, std::string, double> array1Table(
+        const sql::TypedTable<sql::row_id, std::string, double, int64_t> array1Table(
           library->getDatabase().getTable("main_baz_prop1"));
 
         auto inserter = alex::InsertQuery(BazDescriptor(bazType));
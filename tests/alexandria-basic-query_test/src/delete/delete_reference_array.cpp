@@ -98,9 +98,9 @@ void DeleteReferenceArray::operator()()
 
     // Delete Baz.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::string> array0Table(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> array0Table(
           library->getDatabase().getTable("main_baz_prop0"));
-        const sql::TypedTable<sql::row_id, std::string, std::string> array1Table(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> array1Table(
           library->getDatabase().getTable("main_baz_prop1"));
 
         auto deleter = alex::DeleteQuery(BazDescriptor(bazType));
@@ -129,7 +129,7 @@ void DeleteReferenceArray::operator()()
 
     // Delete Bar.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::string> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> arrayTable(
           library->getDatabase().getTable("main_bar_prop0"));
         auto deleter = alex::DeleteQuery(BarDescriptor(barType));
 
@@ -66,7 +66,7 @@ void DeleteStringArray::operator()()
 
     // Delete Foo.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::string> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> arrayTable(
           library->getDatabase().getTable("main_foo_prop0"));
 
         auto inserter = alex::InsertQuery(FooDescriptor(fooType));
@@ -100,9 +100,9 @@ void DeleteStringArray::operator()()
 
     // Insert Bar.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::string> array0Table(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> array0Table(
           library->getDatabase().getTable("main_bar_prop0"));
-        const sql::TypedTable<sql::row_id, std::string, std::string> array1Table(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> array1Table(
           library->getDatabase().getTable("main_bar_prop1"));
 
         auto inserter = alex::InsertQuery(BarDescriptor(barType));
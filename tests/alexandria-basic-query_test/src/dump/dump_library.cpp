@@ -0,0 +1,278 @@
+#include "alexandria-basic-query_test/dump/dump_library.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/library_dump.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Float3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    struct Bar
+    {
+        alex::InstanceId id;
+        float            x = 0;
+    };
+
+    struct Foo
+    {
+        alex::InstanceId               id;
+        std::string                    name;
+        Float3                         position;
+        alex::PrimitiveArray<int32_t>  ints;
+        alex::StringArray              strings;
+        alex::Blob<std::vector<float>> shared;
+        alex::Blob<std::vector<float>> large;
+        alex::Reference<Bar>           bar;
+    };
+
+    using Float3MemberList =
+      alex::MemberList<alex::Member<"x", &Float3::x>, alex::Member<"y", &Float3::y>, alex::Member<"z", &Float3::z>>;
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>, alex::Member<"x", &Bar::x>>;
+
+    using FooDescriptor =
+      alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                   alex::Member<"name", &Foo::name>,
+                                   alex::NestedMember<"position", Float3MemberList, &Foo::position>,
+                                   alex::Member<"ints", &Foo::ints>,
+                                   alex::Member<"strings", &Foo::strings>,
+                                   alex::Member<"shared", &Foo::shared>,
+                                   alex::Member<"large", &Foo::large>,
+                                   alex::Member<"bar", &Foo::bar>>;
+
+    [[nodiscard]] int64_t countRows(alex::Library& library, const std::string& table, const std::string& where = "")
+    {
+        alex::RawStatement stmt(
+          library.getDatabase(), std::format("SELECT count(*) FROM {}{};", alex::quoteIdentifier(table), where), false);
+        return stmt.step() ? stmt.getInt64(0) : -1;
+    }
+
+    /**
+     * \brief Get the name of the first generated table of a kind.
+     */
+    [[nodiscard]] std::string getGeneratedTable(alex::Library& library, const std::string& kind)
+    {
+        alex::RawStatement stmt(library.getDatabase(), "SELECT name FROM tables WHERE kind = ?1 ORDER BY id;", false);
+        stmt.bind(1, kind);
+        return stmt.step() ? std::string(stmt.getText(0)) : std::string();
+    }
+}  // namespace
+
+void DumpLibrary::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout float3Layout;
+        float3Layout.createPrimitiveProperty("x", alex::DataType::Float);
+        float3Layout.createPrimitiveProperty("y", alex::DataType::Float);
+        float3Layout.createPrimitiveProperty("z", alex::DataType::Float);
+        float3Layout.commit(*nameSpace, "float3", alex::TypeLayout::Instantiable::False);
+
+        alex::TypeLayout barLayout;
+        barLayout.createPrimitiveProperty("prop0", alex::DataType::Float);
+        barLayout.commit(*nameSpace, "bar");
+
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0").setFullText();
+        fooLayout.createNestedTypeProperty("prop1", nameSpace->getType("float3")).setSpatial();
+        fooLayout.createPrimitiveArrayProperty("prop2", alex::DataType::Int32);
+        fooLayout.createStringArrayProperty("prop3");
+        fooLayout.createBlobProperty("prop4").setDeduplicated();
+        fooLayout.createBlobProperty("prop5").setExternal(64);
+        fooLayout.createReferenceProperty("prop6", nameSpace->getType("bar"));
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+    auto barDescriptor = BarDescriptor(nameSpace->getType("bar"));
+
+    Bar bar0{.x = 1.0f};
+    Bar bar1{.x = 2.0f};
+    Foo foo0{.name = "apple pie", .position = {1, 2, 3}};
+    foo0.ints.get()    = {1, 2, 3};
+    foo0.strings.get() = {"a", "b"};
+    foo0.shared.get()  = {1.0f, 2.0f, 3.0f};
+    foo0.large.get().assign(100, 0.5f);
+    foo0.bar = bar0;
+    Foo foo1{.name = "banana split", .position = {4, 5, 6}};
+    foo1.strings.get() = {"c"};
+    foo1.shared.get()  = {1.0f, 2.0f, 3.0f};
+    foo1.large.get()   = {1.0f};
+    foo1.bar           = bar1;
+
+    expectNoThrow([&] {
+        auto barInserter = alex::InsertQuery(barDescriptor);
+        barInserter(bar0);
+        barInserter(bar1);
+        auto fooInserter = alex::InsertQuery(fooDescriptor);
+        fooInserter(foo0);
+        fooInserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    const auto cwd    = std::filesystem::current_path();
+    const auto dump   = cwd / "library.dump";
+    const auto target = cwd / "imported.db";
+    std::filesystem::remove(dump);
+    std::filesystem::remove(target);
+
+    // Compare the instances of the imported library with the originals.
+    const auto verify = [&](alex::Library& library, const std::vector<const Foo*>& foos) {
+        auto desc   = FooDescriptor(library.getNamespace("main").getType("foo"));
+        auto getter = alex::GetQuery(desc);
+        for (const auto* foo : foos)
+        {
+            Foo foo_get{.id = foo->id};
+            expectNoThrow([&] { getter(foo_get); }).fatal("Failed to retrieve object");
+            compareEQ(foo->name, foo_get.name);
+            compareEQ(foo->position.z, foo_get.position.z);
+            compareEQ(foo->ints.get(), foo_get.ints.get());
+            compareEQ(foo->strings.get(), foo_get.strings.get());
+            compareEQ(foo->shared.get(), foo_get.shared.get());
+            compareEQ(foo->large.get(), foo_get.large.get());
+            compareTrue(foo->bar.getId() == foo_get.bar.getId());
+        }
+    };
+
+    /*
+     * Restore into a new library.
+     */
+
+    alex::LibraryDump::Stats written;
+    expectNoThrow([&] { written = alex::LibraryDump::write(*library, dump); }).fatal("Failed to write dump");
+    compareTrue(written.rows > 0);
+    compareTrue(written.tables > 0);
+    compareEQ(written.bytes, static_cast<uint64_t>(std::filesystem::file_size(dump)));
+
+    {
+        alex::LibraryDump::Stats read;
+        expectNoThrow([&] { read = alex::LibraryDump::read(target, dump, 2); }).fatal("Failed to read dump");
+        compareEQ(read.rows, written.rows);
+        compareEQ(read.tables, written.tables);
+        compareEQ(read.bytes, written.bytes);
+
+        alex::LibraryPtr imported;
+        expectNoThrow([&] { imported = alex::Library::open(target); }).fatal("Failed to open library");
+        verify(*imported, {&foo0, &foo1});
+
+        // Shared blobs are stored once and referenced twice. The large value is stored externally again.
+        const auto shared = alex::BlobStore::getStats(imported->getDatabase());
+        compareEQ(shared.blobs, int64_t{1});
+        compareEQ(shared.references, int64_t{2});
+        compareEQ(imported->getExternalStore().getStats().blobs, int64_t{1});
+
+        // Fulltext and spatial indices are rebuilt.
+        const auto fts   = getGeneratedTable(*imported, "fulltext");
+        const auto rtree = getGeneratedTable(*imported, "spatial");
+        compareEQ(countRows(*imported, fts, std::format(" WHERE {} MATCH 'apple'", alex::quoteIdentifier(fts))),
+                  int64_t{1});
+        compareEQ(countRows(*imported, rtree), int64_t{2});
+        compareEQ(countRows(*imported, rtree, " WHERE min2 >= 5.5 AND max2 <= 6.5"), int64_t{1});
+    }
+
+    /*
+     * Append to an existing library.
+     */
+
+    // Only foo2 is dumped. It references bar0, which only exists in the imported library.
+    Foo foo2{.name = "cherry tart", .position = {7, 8, 9}};
+    foo2.ints.get()   = {4, 5};
+    foo2.shared.get() = {1.0f, 2.0f, 3.0f};
+    foo2.large.get().assign(200, 1.5f);
+    foo2.bar = bar0;
+    expectNoThrow([&] {
+        auto fooDeleter = alex::DeleteQuery(fooDescriptor);
+        fooDeleter(foo0);
+        fooDeleter(foo1);
+        auto barDeleter = alex::DeleteQuery(barDescriptor);
+        barDeleter(bar0);
+        barDeleter(bar1);
+
+        alex::execute(library->getDatabase(), "PRAGMA foreign_keys = OFF;");
+        alex::InsertQuery(fooDescriptor)(foo2);
+        alex::execute(library->getDatabase(), "PRAGMA foreign_keys = ON;");
+    }).fatal("Failed to modify objects");
+
+    expectNoThrow([&] { alex::LibraryDump::write(*library, dump); }).fatal("Failed to write dump");
+    expectNoThrow([&] { alex::LibraryDump::read(target, dump, 1); }).fatal("Failed to read dump");
+
+    int64_t arrayRows = 0;
+    {
+        alex::LibraryPtr imported;
+        expectNoThrow([&] { imported = alex::Library::open(target); }).fatal("Failed to open library");
+        verify(*imported, {&foo0, &foo1, &foo2});
+
+        const auto& fooTable = imported->getNamespace("main").getType("foo").getInstanceTable().getName();
+        arrayRows            = countRows(*imported, fooTable + "_prop2");
+        compareEQ(countRows(*imported, fooTable), int64_t{3});
+        compareEQ(arrayRows, int64_t{5});
+        compareEQ(alex::BlobStore::getStats(imported->getDatabase()).references, int64_t{3});
+        compareEQ(imported->getExternalStore().getStats().blobs, int64_t{2});
+
+        const auto fts = getGeneratedTable(*imported, "fulltext");
+        compareEQ(countRows(*imported, fts, std::format(" WHERE {} MATCH 'cherry'", alex::quoteIdentifier(fts))),
+                  int64_t{1});
+        compareEQ(countRows(*imported, getGeneratedTable(*imported, "spatial")), int64_t{3});
+    }
+
+    /*
+     * Dangling references.
+     */
+
+    // foo3 references an instance that exists nowhere.
+    Foo foo3{.name = "date loaf", .position = {1, 1, 1}};
+    foo3.ints.get() = {6, 7, 8};
+    alex::InstanceId missing;
+    missing.regenerate();
+    foo3.bar = missing;
+    expectNoThrow([&] {
+        alex::DeleteQuery(fooDescriptor)(foo2);
+        alex::execute(library->getDatabase(), "PRAGMA foreign_keys = OFF;");
+        alex::InsertQuery(fooDescriptor)(foo3);
+        alex::execute(library->getDatabase(), "PRAGMA foreign_keys = ON;");
+    }).fatal("Failed to modify objects");
+    expectNoThrow([&] { alex::LibraryDump::write(*library, dump); }).fatal("Failed to write dump");
+
+    // Batches that were already committed are removed again.
+    expectThrow([&] { alex::LibraryDump::read(target, dump, 1); });
+    {
+        alex::LibraryPtr imported;
+        expectNoThrow([&] { imported = alex::Library::open(target); }).fatal("Failed to open library");
+        verify(*imported, {&foo0, &foo1, &foo2});
+
+        const auto& fooTable = imported->getNamespace("main").getType("foo").getInstanceTable().getName();
+        compareEQ(countRows(*imported, fooTable), int64_t{3});
+        compareEQ(countRows(*imported, fooTable + "_prop2"), arrayRows);
+        compareEQ(countRows(*imported, getGeneratedTable(*imported, "spatial")), int64_t{3});
+        compareEQ(alex::BlobStore::getStats(imported->getDatabase()).references, int64_t{3});
+        std::filesystem::remove(imported->getExternalStore().getPath());
+    }
+    std::filesystem::remove(target);
+
+    // A library that is created by a failed import is removed.
+    expectThrow([&] { alex::LibraryDump::read(target, dump, 1); });
+    compareFalse(std::filesystem::exists(target));
+    std::filesystem::remove(dump);
+}
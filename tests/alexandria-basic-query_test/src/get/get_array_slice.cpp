@@ -0,0 +1,164 @@
+#include "alexandria-basic-query_test/get/get_array_slice.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Bar
+    {
+        alex::InstanceId id;
+        float            x;
+    };
+
+    struct Foo
+    {
+        alex::InstanceId                    id;
+        alex::PrimitiveArray<int64_t>       ints;
+        alex::StringArray                   strings;
+        alex::PrimitiveArray<float>         packedFloats;
+        alex::StringArray                   packedStrings;
+        alex::BlobArray<std::vector<float>> blobs;
+        alex::ReferenceArray<Bar>           bars;
+    };
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>, alex::Member<"x", &Bar::x>>;
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"ints", &Foo::ints>,
+                                                       alex::Member<"strings", &Foo::strings>,
+                                                       alex::Member<"packedFloats", &Foo::packedFloats>,
+                                                       alex::Member<"packedStrings", &Foo::packedStrings>,
+                                                       alex::Member<"blobs", &Foo::blobs>,
+                                                       alex::Member<"bars", &Foo::bars>>;
+
+    template<typename T>
+    [[nodiscard]] std::vector<T> sub(const std::vector<T>& values, const size_t begin, const size_t count)
+    {
+        const auto first = std::min(begin, values.size());
+        const auto last  = std::min(first + count, values.size());
+        return std::vector<T>(values.begin() + first, values.begin() + last);
+    }
+}  // namespace
+
+void GetArraySlice::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout barLayout;
+        barLayout.createPrimitiveProperty("prop0", alex::DataType::Float);
+        barLayout.commit(*nameSpace, "bar");
+
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveArrayProperty("prop0", alex::DataType::Int64);
+        fooLayout.createStringArrayProperty("prop1");
+        fooLayout.createPrimitiveArrayProperty("prop2", alex::DataType::Float).setPacked();
+        fooLayout.createStringArrayProperty("prop3").setPacked();
+        fooLayout.createBlobArrayProperty("prop4").setDeduplicated();
+        fooLayout.createReferenceArrayProperty("prop5", nameSpace->getType("bar"));
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& barType       = nameSpace->getType("bar");
+    auto& fooType       = nameSpace->getType("foo");
+    auto  barDescriptor = BarDescriptor(barType);
+    auto  fooDescriptor = FooDescriptor(fooType);
+
+    // Create objects.
+    std::vector<Bar> bars(5);
+    Foo              foo;
+    foo.ints.get().resize(1000);
+    std::iota(foo.ints.get().begin(), foo.ints.get().end(), -500);
+    for (size_t i = 0; i < 100; i++) foo.strings.get().emplace_back(std::format("s{}", i));
+    foo.packedFloats.get().resize(1000);
+    std::iota(foo.packedFloats.get().begin(), foo.packedFloats.get().end(), 0.5f);
+    for (size_t i = 0; i < 50; i++) foo.packedStrings.get().emplace_back(std::string(i, 'x'));
+    for (size_t i = 0; i < 10; i++) foo.blobs.add(std::vector<float>(i, static_cast<float>(i)));
+
+    expectNoThrow([&] {
+        auto barInserter = alex::InsertQuery(barDescriptor);
+        for (auto& bar : bars)
+        {
+            barInserter(bar);
+            foo.bars.add(bar);
+        }
+        alex::InsertQuery(fooDescriptor)(foo);
+    }).fatal("Failed to insert objects");
+
+    // Slices are read through the position index of the array table.
+    {
+        const auto         table = alex::quoteIdentifier(fooType.getInstanceTable().getName() + "_prop0");
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("EXPLAIN QUERY PLAN SELECT value FROM {} WHERE instance = ?1 AND position "
+                                            ">= ?2 AND position < ?2 + ?3 ORDER BY position;",
+                                            table),
+                                false);
+        compareTrue(stmt.step()).fatal("Failed to explain query");
+        compareTrue(std::string(stmt.getText(3)).find("COVERING INDEX") != std::string::npos);
+    }
+
+    auto getter = alex::GetQuery(fooDescriptor);
+
+    // Retrieve slices of each kind of array.
+    expectNoThrow([&] {
+        compareEQ(getter.getSlice<"ints">(foo.id, 100, 10), sub(foo.ints.get(), 100, 10));
+        compareEQ(getter.getSlice<"ints">(foo.id, 0, 1), sub(foo.ints.get(), 0, 1));
+        compareEQ(getter.getSlice<"strings">(foo.id, 42, 20), sub(foo.strings.get(), 42, 20));
+        compareEQ(getter.getSlice<"packedFloats">(foo.id, 500, 100), sub(foo.packedFloats.get(), 500, 100));
+        compareEQ(getter.getSlice<"packedStrings">(foo.id, 10, 5), sub(foo.packedStrings.get(), 10, 5));
+        compareEQ(getter.getSlice<"blobs">(foo.id, 3, 4), sub(foo.blobs.get(), 3, 4));
+        compareTrue(getter.getSlice<"bars">(foo.id, 1, 3) == sub(foo.bars.get(), 1, 3));
+    }).fatal("Failed to retrieve slices");
+
+    // Slices are truncated at the end of the array.
+    expectNoThrow([&] {
+        compareEQ(getter.getSlice<"ints">(foo.id, 995, 10), sub(foo.ints.get(), 995, 10));
+        compareTrue(getter.getSlice<"ints">(foo.id, 1000, 10).empty());
+        compareTrue(getter.getSlice<"strings">(foo.id, 50, 0).empty());
+        compareEQ(getter.getSlice<"packedFloats">(foo.id, 990, 20), sub(foo.packedFloats.get(), 990, 20));
+        compareTrue(getter.getSlice<"packedFloats">(foo.id, 2000, 20).empty());
+        compareEQ(getter.getSlice<"packedStrings">(foo.id, 45, 20), sub(foo.packedStrings.get(), 45, 20));
+        compareTrue(getter.getSlice<"packedStrings">(foo.id, 60, 20).empty());
+        compareEQ(getter.getSlice<"blobs">(foo.id, 8, 20), sub(foo.blobs.get(), 8, 20));
+    }).fatal("Failed to retrieve slices");
+
+    // Deleting a referenced object removes it from the reference array. Slices skip the removed element.
+    expectNoThrow([&] { alex::DeleteQuery(barDescriptor)(bars[1]); }).fatal("Failed to delete object");
+    expectNoThrow([&] {
+        auto& ids = foo.bars.get();
+        ids.erase(ids.begin() + 1);
+        compareTrue(getter.getSlice<"bars">(foo.id, 1, 3) == sub(ids, 1, 3));
+        compareTrue(getter.getSlice<"bars">(foo.id, 0, 10) == ids);
+    }).fatal("Failed to retrieve slices");
+
+    // Full retrieval returns all elements in order.
+    {
+        Foo foo_get{.id = foo.id};
+        expectNoThrow([&] { getter(foo_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo.ints.get(), foo_get.ints.get());
+        compareEQ(foo.strings.get(), foo_get.strings.get());
+        compareEQ(foo.packedFloats.get(), foo_get.packedFloats.get());
+        compareEQ(foo.packedStrings.get(), foo_get.packedStrings.get());
+        compareEQ(foo.blobs.get(), foo_get.blobs.get());
+        compareTrue(foo.bars.get() == foo_get.bars.get());
+    }
+
+    // Cannot retrieve a slice without a valid ID.
+    expectThrow([&] { static_cast<void>(getter.getSlice<"ints">(alex::InstanceId{}, 0, 1)); });
+}
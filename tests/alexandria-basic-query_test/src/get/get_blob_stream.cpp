@@ -0,0 +1,188 @@
+#include "alexandria-basic-query_test/get/get_blob_stream.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/blob_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Baz
+    {
+        float   x;
+        int32_t y;
+
+        bool operator==(const Baz& rhs) const noexcept { return x == rhs.x && y == rhs.y; }
+
+        friend std::ostream& operator<<(std::ostream& out, const Baz& baz)
+        {
+            return out << "(" << baz.x << ", " << baz.y << ")";
+        }
+    };
+
+    struct Foo
+    {
+        alex::InstanceId               id;
+        std::string                    name;
+        alex::Blob<Baz>                a{};
+        alex::Blob<std::vector<float>> b;
+        alex::PrimitiveBlob<int32_t>   c;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"name", &Foo::name>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>,
+                                                       alex::Member<"c", &Foo::c>>;
+}  // namespace
+
+void GetBlobStream::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0");
+        fooLayout.createBlobProperty("prop1");
+        fooLayout.createBlobProperty("prop2");
+        fooLayout.createPrimitiveBlobProperty("prop3", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    // Create objects.
+    Foo foo0;
+    foo0.name      = "foo0";
+    foo0.a.get().x = 3.5f;
+    foo0.a.get().y = 12;
+    foo0.b.get()   = {1.0f, 2.0f, 3.0f, 4.0f};
+    foo0.c.get().resize(1000);
+    std::iota(foo0.c.get().begin(), foo0.c.get().end(), 0);
+    Foo foo1;
+    foo1.name = "foo1";
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test skipping blobs and loading them lazily.
+     */
+
+    {
+        auto getter = alex::GetQuery<FooDescriptor, alex::BlobLoading::Lazy>(fooDescriptor);
+
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] { getter(foo0_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo0.id, foo0_get.id);
+        compareEQ(foo0.name, foo0_get.name);
+        compareTrue(foo0_get.b.get().empty());
+        compareTrue(foo0_get.c.get().empty());
+
+        expectNoThrow([&] {
+            alex::loadBlob<"a">(fooDescriptor, foo0_get);
+            alex::loadBlob<"b">(fooDescriptor, foo0_get);
+            alex::loadBlob<"c">(fooDescriptor, foo0_get);
+        }).fatal("Failed to load blobs");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+        compareEQ(foo0.c.get(), foo0_get.c.get());
+
+        Foo foo1_get{.id = foo1.id};
+        expectNoThrow([&] { getter(foo1_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo1.name, foo1_get.name);
+        expectNoThrow([&] {
+            alex::loadBlob<"b">(fooDescriptor, foo1_get);
+            alex::loadBlob<"c">(fooDescriptor, foo1_get);
+        });
+        compareTrue(foo1_get.b.get().empty());
+        compareTrue(foo1_get.c.get().empty());
+
+        // Instance that does not exist.
+        Foo foo2_get{.id = foo0.id};
+        foo2_get.id.regenerate();
+        expectThrow([&] { getter(foo2_get); });
+        expectThrow([&] { alex::loadBlob<"c">(fooDescriptor, foo2_get); });
+    }
+
+    /*
+     * Test ranged reads.
+     */
+
+    {
+        auto reader = alex::openBlobReader<"c">(fooDescriptor, foo0.id);
+        compareEQ(static_cast<int64_t>(1000 * sizeof(int32_t)), reader.size());
+
+        std::vector<int32_t> values(10);
+        reader.read(std::span(values), static_cast<int64_t>(500 * sizeof(int32_t)));
+        compareEQ(std::vector<int32_t>{500, 501, 502, 503, 504, 505, 506, 507, 508, 509}, values);
+
+        // Read past the end.
+        expectThrow([&] { reader.read(std::span(values), static_cast<int64_t>(995 * sizeof(int32_t))); });
+        expectThrow([&] { reader.read(std::span(values), -1); });
+    }
+
+    /*
+     * Test preallocation and chunked writes.
+     */
+
+    {
+        std::vector<int32_t> expected(5000);
+        std::iota(expected.begin(), expected.end(), -2500);
+
+        alex::BlobWriter writer;
+        expectNoThrow([&] {
+            writer = alex::openBlobWriter<"c">(fooDescriptor, foo1.id, static_cast<int64_t>(5000 * sizeof(int32_t)));
+        }).fatal("Failed to open blob");
+        compareEQ(static_cast<int64_t>(5000 * sizeof(int32_t)), writer.size());
+
+        std::vector<int32_t> chunk(512);
+        expectNoThrow([&] {
+            for (size_t i = 0; i < expected.size(); i += chunk.size())
+            {
+                const auto count = std::min(chunk.size(), expected.size() - i);
+                std::copy_n(expected.begin() + static_cast<ptrdiff_t>(i), count, chunk.begin());
+                writer.write(std::span(chunk.data(), count), static_cast<int64_t>(i * sizeof(int32_t)));
+            }
+        }).fatal("Failed to write blob");
+
+        // Cannot grow the blob.
+        expectThrow([&] { writer.write(std::span(chunk), static_cast<int64_t>(5000 * sizeof(int32_t))); });
+        writer = alex::BlobWriter();
+
+        auto getter = alex::GetQuery(fooDescriptor);
+        Foo  foo1_get{.id = foo1.id};
+        expectNoThrow([&] { getter(foo1_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo1.name, foo1_get.name);
+        compareEQ(expected, foo1_get.c.get());
+    }
+
+    /*
+     * Test overwriting part of an existing blob.
+     */
+
+    {
+        expectNoThrow([&] {
+            auto                     writer = alex::openBlobWriter<"b">(fooDescriptor, foo0.id);
+            const std::vector<float> values = {-2.0f, -3.0f};
+            writer.write(std::span(values), static_cast<int64_t>(sizeof(float)));
+        }).fatal("Failed to write blob");
+
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] { alex::loadBlob<"b">(fooDescriptor, foo0_get); }).fatal("Failed to load blob");
+        compareEQ(std::vector<float>{1.0f, -2.0f, -3.0f, 4.0f}, foo0_get.b.get());
+    }
+}
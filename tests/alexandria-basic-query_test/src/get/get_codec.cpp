@@ -0,0 +1,162 @@
+#include "alexandria-basic-query_test/get/get_codec.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/blob_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+
+namespace
+{
+    struct Baz
+    {
+        float   x;
+        int32_t y;
+
+        bool operator==(const Baz& rhs) const noexcept { return x == rhs.x && y == rhs.y; }
+
+        friend std::ostream& operator<<(std::ostream& out, const Baz& baz)
+        {
+            return out << "(" << baz.x << ", " << baz.y << ")";
+        }
+    };
+
+    struct Foo
+    {
+        alex::InstanceId                  id;
+        alex::Blob<std::vector<float>>    a;
+        alex::PrimitiveBlob<int64_t>      b;
+        alex::PrimitiveBlob<uint32_t>     c;
+        alex::BlobArray<std::vector<Baz>> d;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>,
+                                                       alex::Member<"c", &Foo::c>,
+                                                       alex::Member<"d", &Foo::d>>;
+}  // namespace
+
+void GetCodec::operator()()
+{
+    // Codecs are only allowed for blobs, and delta encoding only for integers.
+    {
+        alex::TypeLayout layout;
+        expectThrow(
+          [&] { layout.createPrimitiveProperty("prop0", alex::DataType::Float).setCodec(alex::Codec::ShuffleLz); });
+        expectThrow([&] { layout.createStringProperty("prop1").setCodec(alex::Codec::ShuffleLz); });
+        expectThrow([&] { layout.createBlobProperty("prop2").setCodec(alex::Codec::DeltaVarint); });
+        expectThrow([&] {
+            layout.createPrimitiveBlobProperty("prop3", alex::DataType::Double).setCodec(alex::Codec::DeltaVarint);
+        });
+        expectNoThrow([&] { layout.createBlobArrayProperty("prop4").setCodec(alex::Codec::ShuffleLz); });
+    }
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createBlobProperty("prop0").setCodec(alex::Codec::ShuffleLz);
+        fooLayout.createPrimitiveBlobProperty("prop1", alex::DataType::Int64).setCodec(alex::Codec::DeltaVarint);
+        fooLayout.createPrimitiveBlobProperty("prop2", alex::DataType::Uint32);
+        fooLayout.createBlobArrayProperty("prop3").setCodec(alex::Codec::ShuffleLz);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& fooType       = nameSpace->getType("foo");
+    auto  fooDescriptor = FooDescriptor(fooType);
+
+    compareTrue(fooType.getCodec("prop0") == alex::Codec::ShuffleLz);
+    compareTrue(fooType.getCodec("prop1") == alex::Codec::DeltaVarint);
+    compareTrue(fooType.getCodec("prop2") == alex::Codec::None);
+    compareTrue(fooType.getCodec("prop3") == alex::Codec::ShuffleLz);
+
+    // Create objects.
+    Foo foo0;
+    foo0.a.get().resize(10000);
+    for (size_t i = 0; i < foo0.a.get().size(); i++) foo0.a.get()[i] = static_cast<float>(i % 100) * 0.25f;
+    foo0.b.get().resize(10000);
+    std::iota(foo0.b.get().begin(), foo0.b.get().end(), -5000);
+    foo0.c.get() = {1, 2, 3};
+    foo0.d.add(std::vector<Baz>{{1.0f, 2}, {3.0f, 4}});
+    foo0.d.add(std::vector<Baz>{});
+    foo0.d.add(std::vector<Baz>(500, Baz{5.0f, 6}));
+    Foo foo1;
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    // Encoded blobs should be smaller than the raw values.
+    {
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("SELECT length(prop0), length(prop1) FROM {} WHERE uuid = ?1;",
+                                            alex::quoteIdentifier(fooType.getInstanceTable().getName())),
+                                false);
+        stmt.bind(1, foo0.id.getAsString());
+        compareTrue(stmt.step()).fatal("Failed to select object");
+        compareTrue(stmt.getInt64(0) < static_cast<int64_t>(foo0.a.get().size() * sizeof(float)));
+        compareTrue(stmt.getInt64(1) < static_cast<int64_t>(foo0.b.get().size() * sizeof(int64_t)));
+    }
+
+    // Retrieve and compare.
+    {
+        auto getter = alex::GetQuery(fooDescriptor);
+
+        Foo foo0_get{.id = foo0.id};
+        Foo foo1_get{.id = foo1.id};
+        expectNoThrow([&] {
+            getter(foo0_get);
+            getter(foo1_get);
+        }).fatal("Failed to retrieve objects");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+        compareEQ(foo0.c.get(), foo0_get.c.get());
+        compareEQ(foo0.d.get(), foo0_get.d.get());
+        compareTrue(foo1_get.a.get().empty());
+        compareTrue(foo1_get.b.get().empty());
+        compareTrue(foo1_get.d.get().empty());
+    }
+
+    // Update and retrieve again.
+    {
+        foo0.b.get() = {100, 50, 0, -50};
+        foo0.d.clear();
+        foo0.d.add(std::vector<Baz>{{7.0f, 8}});
+        expectNoThrow([&] { alex::UpdateQuery(fooDescriptor)(foo0); }).fatal("Failed to update object");
+
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] { alex::GetQuery(fooDescriptor)(foo0_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+        compareEQ(foo0.d.get(), foo0_get.d.get());
+    }
+
+    // Lazy loading decodes, incremental access is not possible.
+    {
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] {
+            alex::GetQuery<FooDescriptor, alex::BlobLoading::Lazy>(fooDescriptor)(foo0_get);
+            alex::loadBlob<"a">(fooDescriptor, foo0_get);
+            alex::loadBlob<"b">(fooDescriptor, foo0_get);
+        }).fatal("Failed to load blobs");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+
+        expectThrow([&] { static_cast<void>(alex::openBlobReader<"a">(fooDescriptor, foo0.id)); });
+        expectNoThrow([&] { static_cast<void>(alex::openBlobReader<"c">(fooDescriptor, foo0.id)); });
+    }
+}
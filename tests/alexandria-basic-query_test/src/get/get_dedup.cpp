@@ -0,0 +1,188 @@
+#include "alexandria-basic-query_test/get/get_dedup.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/blob_store.h"
+#include "alexandria-core/codec.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/blob_query.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+
+namespace
+{
+    struct Baz
+    {
+        float   x;
+        int32_t y;
+
+        bool operator==(const Baz& rhs) const noexcept { return x == rhs.x && y == rhs.y; }
+
+        friend std::ostream& operator<<(std::ostream& out, const Baz& baz)
+        {
+            return out << "(" << baz.x << ", " << baz.y << ")";
+        }
+    };
+
+    struct Foo
+    {
+        alex::InstanceId                  id;
+        alex::Blob<std::vector<float>>    a;
+        alex::PrimitiveBlob<int64_t>      b;
+        alex::PrimitiveBlob<uint32_t>     c;
+        alex::BlobArray<std::vector<Baz>> d;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>,
+                                                       alex::Member<"c", &Foo::c>,
+                                                       alex::Member<"d", &Foo::d>>;
+}  // namespace
+
+void GetDedup::operator()()
+{
+    // Deduplication is only allowed for blobs.
+    {
+        alex::TypeLayout layout;
+        expectThrow([&] { layout.createPrimitiveProperty("prop0", alex::DataType::Float).setDeduplicated(); });
+        expectThrow([&] { layout.createStringProperty("prop1").setDeduplicated(); });
+        expectNoThrow([&] { layout.createBlobProperty("prop2").setDeduplicated(); });
+        expectNoThrow([&] { layout.createBlobArrayProperty("prop3").setDeduplicated(); });
+    }
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createBlobProperty("prop0").setDeduplicated();
+        fooLayout.createPrimitiveBlobProperty("prop1", alex::DataType::Int64)
+          .setCodec(alex::Codec::DeltaVarint)
+          .setDeduplicated();
+        fooLayout.createPrimitiveBlobProperty("prop2", alex::DataType::Uint32);
+        fooLayout.createBlobArrayProperty("prop3").setDeduplicated();
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& fooType       = nameSpace->getType("foo");
+    auto  fooDescriptor = FooDescriptor(fooType);
+
+    compareTrue(fooType.isDeduplicated("prop0"));
+    compareTrue(fooType.isDeduplicated("prop1"));
+    compareFalse(fooType.isDeduplicated("prop2"));
+    compareTrue(fooType.isDeduplicated("prop3"));
+
+    // Create two objects with the same content.
+    Foo foo0;
+    foo0.a.get().resize(10000);
+    for (size_t i = 0; i < foo0.a.get().size(); i++) foo0.a.get()[i] = static_cast<float>(i % 100) * 0.25f;
+    foo0.b.get().resize(10000);
+    std::iota(foo0.b.get().begin(), foo0.b.get().end(), -5000);
+    foo0.c.get() = {1, 2, 3};
+    foo0.d.add(std::vector<Baz>{{1.0f, 2}, {3.0f, 4}});
+    foo0.d.add(std::vector<Baz>{});
+    foo0.d.add(std::vector<Baz>(500, Baz{5.0f, 6}));
+    Foo foo1;
+    foo1.a = foo0.a;
+    foo1.b = foo0.b;
+    foo1.c = foo0.c;
+    foo1.d = foo0.d;
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    // Each distinct value should be stored once and referenced twice.
+    {
+        const auto stats = alex::BlobStore::getStats(library->getDatabase());
+        compareEQ(stats.blobs, static_cast<int64_t>(5));
+        compareEQ(stats.references, static_cast<int64_t>(10));
+        compareEQ(stats.referencedBytes, 2 * stats.storedBytes);
+        compareEQ(stats.getRatio(), 2.0);
+    }
+
+    // Instance table should only hold the content keys.
+    {
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("SELECT length(prop0), length(prop1) FROM {} WHERE uuid = ?1;",
+                                            alex::quoteIdentifier(fooType.getInstanceTable().getName())),
+                                false);
+        stmt.bind(1, foo1.id.getAsString());
+        compareTrue(stmt.step()).fatal("Failed to select object");
+        compareEQ(stmt.getInt64(0), static_cast<int64_t>(sizeof(alex::BlobKey)));
+        compareEQ(stmt.getInt64(1), static_cast<int64_t>(sizeof(alex::BlobKey)));
+    }
+
+    // Retrieve and compare.
+    {
+        auto getter = alex::GetQuery(fooDescriptor);
+
+        Foo foo1_get{.id = foo1.id};
+        expectNoThrow([&] { getter(foo1_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo0.a.get(), foo1_get.a.get());
+        compareEQ(foo0.b.get(), foo1_get.b.get());
+        compareEQ(foo0.c.get(), foo1_get.c.get());
+        compareEQ(foo0.d.get(), foo1_get.d.get());
+    }
+
+    // Update one object, after which its new values are stored separately.
+    {
+        foo1.a.get().resize(10);
+        foo1.d.clear();
+        foo1.d.add(std::vector<Baz>{{7.0f, 8}});
+        expectNoThrow([&] { alex::UpdateQuery(fooDescriptor)(foo1); }).fatal("Failed to update object");
+
+        const auto stats = alex::BlobStore::getStats(library->getDatabase());
+        compareEQ(stats.blobs, static_cast<int64_t>(7));
+        compareEQ(stats.references, static_cast<int64_t>(8));
+
+        Foo foo1_get{.id = foo1.id};
+        expectNoThrow([&] { alex::GetQuery(fooDescriptor)(foo1_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo1.a.get(), foo1_get.a.get());
+        compareEQ(foo1.b.get(), foo1_get.b.get());
+        compareEQ(foo1.d.get(), foo1_get.d.get());
+    }
+
+    // Lazy loading and incremental reading resolve the shared blob, writing in place is not possible.
+    {
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] {
+            alex::GetQuery<FooDescriptor, alex::BlobLoading::Lazy>(fooDescriptor)(foo0_get);
+            alex::loadBlob<"a">(fooDescriptor, foo0_get);
+            alex::loadBlob<"b">(fooDescriptor, foo0_get);
+        }).fatal("Failed to load blobs");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+
+        expectNoThrow([&] {
+            auto reader = alex::openBlobReader<"a">(fooDescriptor, foo0.id);
+            compareEQ(reader.size(), static_cast<int64_t>(foo0.a.get().size() * sizeof(float)));
+        });
+        expectThrow([&] { static_cast<void>(alex::openBlobWriter<"a">(fooDescriptor, foo0.id)); });
+    }
+
+    // Deleting objects releases their blobs.
+    {
+        expectNoThrow([&] { alex::DeleteQuery(fooDescriptor)(foo0); }).fatal("Failed to delete object");
+        auto stats = alex::BlobStore::getStats(library->getDatabase());
+        compareEQ(stats.blobs, static_cast<int64_t>(3));
+        compareEQ(stats.references, static_cast<int64_t>(3));
+
+        expectNoThrow([&] { alex::DeleteQuery(fooDescriptor)(foo1); }).fatal("Failed to delete object");
+        stats = alex::BlobStore::getStats(library->getDatabase());
+        compareEQ(stats.blobs, static_cast<int64_t>(0));
+        compareEQ(stats.references, static_cast<int64_t>(0));
+    }
+}
@@ -0,0 +1,243 @@
+#include "alexandria-basic-query_test/get/get_external.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/external_store.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/blob_query.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+
+namespace
+{
+    struct Baz
+    {
+        float   x;
+        int32_t y;
+
+        bool operator==(const Baz& rhs) const noexcept { return x == rhs.x && y == rhs.y; }
+
+        friend std::ostream& operator<<(std::ostream& out, const Baz& baz)
+        {
+            return out << "(" << baz.x << ", " << baz.y << ")";
+        }
+    };
+
+    struct Foo
+    {
+        alex::InstanceId                  id;
+        alex::Blob<std::vector<float>>    a;
+        alex::PrimitiveBlob<int64_t>      b;
+        alex::PrimitiveBlob<uint32_t>     c;
+        alex::BlobArray<std::vector<Baz>> d;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>,
+                                                       alex::Member<"c", &Foo::c>,
+                                                       alex::Member<"d", &Foo::d>>;
+}  // namespace
+
+void GetExternal::operator()()
+{
+    // External storage is only allowed for blobs that are not deduplicated.
+    {
+        alex::TypeLayout layout;
+        expectThrow([&] { layout.createPrimitiveProperty("prop0", alex::DataType::Float).setExternal(1024); });
+        expectThrow([&] { layout.createStringProperty("prop1").setExternal(1024); });
+        expectThrow([&] { layout.createBlobProperty("prop2").setExternal(-1); });
+        expectThrow([&] { layout.createBlobProperty("prop3").setDeduplicated().setExternal(1024); });
+        expectThrow([&] { layout.createBlobProperty("prop4").setExternal(1024).setDeduplicated(); });
+        expectNoThrow([&] { layout.createBlobProperty("prop5").setExternal(1024); });
+        expectNoThrow([&] { layout.createBlobArrayProperty("prop6").setExternal(1024); });
+    }
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createBlobProperty("prop0").setExternal(1024);
+        fooLayout.createPrimitiveBlobProperty("prop1", alex::DataType::Int64)
+          .setCodec(alex::Codec::DeltaVarint)
+          .setExternal(64);
+        fooLayout.createPrimitiveBlobProperty("prop2", alex::DataType::Uint32);
+        fooLayout.createBlobArrayProperty("prop3").setExternal(256);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& fooType       = nameSpace->getType("foo");
+    auto  fooDescriptor = FooDescriptor(fooType);
+    auto& store         = library->getExternalStore();
+
+    compareEQ(fooType.getExternalThreshold("prop0"), static_cast<int64_t>(1024));
+    compareEQ(fooType.getExternalThreshold("prop1"), static_cast<int64_t>(64));
+    compareEQ(fooType.getExternalThreshold("prop2"), static_cast<int64_t>(0));
+    compareEQ(fooType.getExternalThreshold("prop3"), static_cast<int64_t>(256));
+
+    // One object with values above the thresholds, one with values below.
+    Foo foo0;
+    foo0.a.get().resize(10000);
+    for (size_t i = 0; i < foo0.a.get().size(); i++) foo0.a.get()[i] = static_cast<float>(i) * 0.5f;
+    foo0.b.get().resize(10000);
+    std::iota(foo0.b.get().begin(), foo0.b.get().end(), -5000);
+    foo0.c.get() = {1, 2, 3};
+    foo0.d.add(std::vector<Baz>{{1.0f, 2}, {3.0f, 4}});
+    foo0.d.add(std::vector<Baz>{});
+    foo0.d.add(std::vector<Baz>(500, Baz{5.0f, 6}));
+    Foo foo1;
+    foo1.a.get() = {1.0f, 2.0f, 3.0f};
+    foo1.b.get() = {4, 5, 6};
+    foo1.c.get() = {7, 8, 9};
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    // Only the large values should be stored externally.
+    {
+        const auto stats = store.getStats();
+        compareEQ(stats.blobs, static_cast<int64_t>(3));
+        compareTrue(stats.fileBytes >= stats.liveBytes);
+        compareTrue(std::filesystem::exists(store.getPath()));
+
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("SELECT typeof(prop0), typeof(prop1), prop0 FROM {} WHERE uuid = ?1;",
+                                            alex::quoteIdentifier(fooType.getInstanceTable().getName())),
+                                false);
+        stmt.bind(1, foo0.id.getAsString());
+        compareTrue(stmt.step()).fatal("Failed to select object");
+        compareEQ(stmt.getText(0), std::string_view("integer"));
+        compareEQ(stmt.getText(1), std::string_view("integer"));
+        compareTrue(store.verify(stmt.getInt64(2)));
+        stmt.reset();
+        stmt.bind(1, foo1.id.getAsString());
+        compareTrue(stmt.step()).fatal("Failed to select object");
+        compareEQ(stmt.getText(0), std::string_view("blob"));
+        compareEQ(stmt.getText(1), std::string_view("blob"));
+    }
+
+    // Retrieve and compare.
+    {
+        auto getter = alex::GetQuery(fooDescriptor);
+
+        Foo foo0_get{.id = foo0.id};
+        Foo foo1_get{.id = foo1.id};
+        expectNoThrow([&] {
+            getter(foo0_get);
+            getter(foo1_get);
+        }).fatal("Failed to retrieve objects");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+        compareEQ(foo0.c.get(), foo0_get.c.get());
+        compareEQ(foo0.d.get(), foo0_get.d.get());
+        compareEQ(foo1.a.get(), foo1_get.a.get());
+        compareEQ(foo1.b.get(), foo1_get.b.get());
+        compareEQ(foo1.c.get(), foo1_get.c.get());
+        compareEQ(foo1.d.get(), foo1_get.d.get());
+    }
+
+    // External values can be viewed without copying, but not opened for incremental access.
+    {
+        alex::BlobView view0, view1;
+        expectNoThrow([&] {
+            view0 = alex::viewBlob<"a">(fooDescriptor, foo0.id);
+            view1 = alex::viewBlob<"a">(fooDescriptor, foo1.id);
+        }).fatal("Failed to view blobs");
+        const auto values0 = view0.as<float>();
+        const auto values1 = view1.as<float>();
+        compareEQ(foo0.a.get(), std::vector(values0.begin(), values0.end()));
+        compareEQ(foo1.a.get(), std::vector(values1.begin(), values1.end()));
+
+        expectThrow([&] { static_cast<void>(alex::openBlobReader<"a">(fooDescriptor, foo0.id)); });
+        expectThrow([&] { static_cast<void>(alex::openBlobWriter<"a">(fooDescriptor, foo0.id)); });
+        expectNoThrow([&] { static_cast<void>(alex::openBlobReader<"a">(fooDescriptor, foo1.id)); });
+
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] {
+            alex::GetQuery<FooDescriptor, alex::BlobLoading::Lazy>(fooDescriptor)(foo0_get);
+            alex::loadBlob<"a">(fooDescriptor, foo0_get);
+            alex::loadBlob<"b">(fooDescriptor, foo0_get);
+        }).fatal("Failed to load blobs");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+    }
+
+    // Updating replaces the external values. The old values remain in the pack file until it is compacted.
+    {
+        foo0.a.get().resize(20000, 1.5f);
+        foo0.d.clear();
+        foo0.d.add(std::vector<Baz>(100, Baz{7.0f, 8}));
+        expectNoThrow([&] { alex::UpdateQuery(fooDescriptor)(foo0); }).fatal("Failed to update object");
+
+        auto stats = store.getStats();
+        compareEQ(stats.blobs, static_cast<int64_t>(3));
+        compareTrue(stats.fileBytes > stats.liveBytes);
+
+        // Views taken before compaction stay valid.
+        const auto view      = alex::viewBlob<"a">(fooDescriptor, foo0.id);
+        const auto reclaimed = store.compact();
+        compareTrue(reclaimed > 0);
+        compareTrue(std::filesystem::exists(store.getPath()));
+        const auto values = view.as<float>();
+        compareEQ(foo0.a.get(), std::vector(values.begin(), values.end()));
+
+        stats = store.getStats();
+        compareEQ(stats.blobs, static_cast<int64_t>(3));
+        compareTrue(stats.fileBytes < stats.liveBytes + 3 * static_cast<int64_t>(alex::PackFile::alignment));
+
+        Foo foo0_get{.id = foo0.id};
+        expectNoThrow([&] { alex::GetQuery(fooDescriptor)(foo0_get); }).fatal("Failed to retrieve object");
+        compareEQ(foo0.a.get(), foo0_get.a.get());
+        compareEQ(foo0.b.get(), foo0_get.b.get());
+        compareEQ(foo0.d.get(), foo0_get.d.get());
+    }
+
+    // Another store on the same database and pack file, e.g. in another process, follows compactions. The file of
+    // the previous generation is only removed once neither store has it open.
+    {
+        const auto          path = store.getPath();
+        alex::ExternalStore other(library->getDatabase(), path.parent_path() / path.stem().stem());
+
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("SELECT prop0 FROM {} WHERE uuid = ?1;",
+                                            alex::quoteIdentifier(fooType.getInstanceTable().getName())),
+                                false);
+        stmt.bind(1, foo0.id.getAsString());
+        compareTrue(stmt.step()).fatal("Failed to select object");
+        const auto id = stmt.getInt64(0);
+        stmt.reset();
+
+        compareTrue(other.verify(id));
+        compareEQ(other.getPath(), path);
+
+        expectNoThrow([&] { static_cast<void>(store.compact()); }).fatal("Failed to compact store");
+        compareTrue(std::filesystem::exists(path));
+        compareTrue(other.verify(id));
+        compareEQ(other.getPath(), store.getPath());
+        compareFalse(std::filesystem::exists(path));
+
+        const auto values = other.get(id).as<float>();
+        compareEQ(foo0.a.get(), std::vector(values.begin(), values.end()));
+    }
+
+    // Deleting objects releases their external values.
+    {
+        expectNoThrow([&] { alex::DeleteQuery(fooDescriptor)(foo0); }).fatal("Failed to delete object");
+        compareEQ(store.getStats().blobs, static_cast<int64_t>(0));
+        expectNoThrow([&] { alex::DeleteQuery(fooDescriptor)(foo1); }).fatal("Failed to delete object");
+    }
+}
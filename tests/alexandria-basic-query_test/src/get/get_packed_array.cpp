@@ -0,0 +1,156 @@
+#include "alexandria-basic-query_test/get/get_packed_array.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <numeric>
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId              id;
+        alex::PrimitiveArray<float>   floats;
+        alex::StringArray             strings;
+        alex::PrimitiveArray<int32_t> ints;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"floats", &Foo::floats>,
+                                                       alex::Member<"strings", &Foo::strings>,
+                                                       alex::Member<"ints", &Foo::ints>>;
+}  // namespace
+
+void GetPackedArray::operator()()
+{
+    // Packing is only allowed for primitive and string arrays without a full-text index.
+    {
+        alex::TypeLayout layout;
+        expectThrow([&] { layout.createPrimitiveProperty("prop0", alex::DataType::Float).setPacked(); });
+        expectThrow([&] { layout.createStringProperty("prop1").setPacked(); });
+        expectThrow([&] { layout.createBlobArrayProperty("prop2").setPacked(); });
+        expectThrow([&] { layout.createPrimitiveBlobProperty("prop3", alex::DataType::Int32).setPacked(); });
+        expectThrow([&] { layout.createStringArrayProperty("prop4").setFullText().setPacked(); });
+        expectThrow([&] { layout.createStringArrayProperty("prop5").setPacked().setFullText(); });
+        expectNoThrow([&] { layout.createPrimitiveArrayProperty("prop6", alex::DataType::Uint64).setPacked(); });
+        expectNoThrow([&] { layout.createStringArrayProperty("prop7").setPacked(); });
+    }
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveArrayProperty("prop0", alex::DataType::Float).setPacked();
+        fooLayout.createStringArrayProperty("prop1").setPacked();
+        fooLayout.createPrimitiveArrayProperty("prop2", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& fooType       = nameSpace->getType("foo");
+    auto  fooDescriptor = FooDescriptor(fooType);
+
+    compareTrue(fooType.isPacked("prop0"));
+    compareTrue(fooType.isPacked("prop1"));
+    compareFalse(fooType.isPacked("prop2"));
+
+    // Count the rows in the array table of a property that match a condition.
+    const auto countRows = [&](const std::string& prop, const std::string& where = "1") {
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("SELECT count(*) FROM {} WHERE {};",
+                                            alex::quoteIdentifier(fooType.getInstanceTable().getName() + "_" + prop),
+                                            where),
+                                false);
+        stmt.step();
+        return stmt.getInt64(0);
+    };
+
+    // One object with large arrays, one with empty arrays.
+    Foo foo0;
+    foo0.floats.get().resize(10000);
+    std::iota(foo0.floats.get().begin(), foo0.floats.get().end(), -0.5f);
+    foo0.strings.get() = {"abc", "", std::string(1000, 'x'), "def"};
+    foo0.ints.get()    = {1, 2, 3};
+    Foo foo1;
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    // Packed arrays take a single row, and no row at all when empty.
+    compareEQ(countRows("prop0"), static_cast<int64_t>(1));
+    compareEQ(countRows("prop0", "typeof(value) = 'blob'"), static_cast<int64_t>(1));
+    compareEQ(countRows("prop1"), static_cast<int64_t>(1));
+    compareEQ(countRows("prop1", "typeof(value) = 'blob'"), static_cast<int64_t>(1));
+    compareEQ(countRows("prop2"), static_cast<int64_t>(3));
+
+    // Retrieve and compare.
+    {
+        auto getter = alex::GetQuery(fooDescriptor);
+
+        Foo foo0_get{.id = foo0.id};
+        Foo foo1_get{.id = foo1.id};
+        foo1_get.floats.get()  = {1.0f};
+        foo1_get.strings.get() = {"stale"};
+        expectNoThrow([&] {
+            getter(foo0_get);
+            getter(foo1_get);
+        }).fatal("Failed to retrieve objects");
+        compareEQ(foo0.floats.get(), foo0_get.floats.get());
+        compareEQ(foo0.strings.get(), foo0_get.strings.get());
+        compareEQ(foo0.ints.get(), foo0_get.ints.get());
+        compareTrue(foo1_get.floats.get().empty());
+        compareTrue(foo1_get.strings.get().empty());
+        compareTrue(foo1_get.ints.get().empty());
+    }
+
+    // Updating replaces the packed row.
+    {
+        foo0.floats.get().resize(5);
+        foo0.strings.get().clear();
+        foo1.strings.get() = {"ghi"};
+        expectNoThrow([&] {
+            auto updater = alex::UpdateQuery(fooDescriptor);
+            updater(foo0);
+            updater(foo1);
+        }).fatal("Failed to update objects");
+
+        compareEQ(countRows("prop0"), static_cast<int64_t>(1));
+        compareEQ(countRows("prop1"), static_cast<int64_t>(1));
+
+        auto getter = alex::GetQuery(fooDescriptor);
+        Foo  foo0_get{.id = foo0.id};
+        Foo  foo1_get{.id = foo1.id};
+        expectNoThrow([&] {
+            getter(foo0_get);
+            getter(foo1_get);
+        }).fatal("Failed to retrieve objects");
+        compareEQ(foo0.floats.get(), foo0_get.floats.get());
+        compareEQ(foo0.strings.get(), foo0_get.strings.get());
+        compareEQ(foo1.strings.get(), foo1_get.strings.get());
+    }
+
+    // Deleting objects removes the packed rows.
+    {
+        expectNoThrow([&] {
+            auto deleter = alex::DeleteQuery(fooDescriptor);
+            deleter(foo0);
+            deleter(foo1);
+        }).fatal("Failed to delete objects");
+        compareEQ(countRows("prop0"), static_cast<int64_t>(0));
+        compareEQ(countRows("prop1"), static_cast<int64_t>(0));
+    }
+}
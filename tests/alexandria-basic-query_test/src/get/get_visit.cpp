@@ -0,0 +1,191 @@
+#include "alexandria-basic-query_test/get/get_visit.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/codec.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId               id;
+        std::string                    name;
+        float                          radius = 0;
+        int32_t                        a      = 0;
+        alex::Blob<std::vector<float>> b;
+        alex::PrimitiveBlob<int32_t>   c;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"name", &Foo::name>,
+                                                       alex::Member<"radius", &Foo::radius>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>,
+                                                       alex::Member<"c", &Foo::c>>;
+
+    struct Bar
+    {
+        alex::InstanceId               id;
+        alex::Blob<std::vector<float>> a;
+        alex::PrimitiveBlob<int32_t>   b;
+        alex::PrimitiveBlob<int64_t>   c;
+    };
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>,
+                                                       alex::Member<"a", &Bar::a>,
+                                                       alex::Member<"b", &Bar::b>,
+                                                       alex::Member<"c", &Bar::c>>;
+
+    template<typename T>
+    std::vector<T> toVector(const std::span<const std::byte> bytes)
+    {
+        std::vector<T> values(bytes.size() / sizeof(T));
+        if (!values.empty()) std::memcpy(values.data(), bytes.data(), values.size() * sizeof(T));
+        return values;
+    }
+}  // namespace
+
+void GetVisit::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0");
+        fooLayout.createPrimitiveProperty("prop1", alex::DataType::Float);
+        fooLayout.createPrimitiveProperty("prop2", alex::DataType::Int32);
+        fooLayout.createBlobProperty("prop3");
+        fooLayout.createPrimitiveBlobProperty("prop4", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    // Create objects.
+    Foo foo0{.name = "foo0", .radius = 2.5f, .a = -4};
+    foo0.b.get() = {1.0f, 2.0f, 3.0f};
+    foo0.c.get() = {10, 20, 30, 40};
+    Foo foo1{.name = "foo1", .radius = 1.0f, .a = 8};
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    auto getter = alex::GetQuery(fooDescriptor);
+
+    // Visit object with blobs.
+    {
+        size_t calls = 0;
+        expectNoThrow([&] {
+            getter.visit(foo0.id, [&](const alex::RowView<FooDescriptor>& row) {
+                calls++;
+                compareEQ(foo0.id.getAsString(), std::string(row.getId()));
+                compareEQ(std::string_view("foo0"), row.get<"name">());
+                compareEQ(2.5f, row.get<"radius">());
+                compareEQ(-4, row.get<"a">());
+                compareEQ(foo0.b.get(), toVector<float>(row.get<"b">()));
+                compareEQ(foo0.c.get(), toVector<int32_t>(row.get<"c">()));
+            });
+        }).fatal("Failed to visit object");
+        compareEQ(1, calls);
+    }
+
+    // Visit object without blobs.
+    {
+        expectNoThrow([&] {
+            getter.visit(foo1.id, [&](const alex::RowView<FooDescriptor>& row) {
+                compareEQ(std::string_view("foo1"), row.get<"name">());
+                compareEQ(8, row.get<"a">());
+                compareTrue(row.get<"b">().empty());
+                compareTrue(row.get<"c">().empty());
+            });
+        }).fatal("Failed to visit object");
+    }
+
+    // Visiting an object that does not exist should throw.
+    {
+        Foo foo2 = foo0;
+        foo2.id.regenerate();
+        expectThrow([&] { getter.visit(foo2.id, [](const alex::RowView<FooDescriptor>&) {}); });
+    }
+
+    // Exceptions thrown by the callback are propagated and the query stays usable.
+    {
+        expectThrow([&] {
+            getter.visit(foo0.id, [](const alex::RowView<FooDescriptor>&) { throw std::runtime_error("error"); });
+        });
+
+        std::string name;
+        expectNoThrow([&] {
+            getter.visit(foo1.id, [&](const alex::RowView<FooDescriptor>& row) { name = row.get<"name">(); });
+        });
+        compareEQ(std::string("foo1"), name);
+    }
+
+    // Visiting and retrieving can be mixed.
+    {
+        Foo foo0_get;
+        expectNoThrow([&] { foo0_get = getter(foo0.id); }).fatal("Failed to retrieve object");
+        compareEQ(foo0.name, foo0_get.name);
+        compareEQ(foo0.c.get(), foo0_get.c.get());
+    }
+
+    expectNoThrow([&] {
+        alex::TypeLayout barLayout;
+        barLayout.createBlobProperty("prop0").setDeduplicated();
+        barLayout.createPrimitiveBlobProperty("prop1", alex::DataType::Int32).setExternal(64);
+        barLayout.createPrimitiveBlobProperty("prop2", alex::DataType::Int64).setCodec(alex::Codec::DeltaVarint);
+        barLayout.commit(*nameSpace, "bar");
+    }).fatal("Failed to commit types");
+
+    auto barDescriptor = BarDescriptor(nameSpace->getType("bar"));
+
+    // Two objects sharing a deduplicated value, one with an external value.
+    Bar bar0;
+    bar0.a.get() = {1.0f, 2.0f, 3.0f, 4.0f};
+    bar0.b.get().resize(1000);
+    for (size_t i = 0; i < bar0.b.get().size(); i++) bar0.b.get()[i] = static_cast<int32_t>(i) * 3;
+    bar0.c.get() = {1, 2, 3};
+    Bar bar1 = bar0;
+    bar1.b.get() = {5, 6};
+
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(barDescriptor);
+        inserter(bar0);
+        inserter(bar1);
+    }).fatal("Failed to insert objects");
+
+    auto barGetter = alex::GetQuery(barDescriptor);
+
+    // Deduplicated values are viewed as the shared blob, external values as the value in the external store.
+    {
+        for (const auto* bar : {&bar0, &bar1})
+        {
+            expectNoThrow([&] {
+                barGetter.visit(bar->id, [&](const alex::RowView<BarDescriptor>& row) {
+                    compareEQ(bar->a.get(), toVector<float>(row.get<"a">()));
+                    compareEQ(bar->b.get(), toVector<int32_t>(row.get<"b">()));
+                });
+            }).fatal("Failed to visit object");
+        }
+    }
+
+    // Values with a codec cannot be viewed.
+    {
+        expectThrow([&] {
+            barGetter.visit(bar0.id,
+                            [](const alex::RowView<BarDescriptor>& row) { static_cast<void>(row.get<"c">()); });
+        });
+    }
+}
@@ -60,7 +60,7 @@ void InsertBlobArray::operator()()
 
     // Insert Foo.
     {
-        const sql::TypedTable<sql::row_id, std::string, Baz> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, Baz, int64_t> arrayTable(
           library->getDatabase().getTable("main_foo_prop0"));
 
         auto inserter = alex::InsertQuery(FooDescriptor(fooType));
@@ -105,9 +105,9 @@ void InsertBlobArray::operator()()
 
     // Insert Bar.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::vector<Baz>> array0Table(
+        const sql::TypedTable<sql::row_id, std::string, std::vector<Baz>, int64_t> array0Table(
           library->getDatabase().getTable("main_bar_prop0"));
-        const sql::TypedTable<sql::row_id, std::string, std::vector<float>> array1Table(
+        const sql::TypedTable<sql::row_id, std::string, std::vector<float>, int64_t> array1Table(
           library->getDatabase().getTable("main_bar_prop1"));
 
         auto inserter = alex::InsertQuery(BarDescriptor(barType));
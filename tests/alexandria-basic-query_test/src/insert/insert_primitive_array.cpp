@@ -78,7 +78,7 @@ void InsertPrimitiveArray::operator()()
 
     // Insert Foo.
     {
-        const sql::TypedTable<sql::row_id, std::string, float> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, float, int64_t> arrayTable(
           library->getDatabase().getTable("main_foo_prop0"));
 
         auto inserter = alex::InsertQuery(FooDescriptor(fooType));
@@ -118,7 +118,7 @@ void InsertPrimitiveArray::operator()()
 
     // Insert Bar.
     {
-        const sql::TypedTable<sql::row_id, std::string, int32_t> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, int32_t, int64_t> arrayTable(
           library->getDatabase().getTable("main_bar_prop0"));
 
         auto inserter = alex::InsertQuery(BarDescriptor(barType));
@@ -158,9 +158,9 @@ void InsertPrimitiveArray::operator()()
 
     // Insert Baz.
     {
-        const sql::TypedTable<sql::row_id, std::string, uint32_t> array0Table(
+        const sql::TypedTable<sql::row_id, std::string, uint32_t, int64_t> array0Table(
           library->getDatabase().getTable("main_baz_prop0"));
-        const sql::TypedTable<sql::row_id, std::string, double> array1Table(
+        const sql::TypedTable<sql::row_id, std::string, double, int64_t> array1Table(
           library->getDatabase().getTable("main_baz_prop1"));
 
         auto inserter = alex::InsertQuery(BazDescriptor(bazType));
@@ -79,7 +79,7 @@ void InsertReferenceArray::operator()()
 
     // Insert Bar.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::string> arrayTable(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> arrayTable(
           library->getDatabase().getTable("main_bar_prop0"));
 
         auto inserter = alex::InsertQuery(BarDescriptor(barType));
@@ -110,9 +110,9 @@ void InsertReferenceArray::operator()()
 
     // Insert Baz.
     {
-        const sql::TypedTable<sql::row_id, std::string, std::string> array0Table(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> array0Table(
           library->getDatabase().getTable("main_baz_prop0"));
-        const sql::TypedTable<sql::row_id, std::string, std::string> array1Table(
+        const sql::TypedTable<sql::row_id, std::string, std::string, int64_t> array1Table(
           library->getDatabase().getTable("main_baz_prop1"));
 
         auto inserter = alex::InsertQuery(BazDescriptor(bazType));
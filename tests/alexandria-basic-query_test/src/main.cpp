@@ -20,9 +20,16 @@
 #include "alexandria-basic-query_test/delete/delete_reference_array.h"
 #include "alexandria-basic-query_test/delete/delete_string.h"
 #include "alexandria-basic-query_test/delete/delete_string_array.h"
+#include "alexandria-basic-query_test/dump/dump_library.h"
+#include "alexandria-basic-query_test/get/get_array_slice.h"
 #include "alexandria-basic-query_test/get/get_blob.h"
 #include "alexandria-basic-query_test/get/get_blob_array.h"
+#include "alexandria-basic-query_test/get/get_blob_stream.h"
+#include "alexandria-basic-query_test/get/get_codec.h"
+#include "alexandria-basic-query_test/get/get_dedup.h"
+#include "alexandria-basic-query_test/get/get_external.h"
 #include "alexandria-basic-query_test/get/get_invalid.h"
+#include "alexandria-basic-query_test/get/get_packed_array.h"
 #include "alexandria-basic-query_test/get/get_primitive.h"
 #include "alexandria-basic-query_test/get/get_primitive_array.h"
 #include "alexandria-basic-query_test/get/get_primitive_blob.h"
@@ -30,6 +37,7 @@
 #include "alexandria-basic-query_test/get/get_reference_array.h"
 #include "alexandria-basic-query_test/get/get_string.h"
 #include "alexandria-basic-query_test/get/get_string_array.h"
+#include "alexandria-basic-query_test/get/get_visit.h"
 #include "alexandria-basic-query_test/insert/insert_blob.h"
 #include "alexandria-basic-query_test/insert/insert_blob_array.h"
 #include "alexandria-basic-query_test/insert/insert_invalid.h"
@@ -40,6 +48,10 @@
 #include "alexandria-basic-query_test/insert/insert_reference_array.h"
 #include "alexandria-basic-query_test/insert/insert_string.h"
 #include "alexandria-basic-query_test/insert/insert_string_array.h"
+#include "alexandria-basic-query_test/observe/observe_change_feed.h"
+#include "alexandria-basic-query_test/observe/observe_queries.h"
+#include "alexandria-basic-query_test/shard/shard_queries.h"
+#include "alexandria-basic-query_test/update/update_array_elements.h"
 #include "alexandria-basic-query_test/update/update_blob.h"
 #include "alexandria-basic-query_test/update/update_blob_array.h"
 #include "alexandria-basic-query_test/update/update_invalid.h"
@@ -80,10 +92,18 @@ int main(const int argc, char** argv)
       DeleteReferenceArray,
       DeleteString,
       DeleteStringArray,
+      // dump
+      DumpLibrary,
       // get
+      GetArraySlice,
       GetBlob,
       GetBlobArray,
+      GetBlobStream,
+      GetCodec,
+      GetDedup,
+      GetExternal,
       GetInvalid,
+      GetPackedArray,
       GetPrimitive,
       GetPrimitiveArray,
       GetPrimitiveBlob,
@@ -91,6 +111,7 @@ int main(const int argc, char** argv)
       GetReferenceArray,
       GetString,
       GetStringArray,
+      GetVisit,
       // insert
       InsertBlob,
       InsertBlobArray,
@@ -102,7 +123,13 @@ int main(const int argc, char** argv)
       InsertReferenceArray,
       InsertString,
       InsertStringArray,
+      // observe
+      ObserveChangeFeed,
+      ObserveQueries,
+      // shard
+      ShardQueries,
       // update
+      UpdateArrayElements,
       UpdateBlob,
       UpdateBlobArray,
       UpdateInvalid,
@@ -0,0 +1,132 @@
+#include "alexandria-basic-query_test/observe/observe_change_feed.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/change_log.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/array_query.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId            id;
+        int64_t                     a = 0;
+        alex::PrimitiveArray<float> floats;
+    };
+
+    struct Bar
+    {
+        alex::InstanceId              id;
+        alex::PrimitiveArray<int32_t> ints;
+        alex::StringArray             strings;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"floats", &Foo::floats>>;
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>,
+                                                       alex::Member<"ints", &Bar::ints>,
+                                                       alex::Member<"strings", &Bar::strings>>;
+}  // namespace
+
+void ObserveChangeFeed::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int64);
+        fooLayout.createPrimitiveArrayProperty("prop1", alex::DataType::Float);
+        fooLayout.commit(*nameSpace, "foo");
+
+        // Bar has no columns besides the UUID.
+        alex::TypeLayout barLayout;
+        barLayout.createPrimitiveArrayProperty("prop0", alex::DataType::Int32);
+        barLayout.createStringArrayProperty("prop1");
+        barLayout.commit(*nameSpace, "bar");
+    }).fatal("Failed to commit types");
+
+    expectNoThrow([&] { library->enableChangeLog(); }).fatal("Failed to enable change log");
+
+    auto& fooType       = nameSpace->getType("foo");
+    auto& barType       = nameSpace->getType("bar");
+    auto  fooDescriptor = FooDescriptor(fooType);
+    auto  barDescriptor = BarDescriptor(barType);
+    auto  fooInserter   = alex::InsertQuery(fooDescriptor);
+    auto  barInserter   = alex::InsertQuery(barDescriptor);
+    auto  fooUpdater    = alex::UpdateQuery(fooDescriptor);
+    auto  barUpdater    = alex::UpdateQuery(barDescriptor);
+    auto  fooDeleter    = alex::DeleteQuery(fooDescriptor);
+    auto  barDeleter    = alex::DeleteQuery(barDescriptor);
+
+    std::unique_ptr<alex::ChangeFeed> feed;
+    expectNoThrow([&] { feed = std::make_unique<alex::ChangeFeed>(*library, "consumer"); })
+      .fatal("Failed to open feed");
+
+    const auto expectChanges = [&](const std::vector<std::pair<const alex::Type*, const alex::InstanceId*>>& ids,
+                                   const alex::ChangeOp                                                  op) {
+        std::vector<alex::Change> changes;
+        expectNoThrow([&] { changes = feed->next(); }).fatal("Failed to read feed");
+        compareEQ(changes.size(), ids.size()).fatal("Unexpected number of changes");
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            compareEQ(changes[i].type, ids[i].first->getId());
+            compareTrue(changes[i].id == *ids[i].second);
+            compareTrue(changes[i].op == op);
+        }
+        expectNoThrow([&] { feed->acknowledge(); });
+    };
+
+    Foo foo;
+    foo.a            = 10;
+    foo.floats.get() = {1.0f, 2.0f};
+    Bar bar;
+    bar.ints.get()    = {1, 2, 3};
+    bar.strings.get() = {"abc"};
+
+    // Inserts are recorded once per instance, not per array element.
+    expectNoThrow([&] {
+        fooInserter(foo);
+        barInserter(bar);
+    }).fatal("Failed to insert objects");
+    expectChanges({{&fooType, &foo.id}, {&barType, &bar.id}}, alex::ChangeOp::Insert);
+
+    // Updates are recorded as well for types without any column besides the UUID.
+    foo.a             = 20;
+    bar.ints.get()    = {4, 5};
+    bar.strings.get() = {"def", "ghi"};
+    expectNoThrow([&] {
+        fooUpdater(foo);
+        barUpdater(bar);
+    }).fatal("Failed to update objects");
+    expectChanges({{&fooType, &foo.id}, {&barType, &bar.id}}, alex::ChangeOp::Update);
+
+    // Modifying single arrays is recorded as an update of the instance.
+    expectNoThrow([&] {
+        alex::ArrayAppendQuery<FooDescriptor, "floats">(fooDescriptor)(foo.id, 3.0f);
+        alex::ArrayAppendQuery<BarDescriptor, "ints">(barDescriptor)(bar.id, std::vector{6, 7});
+    }).fatal("Failed to append elements");
+    expectChanges({{&fooType, &foo.id}, {&barType, &bar.id}}, alex::ChangeOp::Update);
+
+    expectNoThrow([&] {
+        fooDeleter(foo);
+        barDeleter(bar);
+    }).fatal("Failed to delete objects");
+    expectChanges({{&fooType, &foo.id}, {&barType, &bar.id}}, alex::ChangeOp::Delete);
+
+    expectNoThrow([&] { compareTrue(feed->next().empty()); });
+}
@@ -0,0 +1,167 @@
+#include "alexandria-basic-query_test/observe/observe_queries.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/histogram_observer.h"
+#include "alexandria-core/query_observer.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId            id;
+        int64_t                     a = 0;
+        std::string                 b;
+        alex::PrimitiveArray<float> floats;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>,
+                                                       alex::Member<"floats", &Foo::floats>>;
+
+    class RecordingObserver final : public alex::QueryObserver
+    {
+    public:
+        void onQuery(const alex::QueryEvent& event) override { events.push_back(event); }
+
+        void onStatement(const alex::StatementEvent&) override { statements++; }
+
+        std::vector<alex::QueryEvent> events;
+        size_t                        statements = 0;
+    };
+}  // namespace
+
+void ObserveQueries::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int64);
+        fooLayout.createStringProperty("prop1");
+        fooLayout.createPrimitiveArrayProperty("prop2", alex::DataType::Float);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& fooType  = nameSpace->getType("foo");
+    auto  inserter = alex::InsertQuery(FooDescriptor(fooType));
+    auto  getter   = alex::GetQuery(FooDescriptor(fooType));
+    auto  deleter  = alex::DeleteQuery(FooDescriptor(fooType));
+
+    Foo foo;
+    foo.a            = 10;
+    foo.b            = "abc";
+    foo.floats.get() = {1.0f, 2.0f, 3.0f};
+    compareTrue(library->getQueryObserver() == nullptr);
+    expectNoThrow([&] { inserter(foo); }).fatal("Failed to insert object");
+
+    RecordingObserver observer;
+    expectNoThrow([&] { library->setQueryObserver(&observer); }).fatal("Failed to register observer");
+    compareTrue(library->getQueryObserver() == &observer);
+
+    // Get reports each stage in order, followed by the whole query.
+    {
+        Foo foo_get;
+        foo_get.id = foo.id;
+        expectNoThrow([&] { getter(foo_get); }).fatal("Failed to retrieve object");
+
+        const std::vector stages = {alex::QueryStage::Uuid,
+                                    alex::QueryStage::Begin,
+                                    alex::QueryStage::Primitive,
+                                    alex::QueryStage::PrimitiveArray,
+                                    alex::QueryStage::BlobArray,
+                                    alex::QueryStage::ReferenceArray,
+                                    alex::QueryStage::Commit,
+                                    alex::QueryStage::Total};
+        compareEQ(observer.events.size(), stages.size()).fatal("Unexpected number of events");
+        for (size_t i = 0; i < stages.size(); i++)
+        {
+            const auto& event = observer.events[i];
+            compareTrue(event.stage == stages[i]);
+            compareTrue(event.type == &fooType);
+            compareTrue(event.query == alex::QueryClass::Get);
+            compareFalse(event.failed);
+        }
+
+        // One instance row and three elements of 8 bytes each were returned.
+        compareEQ(observer.events[2].rows, uint64_t{1});
+        compareEQ(observer.events[3].rows, uint64_t{3});
+        compareEQ(observer.events[3].bytes, uint64_t{24});
+        compareEQ(observer.events[7].rows, uint64_t{4});
+        compareTrue(observer.statements > 0);
+    }
+
+    // Insert counts the modified rows.
+    {
+        observer.events.clear();
+        Foo foo2;
+        foo2.floats.get() = {4.0f, 5.0f};
+        expectNoThrow([&] { inserter(foo2); }).fatal("Failed to insert object");
+        compareTrue(observer.events.back().stage == alex::QueryStage::Total);
+        compareTrue(observer.events.back().query == alex::QueryClass::Insert);
+        compareEQ(observer.events.back().rows, uint64_t{3});
+
+        observer.events.clear();
+        expectNoThrow([&] { deleter(foo2); }).fatal("Failed to delete object");
+        compareTrue(observer.events.back().stage == alex::QueryStage::Total);
+        compareTrue(observer.events.back().query == alex::QueryClass::Delete);
+    }
+
+    // A query that throws is reported as failed.
+    {
+        observer.events.clear();
+        Foo missing;
+        missing.id.regenerate();
+        expectThrow([&] { getter(missing); });
+        compareFalse(observer.events.empty()).fatal("No events reported");
+        compareTrue(observer.events.back().stage == alex::QueryStage::Total);
+        compareTrue(observer.events.back().failed);
+    }
+
+    // Histogram observer records a histogram per type, query class and stage.
+    alex::HistogramObserver histograms;
+    expectNoThrow([&] { library->setQueryObserver(&histograms); }).fatal("Failed to register observer");
+    for (size_t i = 0; i < 10; i++)
+    {
+        Foo foo_get;
+        foo_get.id = foo.id;
+        expectNoThrow([&] { getter(foo_get); }).fatal("Failed to retrieve object");
+    }
+
+    const auto* total = histograms.getStage(fooType, alex::QueryClass::Get, alex::QueryStage::Total);
+    compareTrue(total != nullptr).fatal("Missing histogram");
+    compareEQ(total->latency.count(), uint64_t{10});
+    compareEQ(total->rows.load(), uint64_t{40});
+    compareEQ(total->failed.load(), uint64_t{0});
+    compareTrue(total->latency.percentile(50.0) <= total->latency.max());
+    compareTrue(histograms.getStage(fooType, alex::QueryClass::Insert, alex::QueryStage::Total) == nullptr);
+    compareTrue(histograms.getStatements().count() > 0);
+
+    std::stringstream dump;
+    histograms.dump(dump);
+    compareTrue(dump.str().find("primitive_array") != std::string::npos);
+
+    // Nothing is reported after removing the observer.
+    expectNoThrow([&] { library->setQueryObserver(nullptr); }).fatal("Failed to remove observer");
+    const auto statements = histograms.getStatements().count();
+    {
+        Foo foo_get;
+        foo_get.id = foo.id;
+        expectNoThrow([&] { getter(foo_get); }).fatal("Failed to retrieve object");
+    }
+    compareEQ(total->latency.count(), uint64_t{10});
+    compareEQ(histograms.getStatements().count(), statements);
+}
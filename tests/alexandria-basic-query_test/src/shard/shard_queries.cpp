@@ -0,0 +1,124 @@
+#include "alexandria-basic-query_test/shard/shard_queries.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/sharded_library.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/sharded_query.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId id;
+        float            a = 0;
+        int32_t          b = 0;
+    };
+
+    struct Bar
+    {
+        alex::InstanceId     id;
+        alex::Reference<Foo> foo;
+    };
+
+    using FooDescriptor = alex::
+      GenerateTypeDescriptor<alex::Member<"id", &Foo::id>, alex::Member<"a", &Foo::a>, alex::Member<"b", &Foo::b>>;
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>, alex::Member<"foo", &Bar::foo>>;
+}  // namespace
+
+void ShardQueries::operator()()
+{
+    alex::ShardedLibraryPtr library;
+    expectNoThrow([&] {
+        library = alex::ShardedLibrary::create({"", "", "", ""});
+        library->updateSpecification([](alex::Library& shard) {
+            auto& nameSpace = shard.createNamespace("main");
+
+            alex::TypeLayout fooLayout;
+            fooLayout.createPrimitiveProperty("prop0", alex::DataType::Float);
+            fooLayout.createPrimitiveProperty("prop1", alex::DataType::Int32);
+            fooLayout.commit(nameSpace, "foo");
+
+            alex::TypeLayout barLayout;
+            barLayout.createReferenceProperty("prop0", nameSpace.getType("foo"));
+            barLayout.commit(nameSpace, "bar");
+        });
+    }).fatal("Failed to create library");
+
+    alex::ShardedInsertQuery<FooDescriptor> fooInserter(*library, "main", "foo");
+    alex::ShardedInsertQuery<BarDescriptor> barInserter(*library, "main", "bar");
+    alex::ShardedGetQuery<FooDescriptor>    fooGetter(*library, "main", "foo");
+    alex::ShardedUpdateQuery<FooDescriptor> fooUpdater(*library, "main", "foo");
+    alex::ShardedDeleteQuery<FooDescriptor> fooDeleter(*library, "main", "foo");
+    alex::ShardedGetQuery<BarDescriptor>    barGetter(*library, "main", "bar");
+
+    // Insert instances. They are distributed over all shards.
+    std::vector<Foo>    foos(64);
+    std::vector<size_t> counts(library->getShardCount());
+    for (size_t i = 0; i < foos.size(); i++)
+    {
+        foos[i].a = static_cast<float>(i);
+        foos[i].b = static_cast<int32_t>(i);
+        expectNoThrow([&] { fooInserter(foos[i]); }).fatal("Failed to insert object");
+        compareTrue(foos[i].id.valid());
+        counts[library->getShardIndex(foos[i].id)]++;
+    }
+    for (const auto count : counts) compareTrue(count > 0);
+
+    // Instances with an ID are rejected.
+    expectThrow([&] { fooInserter(foos[0]); });
+
+    // Retrieve instances from the shard they were routed to.
+    for (const auto& foo : foos)
+    {
+        Foo foo_get;
+        expectNoThrow([&] { foo_get = fooGetter(foo.id); }).fatal("Failed to retrieve object");
+        compareEQ(foo_get.a, foo.a);
+        compareEQ(foo_get.b, foo.b);
+
+        // Instances are not visible through the queries of other shards.
+        const auto other = (library->getShardIndex(foo.id) + 1) % library->getShardCount();
+        expectThrow([&] { static_cast<void>(fooGetter.getQuery(other)(foo.id)); });
+    }
+
+    // Update.
+    foos[1].b = 100;
+    expectNoThrow([&] { compareTrue(fooUpdater(foos[1])); }).fatal("Failed to update object");
+    compareEQ(fooGetter(foos[1].id).b, 100);
+
+    // References within a shard succeed when co-located with the referenced instance.
+    Bar bar0;
+    bar0.foo = foos[2];
+    expectNoThrow([&] { barInserter.insertColocated(bar0, foos[2].id); }).fatal("Failed to insert object");
+    compareEQ(library->getShardIndex(bar0.id), library->getShardIndex(foos[2].id));
+    compareEQ(barGetter(bar0.id).foo.getId(), foos[2].id);
+
+    // References across shards fail like references to instances that do not exist.
+    Bar bar1;
+    bar1.foo = foos[3];
+
+    const auto other = library->getShardIndex(foos[3].id) == 0 ? size_t{1} : size_t{0};
+    expectThrow([&] { barInserter.getQuery(other)(bar1, library->generateId(other)); });
+
+    // Deleting only affects the shard of the instance, and nulls references within that shard.
+    expectNoThrow([&] { compareTrue(fooDeleter(foos[2].id)); }).fatal("Failed to delete object");
+    expectThrow([&] { static_cast<void>(fooGetter(foos[2].id)); });
+    compareTrue(barGetter(bar0.id).foo.isNone());
+    compareEQ(fooGetter(foos[3].id).b, 3);
+
+    // Invalid IDs cannot be routed.
+    alex::InstanceId invalid;
+    expectThrow([&] { static_cast<void>(fooGetter(invalid)); });
+    expectThrow([&] { fooDeleter(invalid); });
+}
@@ -0,0 +1,218 @@
+#include "alexandria-basic-query_test/update/update_array_elements.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/array_query.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/get_query.h"
+#include "alexandria-basic-query/insert_query.h"
+
+namespace
+{
+    struct Bar
+    {
+        alex::InstanceId id;
+        float            x;
+    };
+
+    struct Foo
+    {
+        alex::InstanceId                    id;
+        alex::PrimitiveArray<int32_t>       ints;
+        alex::StringArray                   strings;
+        alex::PrimitiveArray<float>         packedFloats;
+        alex::BlobArray<std::vector<float>> blobs;
+        alex::ReferenceArray<Bar>           bars;
+    };
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>, alex::Member<"x", &Bar::x>>;
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"ints", &Foo::ints>,
+                                                       alex::Member<"strings", &Foo::strings>,
+                                                       alex::Member<"packedFloats", &Foo::packedFloats>,
+                                                       alex::Member<"blobs", &Foo::blobs>,
+                                                       alex::Member<"bars", &Foo::bars>>;
+}  // namespace
+
+void UpdateArrayElements::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout barLayout;
+        barLayout.createPrimitiveProperty("prop0", alex::DataType::Float);
+        barLayout.commit(*nameSpace, "bar");
+
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveArrayProperty("prop0", alex::DataType::Int32);
+        fooLayout.createStringArrayProperty("prop1");
+        fooLayout.createPrimitiveArrayProperty("prop2", alex::DataType::Float).setPacked();
+        fooLayout.createBlobArrayProperty("prop3").setDeduplicated();
+        fooLayout.createReferenceArrayProperty("prop4", nameSpace->getType("bar"));
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto& barType       = nameSpace->getType("bar");
+    auto& fooType       = nameSpace->getType("foo");
+    auto  barDescriptor = BarDescriptor(barType);
+    auto  fooDescriptor = FooDescriptor(fooType);
+
+    // Get the smallest row id in the array table of a property.
+    const auto minRowId = [&](const std::string& prop) {
+        alex::RawStatement stmt(library->getDatabase(),
+                                std::format("SELECT min(id) FROM {};",
+                                            alex::quoteIdentifier(fooType.getInstanceTable().getName() + "_" + prop)),
+                                false);
+        stmt.step();
+        return stmt.getInt64(0);
+    };
+
+    // Create objects.
+    std::vector<Bar> bars(4);
+    Foo              foo0, foo1;
+    foo0.ints.get()         = {1, 2, 3};
+    foo0.strings.get()      = {"a", "b"};
+    foo0.packedFloats.get() = {0.5f};
+    foo0.blobs.add(std::vector<float>{1.0f});
+
+    expectNoThrow([&] {
+        auto barInserter = alex::InsertQuery(barDescriptor);
+        for (auto& bar : bars) barInserter(bar);
+        foo0.bars.add(bars[0]);
+        auto fooInserter = alex::InsertQuery(fooDescriptor);
+        fooInserter(foo0);
+        fooInserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    auto getter = alex::GetQuery(fooDescriptor);
+    auto verify = [&](const Foo& expected) {
+        Foo foo_get{.id = expected.id};
+        expectNoThrow([&] { getter(foo_get); }).fatal("Failed to retrieve object");
+        compareEQ(expected.ints.get(), foo_get.ints.get());
+        compareEQ(expected.strings.get(), foo_get.strings.get());
+        compareEQ(expected.packedFloats.get(), foo_get.packedFloats.get());
+        compareEQ(expected.blobs.get(), foo_get.blobs.get());
+        compareTrue(expected.bars.get() == foo_get.bars.get());
+    };
+
+    // Append single elements and ranges. Existing rows are not rewritten.
+    {
+        const auto firstRow = minRowId("prop0");
+        expectNoThrow([&] {
+            alex::ArrayAppendQuery<FooDescriptor, "ints"> appendInts(fooDescriptor);
+            appendInts(foo0.id, 4);
+            appendInts(foo0.id, std::vector<int32_t>{5, 6});
+            alex::ArrayAppendQuery<FooDescriptor, "strings">(fooDescriptor)(foo0.id, "c");
+            alex::ArrayAppendQuery<FooDescriptor, "packedFloats">(fooDescriptor)(foo0.id, std::vector{1.5f, 2.5f});
+            alex::ArrayAppendQuery<FooDescriptor, "blobs">(fooDescriptor)(foo0.id, std::vector{2.0f, 3.0f});
+            alex::ArrayAppendQuery<FooDescriptor, "bars">(fooDescriptor)(foo0.id, bars[1].id);
+        }).fatal("Failed to append elements");
+        compareEQ(firstRow, minRowId("prop0"));
+
+        foo0.ints.get()         = {1, 2, 3, 4, 5, 6};
+        foo0.strings.get()      = {"a", "b", "c"};
+        foo0.packedFloats.get() = {0.5f, 1.5f, 2.5f};
+        foo0.blobs.add(std::vector{2.0f, 3.0f});
+        foo0.bars.add(bars[1]);
+        verify(foo0);
+    }
+
+    // Batch appends to several instances in one transaction. Empty arrays can be appended to as well.
+    {
+        alex::ArrayAppendQuery<FooDescriptor, "bars"> appendBars(fooDescriptor);
+        expectNoThrow([&] {
+            auto transaction = library->getDatabase().beginTransaction(sql::Transaction::Type::Deferred);
+            for (size_t i = 2; i < bars.size(); i++)
+            {
+                appendBars(foo0.id, bars[i].id);
+                appendBars(foo1.id, bars[i].id);
+            }
+            transaction.commit();
+        }).fatal("Failed to append elements");
+
+        foo0.bars.add(bars[2]);
+        foo0.bars.add(bars[3]);
+        foo1.bars.add(bars[2]);
+        foo1.bars.add(bars[3]);
+        verify(foo0);
+        verify(foo1);
+    }
+
+    // Erase elements. Following elements move up, so that slices still work.
+    {
+        size_t erased0 = 0, erased1 = 0, erased2 = 0, erased3 = 0;
+        expectNoThrow([&] {
+            alex::ArrayEraseQuery<FooDescriptor, "ints"> eraseInts(fooDescriptor);
+            erased0 = eraseInts(foo0.id, 1, 2);
+            erased1 = eraseInts(foo0.id, 3, 10);
+            erased2 = alex::ArrayEraseQuery<FooDescriptor, "packedFloats">(fooDescriptor)(foo0.id, 0);
+            erased3 = alex::ArrayEraseQuery<FooDescriptor, "strings">(fooDescriptor)(foo0.id, 5);
+            static_cast<void>(alex::ArrayEraseQuery<FooDescriptor, "blobs">(fooDescriptor)(foo0.id, 0));
+        }).fatal("Failed to erase elements");
+        compareEQ(erased0, static_cast<size_t>(2));
+        compareEQ(erased1, static_cast<size_t>(1));
+        compareEQ(erased2, static_cast<size_t>(1));
+        compareEQ(erased3, static_cast<size_t>(0));
+
+        foo0.ints.get()         = {1, 4, 5};
+        foo0.packedFloats.get() = {1.5f, 2.5f};
+        foo0.blobs.get().erase(foo0.blobs.get().begin());
+        verify(foo0);
+        compareEQ(getter.getSlice<"ints">(foo0.id, 1, 2), std::vector<int32_t>{4, 5});
+    }
+
+    // Deleting a referenced instance leaves a gap in the reference array. Elements are still addressed by index.
+    {
+        expectNoThrow([&] { alex::DeleteQuery(barDescriptor)(bars[1]); }).fatal("Failed to delete object");
+        size_t erased = 0;
+        expectNoThrow([&] {
+            erased = alex::ArrayEraseQuery<FooDescriptor, "bars">(fooDescriptor)(foo0.id, 1);
+        }).fatal("Failed to erase elements");
+        compareEQ(erased, static_cast<size_t>(1));
+
+        auto& ids = foo0.bars.get();
+        ids.erase(ids.begin() + 1, ids.begin() + 3);
+        verify(foo0);
+    }
+
+    // Replace elements.
+    {
+        expectNoThrow([&] {
+            alex::ArraySetQuery<FooDescriptor, "ints">(fooDescriptor)(foo0.id, 2, 50);
+            alex::ArraySetQuery<FooDescriptor, "strings">(fooDescriptor)(foo0.id, 0, "z");
+            alex::ArraySetQuery<FooDescriptor, "packedFloats">(fooDescriptor)(foo0.id, 1, -1.0f);
+            alex::ArraySetQuery<FooDescriptor, "blobs">(fooDescriptor)(foo0.id, 0, std::vector{4.0f});
+            alex::ArraySetQuery<FooDescriptor, "bars">(fooDescriptor)(foo0.id, 1, bars[2].id);
+        }).fatal("Failed to set elements");
+
+        foo0.ints.get()[2]         = 50;
+        foo0.strings.get()[0]      = "z";
+        foo0.packedFloats.get()[1] = -1.0f;
+        foo0.blobs.get()[0]        = {4.0f};
+        foo0.bars.get()[1]         = bars[2].id;
+        verify(foo0);
+
+        // Indices out of range are rejected without modifying the array.
+        expectThrow([&] { alex::ArraySetQuery<FooDescriptor, "ints">(fooDescriptor)(foo0.id, 3, 0); });
+        expectThrow([&] { alex::ArraySetQuery<FooDescriptor, "packedFloats">(fooDescriptor)(foo0.id, 2, 0.0f); });
+        expectThrow([&] { alex::ArraySetQuery<FooDescriptor, "bars">(fooDescriptor)(foo1.id, 2, bars[0].id); });
+        verify(foo0);
+        verify(foo1);
+    }
+
+    // Cannot modify arrays without a valid ID.
+    expectThrow([&] { alex::ArrayAppendQuery<FooDescriptor, "ints">(fooDescriptor)(alex::InstanceId{}, 1); });
+    expectThrow([&] { alex::ArrayEraseQuery<FooDescriptor, "ints">(fooDescriptor)(alex::InstanceId{}, 0); });
+    expectThrow([&] { alex::ArraySetQuery<FooDescriptor, "ints">(fooDescriptor)(alex::InstanceId{}, 0, 1); });
+}
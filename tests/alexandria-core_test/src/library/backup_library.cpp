@@ -0,0 +1,98 @@
+#include "alexandria-core_test/library/backup_library.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+
+namespace
+{
+    [[nodiscard]] int64_t countInstances(alex::Library& library)
+    {
+        alex::RawStatement stmt(library.getDatabase(), "SELECT count(*) FROM main_type;", false);
+        return stmt.step() ? stmt.getInt64(0) : -1;
+    }
+}  // namespace
+
+void BackupLibrary::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout layout;
+        layout.createStringProperty("p0");
+        layout.createPrimitiveArrayProperty("p1", alex::DataType::Int32);
+        layout.commit(*nameSpace, "type");
+    }).fatal("Failed to commit types");
+
+    // Insert enough instances to span several pages.
+    expectNoThrow([&] {
+        alex::RawStatement instance(library->getDatabase(), "INSERT INTO main_type (uuid, p0) VALUES (?1, ?2);");
+        for (int32_t i = 0; i < 1000; i++)
+        {
+            instance.bind(1, std::format("instance{}", i));
+            instance.bind(2, std::string(100, 'a'));
+            instance.step();
+            instance.reset();
+        }
+    }).fatal("Failed to insert rows");
+
+    // In-memory copy holds the same specification and instances, and is independent of the library.
+    {
+        alex::LibraryPtr copy;
+        expectNoThrow([&] { copy = library->backupToMemory(); }).fatal("Failed to back up library");
+        compareTrue(copy != nullptr).fatal("Backup was cancelled");
+        expectNoThrow([&] { static_cast<void>(copy->getNamespace("main").getType("type")); });
+        compareEQ(countInstances(*copy), int64_t{1000});
+
+        expectNoThrow([&] { alex::execute(copy->getDatabase(), "DELETE FROM main_type;"); });
+        compareEQ(countInstances(*copy), int64_t{0});
+        compareEQ(countInstances(*library), int64_t{1000});
+    }
+
+    const auto file = std::filesystem::current_path() / "backup.alex";
+    std::filesystem::remove(file);
+
+    // Copy to a file one page at a time, reporting progress after each step.
+    {
+        std::vector<alex::BackupProgress> progress;
+        bool                              completed = false;
+        expectNoThrow([&] {
+            completed = library->backupTo(file, 1, [&progress](const alex::BackupProgress& p) {
+                progress.push_back(p);
+                return true;
+            });
+        }).fatal("Failed to back up library");
+        compareTrue(completed);
+        compareTrue(progress.size() > 1).fatal("Expected more than one step");
+        compareTrue(progress.front().remaining > progress.back().remaining);
+        compareEQ(progress.back().remaining, int64_t{0});
+        compareEQ(progress.back().getFraction(), 1.0);
+
+        alex::LibraryPtr copy;
+        expectNoThrow([&] { copy = alex::Library::open(file); }).fatal("Failed to open backup");
+        compareEQ(countInstances(*copy), int64_t{1000});
+    }
+
+    // Backups do not overwrite existing files.
+    expectThrow([&] { library->backupTo(file); });
+    std::filesystem::remove(file);
+
+    // Cancelled backups leave no file behind.
+    {
+        bool completed = true;
+        const auto cancel = [](const alex::BackupProgress&) { return false; };
+        expectNoThrow([&] { completed = library->backupTo(file, 1, cancel); });
+        compareFalse(completed);
+        compareFalse(std::filesystem::exists(file));
+        compareTrue(library->backupToMemory(1, cancel) == nullptr);
+    }
+}
@@ -0,0 +1,97 @@
+#include "alexandria-core_test/library/create_sharded_library.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/sharded_library.h"
+#include "alexandria-core/type_layout.h"
+
+void CreateShardedLibrary::operator()()
+{
+    // Shard files are numbered after the base path.
+    const auto file  = std::filesystem::current_path() / "sharded.alex";
+    const auto files = alex::ShardedLibrary::getShardFiles(file, 3);
+    compareEQ(files.size(), size_t{3}).fatal("Wrong number of shard files");
+    compareEQ(files[0].filename().string(), std::string("sharded.alex.0"));
+    compareEQ(files[2].filename().string(), std::string("sharded.alex.2"));
+
+    // Try open, create and openOrCreate with and without existing files.
+    for (const auto& f : files) std::filesystem::remove(f);
+    expectThrow([&files] { alex::ShardedLibrary::open(files); });
+    expectNoThrow([&files] { alex::ShardedLibrary::create(files); });
+    expectNoThrow([&files] { alex::ShardedLibrary::open(files); });
+    expectThrow([&files] { alex::ShardedLibrary::create(files); });
+    expectNoThrow([&files, this] {
+        auto [lib, created] = alex::ShardedLibrary::openOrCreate(files);
+        compareFalse(created);
+    });
+
+    // A partial set of shard files is an error, not a reason to create the missing ones.
+    std::filesystem::remove(files[1]);
+    expectThrow([&files] { alex::ShardedLibrary::openOrCreate(files); });
+    for (const auto& f : files) std::filesystem::remove(f);
+
+    expectThrow([] { alex::ShardedLibrary::create({}); });
+
+    // In-memory shards.
+    alex::ShardedLibraryPtr library;
+    expectNoThrow([&library] { library = alex::ShardedLibrary::create({"", "", ""}); }).fatal("Failed to create");
+    compareEQ(library->getShardCount(), size_t{3});
+    expectThrow([&library] { static_cast<void>(library->getShard(3)); });
+
+    // The same specification can be committed to all shards.
+    expectNoThrow([&library] {
+        library->updateSpecification([](alex::Library& shard) {
+            auto&            nameSpace = shard.createNamespace("main");
+            alex::TypeLayout layout;
+            layout.createPrimitiveProperty("p0", alex::DataType::Int32);
+            layout.commit(nameSpace, "type");
+        });
+    }).fatal("Failed to update specification");
+
+    // Diverging specifications are detected.
+    expectThrow([&library] {
+        library->updateSpecification([&library](alex::Library& shard) {
+            if (&shard == &library->getShard(1)) shard.createNamespace("other");
+        });
+    });
+
+    // Routing is deterministic and generated IDs land in the requested shard.
+    alex::InstanceId invalid;
+    expectThrow([&library, &invalid] { static_cast<void>(library->getShardIndex(invalid)); });
+    std::vector<size_t> counts(library->getShardCount());
+    for (size_t i = 0; i < 300; i++)
+    {
+        alex::InstanceId id;
+        id.regenerate();
+        const auto index = library->getShardIndex(id);
+        compareEQ(library->getShardIndex(id), index);
+        counts[index]++;
+
+        const auto generated = library->generateId(i % library->getShardCount());
+        compareEQ(library->getShardIndex(generated), i % library->getShardCount());
+        compareEQ(&library->getShard(generated), &library->getShard(i % library->getShardCount()));
+    }
+    for (const auto count : counts) compareTrue(count > 0);
+
+    // Exceptions thrown on a shard are rethrown once all shards are done.
+    std::vector<size_t> visited(library->getShardCount());
+    expectThrow([&library, &visited] {
+        library->parallel([&visited](const size_t i) {
+            visited[i] = 1;
+            if (i == 1) throw std::runtime_error("");
+        });
+    });
+    for (const auto v : visited) compareEQ(v, size_t{1});
+}
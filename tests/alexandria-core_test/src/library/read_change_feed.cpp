@@ -0,0 +1,127 @@
+#include "alexandria-core_test/library/read_change_feed.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/change_log.h"
+#include "alexandria-core/raw_statement.h"
+
+void ReadChangeFeed::operator()()
+{
+    alex::Type* type0 = nullptr;
+    expectNoThrow([&] {
+        alex::TypeLayout layout;
+        layout.createPrimitiveProperty("p0", alex::DataType::Int32);
+        type0 = layout.commit(*nameSpace, "type0").second;
+    }).fatal("Failed to commit types");
+
+    // Feeds require the change log.
+    compareFalse(library->isChangeLogEnabled());
+    expectThrow([&] { alex::ChangeFeed feed(*library, "consumer"); });
+
+    expectNoThrow([&] { library->enableChangeLog(); }).fatal("Failed to enable change log");
+    compareTrue(library->isChangeLogEnabled());
+    expectNoThrow([&] { library->enableChangeLog(); });
+
+    // Types committed after enabling the change log are recorded as well.
+    alex::Type* type1 = nullptr;
+    expectNoThrow([&] {
+        alex::TypeLayout layout;
+        layout.createPrimitiveProperty("p0", alex::DataType::Int32);
+        type1 = layout.commit(*nameSpace, "type1").second;
+    }).fatal("Failed to commit types");
+
+    // Register the consumer before making any changes.
+    std::unique_ptr<alex::ChangeFeed> feed;
+    expectNoThrow([&] { feed = std::make_unique<alex::ChangeFeed>(*library, "consumer"); })
+      .fatal("Failed to open feed");
+    compareEQ(feed->getName(), std::string("consumer"));
+    compareEQ(feed->getPosition(), int64_t{0});
+
+    alex::InstanceId id0, id1;
+    id0.regenerate();
+    id1.regenerate();
+    const auto execute = [&](const std::string& sql, const alex::InstanceId& id = {}) {
+        alex::RawStatement stmt(library->getDatabase(), sql, false);
+        if (id.valid()) stmt.bind(1, id.getAsString());
+        stmt.step();
+    };
+    expectNoThrow([&] {
+        execute("INSERT INTO main_type0 (uuid, p0) VALUES (?1, 1);", id0);
+        execute("INSERT INTO main_type1 (uuid, p0) VALUES (?1, 2);", id1);
+        execute("UPDATE main_type0 SET p0 = 3;");
+        execute("DELETE FROM main_type1;");
+    }).fatal("Failed to modify instances");
+
+    // Read in batches of 3.
+    std::vector<alex::Change> changes;
+    expectNoThrow([&] { changes = feed->next(3); }).fatal("Failed to read feed");
+    compareEQ(changes.size(), size_t{3}).fatal("Unexpected number of changes");
+    compareEQ(changes[0].type, type0->getId());
+    compareTrue(changes[0].id == id0);
+    compareTrue(changes[0].op == alex::ChangeOp::Insert);
+    compareEQ(changes[1].type, type1->getId());
+    compareTrue(changes[1].id == id1);
+    compareTrue(changes[1].op == alex::ChangeOp::Insert);
+    compareTrue(changes[2].id == id0);
+    compareTrue(changes[2].op == alex::ChangeOp::Update);
+    compareTrue(changes[0].seq < changes[1].seq && changes[1].seq < changes[2].seq);
+    compareEQ(feed->getPosition(), changes[2].seq);
+    expectNoThrow([&] { feed->acknowledge(); });
+    compareEQ(feed->getAcknowledged(), changes[2].seq);
+
+    expectNoThrow([&] { changes = feed->next(3); }).fatal("Failed to read feed");
+    compareEQ(changes.size(), size_t{1}).fatal("Unexpected number of changes");
+    compareTrue(changes[0].id == id1);
+    compareTrue(changes[0].op == alex::ChangeOp::Delete);
+    expectNoThrow([&] { compareTrue(feed->next().empty()); });
+
+    // Rewinding returns the unacknowledged change again.
+    feed->rewind();
+    expectNoThrow([&] { compareEQ(feed->next().size(), size_t{1}); });
+
+    // A new feed of the same consumer resumes after the acknowledged changes.
+    expectNoThrow([&] {
+        alex::ChangeFeed resumed(*library, "consumer");
+        compareEQ(resumed.getPosition(), feed->getAcknowledged());
+        compareEQ(resumed.next().size(), size_t{1});
+    });
+
+    // A new consumer starts after the most recent change.
+    expectNoThrow([&] {
+        alex::ChangeFeed other(*library, "other");
+        compareEQ(other.getPosition(), alex::ChangeLog::getLatestSequence(library->getDatabase()));
+        compareTrue(other.next().empty());
+    });
+
+    // Only changes acknowledged by every consumer are truncated.
+    expectNoThrow([&] { compareEQ(alex::ChangeLog::truncate(library->getDatabase()), int64_t{3}); });
+    expectNoThrow([&] { compareEQ(alex::ChangeLog::truncate(library->getDatabase()), int64_t{0}); });
+    expectNoThrow([&] {
+        compareTrue(feed->next().empty());
+        feed->acknowledge();
+        compareEQ(alex::ChangeLog::truncate(library->getDatabase()), int64_t{1});
+    });
+
+    // Sequence numbers are not reused after truncation.
+    expectNoThrow([&] {
+        execute("DELETE FROM main_type0;");
+        changes = feed->next();
+    });
+    compareEQ(changes.size(), size_t{1}).fatal("Unexpected number of changes");
+    compareEQ(changes[0].seq, int64_t{5});
+
+    expectNoThrow([&] {
+        compareTrue(alex::ChangeLog::removeConsumer(library->getDatabase(), "other"));
+        compareFalse(alex::ChangeLog::removeConsumer(library->getDatabase(), "other"));
+    });
+}
@@ -0,0 +1,90 @@
+#include "alexandria-core_test/library/read_storage_stats.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <string>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/storage_stats.h"
+
+void ReadStorageStats::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout layout;
+        layout.createStringProperty("p0");
+        layout.createPrimitiveArrayProperty("p1", alex::DataType::Int32);
+        layout.commit(*nameSpace, "type");
+    }).fatal("Failed to commit types");
+
+    // Insert 100 instances with 3 elements each.
+    expectNoThrow([&] {
+        alex::RawStatement instance(library->getDatabase(), "INSERT INTO main_type (uuid, p0) VALUES (?1, ?2);");
+        alex::RawStatement element(library->getDatabase(),
+                                   "INSERT INTO main_type_p1 (instance, value, position) VALUES (?1, ?2, ?3);");
+        for (int32_t i = 0; i < 100; i++)
+        {
+            const auto uuid = std::format("instance{}", i);
+            instance.bind(1, uuid);
+            instance.bind(2, std::string("abcd"));
+            instance.step();
+            instance.reset();
+
+            for (int32_t j = 0; j < 3; j++)
+            {
+                element.bind(1, uuid);
+                element.bind(2, i * j);
+                element.bind(3, j);
+                element.step();
+                element.reset();
+            }
+        }
+    }).fatal("Failed to insert rows");
+
+    alex::StorageStats stats;
+    expectNoThrow([&] { stats = library->storageStats(); }).fatal("Failed to read storage stats");
+
+    compareTrue(stats.pageSize > 0);
+    compareTrue(stats.pageCount > 0);
+    compareEQ(stats.types.size(), size_t{1}).fatal("Unexpected number of types");
+
+    const auto& type = stats.types[0];
+    compareEQ(type.nameSpace, std::string("main"));
+    compareEQ(type.name, std::string("type"));
+    compareEQ(type.tables.size(), size_t{2}).fatal("Unexpected number of tables");
+
+    // Instance table with a unique index on the uuid column.
+    const auto& instances = type.tables[0];
+    compareEQ(instances.name, std::string("main_type"));
+    compareEQ(instances.kind, std::string("instance"));
+    compareEQ(instances.table.rows, uint64_t{100});
+    compareEQ(instances.indices.rows, uint64_t{100});
+    compareEQ(instances.table.size, instances.table.pages * stats.pageSize);
+    compareTrue(instances.table.getFragmentation() >= 0.0 && instances.table.getFragmentation() <= 1.0);
+
+    // Columns of the instance table.
+    const auto p0 = std::ranges::find(instances.columns, std::string("p0"), &alex::ColumnStats::name);
+    compareTrue(p0 != instances.columns.end()).fatal("Missing column");
+    compareEQ(p0->bytes, uint64_t{400});
+
+    // Array table with a position and a value index.
+    const auto& elements = type.tables[1];
+    compareEQ(elements.name, std::string("main_type_p1"));
+    compareEQ(elements.kind, std::string("primitive_array"));
+    compareEQ(elements.table.rows, uint64_t{300});
+    compareEQ(elements.indices.rows, uint64_t{600});
+
+    // Totals of the type.
+    compareEQ(type.table.rows, uint64_t{400});
+    compareEQ(type.table.pages, instances.table.pages + elements.table.pages);
+
+    // Library metadata.
+    compareTrue(std::ranges::find(stats.other, std::string("types"), &alex::TableStats::name) != stats.other.end());
+}
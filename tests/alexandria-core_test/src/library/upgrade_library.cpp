@@ -0,0 +1,86 @@
+#include "alexandria-core_test/library/upgrade_library.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <format>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/library.h"
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_layout.h"
+
+void UpgradeLibrary::operator()()
+{
+    const auto file = std::filesystem::current_path() / "upgrade.alex";
+    std::filesystem::remove(file);
+
+    // Write a library with the schema of version 0, i.e. without property options and array element positions.
+    expectNoThrow([&] {
+        const auto db = sql::Database::create(file);
+        alex::execute(
+          *db,
+          std::format(
+            "CREATE TABLE namespaces (id INTEGER PRIMARY KEY NOT NULL, name TEXT NOT NULL);"
+            "CREATE TABLE types (id INTEGER PRIMARY KEY NOT NULL, namespace INTEGER NOT NULL REFERENCES "
+            "namespaces(id) ON DELETE RESTRICT, name TEXT NOT NULL UNIQUE, is_instance INTEGER NOT NULL);"
+            "CREATE TABLE properties (id INTEGER PRIMARY KEY NOT NULL, type INTEGER NOT NULL REFERENCES types(id) ON "
+            "DELETE RESTRICT, name TEXT, datatype TEXT, reference_type INTEGER REFERENCES types(id), is_array "
+            "INTEGER, is_blob INTEGER);"
+            "CREATE TABLE tables (id INTEGER PRIMARY KEY NOT NULL, type INTEGER NOT NULL REFERENCES types(id) ON "
+            "DELETE RESTRICT, name TEXT, kind TEXT);"
+            "INSERT INTO namespaces VALUES (1, 'main');"
+            "INSERT INTO types VALUES (1, 1, 'type', 1);"
+            "INSERT INTO properties VALUES (1, 1, 'p0', '{0}', NULL, 0, 0), (2, 1, 'p1', '{0}', NULL, 1, 0);"
+            "INSERT INTO tables VALUES (1, 1, 'main_type', 'instance'), (2, 1, 'main_type_p1', 'primitive_array');"
+            "CREATE TABLE main_type (id INTEGER PRIMARY KEY, uuid TEXT NOT NULL UNIQUE, p0 INTEGER);"
+            "CREATE TABLE main_type_p1 (id INTEGER PRIMARY KEY, instance TEXT NOT NULL REFERENCES main_type(uuid) ON "
+            "DELETE CASCADE, value INTEGER);"
+            "INSERT INTO main_type VALUES (1, 'a', 10), (2, 'b', 20);"
+            "INSERT INTO main_type_p1 (instance, value) VALUES ('a', 5), ('b', 6), ('a', 7), ('b', 8), ('a', 9);",
+            toString(alex::DataType::Int32)));
+    }).fatal("Failed to write library");
+
+    // Opening upgrades the schema. Elements are numbered in order of insertion.
+    alex::LibraryPtr library;
+    expectNoThrow([&] { library = alex::Library::open(file); }).fatal("Failed to open library");
+    {
+        auto& type = library->getNamespace("main").getType("type");
+        compareEQ(type.getExternalThreshold("p0"), static_cast<int64_t>(0));
+
+        alex::RawStatement stmt(
+          library->getDatabase(), "SELECT instance, position FROM main_type_p1 ORDER BY instance, value;", false);
+        std::vector<std::string> positions;
+        while (stmt.step()) positions.emplace_back(std::format("{}{}", stmt.getText(0), stmt.getInt64(1)));
+        compareEQ(positions, std::vector<std::string>{"a0", "a1", "a2", "b0", "b1"});
+
+        alex::RawStatement version(library->getDatabase(), "PRAGMA user_version;", false);
+        compareTrue(version.step());
+        compareEQ(version.getInt64(0), static_cast<int64_t>(1));
+    }
+
+    // Upgraded libraries accept new types and can be opened again.
+    expectNoThrow([&] {
+        alex::TypeLayout layout;
+        layout.createPrimitiveArrayProperty("p0", alex::DataType::Int32).setPacked(true);
+        layout.createBlobProperty("p1").setExternal(4096);
+        layout.commit(library->getNamespace("main"), "type2");
+    }).fatal("Failed to commit type");
+    library.reset();
+    expectNoThrow([&] { library = alex::Library::open(file); }).fatal("Failed to open library");
+    {
+        const auto& type = library->getNamespace("main").getType("type2");
+        compareTrue(type.isPacked("p0"));
+        compareEQ(type.getExternalThreshold("p1"), static_cast<int64_t>(4096));
+    }
+
+    library.reset();
+    std::filesystem::remove(file);
+}
@@ -10,7 +10,12 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-core_test/library/backup_library.h"
 #include "alexandria-core_test/library/create_library.h"
+#include "alexandria-core_test/library/create_sharded_library.h"
+#include "alexandria-core_test/library/read_change_feed.h"
+#include "alexandria-core_test/library/read_storage_stats.h"
+#include "alexandria-core_test/library/upgrade_library.h"
 #include "alexandria-core_test/member_types/member_type_blob.h"
 #include "alexandria-core_test/member_types/member_type_blob_custom.h"
 #include "alexandria-core_test/member_types/member_type_blob_array.h"
@@ -55,7 +60,12 @@ int main(const int argc, char** argv)
 
     bt::run<
       // library
+      BackupLibrary,
       CreateLibrary,
+      CreateShardedLibrary,
+      ReadChangeFeed,
+      ReadStorageStats,
+      UpgradeLibrary,
       // member_types
       MemberTypeBlob,
       MemberTypeBlobCustom,
@@ -0,0 +1,15 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_testutils/utils.h"
+
+class CachedSearch final : public utils::LibraryMember
+{
+public:
+    CachedSearch() : LibraryMember(false) {}
+
+    void operator()() override;
+};
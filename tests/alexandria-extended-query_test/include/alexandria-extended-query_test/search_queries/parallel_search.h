@@ -0,0 +1,17 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria_testutils/utils.h"
+
+class ParallelSearch final : public utils::LibraryMember
+{
+public:
+    static constexpr bool isParallel = false;
+
+    ParallelSearch() : LibraryMember(false) {}
+
+    void operator()() override;
+};
@@ -0,0 +1,211 @@
+#include "alexandria-extended-query_test/aggregate_query.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/aggregate_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId              id;
+        std::string                   name;
+        float                         radius = 0;
+        int32_t                       a      = 0;
+        alex::PrimitiveArray<int32_t> samples;
+
+        Foo() = default;
+
+        Foo(std::string n, const float r, const int32_t aa, std::vector<int32_t> ssamples) :
+            name(std::move(n)), radius(r), a(aa)
+        {
+            samples.get() = std::move(ssamples);
+        }
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"name", &Foo::name>,
+                                                       alex::Member<"radius", &Foo::radius>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"samples", &Foo::samples>>;
+}  // namespace
+
+void AggregateQuery::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0");
+        fooLayout.createPrimitiveProperty("prop1", alex::DataType::Float);
+        fooLayout.createPrimitiveProperty("prop2", alex::DataType::Int32);
+        fooLayout.createPrimitiveArrayProperty("prop3", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    Foo foo0("x", 1.0f, 1, {1, 2, 3});
+    Foo foo1("x", 3.0f, 2, {10});
+    Foo foo2("y", 2.0f, 3, {});
+    Foo foo3("z", 4.0f, 4, {5, 5});
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+        inserter(foo2);
+        inserter(foo3);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test aggregates over instance columns.
+     */
+
+    {
+        auto query = alex::aggregate(fooDescriptor,
+                                     alex::count<FooDescriptor>(),
+                                     alex::minimum<FooDescriptor, "radius">(),
+                                     alex::maximum<FooDescriptor, "name">(),
+                                     alex::sum<FooDescriptor, "a">(),
+                                     alex::average<FooDescriptor, "radius">());
+        const auto [count, minRadius, maxName, sumA, avgRadius] = query();
+        compareEQ(4, count);
+        compareTrue(minRadius.has_value());
+        compareEQ(1.0f, *minRadius);
+        compareTrue(maxName.has_value());
+        compareEQ(std::string("z"), *maxName);
+        compareEQ(10, sumA);
+        compareTrue(avgRadius.has_value());
+        compareEQ(2.5, *avgRadius);
+    }
+
+    /*
+     * Test aggregates over an array table.
+     */
+
+    {
+        auto query = alex::aggregate(fooDescriptor,
+                                     alex::count<FooDescriptor>(),
+                                     alex::count<FooDescriptor, "samples">(),
+                                     alex::minimum<FooDescriptor, "samples">(),
+                                     alex::maximum<FooDescriptor, "samples">(),
+                                     alex::sum<FooDescriptor, "samples">(),
+                                     alex::average<FooDescriptor, "samples">());
+        const auto [count, sampleCount, minSample, maxSample, sumSamples, avgSamples] = query();
+        compareEQ(4, count);
+        compareEQ(6, sampleCount);
+        compareEQ(1, minSample.value_or(-1));
+        compareEQ(10, maxSample.value_or(-1));
+        compareEQ(26, sumSamples);
+        compareTrue(avgSamples.has_value());
+        compareTrue(std::abs(*avgSamples - 26.0 / 6.0) < 1e-9);
+    }
+
+    /*
+     * Test group by.
+     */
+
+    {
+        auto query = alex::aggregate(fooDescriptor,
+                                     alex::groupBy<FooDescriptor, "name">(),
+                                     alex::count<FooDescriptor>(),
+                                     alex::maximum<FooDescriptor, "radius">(),
+                                     alex::sum<FooDescriptor, "samples">());
+        const auto rows = query();
+        compareEQ(3, rows.size()).fatal("Wrong number of groups");
+
+        compareEQ(std::string("x"), std::get<0>(rows[0]));
+        compareEQ(2, std::get<1>(rows[0]));
+        compareEQ(3.0f, std::get<2>(rows[0]).value_or(0));
+        compareEQ(16, std::get<3>(rows[0]));
+
+        compareEQ(std::string("y"), std::get<0>(rows[1]));
+        compareEQ(1, std::get<1>(rows[1]));
+        compareEQ(2.0f, std::get<2>(rows[1]).value_or(0));
+        compareEQ(0, std::get<3>(rows[1]));
+
+        compareEQ(std::string("z"), std::get<0>(rows[2]));
+        compareEQ(1, std::get<1>(rows[2]));
+        compareEQ(4.0f, std::get<2>(rows[2]).value_or(0));
+        compareEQ(10, std::get<3>(rows[2]));
+    }
+
+    /*
+     * Test filtering with a search expression.
+     */
+
+    {
+        auto query = alex::aggregate(fooDescriptor,
+                                     alex::greater<FooDescriptor, "radius">() ||
+                                       alex::contains<FooDescriptor, "samples">(),
+                                     alex::count<FooDescriptor>(),
+                                     alex::maximum<FooDescriptor, "a">(),
+                                     alex::sum<FooDescriptor, "samples">(),
+                                     alex::average<FooDescriptor, "radius">());
+
+        {
+            const auto [count, maxA, sumSamples, avgRadius] = query(2.5f, 2);
+            compareEQ(3, count);
+            compareEQ(4, maxA.value_or(-1));
+            compareEQ(26, sumSamples);
+            compareEQ(8.0 / 3.0, avgRadius.value_or(0));
+        }
+
+        // Empty selection.
+        {
+            const auto [count, maxA, sumSamples, avgRadius] = query(100.0f, 100);
+            compareEQ(0, count);
+            compareFalse(maxA.has_value());
+            compareEQ(0, sumSamples);
+            compareFalse(avgRadius.has_value());
+        }
+    }
+
+    {
+        auto query = alex::aggregate(fooDescriptor,
+                                     alex::greater<FooDescriptor, "radius">(),
+                                     alex::groupBy<FooDescriptor, "name">(),
+                                     alex::count<FooDescriptor>());
+        const auto rows = query(1.5f);
+        compareEQ(3, rows.size()).fatal("Wrong number of groups");
+        compareEQ(1, std::get<1>(rows[0]));
+        compareEQ(1, std::get<1>(rows[1]));
+        compareEQ(1, std::get<1>(rows[2]));
+    }
+
+    /*
+     * Test counting search results.
+     */
+
+    {
+        auto query = alex::search(fooDescriptor, alex::greater<FooDescriptor, "radius">());
+        query.limit(1);
+        query(2.5f);
+        compareEQ(2, query.count());
+        compareTrue(query.exists());
+
+        query(100.0f);
+        compareEQ(0, query.count());
+        compareFalse(query.exists());
+    }
+
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "name">());
+        query("x");
+        compareEQ(2, query.count());
+        compareTrue(query.exists());
+
+        query("w");
+        compareEQ(0, query.count());
+        compareFalse(query.exists());
+    }
+}
@@ -10,8 +10,19 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "alexandria-extended-query_test/aggregate_query.h"
+#include "alexandria-extended-query_test/search_queries/array_search.h"
+#include "alexandria-extended-query_test/search_queries/cached_search.h"
+#include "alexandria-extended-query_test/search_queries/expression_search.h"
+#include "alexandria-extended-query_test/search_queries/ordered_search.h"
+#include "alexandria-extended-query_test/search_queries/paged_search.h"
+#include "alexandria-extended-query_test/search_queries/parallel_search.h"
 #include "alexandria-extended-query_test/search_queries/primitive_search.h"
 #include "alexandria-extended-query_test/search_queries/reference_search.h"
+#include "alexandria-extended-query_test/search_queries/sharded_search.h"
+#include "alexandria-extended-query_test/search_queries/spatial_search.h"
+#include "alexandria-extended-query_test/search_queries/text_search.h"
+#include "alexandria-extended-query_test/search_queries/visit_search.h"
 #include "alexandria-extended-query_test/table_sets/table_sets_blob.h"
 #include "alexandria-extended-query_test/table_sets/table_sets_blob_array.h"
 #include "alexandria-extended-query_test/table_sets/table_sets_nested.h"
@@ -42,9 +53,21 @@ int main(const int argc, char** argv)
 #endif
 
     bt::run<
+      // aggregate queries
+      AggregateQuery,
       // search queries
+      ArraySearch,
+      CachedSearch,
+      ExpressionSearch,
+      OrderedSearch,
+      PagedSearch,
+      ParallelSearch,
       PrimitiveSearch,
       ReferenceSearch,
+      ShardedSearch,
+      SpatialSearch,
+      TextSearch,
+      VisitSearch,
       // table sets
       TableSetsBlob,
       TableSetsBlobArray,
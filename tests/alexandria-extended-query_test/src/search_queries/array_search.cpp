@@ -0,0 +1,158 @@
+#include "alexandria-extended-query_test/search_queries/array_search.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/array_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId              id;
+        int32_t                       a = 0;
+        alex::PrimitiveArray<int32_t> samples;
+        alex::StringArray             tags;
+
+        Foo() = default;
+
+        Foo(const int32_t aa, std::vector<int32_t> ssamples, std::vector<std::string> ttags) : a(aa)
+        {
+            samples.get() = std::move(ssamples);
+            tags.get()    = std::move(ttags);
+        }
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"samples", &Foo::samples>,
+                                                       alex::Member<"tags", &Foo::tags>>;
+}  // namespace
+
+void ArraySearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+        fooLayout.createPrimitiveArrayProperty("prop1", alex::DataType::Int32);
+        fooLayout.createStringArrayProperty("prop2");
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    Foo foo0(1, {1, 2, 3}, {"red", "green"});
+    Foo foo1(1, {10, 20, 30}, {"blue"});
+    Foo foo2(2, {5, 15}, {"red", "blue"});
+    Foo foo3(2, {}, {});
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+        inserter(foo2);
+        inserter(foo3);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test contains.
+     */
+
+    {
+        auto query = alex::arraySearch(fooDescriptor, alex::contains<FooDescriptor, "tags">());
+        query("red");
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo2.id}, ids);
+
+        query("blue");
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo2.id}, ids);
+
+        query("yellow");
+        ids.assign(query.begin(), query.end());
+        compareTrue(ids.empty());
+    }
+
+    {
+        auto query = alex::arraySearch(fooDescriptor, alex::contains<FooDescriptor, "samples">());
+        query(15);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo2.id}, ids);
+    }
+
+    /*
+     * Test any and all.
+     */
+
+    {
+        auto query =
+          alex::arraySearch(fooDescriptor, alex::any<FooDescriptor, "samples", alex::SearchOp::Greater>());
+        query(10);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo2.id}, ids);
+
+        query(20);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id}, ids);
+    }
+
+    {
+        // Empty arrays satisfy all comparisons.
+        auto query = alex::arraySearch(fooDescriptor, alex::all<FooDescriptor, "samples", alex::SearchOp::Less>());
+        query(10);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo3.id}, ids);
+
+        query(20);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo2.id, foo3.id}, ids);
+
+        // NULL values do not satisfy any comparison.
+        expectNoThrow([&] {
+            alex::RawStatement stmt(library->getDatabase(),
+                                    "INSERT INTO main_foo_prop1 (instance, value, position) VALUES (?1, NULL, 0);");
+            stmt.bind(1, foo3.id.getAsString());
+            stmt.step();
+        }).fatal("Failed to insert NULL value");
+        query(20);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo2.id}, ids);
+    }
+
+    /*
+     * Test composition with primitive search operators.
+     */
+
+    {
+        auto query = alex::arraySearchAnd(
+          fooDescriptor, alex::equal<FooDescriptor, "a">(), alex::contains<FooDescriptor, "tags">());
+        query(1, "red");
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id}, ids);
+
+        query(2, "blue");
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo2.id}, ids);
+    }
+
+    {
+        auto query = alex::arraySearchOr(fooDescriptor,
+                                         alex::contains<FooDescriptor, "tags">(),
+                                         alex::any<FooDescriptor, "samples", alex::SearchOp::GreaterEqual>());
+        query("green", 30);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo1.id}, ids);
+
+        // Paging is applied by the statement.
+        query.limit(1);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id}, ids);
+
+        query.after(foo0.id);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id}, ids);
+    }
+}
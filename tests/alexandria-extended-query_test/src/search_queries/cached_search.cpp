@@ -0,0 +1,157 @@
+#include "alexandria-extended-query_test/search_queries/cached_search.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+#include "alexandria-extended-query/search_queries/array_search.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId              id;
+        int32_t                       a = 0;
+        alex::PrimitiveArray<int32_t> samples;
+    };
+
+    struct Bar
+    {
+        alex::InstanceId id;
+        int32_t          a = 0;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"samples", &Foo::samples>>;
+
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>, alex::Member<"a", &Bar::a>>;
+}  // namespace
+
+void CachedSearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+        fooLayout.createPrimitiveArrayProperty("prop1", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+
+        alex::TypeLayout barLayout;
+        barLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+        barLayout.commit(*nameSpace, "bar");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+    auto barDescriptor = BarDescriptor(nameSpace->getType("bar"));
+
+    std::vector<Foo> foos(10);
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        for (size_t i = 0; i < foos.size(); i++)
+        {
+            foos[i].a = static_cast<int32_t>(i % 2);
+            foos[i].samples.get().push_back(static_cast<int32_t>(i));
+            inserter(foos[i]);
+        }
+    }).fatal("Failed to insert objects");
+
+    auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+    expectNoThrow([&] { query.cache(4); }).fatal("Failed to enable cache");
+    const auto& cache = *query.getCache();
+
+    std::vector<alex::InstanceId> ids;
+    const std::vector             evens{foos[0].id, foos[2].id, foos[4].id, foos[6].id, foos[8].id};
+
+    // Results are stored on the first iteration and returned from the cache afterwards.
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(evens, ids);
+    compareEQ(cache.getMisses(), uint64_t{1});
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(evens, ids);
+    compareEQ(cache.getHits(), uint64_t{1});
+
+    // Parameters and paging are part of the key.
+    ids.assign(query(1).begin(), query.end());
+    compareEQ(ids.size(), size_t{5});
+    ids.assign(query.limit(2)(0).begin(), query.end());
+    compareEQ(std::vector{foos[0].id, foos[2].id}, ids);
+    compareEQ(cache.getMisses(), uint64_t{3});
+    ids.assign(query.resetPaging()(0).begin(), query.end());
+    compareEQ(evens, ids);
+    compareEQ(cache.getHits(), uint64_t{2});
+    compareEQ(cache.size(), size_t{3});
+
+    // Modifying other types does not invalidate the results.
+    expectNoThrow([&] {
+        Bar bar;
+        alex::InsertQuery(barDescriptor)(bar);
+    }).fatal("Failed to insert object");
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(cache.getHits(), uint64_t{3});
+
+    // Updating an instance invalidates the results.
+    expectNoThrow([&] {
+        foos[0].a = 1;
+        alex::UpdateQuery(fooDescriptor)(foos[0]);
+    }).fatal("Failed to update object");
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(std::vector{foos[2].id, foos[4].id, foos[6].id, foos[8].id}, ids);
+    compareEQ(cache.getMisses(), uint64_t{4});
+
+    // Modifying an array table invalidates the results as well.
+    auto arrayQuery = alex::arraySearch(fooDescriptor, alex::contains<FooDescriptor, "samples">());
+    arrayQuery.cache();
+    ids.assign(arrayQuery(3).begin(), arrayQuery.end());
+    compareEQ(std::vector{foos[3].id}, ids);
+    expectNoThrow([&] { alex::execute(library->getDatabase(), "DELETE FROM main_foo_prop1 WHERE value = 3;"); })
+      .fatal("Failed to delete array values");
+    ids.assign(arrayQuery(3).begin(), arrayQuery.end());
+    compareTrue(ids.empty());
+    compareEQ(arrayQuery.getCache()->getHits(), uint64_t{0});
+
+    // Results found in an open transaction are not stored.
+    expectNoThrow([&] {
+        alex::execute(library->getDatabase(), "BEGIN;");
+        ids.assign(query(1).begin(), query.end());
+        ids.assign(query(1).begin(), query.end());
+        alex::execute(library->getDatabase(), "COMMIT;");
+    }).fatal("Failed to search in transaction");
+    compareEQ(ids.size(), size_t{6});
+    compareEQ(cache.getMisses(), uint64_t{6});
+
+    // Commits of other connections invalidate all results. The array table of the type was modified above, so the
+    // results are stored again first.
+    ids.assign(query(0).begin(), query.end());
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(cache.getMisses(), uint64_t{7});
+    compareEQ(cache.getHits(), uint64_t{4});
+    expectNoThrow([&] {
+        const auto other = alex::Library::open(std::filesystem::current_path() / "lib.db");
+        alex::execute(other->getDatabase(), "UPDATE main_foo SET prop0 = 0;");
+    }).fatal("Failed to update objects through other connection");
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(ids.size(), size_t{10});
+    compareEQ(cache.getMisses(), uint64_t{8});
+
+    // The least recently used entries are evicted.
+    for (int32_t i = 10; i < 20; i++) ids.assign(query(i).begin(), query.end());
+    compareEQ(cache.size(), size_t{4});
+
+    // Disabling the cache.
+    query.cache(0);
+    compareTrue(query.getCache() == nullptr);
+    ids.assign(query(0).begin(), query.end());
+    compareEQ(ids.size(), size_t{10});
+}
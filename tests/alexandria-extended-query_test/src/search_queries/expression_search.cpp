@@ -0,0 +1,143 @@
+#include "alexandria-extended-query_test/search_queries/expression_search.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId id;
+        int32_t          a = 0;
+    };
+
+    struct Bar
+    {
+        alex::InstanceId              id;
+        float                         radius = 0;
+        std::string                   name;
+        alex::ReferenceArray<Foo>     foos;
+        alex::PrimitiveArray<int32_t> values;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>, alex::Member<"a", &Foo::a>>;
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>,
+                                                       alex::Member<"radius", &Bar::radius>,
+                                                       alex::Member<"name", &Bar::name>,
+                                                       alex::Member<"foos", &Bar::foos>,
+                                                       alex::Member<"values", &Bar::values>>;
+}  // namespace
+
+void ExpressionSearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+
+        alex::TypeLayout barLayout;
+        barLayout.createPrimitiveProperty("prop0", alex::DataType::Float);
+        barLayout.createStringProperty("prop1");
+        barLayout.createReferenceArrayProperty("prop2", nameSpace->getType("foo"));
+        barLayout.createPrimitiveArrayProperty("prop3", alex::DataType::Int32);
+        barLayout.commit(*nameSpace, "bar");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+    auto barDescriptor = BarDescriptor(nameSpace->getType("bar"));
+
+    Foo foo0, foo1;
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+    }).fatal("Failed to insert objects");
+
+    Bar bar0{.radius = 0.5f, .name = "x"};
+    Bar bar1{.radius = 2.0f, .name = "y"};
+    Bar bar2{.radius = 3.0f, .name = "z"};
+    Bar bar3{.radius = 0.1f, .name = "w"};
+    bar0.foos.add(foo0);
+    bar0.values.get().push_back(1);
+    bar1.foos.add(foo0);
+    bar1.foos.add(foo1);
+    bar1.values.get().push_back(2);
+    bar2.foos.add(foo1);
+    bar3.values.get().push_back(5);
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(barDescriptor);
+        inserter(bar0);
+        inserter(bar1);
+        inserter(bar2);
+        inserter(bar3);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test nested conjunction and disjunction over primitive and reference operators.
+     */
+
+    {
+        auto query = alex::search(barDescriptor,
+                                  (alex::greater<BarDescriptor, "radius">() || alex::equal<BarDescriptor, "name">()) &&
+                                    alex::references<BarDescriptor, "foos">());
+        query(1.0f, "x", foo0.id);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{bar0.id, bar1.id}, ids);
+
+        query(1.0f, "x", foo1.id);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{bar1.id, bar2.id}, ids);
+    }
+
+    /*
+     * Test negation.
+     */
+
+    {
+        auto query = alex::search(barDescriptor, !alex::references<BarDescriptor, "foos">());
+        query(foo0.id);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{bar2.id, bar3.id}, ids);
+    }
+
+    /*
+     * Test conjunction of references matches the INTERSECT based search.
+     */
+
+    {
+        auto query = alex::search(barDescriptor,
+                                  alex::references<BarDescriptor, "foos">() &&
+                                    alex::references<BarDescriptor, "foos">());
+        query(foo0.id, foo1.id);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{bar1.id}, ids);
+
+        auto query2 = alex::referenceSearchAnd(
+          barDescriptor, alex::references<BarDescriptor, "foos">(), alex::references<BarDescriptor, "foos">());
+        query2(foo0.id, foo1.id);
+        std::vector<alex::InstanceId> ids2(query2.begin(), query2.end());
+        compareEQ(ids2, ids);
+    }
+
+    /*
+     * Test array operators inside expressions.
+     */
+
+    {
+        auto query = alex::search(barDescriptor,
+                                  (alex::contains<BarDescriptor, "values">() || alex::less<BarDescriptor, "radius">()) &&
+                                    alex::notEqual<BarDescriptor, "name">());
+        query(5, 1.0f, "w");
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{bar0.id}, ids);
+
+        query(5, 1.0f, "x");
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{bar3.id}, ids);
+    }
+}
@@ -0,0 +1,131 @@
+#include "alexandria-extended-query_test/search_queries/ordered_search.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId id;
+        std::string      name;
+        float            radius = 0;
+        int32_t          a      = 0;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"name", &Foo::name>,
+                                                       alex::Member<"radius", &Foo::radius>,
+                                                       alex::Member<"a", &Foo::a>>;
+}  // namespace
+
+void OrderedSearch::operator()()
+{
+    expectThrow([&] {
+        alex::TypeLayout layout;
+        layout.createPrimitiveArrayProperty("prop0", alex::DataType::Int32).setIndexed();
+    });
+
+    expectThrow([&] {
+        alex::TypeLayout layout;
+        layout.createPrimitiveBlobProperty("prop0", alex::DataType::Float).setIndexed();
+    });
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0");
+        fooLayout.createPrimitiveProperty("prop1", alex::DataType::Float).setIndexed();
+        fooLayout.createPrimitiveProperty("prop2", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    compareFalse(nameSpace->getType("foo").getLayout().getProperties()[0]->isIndexed());
+    compareTrue(nameSpace->getType("foo").getLayout().getProperties()[1]->isIndexed());
+
+    // Index was created.
+    {
+        const auto&        table = nameSpace->getType("foo").getInstanceTable();
+        alex::RawStatement stmt(
+          library->getDatabase(), "SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = ?1;", false);
+        stmt.bind(1, alex::PropertyLayout::getIndexName(table.getName(), "prop1"));
+        compareTrue(stmt.step());
+    }
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    Foo foo0{.name = "b", .radius = 3.0f, .a = 1};
+    Foo foo1{.name = "a", .radius = 1.0f, .a = 1};
+    Foo foo2{.name = "b", .radius = 4.0f, .a = 0};
+    Foo foo3{.name = "a", .radius = 2.0f, .a = 1};
+    Foo foo4{.name = "c", .radius = 2.0f, .a = 1};
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+        inserter(foo2);
+        inserter(foo3);
+        inserter(foo4);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test ordering by a single key.
+     */
+
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+        query.orderBy<"radius">();
+        query(1);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo3.id, foo4.id, foo0.id}, ids);
+
+    }
+
+    {
+        // Ties are broken by rowid in the direction of the key.
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+        query.orderBy<"radius">(alex::Order::Descending);
+        query(1);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo4.id, foo3.id, foo1.id}, ids);
+    }
+
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::greaterEqual<FooDescriptor, "radius">());
+        query.orderBy<"radius">(alex::Order::Descending);
+
+        // Top-N.
+        query.limit(2)(0.0f);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo2.id, foo0.id}, ids);
+
+        // Statement is reused with other parameter values.
+        query.limit(-1)(2.0f);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo2.id, foo0.id, foo4.id, foo3.id}, ids);
+
+        query.offset(3);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo3.id}, ids);
+
+        expectThrow([&] { query.after(foo0.id); });
+    }
+
+    /*
+     * Test ordering by multiple keys.
+     */
+
+    {
+        auto query = alex::search(fooDescriptor, alex::greater<FooDescriptor, "radius">());
+        query(0.0f);
+        query.orderBy<"name">().orderBy<"radius">(alex::Order::Descending);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo3.id, foo1.id, foo2.id, foo0.id, foo4.id}, ids);
+        compareEQ(5, query.count());
+    }
+}
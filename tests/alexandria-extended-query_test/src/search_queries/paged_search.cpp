@@ -0,0 +1,143 @@
+#include "alexandria-extended-query_test/search_queries/paged_search.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+#include "alexandria-extended-query/search_queries/reference_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId id;
+        int32_t          a = 0;
+    };
+
+    struct Bar
+    {
+        alex::InstanceId          id;
+        alex::ReferenceArray<Foo> foos;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>, alex::Member<"a", &Foo::a>>;
+    using BarDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Bar::id>, alex::Member<"foos", &Bar::foos>>;
+}  // namespace
+
+void PagedSearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+        fooLayout.commit(*nameSpace, "foo");
+
+        alex::TypeLayout barLayout;
+        barLayout.createReferenceArrayProperty("prop0", nameSpace->getType("foo"));
+        barLayout.commit(*nameSpace, "bar");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+    auto barDescriptor = BarDescriptor(nameSpace->getType("bar"));
+
+    std::vector<Foo> foos(10);
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        for (int32_t i = 0; i < 10; i++)
+        {
+            foos[i].a = i % 2;
+            inserter(foos[i]);
+        }
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test limit and offset.
+     */
+
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+        query.limit(2)(0);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foos[0].id, foos[2].id}, ids);
+
+        query.offset(3)(0);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[6].id, foos[8].id}, ids);
+
+        query.offset(4)(0);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[8].id}, ids);
+
+        query.resetPaging()(1);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[1].id, foos[3].id, foos[5].id, foos[7].id, foos[9].id}, ids);
+    }
+
+    /*
+     * Test keyset pagination.
+     */
+
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+        query.limit(2);
+
+        query(1);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foos[1].id, foos[3].id}, ids);
+
+        expectNoThrow([&] { query.after(ids.back()); });
+        query(1);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[5].id, foos[7].id}, ids);
+
+        expectNoThrow([&] { query.after(ids.back()); });
+        query(1);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[9].id}, ids);
+
+        expectNoThrow([&] { query.after(ids.back()); });
+        query(1);
+        ids.assign(query.begin(), query.end());
+        compareTrue(ids.empty());
+
+        // Rowids are assigned in insertion order.
+        query.after(sql::row_id{4})(0);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[4].id, foos[6].id}, ids);
+
+        // The keyset filter is bound immediately, without invoking the query again.
+        query.resetPaging().after(sql::row_id{6});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[6].id, foos[8].id}, ids);
+    }
+
+    /*
+     * Test resetting the keyset filter without a limit.
+     */
+
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+        query(0);
+
+        query.after(sql::row_id{4});
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foos[4].id, foos[6].id, foos[8].id}, ids);
+
+        // Removing the keyset filter also applies without invoking the query again.
+        query.resetPaging();
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foos[0].id, foos[2].id, foos[4].id, foos[6].id, foos[8].id}, ids);
+    }
+
+    /*
+     * Test keyset pagination is rejected for union based searches.
+     */
+
+    {
+        auto query = alex::referenceSearch(barDescriptor, alex::references<BarDescriptor, "foos">());
+        expectThrow([&] { query.after(foos[0].id); });
+        expectNoThrow([&] { query.limit(1); });
+    }
+}
@@ -0,0 +1,150 @@
+#include "alexandria-extended-query_test/search_queries/parallel_search.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/raw_statement.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId id;
+        int32_t          a = 0;
+        float            b = 0;
+    };
+
+    using FooDescriptor = alex::
+      GenerateTypeDescriptor<alex::Member<"id", &Foo::id>, alex::Member<"a", &Foo::a>, alex::Member<"b", &Foo::b>>;
+
+    [[nodiscard]] std::vector<std::string> sorted(const std::vector<alex::InstanceId>& ids)
+    {
+        std::vector<std::string> strings;
+        for (const auto& id : ids) strings.emplace_back(id.getAsString());
+        std::ranges::sort(strings);
+        return strings;
+    }
+}  // namespace
+
+void ParallelSearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+        fooLayout.createPrimitiveProperty("prop1", alex::DataType::Float);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    std::vector<Foo> foos(1000);
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        alex::execute(library->getDatabase(), "BEGIN;");
+        for (size_t i = 0; i < foos.size(); i++)
+        {
+            foos[i].a = static_cast<int32_t>(i % 7);
+            foos[i].b = static_cast<float>(i);
+            inserter(foos[i]);
+        }
+        alex::execute(library->getDatabase(), "COMMIT;");
+    }).fatal("Failed to insert objects");
+
+    auto serial   = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+    auto parallel = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+    expectNoThrow([&] { parallel.parallel(4); }).fatal("Failed to enable parallel execution");
+
+    std::vector<alex::InstanceId> expected, ids;
+
+    // Results are merged in rowid order.
+    serial(3);
+    parallel(3);
+    expected.assign(serial.begin(), serial.end());
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(expected.size(), size_t{143});
+    compareEQ(expected, ids);
+
+    // Same for predicates on other members.
+    {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::greaterEqual<FooDescriptor, "b">());
+        query(500.0f);
+        expected.assign(query.begin(), query.end());
+        query.parallel(3)(500.0f);
+        ids.assign(query.begin(), query.end());
+        compareEQ(expected, ids);
+    }
+
+    // Limit and offset apply to the merged results.
+    serial.limit(20).offset(50)(3);
+    parallel.limit(20).offset(50)(3);
+    expected.assign(serial.begin(), serial.end());
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(expected.size(), size_t{20});
+    compareEQ(expected, ids);
+
+    // Keyset pagination.
+    serial.resetPaging().limit(30);
+    parallel.resetPaging().limit(30);
+    expectNoThrow([&] {
+        serial.after(foos[500].id)(3);
+        parallel.after(foos[500].id)(3);
+    });
+    expected.assign(serial.begin(), serial.end());
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(expected, ids);
+
+    // No matches.
+    parallel.resetPaging()(7);
+    ids.assign(parallel.begin(), parallel.end());
+    compareTrue(ids.empty());
+
+    // Unordered results contain the same instances.
+    serial.resetPaging()(5);
+    parallel.parallel(4, alex::ParallelOrder::Unordered).resetPaging()(5);
+    expected.assign(serial.begin(), serial.end());
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(sorted(expected), sorted(ids));
+
+    // With a limit, any matching instances fill the page.
+    parallel.limit(10)(5);
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(ids.size(), size_t{10});
+    for (const auto& id : ids) compareTrue(std::ranges::find(expected, id) != expected.end());
+
+    // Searches ordered by member values keep running serially.
+    serial.resetPaging().orderBy<"b">(alex::Order::Descending)(2);
+    parallel.resetPaging().orderBy<"b">(alex::Order::Descending)(2);
+    expected.assign(serial.begin(), serial.end());
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(expected, ids);
+
+    // Disabling parallel execution.
+    parallel.parallel(1)(2);
+    ids.assign(parallel.begin(), parallel.end());
+    compareEQ(expected, ids);
+
+    // Iterations that start in an open transaction run serially, so that they see its changes.
+    expectNoThrow([&] {
+        auto query = alex::primitiveSearch(fooDescriptor, alex::equal<FooDescriptor, "a">());
+        query.parallel(4)(2);
+        alex::execute(library->getDatabase(), "BEGIN;");
+        Foo foo;
+        foo.a = 2;
+        alex::InsertQuery(fooDescriptor)(foo);
+        ids.assign(query.begin(), query.end());
+        alex::execute(library->getDatabase(), "ROLLBACK;");
+    }).fatal("Failed to search in transaction");
+    compareEQ(ids.size(), size_t{144});
+}
@@ -0,0 +1,131 @@
+#include "alexandria-extended-query_test/search_queries/sharded_search.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/namespace.h"
+#include "alexandria-core/sharded_library.h"
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-core/type_layout.h"
+#include "alexandria-basic-query/sharded_query.h"
+#include "alexandria-extended-query/search_queries/primitive_search.h"
+#include "alexandria-extended-query/sharded_search_query.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId id;
+        int32_t          a = 0;
+        int32_t          b = 0;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"a", &Foo::a>,
+                                                       alex::Member<"b", &Foo::b>>;
+}  // namespace
+
+void ShardedSearch::operator()()
+{
+    alex::ShardedLibraryPtr library;
+    expectNoThrow([&] {
+        library = alex::ShardedLibrary::create({"", "", ""});
+        library->updateSpecification([](alex::Library& shard) {
+            alex::TypeLayout fooLayout;
+            fooLayout.createPrimitiveProperty("prop0", alex::DataType::Int32);
+            fooLayout.createPrimitiveProperty("prop1", alex::DataType::Int32);
+            fooLayout.commit(shard.createNamespace("main"), "foo");
+        });
+    }).fatal("Failed to create library");
+
+    std::vector<Foo> foos(60);
+    expectNoThrow([&] {
+        alex::ShardedInsertQuery<FooDescriptor> inserter(*library, "main", "foo");
+        for (size_t i = 0; i < foos.size(); i++)
+        {
+            foos[i].a = static_cast<int32_t>(i % 3);
+            foos[i].b = static_cast<int32_t>(i * 7 % foos.size());
+            inserter(foos[i]);
+        }
+    }).fatal("Failed to insert objects");
+
+    auto query = alex::shardedSearch(*library, [](alex::Library& shard) {
+        return alex::primitiveSearch(FooDescriptor(shard.getNamespace("main").getType("foo")),
+                                     alex::equal<FooDescriptor, "a">());
+    });
+
+    // Expected results, in shard order and within each shard in insertion order.
+    std::vector<alex::InstanceId> expected;
+    for (size_t shard = 0; shard < library->getShardCount(); shard++)
+        for (const auto& foo : foos)
+            if (foo.a == 1 && library->getShardIndex(foo.id) == shard) expected.emplace_back(foo.id);
+
+    // All matches from all shards.
+    std::vector<alex::InstanceId> ids;
+    expectNoThrow([&] { ids = query(1).get(); }).fatal("Failed to run query");
+    compareEQ(expected, ids);
+    compareEQ(query.count(), int64_t{20});
+    compareTrue(query.exists());
+    compareFalse(query(3).exists());
+    compareEQ(query.count(), int64_t{0});
+
+    // Limit and offset apply to the merged results.
+    ids = query.limit(7).offset(5)(1).get();
+    compareEQ(std::vector(expected.begin() + 5, expected.begin() + 12), ids);
+    ids = query.offset(18)(1).get();
+    compareEQ(std::vector(expected.begin() + 18, expected.end()), ids);
+    ids = query.offset(25)(1).get();
+    compareTrue(ids.empty());
+    ids = query.resetPaging()(1).get();
+    compareEQ(expected, ids);
+
+    // The query of a shard only returns instances stored in that shard.
+    auto& shardQuery = query.getQuery(1)(1);
+    for (const auto& id : shardQuery) compareEQ(library->getShardIndex(id), size_t{1});
+
+    // Ordered queries return the global top results, not those of the first shard.
+    auto ordered = alex::shardedSearch(*library, [](alex::Library& shard) {
+        auto q = alex::primitiveSearch(FooDescriptor(shard.getNamespace("main").getType("foo")),
+                                       alex::greaterEqual<FooDescriptor, "a">());
+        q.orderBy<"b">(alex::Order::Descending);
+        return q;
+    });
+    auto sorted = foos;
+    std::ranges::sort(sorted, [](const Foo& lhs, const Foo& rhs) { return lhs.b > rhs.b; });
+    expected.clear();
+    for (size_t i = 0; i < 5; i++) expected.emplace_back(sorted[i + 3].id);
+    ids = ordered.limit(5).offset(3)(0).get();
+    compareEQ(expected, ids);
+
+    // Ties are broken by identifier.
+    auto tied = alex::shardedSearch(*library, [](alex::Library& shard) {
+        auto q = alex::primitiveSearch(FooDescriptor(shard.getNamespace("main").getType("foo")),
+                                       alex::greaterEqual<FooDescriptor, "a">());
+        q.orderBy<"a">();
+        return q;
+    });
+    std::ranges::sort(sorted, [](const Foo& lhs, const Foo& rhs) {
+        if (lhs.a != rhs.a) return lhs.a < rhs.a;
+        return lhs.id.get() < rhs.id.get();
+    });
+    expected.clear();
+    for (const auto& foo : sorted) expected.emplace_back(foo.id);
+    ids = tied(0).get();
+    compareEQ(expected, ids);
+
+    // The paging of the per-shard queries is neither applied nor changed.
+    tied.getQuery(0).limit(2);
+    ids = tied(0).get();
+    compareEQ(expected, ids);
+    size_t count = 0;
+    for ([[maybe_unused]] const auto& id : tied.getQuery(0)) count++;
+    compareEQ(count, size_t{2});
+}
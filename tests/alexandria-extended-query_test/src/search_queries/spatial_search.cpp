@@ -0,0 +1,199 @@
+#include "alexandria-extended-query_test/search_queries/spatial_search.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+#include "alexandria-extended-query/search_queries/spatial_search.h"
+
+namespace
+{
+    struct Float3
+    {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    struct Foo
+    {
+        alex::InstanceId id;
+        std::string      name;
+        Float3           position;
+    };
+
+    using Float3MemberList =
+      alex::MemberList<alex::Member<"x", &Float3::x>, alex::Member<"y", &Float3::y>, alex::Member<"z", &Float3::z>>;
+    using FooDescriptor =
+      alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                   alex::Member<"name", &Foo::name>,
+                                   alex::NestedMember<"position", Float3MemberList, &Foo::position>>;
+}  // namespace
+
+void SpatialSearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout float1Layout;
+        float1Layout.createPrimitiveProperty("x", alex::DataType::Float);
+        float1Layout.commit(*nameSpace, "float1", alex::TypeLayout::Instantiable::False);
+
+        alex::TypeLayout float3Layout;
+        float3Layout.createPrimitiveProperty("x", alex::DataType::Float);
+        float3Layout.createPrimitiveProperty("y", alex::DataType::Float);
+        float3Layout.createPrimitiveProperty("z", alex::DataType::Float);
+        float3Layout.commit(*nameSpace, "float3", alex::TypeLayout::Instantiable::False);
+    }).fatal("Failed to commit types");
+
+    expectThrow([&] {
+        alex::TypeLayout layout;
+        layout.createStringProperty("prop0").setSpatial();
+    });
+
+    expectThrow([&] {
+        alex::TypeLayout layout;
+        layout.createNestedTypeProperty("prop0", nameSpace->getType("float1")).setSpatial();
+    });
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0");
+        fooLayout.createNestedTypeProperty("prop1", nameSpace->getType("float3")).setSpatial();
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    compareFalse(nameSpace->getType("foo").getLayout().getProperties()[0]->isSpatial());
+    compareTrue(nameSpace->getType("foo").getLayout().getProperties()[1]->isSpatial());
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    Foo foo0{.name = "a", .position = {0, 0, 0}};
+    Foo foo1{.name = "b", .position = {1, 1, 1}};
+    Foo foo2{.name = "a", .position = {5, 5, 5}};
+    Foo foo3{.name = "b", .position = {-2, 0, 0}};
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+        inserter(foo2);
+        inserter(foo3);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test box search.
+     */
+
+    {
+        auto query = alex::spatialSearch(fooDescriptor, alex::withinBox<FooDescriptor, "position">());
+        query(alex::SpatialBox<3>{.min = {-1, -1, -1}, .max = {2, 2, 2}});
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo1.id}, ids);
+
+        // Bounds are inclusive.
+        query(alex::SpatialBox<3>{.min = {-2, 0, 0}, .max = {0, 0, 0}});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo3.id}, ids);
+
+        query(alex::SpatialBox<3>{.min = {10, 10, 10}, .max = {20, 20, 20}});
+        ids.assign(query.begin(), query.end());
+        compareTrue(ids.empty());
+    }
+
+    /*
+     * Test radius search.
+     */
+
+    {
+        auto query = alex::spatialSearch(fooDescriptor, alex::withinRadius<FooDescriptor, "position">());
+        query(alex::SpatialSphere<3>{.center = {-1, 0, 0}, .radius = 1.5});
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo3.id}, ids);
+
+        query(alex::SpatialSphere<3>{.center = {0, 0, 0}, .radius = 2.1});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo1.id, foo3.id}, ids);
+    }
+
+    /*
+     * Test nearest search.
+     */
+
+    {
+        auto query = alex::nearestSearch(fooDescriptor, alex::withinRadius<FooDescriptor, "position">());
+        query(alex::SpatialSphere<3>{.center = {1.5, 1.5, 1.5}, .radius = 100});
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo0.id, foo3.id, foo2.id}, ids);
+
+        query.limit(2);
+        query(alex::SpatialSphere<3>{.center = {-2, 0, 0}, .radius = 100});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo3.id, foo0.id}, ids);
+        expectThrow([&] { query.after(foo3.id); });
+
+        // The radius is widened until enough instances are found.
+        query.limit(3);
+        query(alex::SpatialSphere<3>{.center = {1.5, 1.5, 1.5}, .radius = 0.1});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo0.id, foo3.id}, ids);
+
+        // Offset instances count towards the number of instances to find.
+        query.offset(2);
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo3.id, foo2.id}, ids);
+
+        // A radius of 0 is widened as well. All instances are returned when there are fewer than requested.
+        query.offset(0);
+        query.limit(10);
+        query(alex::SpatialSphere<3>{.center = {-2, 0, 0}, .radius = 0});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo3.id, foo0.id, foo1.id, foo2.id}, ids);
+
+        // Without a limit, only the radius of the sphere is searched.
+        query.resetPaging();
+        query(alex::SpatialSphere<3>{.center = {1.5, 1.5, 1.5}, .radius = 0.1});
+        ids.assign(query.begin(), query.end());
+        compareTrue(ids.empty());
+    }
+
+    /*
+     * Test spatial operators inside expressions.
+     */
+
+    {
+        auto query = alex::search(fooDescriptor,
+                                  alex::withinBox<FooDescriptor, "position">() && alex::equal<FooDescriptor, "name">());
+        query(alex::SpatialBox<3>{.min = {-3, -3, -3}, .max = {3, 3, 3}}, std::string("b"));
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo3.id}, ids);
+    }
+
+    /*
+     * Test that the index follows updates and deletes.
+     */
+
+    {
+        foo2.position = {0.5f, 0.5f, 0.5f};
+        expectNoThrow([&] {
+            auto updater = alex::UpdateQuery(fooDescriptor);
+            updater(foo2);
+        }).fatal("Failed to update object");
+
+        auto query = alex::spatialSearch(fooDescriptor, alex::withinBox<FooDescriptor, "position">());
+        query(alex::SpatialBox<3>{.min = {0, 0, 0}, .max = {1, 1, 1}});
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo1.id, foo2.id}, ids);
+
+        expectNoThrow([&] {
+            auto deleter = alex::DeleteQuery(fooDescriptor);
+            deleter(foo1);
+        }).fatal("Failed to delete object");
+
+        query(alex::SpatialBox<3>{.min = {0, 0, 0}, .max = {1, 1, 1}});
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo2.id}, ids);
+    }
+}
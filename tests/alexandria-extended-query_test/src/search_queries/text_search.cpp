@@ -0,0 +1,157 @@
+#include "alexandria-extended-query_test/search_queries/text_search.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/delete_query.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-basic-query/update_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+#include "alexandria-extended-query/search_queries/text_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId  id;
+        std::string       title;
+        std::string       body;
+        alex::StringArray tags;
+        float             size = 0;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"title", &Foo::title>,
+                                                       alex::Member<"body", &Foo::body>,
+                                                       alex::Member<"tags", &Foo::tags>,
+                                                       alex::Member<"size", &Foo::size>>;
+}  // namespace
+
+void TextSearch::operator()()
+{
+    expectThrow([&] {
+        alex::TypeLayout layout;
+        layout.createPrimitiveProperty("prop0", alex::DataType::Int32).setFullText();
+    });
+
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0").setFullText();
+        fooLayout.createStringProperty("prop1");
+        fooLayout.createStringArrayProperty("prop2").setFullText();
+        fooLayout.createPrimitiveProperty("prop3", alex::DataType::Float);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    compareTrue(nameSpace->getType("foo").getLayout().getProperties()[0]->isFullText());
+    compareFalse(nameSpace->getType("foo").getLayout().getProperties()[1]->isFullText());
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    Foo foo0{.title = "red car", .body = "red", .size = 1.0f};
+    Foo foo1{.title = "red red red", .body = "red", .size = 2.0f};
+    Foo foo2{.title = "blue boat", .body = "red", .size = 3.0f};
+    foo0.tags.get() = {"fast", "shiny"};
+    foo1.tags.get() = {"slow"};
+    foo2.tags.get() = {"shiny new", "wet"};
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        inserter(foo0);
+        inserter(foo1);
+        inserter(foo2);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test ranked search on a string property.
+     */
+
+    {
+        auto query = alex::textSearch(fooDescriptor, alex::matches<FooDescriptor, "title">());
+        query("red");
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id, foo0.id}, ids);
+
+        query("boat OR car");
+        ids.assign(query.begin(), query.end());
+        compareEQ(2, ids.size());
+
+        query("bo*");
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo2.id}, ids);
+
+        query.limit(1);
+        query("red");
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id}, ids);
+        expectThrow([&] { query.after(foo1.id); });
+    }
+
+    /*
+     * Test search on a string array property.
+     */
+
+    {
+        auto query = alex::textSearch(fooDescriptor, alex::matches<FooDescriptor, "tags">());
+        query("shiny");
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(2, ids.size());
+
+        query("wet");
+        ids.assign(query.begin(), query.end());
+        compareEQ(std::vector{foo2.id}, ids);
+    }
+
+    /*
+     * Test full-text operators inside expressions.
+     */
+
+    {
+        auto query = alex::search(fooDescriptor,
+                                  alex::matches<FooDescriptor, "title">() &&
+                                    (alex::matches<FooDescriptor, "tags">() || alex::greater<FooDescriptor, "size">()));
+        query("red", "fast", 1.5f);
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo0.id, foo1.id}, ids);
+    }
+
+    /*
+     * Test that the index follows updates and deletes.
+     */
+
+    {
+        foo0.title = "green car";
+        foo2.tags.get() = {"dry"};
+        expectNoThrow([&] {
+            auto updater = alex::UpdateQuery(fooDescriptor);
+            updater(foo0);
+            updater(foo2);
+        }).fatal("Failed to update objects");
+
+        auto query = alex::textSearch(fooDescriptor, alex::matches<FooDescriptor, "title">());
+        query("red");
+        std::vector<alex::InstanceId> ids(query.begin(), query.end());
+        compareEQ(std::vector{foo1.id}, ids);
+
+        auto tagQuery = alex::textSearch(fooDescriptor, alex::matches<FooDescriptor, "tags">());
+        tagQuery("wet");
+        ids.assign(tagQuery.begin(), tagQuery.end());
+        compareTrue(ids.empty());
+
+        expectNoThrow([&] {
+            auto deleter = alex::DeleteQuery(fooDescriptor);
+            deleter(foo1);
+        }).fatal("Failed to delete object");
+
+        query("red");
+        ids.assign(query.begin(), query.end());
+        compareTrue(ids.empty());
+    }
+
+    /*
+     * Test that searching a property without full-text index fails.
+     */
+
+    expectThrow([&] { static_cast<void>(alex::textSearch(fooDescriptor, alex::matches<FooDescriptor, "body">())); });
+}
@@ -0,0 +1,110 @@
+#include "alexandria-extended-query_test/search_queries/visit_search.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "alexandria-core/type_descriptor.h"
+#include "alexandria-basic-query/insert_query.h"
+#include "alexandria-extended-query/search_queries/expression_search.h"
+
+namespace
+{
+    struct Foo
+    {
+        alex::InstanceId            id;
+        std::string                 name;
+        float                       radius = 0;
+        alex::PrimitiveBlob<double> values;
+    };
+
+    using FooDescriptor = alex::GenerateTypeDescriptor<alex::Member<"id", &Foo::id>,
+                                                       alex::Member<"name", &Foo::name>,
+                                                       alex::Member<"radius", &Foo::radius>,
+                                                       alex::Member<"values", &Foo::values>>;
+}  // namespace
+
+void VisitSearch::operator()()
+{
+    expectNoThrow([&] {
+        alex::TypeLayout fooLayout;
+        fooLayout.createStringProperty("prop0");
+        fooLayout.createPrimitiveProperty("prop1", alex::DataType::Float);
+        fooLayout.createPrimitiveBlobProperty("prop2", alex::DataType::Double);
+        fooLayout.commit(*nameSpace, "foo");
+    }).fatal("Failed to commit types");
+
+    auto fooDescriptor = FooDescriptor(nameSpace->getType("foo"));
+
+    std::vector<Foo> foos(5);
+    for (size_t i = 0; i < foos.size(); i++)
+    {
+        foos[i].name   = "foo" + std::to_string(i);
+        foos[i].radius = static_cast<float>(i);
+        foos[i].values.get().resize(i, static_cast<double>(i));
+    }
+    expectNoThrow([&] {
+        auto inserter = alex::InsertQuery(fooDescriptor);
+        for (auto& foo : foos) inserter(foo);
+    }).fatal("Failed to insert objects");
+
+    /*
+     * Test visiting all results.
+     */
+
+    {
+        auto query = alex::search(fooDescriptor, alex::greater<FooDescriptor, "radius">());
+        query(1.5f);
+
+        std::vector<std::string> names;
+        size_t                   bytes = 0;
+        expectNoThrow([&] {
+            query.visit([&](const alex::RowView<FooDescriptor>& row) {
+                names.emplace_back(row.get<"name">());
+                bytes += row.get<"values">().size();
+            });
+        }).fatal("Failed to visit results");
+        compareEQ(std::vector<std::string>{"foo2", "foo3", "foo4"}, names);
+        compareEQ((2 + 3 + 4) * sizeof(double), bytes);
+
+        // Parameters can be changed between visits.
+        query(3.5f);
+        names.clear();
+        query.visit([&](const alex::RowView<FooDescriptor>& row) { names.emplace_back(row.get<"name">()); });
+        compareEQ(std::vector<std::string>{"foo4"}, names);
+    }
+
+    /*
+     * Test stopping early, paging and ordering.
+     */
+
+    {
+        auto query = alex::search(fooDescriptor, alex::greater<FooDescriptor, "radius">());
+        query(-1.0f);
+
+        std::vector<std::string> names;
+        query.visit([&](const alex::RowView<FooDescriptor>& row) {
+            names.emplace_back(row.get<"name">());
+            return names.size() < 2;
+        });
+        compareEQ(std::vector<std::string>{"foo0", "foo1"}, names);
+
+        names.clear();
+        query.offset(1).limit(2);
+        query.visit([&](const alex::RowView<FooDescriptor>& row) { names.emplace_back(row.get<"name">()); });
+        compareEQ(std::vector<std::string>{"foo1", "foo2"}, names);
+
+        names.clear();
+        query.resetPaging();
+        query.orderBy<"radius">(alex::Order::Descending);
+        query.visit([&](const alex::RowView<FooDescriptor>& row) { names.emplace_back(row.get<"name">()); });
+        compareEQ(std::vector<std::string>{"foo4", "foo3", "foo2", "foo1", "foo0"}, names);
+    }
+}